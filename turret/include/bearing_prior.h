@@ -0,0 +1,112 @@
+/**
+ * @file bearing_prior.h
+ * @brief Learned histogram of where the beacon is usually found.
+ *
+ * The pan range (±PAN_LIMIT_DEG) is split into PRIOR_BINS bins of
+ * PRIOR_BIN_DEG.  Every time the beacon is acquired or lost, the bin at
+ * the current pan bearing gains PRIOR_EVENT_WEIGHT and its learned
+ * elevation (tilt angle) is blended toward the current tilt.
+ *
+ *   - Aging:       every PRIOR_AGE_INTERVAL_MS all weights decay by 1/8.
+ *   - Saturation:  if a bin would overflow, all weights are halved first,
+ *                  which preserves the ranking.
+ *   - Persistence: save()/load() pack the histogram into a fixed-size,
+ *                  checksummed blob for NVS; the caller owns the storage.
+ *
+ * The search planner ranks bins by weight and visits the likely bearings
+ * first, tilting to each bin's learned elevation.
+ */
+
+#ifndef BEARING_PRIOR_H
+#define BEARING_PRIOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+class BearingPrior {
+public:
+    /** @brief Packed size of save() output, in bytes. */
+    static constexpr size_t BLOB_SIZE = 4 + PRIOR_BINS * 3 + 2;
+
+    /** @brief Forget everything learned.  Call (or load()) before use. */
+    void clear();
+
+    /** @brief Record that the beacon was (re)acquired at this pose. */
+    void recordAcquired(float bearingDeg, int16_t tiltDeg);
+
+    /** @brief Record that the beacon was lost at this pose. */
+    void recordLost(float bearingDeg, int16_t tiltDeg);
+
+    /**
+     * @brief Apply one aging step if PRIOR_AGE_INTERVAL_MS has elapsed.
+     *
+     * Call once per main-loop iteration, or schedule age() every
+     * PRIOR_AGE_INTERVAL_MS instead.
+     */
+    void ageIfDue();
+
+    /** @brief Decay every bin weight by 1/8 now. */
+    void age();
+
+    /** @brief Bin index covering @p bearingDeg (clamped to the pan range). */
+    static uint8_t binFor(float bearingDeg);
+
+    /** @brief Bearing at the center of @p bin (degrees). */
+    static float binCenterDeg(uint8_t bin);
+
+    /** @brief Current weight of @p bin. */
+    uint16_t weight(uint8_t bin) const;
+
+    /** @brief Sum of all bin weights (0 = nothing learned). */
+    uint32_t totalWeight() const;
+
+    /**
+     * @brief Learned tilt angle for the bin covering @p bearingDeg.
+     * @return TILT_SCAN_DEG if nothing has been learned there.
+     */
+    int16_t elevationAt(float bearingDeg) const;
+
+    /**
+     * @brief Fill @p out with non-empty bin indices, heaviest first.
+     * @return Number of indices written (≤ @p maxBins).
+     */
+    uint8_t rankBins(uint8_t *out, uint8_t maxBins) const;
+
+    /** @brief True if the histogram changed since the last markClean(). */
+    bool isDirty() const;
+
+    /** @brief Call after the histogram has been persisted. */
+    void markClean();
+
+    /**
+     * @brief Pack the histogram into @p out (BLOB_SIZE bytes).
+     * @return Bytes written.
+     */
+    size_t save(uint8_t *out) const;
+
+    /**
+     * @brief Restore from a blob produced by save().
+     * @return false (and leaves the prior cleared) on size, version or
+     *         checksum mismatch.
+     */
+    bool load(const uint8_t *in, size_t len);
+
+private:
+    static constexpr uint8_t  NO_ELEVATION = 0xFF;   ///< Bin has no tilt data
+    static constexpr uint16_t BLOB_MAGIC   = 0x5042; ///< "BP"
+    static constexpr uint8_t  BLOB_VERSION = 1;
+
+    uint16_t weight_[PRIOR_BINS]    = {};
+    uint8_t  elevation_[PRIOR_BINS] = {};
+    uint32_t lastAgeMs_ = 0;   ///< millis() of the last aging step
+    bool dirty_ = false;
+
+    /** @brief Shared implementation of the record*() calls. */
+    void record(float bearingDeg, int16_t tiltDeg);
+
+    /** @brief Fletcher-16 over @p len bytes. */
+    static uint16_t checksum(const uint8_t *data, size_t len);
+};
+
+#endif // BEARING_PRIOR_H
@@ -18,6 +18,21 @@
 
 #include <stdint.h>
 
+/**
+ * @brief Declare a tunable constant.
+ *
+ * constexpr on the target and in the unit tests.  In the host simulator
+ * (SENTRY_SIM) a plain variable instead, so sentry-tune can try other
+ * values without a rebuild (sim/sim_tunables.h lists them) — one per
+ * thread, as each WorkPool thread runs its own turret.  Anything that
+ * needs a compile-time value must not depend on one.
+ */
+#ifdef SENTRY_SIM
+#define TURRET_TUNABLE(type, name, value) inline thread_local type name = value
+#else
+#define TURRET_TUNABLE(type, name, value) constexpr type name = value
+#endif
+
 // ===================================================================
 // Pin Assignments  (ESP32 DevKit v1)
 //
@@ -57,14 +72,20 @@ constexpr uint8_t PIN_STATUS_LED    = 2;
  * Each sensor maintains a circular buffer of this many recent readings.
  * A sensor counts as "active" only if at least SENSOR_FILTER_THRESHOLD
  * of the last SENSOR_FILTER_WINDOW samples were LOW (signal detected).
+ * At most 8 (one bit per sample in a uint8_t); at least 7, or a window
+ * can fall between two beacon trains (BEACON_CYCLE_MS).
  */
-constexpr uint8_t SENSOR_FILTER_WINDOW    = 8;
+TURRET_TUNABLE(uint8_t, SENSOR_FILTER_WINDOW, 8);
 
 /**
  * @brief Minimum detections within the window to count as "active".
- * 6 out of 8 → rejects brief reflections while staying responsive.
+ * A detection is a tick whose LOW latch caught a burst train, and the
+ * beacon sends one train per BEACON_CYCLE_MS (126 ms): 8 ticks (160 ms)
+ * always hold one, and hold two when a second train falls inside or one
+ * straddles a tick.  2 out of 8 → a lone glint is not enough.
+ * Not a tunable: the search sweep rate is derived from it at compile time.
  */
-constexpr uint8_t SENSOR_FILTER_THRESHOLD = 6;
+constexpr uint8_t SENSOR_FILTER_THRESHOLD = 2;
 
 /**
  * @brief Saturation guard — if a sensor reports LOW for this many
@@ -108,6 +129,22 @@ constexpr float PAN_MIN_SPEED = 0.15f;
  */
 constexpr float PAN_DEG_PER_SEC = 60.0f;
 
+// ===================================================================
+// Servo Output Stage
+// ===================================================================
+
+/**
+ * @brief Servo PWM frame period, microseconds (50 Hz — ESP32Servo default).
+ * At most one new pulse width is committed per frame.
+ */
+constexpr uint32_t SERVO_FRAME_US = 20000;
+
+/** @brief Standard-servo pulse width at 0° (ESP32Servo default minimum). */
+constexpr uint16_t SERVO_MIN_PULSE_US = 544;
+
+/** @brief Standard-servo pulse width at 180° (ESP32Servo default maximum). */
+constexpr uint16_t SERVO_MAX_PULSE_US = 2400;
+
 // ===================================================================
 // Tilt Axis
 // ===================================================================
@@ -134,7 +171,7 @@ constexpr uint8_t TILT_STEP_DEG = 1;
  * @brief Minimum time between tilt steps, in milliseconds.
  * Lets the mechanical system settle.  (Issue #8.)
  */
-constexpr uint16_t TILT_HOLDOFF_MS = 100;
+TURRET_TUNABLE(uint16_t, TILT_HOLDOFF_MS, 100);
 
 // ===================================================================
 // Tracking Engine  (Issue #8)
@@ -144,13 +181,102 @@ constexpr uint16_t TILT_HOLDOFF_MS = 100;
  * @brief Pan speed when beacon is far off-center (only one sensor active).
  * Normalised 0.0–1.0.
  */
-constexpr float TRACK_PAN_SPEED_FAST = 0.80f;
+TURRET_TUNABLE(float, TRACK_PAN_SPEED_FAST, 0.80f);
 
 /**
  * @brief Pan speed when beacon is nearly centered (intermittent off-side hits).
  * Normalised 0.0–1.0.
  */
-constexpr float TRACK_PAN_SPEED_SLOW = 0.30f;
+TURRET_TUNABLE(float, TRACK_PAN_SPEED_SLOW, 0.30f);
+
+/**
+ * @brief "Recently active" window for the opposing horizontal sensor (ms).
+ * If the other side fired within this window the beacon is near center
+ * and the tracker uses the slow gain.
+ */
+TURRET_TUNABLE(uint16_t, TRACK_APPROACH_MEMORY_MS, 400);
+
+// ===================================================================
+// Turret State Machine — tracking sub-states
+//
+//   ACQUIRING — beacon just (re)appeared: permissive filter, full gains,
+//               get it centered quickly.
+//   LOCKED    — centered for LOCK_CENTERED_MS: strict filter, low gains,
+//               hold steady without hunting.
+//   COASTING  — filtered reading blank for COAST_DEBOUNCE_MS while the
+//               monitor still says present: keep the last pan motion,
+//               decaying to a stop over COAST_MAX_MS, until the beacon is
+//               seen again; then back to the sub-state it coasted from.
+// ===================================================================
+
+/**
+ * @brief Majority-vote threshold while ACQUIRING (of SENSOR_FILTER_WINDOW).
+ * 1: the one train every window is sure to hold.
+ */
+TURRET_TUNABLE(uint8_t, ACQUIRE_FILTER_THRESHOLD, 1);
+
+/** @brief Majority-vote threshold while LOCKED. */
+TURRET_TUNABLE(uint8_t, LOCK_FILTER_THRESHOLD, SENSOR_FILTER_THRESHOLD);
+
+/** @brief LOCKED pan speed with the beacon off to one side. */
+TURRET_TUNABLE(float, LOCK_PAN_SPEED_FAST, 0.40f);
+
+/** @brief LOCKED pan speed with the beacon near center. */
+TURRET_TUNABLE(float, LOCK_PAN_SPEED_SLOW, 0.18f);
+
+/** @brief Continuous L+R (centered) time that promotes ACQUIRING → LOCKED (ms). */
+TURRET_TUNABLE(uint16_t, LOCK_CENTERED_MS, 300);
+
+/** @brief Continuous one-sided time that demotes LOCKED → ACQUIRING (ms). */
+TURRET_TUNABLE(uint16_t, LOCK_BREAK_MS, 400);
+
+/** @brief COASTING: time over which the last pan speed decays to zero (ms). */
+TURRET_TUNABLE(uint16_t, COAST_MAX_MS, 600);
+
+/**
+ * @brief Continuous blank filtered reading that starts COASTING (ms).
+ * The first whole tick past one beacon burst cycle (BEACON_CYCLE_MS),
+ * so a single missed burst train leaves ACQUIRING / LOCKED and their
+ * dwell timers alone.  Meanwhile the tracker holds, as on any blank
+ * reading; COASTING then carries on from the last tracked speed, its
+ * decay timed from the first blank tick.
+ */
+TURRET_TUNABLE(uint16_t, COAST_DEBOUNCE_MS, 140);
+
+// ===================================================================
+// Park Planner
+// ===================================================================
+
+/**
+ * @brief Peak normalised pan speed while driving home.
+ * Used while the pan is further than PARK_DECEL_DEG from home.
+ */
+constexpr float PARK_PAN_SPEED_MAX = 1.0f;
+
+/**
+ * @brief Deceleration zone (degrees from home).
+ * Inside this distance the park speed scales down proportionally with
+ * the remaining distance, floored at PAN_MIN_SPEED so the drive never
+ * stalls in the gear backlash.
+ */
+constexpr float PARK_DECEL_DEG = 30.0f;
+
+/** @brief Pan counts as home once |position| is below this (degrees). */
+constexpr float PARK_HOME_TOLERANCE_DEG = 1.0f;
+
+/**
+ * @brief Maximum tilt change per loop iteration while parking (degrees).
+ * At 50 Hz → 100°/s ceiling; the planner normally paces tilt slower so
+ * it arrives together with the pan.
+ */
+constexpr uint8_t PARK_TILT_STEP_DEG = 2;
+
+/**
+ * @brief Settle time after the park completes before both servos are
+ *        powered down (PWM detached), in milliseconds.
+ * Gives the tilt horn time to physically reach its last commanded angle.
+ */
+constexpr uint16_t PARK_SETTLE_MS = 500;
 
 // ===================================================================
 // Signal Monitor  (Issue #9)
@@ -169,27 +295,486 @@ constexpr uint16_t SIGNAL_LOSS_SEARCH_MS = 3000;
 
 /**
  * @brief Time without any signal before transitioning to PARKED.
+ * Long enough for the search to cover the whole pan range once from
+ * anywhere: one and a half passes at the detection-limited rate
+ * (SEARCH_MAX_PAN_DEG_PER_SEC, ~12°/s), ~35 s.  The sweep rate is set
+ * by the SPRT's presence decision (Search Detection Model below); a
+ * shorter timeout parks before the search has reached the far side.
  */
-constexpr uint16_t SIGNAL_LOSS_PARK_MS = 15000;
+TURRET_TUNABLE(uint16_t, SIGNAL_LOSS_PARK_MS, 40000);
 
 /**
  * @brief Sweep half-angle during SEARCHING state (degrees from center).
  */
 constexpr float SEARCH_SWEEP_DEG = 90.0f;
 
+// ===================================================================
+// Loop Tick and Beacon Timing
+//
+// How often the turret samples and how often the beacon shows.  The
+// beacon side mirrors beacon/include/config.h: a train of bursts, then
+// the watchdog sleep.
+// ===================================================================
+
+/** @brief Target loop period in milliseconds (50 Hz). */
+constexpr uint16_t LOOP_PERIOD_MS = 20;
+
+/** @brief Control tick period in microseconds (absolute-deadline timer). */
+constexpr uint32_t LOOP_PERIOD_US = LOOP_PERIOD_MS * 1000UL;
+
+/** @brief Beacon carrier burst (µs) — BURST_ON_US. */
+constexpr uint16_t BEACON_BURST_ON_US = 600;
+
+/** @brief Beacon gap after each burst (µs) — BURST_OFF_US. */
+constexpr uint16_t BEACON_BURST_OFF_US = 600;
+
+/** @brief Bursts per beacon train — BURSTS_PER_CYCLE. */
+constexpr uint8_t BEACON_BURSTS = 5;
+
+/** @brief Beacon watchdog sleep after each train (ms) — WDTO_120MS. */
+constexpr uint16_t BEACON_SLEEP_MS = 120;
+
+/** @brief First burst start to last burst end (µs): 5.4 ms of the cycle. */
+constexpr uint32_t BEACON_TRAIN_US =
+    BEACON_BURSTS * BEACON_BURST_ON_US + (BEACON_BURSTS - 1) * BEACON_BURST_OFF_US;
+
+/** @brief Beacon burst-train period (ms): 5 × (600 + 600) µs + 120 ms = 126. */
+constexpr uint16_t BEACON_CYCLE_MS =
+    BEACON_BURSTS * (BEACON_BURST_ON_US + BEACON_BURST_OFF_US) / 1000 + BEACON_SLEEP_MS;
+
+// ===================================================================
+// Signal Monitor — Sequential Probability Ratio Test
+//
+// Per tick and per sensor the monitor observes a raw hit (x = 1) or not
+// (x = 0) and accumulates that sensor's log-likelihood ratio
+//     S += ln P(x | present) − ln P(x | absent)
+// clamped to [lower, upper] so the test restarts at each decision.
+//   upper = ln((1 − β) / α)   → beacon present  (→ TRACKING), any sensor
+//   lower = ln(β / (1 − α))   → beacon absent   (TRACKING → SEARCHING),
+//                               every sensor
+// One test per sensor: ambient hits on the four sensors do not add up
+// to look like the beacon on one.
+// α trades false acquisitions against acquisition delay; β trades false
+// losses against loss-detection delay.
+// ===================================================================
+
+/**
+ * @brief P(raw hit on a sensor's tick | beacon present, in its view).
+ *
+ * A raw sample is the sensor's LOW latch over the whole tick
+ * (sensor_array.h), so a tick hits when one of the beacon's trains
+ * overlaps it: a train starting within LOOP_PERIOD_MS + BEACON_TRAIN_US
+ * of the tick's end, once per BEACON_CYCLE_MS.
+ * (20 + 5.4) / 126 ≈ 0.20.  An instantaneous read would hit on the
+ * bursts alone, 5 × 0.6 / 126 ≈ 0.024 — no better than ambient.
+ */
+constexpr float SPRT_P_HIT_PRESENT =
+    (LOOP_PERIOD_US + BEACON_TRAIN_US) / (BEACON_CYCLE_MS * 1000.0f);
+
+/**
+ * @brief P(raw hit on a sensor's tick | beacon absent) — ambient IR,
+ *        reflections.  4 % of the ticks across the four sensors.
+ *
+ * The evidence turns towards "present" above ~6.7 % ambient hits per
+ * sensor; a heavily lit room (sim "noise", 3 %) stays well clear of it.
+ */
+TURRET_TUNABLE(float, SPRT_P_HIT_ABSENT, 0.01f);
+
+#ifndef SENTRY_SIM   // a variable there; sentry-tune's range stays below 0.05
+static_assert(SPRT_P_HIT_PRESENT > 4.0f * SPRT_P_HIT_ABSENT,
+              "Beacon hits barely outnumber ambient ones; the test would crawl");
+#endif
+
+/** @brief Target false-presence probability (α). */
+TURRET_TUNABLE(float, SPRT_ALPHA, 1e-4f);
+
+/** @brief Target false-loss probability (β). */
+TURRET_TUNABLE(float, SPRT_BETA, 1e-6f);
+
+/**
+ * @brief Wald's expected sample count from "absent" to "present" with
+ *        the beacon in view (ticks).
+ *
+ * (upper − lower) / E[LLR step] at SPRT_P_HIT_PRESENT:
+ * (9.21 + 13.82) / (0.20 × 3.00 − 0.80 × 0.215) ≈ 53.1, rounded up.
+ * ln() is not constexpr, so the figure is spelled out; the native tests
+ * recompute it from the monitor's thresholds.  It holds for the values
+ * above; a sentry-tune candidate that moves them keeps this search dwell.
+ */
+constexpr uint16_t SPRT_PRESENT_MEAN_TICKS = 54;
+
+/**
+ * @brief Median of the same stopping time (ticks).
+ *
+ * Hits independent at SPRT_P_HIT_PRESENT, LLR clamped at the lower
+ * threshold; the exact distribution has median 51, p90 82, p99 117, and
+ * is reached within twice the median 97 % of the time.  The shipped
+ * beacon's trains are periodic and tighter than that (test 51: worst 61
+ * over every train phase).  Spelled out like the mean; the native tests
+ * check it by Monte Carlo on the monitor.
+ */
+constexpr uint16_t SPRT_PRESENT_MEDIAN_TICKS = 51;
+
+// ===================================================================
+// Signal Monitor — Adaptive Loss Timeouts
+//
+// Every absence (presence lost → presence decided again) is counted in a
+// log-spaced histogram: bin 0 holds absences under 2 s, bin i ≥ 1 holds
+// [2^i, 2^(i+1)) s, the last bin is open-ended.  From it the monitor picks
+//   park timeout T  minimising Σ count × (d ≤ T ? d : T + UNPARK_COST)
+//                   — servo-on time spent waiting, plus the cost of a full
+//                   park / unpark cycle when the wait was too
+//                   short;
+//   hold time       the ADAPT_HOLD_QUANTILE quantile of absences that end
+//                   before T — how long SEARCHING keeps scanning the exit
+//                   bearing before the wider search starts.
+// Until ABSENCE_MIN_SAMPLES absences are seen, SIGNAL_LOSS_PARK_MS and no
+// hold are used.
+// ===================================================================
+
+/** @brief Number of log-spaced absence-duration bins (last is open-ended). */
+constexpr uint8_t ABSENCE_BINS = 12;
+
+/** @brief Absences recorded before the timeouts start adapting. */
+constexpr uint8_t ABSENCE_MIN_SAMPLES = 6;
+
+/**
+ * @brief Count at which all bins are halved, so the histogram is bounded
+ *        and follows changes in routine within a few dozen absences.
+ */
+constexpr uint8_t ABSENCE_COUNT_MAX = 32;
+
+/**
+ * @brief Servo-on time (ms) one park / unpark cycle is worth: the
+ *        travel home and back, and the user waiting for the fan to find
+ *        them again from home — weighted well above idle servo time
+ *        because the user notices it.
+ */
+constexpr uint32_t ABSENCE_UNPARK_COST_MS = 30000;
+
+/** @brief Shortest adaptive park timeout (ms). */
+TURRET_TUNABLE(uint32_t, ADAPT_PARK_MIN_MS, 4000);
+
+/** @brief Longest adaptive park timeout (ms). */
+TURRET_TUNABLE(uint32_t, ADAPT_PARK_MAX_MS, 120000);
+
+/** @brief Fraction of short (< park timeout) absences the hold should outlast. */
+TURRET_TUNABLE(float, ADAPT_HOLD_QUANTILE, 0.9f);
+
+/** @brief Longest hold on the exit bearing (ms). */
+TURRET_TUNABLE(uint32_t, ADAPT_HOLD_MAX_MS, 60000);
+
+// ===================================================================
+// Search Planner / Bearing Prior
+// ===================================================================
+
+/** @brief Width of one bearing-histogram bin (degrees). */
+constexpr float PRIOR_BIN_DEG = 15.0f;
+
+/** @brief Number of bearing bins spanning ±PAN_LIMIT_DEG (270° / 15° = 18). */
+constexpr uint8_t PRIOR_BINS = static_cast<uint8_t>(2.0f * PAN_LIMIT_DEG / PRIOR_BIN_DEG);
+
+/** @brief Histogram weight added per acquired / lost event (fixed point). */
+constexpr uint16_t PRIOR_EVENT_WEIGHT = 256;
+
+/**
+ * @brief Aging interval (ms).  Every interval all bin weights decay by
+ * 1/8, so habits from weeks ago fade out behind recent ones.
+ */
+constexpr uint32_t PRIOR_AGE_INTERVAL_MS = 3600000UL;   // 1 hour
+
+/**
+ * @brief Learned bearings visited before falling back to the symmetric
+ *        ±SEARCH_SWEEP_DEG sweep (the last-known bearing is always first).
+ */
+constexpr uint8_t SEARCH_MAX_WAYPOINTS = 4;
+
 /**
- * @brief Sweep speed during SEARCHING state (normalised, slow).
+ * @brief Pan speed while moving between learned bearings (normalised).
+ * Faster than the sweep: transit legs are not relied on for detection.
  */
-constexpr float SEARCH_SWEEP_SPEED = 0.25f;
+constexpr float SEARCH_TRANSIT_SPEED = 0.60f;
+
+/** @brief A search leg ends within this distance of its target (degrees). */
+constexpr float SEARCH_WAYPOINT_TOL_DEG = 1.0f;
 
 // ===================================================================
 // Main Loop
 // ===================================================================
 
-/** @brief Target loop period in milliseconds (50 Hz). */
-constexpr uint16_t LOOP_PERIOD_MS = 20;
+/** @brief Width of one tick-jitter histogram bin (µs). */
+constexpr uint16_t JITTER_BIN_US = 50;
+
+/**
+ * @brief Tick-jitter histogram bins (the last one is open-ended).
+ *
+ * 40 × 50 µs covers 0–2 ms of lateness, beyond which the p99 figure
+ * falls back to the observed maximum.
+ */
+constexpr uint8_t JITTER_BINS = 40;
 
 /** @brief Serial debug output baud rate. */
 constexpr uint32_t SERIAL_BAUD = 115200;
 
+/** @brief Serial debug status line period (ms). */
+constexpr uint16_t DEBUG_PRINT_MS = 500;
+
+/** @brief Status LED blink half-period while SEARCHING (ms). */
+constexpr uint16_t STATUS_BLINK_MS = 500;
+
+// ===================================================================
+// Scheduler
+//
+// Timed work on the control task (LED blink, prior aging) is registered
+// as deadlines in a fixed-capacity min-heap; the task sleeps until the
+// earliest one instead of every module polling millis().
+// ===================================================================
+
+/** @brief Maximum simultaneously scheduled jobs (no heap allocation). */
+constexpr uint8_t SCHED_MAX_JOBS = 8;
+
+/** @brief Longest the loop sleeps when nothing is scheduled (ms). */
+constexpr uint16_t SCHED_IDLE_MAX_MS = 1000;
+
+// ===================================================================
+// Task Pipeline
+//
+// Capture (sensor sampling + majority filter) runs on one core at high
+// priority; the fixed-rate control tick runs alone on the other; serial
+// telemetry and commands run at low priority beside capture.  They talk
+// only through SPSC rings (spsc_ring.h).
+// ===================================================================
+
+/** @brief Core of the capture task (PRO CPU). */
+constexpr int8_t CAPTURE_TASK_CORE = 0;
+
+/** @brief Core of the control task (APP CPU, where loopTask was). */
+constexpr int8_t CONTROL_TASK_CORE = 1;
+
+/** @brief Core of the telemetry task (shares with capture, lower priority). */
+constexpr int8_t TELEMETRY_TASK_CORE = 0;
+
+/** @brief FreeRTOS priorities (higher wins; Arduino loopTask is 1). */
+constexpr uint8_t CAPTURE_TASK_PRIORITY   = 5;
+constexpr uint8_t CONTROL_TASK_PRIORITY   = 4;
+constexpr uint8_t TELEMETRY_TASK_PRIORITY = 1;
+
+/** @brief Stack per task (bytes). */
+constexpr uint32_t TASK_STACK_BYTES = 4096;
+
+/**
+ * @brief How far the capture tick leads the control tick (µs).
+ *
+ * Capture and control share LOOP_PERIOD_US; the control tick falls this
+ * long after each capture, so it always finds a fresh snapshot.
+ */
+constexpr uint32_t CAPTURE_LEAD_US = 2000;
+
+/** @brief Ring sizes (powers of two; one slot is kept empty). */
+constexpr uint16_t SNAPSHOT_RING_SIZE  = 8;    // capture → control
+constexpr uint16_t TELEMETRY_RING_SIZE = 32;   // control → telemetry
+constexpr uint16_t COMMAND_RING_SIZE   = 8;    // telemetry → control
+
+/** @brief Telemetry task poll period (ms). */
+constexpr uint16_t TELEMETRY_POLL_MS = 10;
+
+/**
+ * @brief Control-tick stride while parked with the servos powered down.
+ *
+ * Nothing moves then, and a tick without a raw hit changes nothing, so
+ * the control task wakes every PARK_IDLE_TICKS periods (or for a
+ * scheduled job) and consumes the snapshots in between together.  A raw
+ * hit puts it back on every period.  The snapshot ring must hold the
+ * gap, with room for one late tick.
+ */
+constexpr uint8_t PARK_IDLE_TICKS = 5;
+
+static_assert(PARK_IDLE_TICKS + 2 <= SNAPSHOT_RING_SIZE,
+              "Snapshot ring overflows between parked control ticks");
+
+// ===================================================================
+// Profiler
+// ===================================================================
+
+/**
+ * @brief Per-stage timing (profiler.h).  false compiles every scope out.
+ */
+constexpr bool PROFILING_ENABLED = true;
+
+/**
+ * @brief Log2 histogram buckets per stage.
+ *
+ * Bucket i counts durations in [2^i, 2^(i+1)) clock ticks (CPU cycles
+ * on target, ns on host); 28 buckets reach ~1 s at 240 MHz.
+ */
+constexpr uint8_t PROF_BUCKETS = 28;
+
+// ===================================================================
+// Telemetry Stream
+//
+// Every control tick becomes one fixed-layout binary record, CRC-16
+// protected and COBS framed (0x00 delimits frames), queued in a byte
+// ring that the telemetry task drains only as fast as the UART accepts.
+// Decode captures on the host with tools/telemetry_decode.cpp.
+// ===================================================================
+
+/** @brief Start in binary mode ('b' toggles to the text status line). */
+constexpr bool TELEMETRY_BINARY_DEFAULT = true;
+
+/**
+ * @brief Outgoing byte ring (power of two).
+ *
+ * One frame is 22 bytes on the wire (18-byte record + CRC + COBS
+ * overhead + delimiter): 1024 bytes buffer ~46 ticks, almost a second
+ * of a stalled UART, before whole frames are dropped.
+ */
+constexpr uint16_t TELEMETRY_TX_RING_BYTES = 1024;
+
+// ===================================================================
+// Flight Recorder
+//
+// The last FLIGHT_RECORDER_TICKS telemetry records are kept in RTC slow
+// memory that the bootloader does not clear, so after a watchdog (or
+// any other) reset the next boot can print what the loop was doing.
+// ===================================================================
+
+/**
+ * @brief Ticks kept (200 × 20 ms = the last 4 s).
+ *
+ * 200 × 20-byte records = 4000 bytes of the ESP32's 8 KB RTC slow memory.
+ */
+constexpr uint16_t FLIGHT_RECORDER_TICKS = 200;
+
+// ===================================================================
+// Detection Latency
+//
+// Each time the beacon comes back (first raw sensor hit after the
+// filter has been quiet for LATENCY_QUIET_MS) the pipeline times how
+// long the filter, the monitor, the tracker and the pan servo take to
+// respond (latency_tracker.h).
+// ===================================================================
+
+/**
+ * @brief Quiet time before a raw hit opens a latency event (ms).
+ *
+ * Longer than the filter's own dropouts between trains while the beacon
+ * is held (one missed train, ~250 ms), shorter than the occlusions and
+ * walk-outs the event is meant to time.
+ */
+constexpr uint16_t LATENCY_QUIET_MS = 500;
+
+/** @brief Width of one latency histogram bin (ms). */
+constexpr uint16_t LATENCY_BIN_MS = 32;
+
+/**
+ * @brief Latency histogram bins (the last one is open-ended): 0–2048 ms,
+ *        past LATENCY_TIMEOUT_MS, so every completed event has its bin.
+ */
+constexpr uint8_t LATENCY_BINS = 64;
+
+/**
+ * @brief An event not through to the servo after this long is abandoned
+ *        (a reflection, or a beacon that left again) (ms).
+ */
+constexpr uint16_t LATENCY_TIMEOUT_MS = 2000;
+
+/**
+ * @brief Budget for raw hit → pan servo write, p99 (ms).
+ *
+ * Back from a search or a park the tracker waits for the monitor, whose
+ * presence test on the shipped beacon stops within two beacon cycles of
+ * Wald's mean, from any train phase (test 51): (54 + 2 × 7) ticks.  The
+ * servo write follows in the same tick.  After a short occlusion the
+ * monitor is still TRACKING and only the filter stands in the way.
+ * Checked by the native tests on the firmware's burst pattern.
+ */
+constexpr uint16_t LATENCY_BUDGET_MS =
+    (SPRT_PRESENT_MEAN_TICKS + 2 * (BEACON_CYCLE_MS / LOOP_PERIOD_MS + 1)) * LOOP_PERIOD_MS;
+
+static_assert(LATENCY_BUDGET_MS < LATENCY_TIMEOUT_MS,
+              "events within budget must not be abandoned");
+static_assert(LATENCY_TIMEOUT_MS <= LATENCY_BIN_MS * LATENCY_BINS,
+              "a completed event must not land in the open-ended bin");
+
+// ===================================================================
+// Search Detection Model
+//
+// A sweep is only useful if the beacon stays inside the sensor field of
+// view long enough to be confirmed.  Confirmation is the monitor's
+// presence test climbing from "absent" (the majority filter is ACTIVE
+// long before, on the first train), so the dwell is sized from the
+// SPRT's stopping time: its median, SPRT_PRESENT_MEDIAN_TICKS.
+// During that dwell the sweep may cross at most SEARCH_FOV_MARGIN of the
+// FOV width, which bounds the search speed on each axis.  At 0.5 a
+// beacon on the sweep line is in view for two medians, and is confirmed
+// on that pass 97 % of the time; one at the pan limit, where the FOV is
+// clipped to ~17°, about 80 %.  A miss waits for the next pass.
+//
+// At ~12°/s one raster takes over a minute; SIGNAL_LOSS_PARK_MS is
+// sized to match.
+// ===================================================================
+
+/** @brief Half-angle of the sensor cross field of view, pan axis (degrees). */
+constexpr float SENSOR_FOV_PAN_HALF_DEG = 12.0f;
+
+/** @brief Half-angle of the sensor cross field of view, tilt axis (degrees). */
+constexpr float SENSOR_FOV_TILT_HALF_DEG = 12.0f;
+
+/** @brief Fraction of the FOV width a search may sweep across per dwell. */
+constexpr float SEARCH_FOV_MARGIN = 0.5f;
+
+/** @brief Median in-view time to confirm the beacon (ms). */
+constexpr uint16_t SEARCH_DETECT_DWELL_MS = SPRT_PRESENT_MEDIAN_TICKS * LOOP_PERIOD_MS;
+
+/** @brief Fastest pan rate that keeps the detection margin (°/s). */
+constexpr float SEARCH_MAX_PAN_DEG_PER_SEC =
+    2.0f * SENSOR_FOV_PAN_HALF_DEG * SEARCH_FOV_MARGIN * 1000.0f / SEARCH_DETECT_DWELL_MS;
+
+/** @brief Fastest tilt rate that keeps the detection margin (°/s). */
+constexpr float SEARCH_MAX_TILT_DEG_PER_SEC =
+    2.0f * SENSOR_FOV_TILT_HALF_DEG * SEARCH_FOV_MARGIN * 1000.0f / SEARCH_DETECT_DWELL_MS;
+
+/**
+ * @brief Fastest sweep speed that keeps the detection margin (normalised).
+ * The detection-limited pan rate, capped at full speed.
+ * (±12° FOV, 1020 ms dwell → ≈11.8°/s → 0.20.)
+ */
+constexpr float SEARCH_DETECT_SPEED =
+    (SEARCH_MAX_PAN_DEG_PER_SEC >= PAN_DEG_PER_SEC)
+        ? 1.0f : SEARCH_MAX_PAN_DEG_PER_SEC / PAN_DEG_PER_SEC;
+
+static_assert(SEARCH_DETECT_SPEED >= PAN_MIN_SPEED,
+              "Detection-limited sweep is below the pan backlash threshold");
+static_assert(SEARCH_TRANSIT_SPEED > SEARCH_DETECT_SPEED,
+              "Transit legs should outrun the detection-limited sweep");
+
+/** @brief Sweep speed during SEARCHING (normalised). */
+TURRET_TUNABLE(float, SEARCH_SWEEP_SPEED, SEARCH_DETECT_SPEED);
+
+/**
+ * @brief Raster rows needed so every tilt in [TILT_MIN_DEG, TILT_MAX_DEG]
+ *        is within SENSOR_FOV_TILT_HALF_DEG of a row (rows evenly spaced,
+ *        first and last on the limits).
+ */
+constexpr uint8_t SEARCH_RASTER_ROWS = static_cast<uint8_t>(
+    (TILT_MAX_DEG - TILT_MIN_DEG) / (2.0f * SENSOR_FOV_TILT_HALF_DEG) + 0.999f) + 1;
+
+/**
+ * @brief Exhaustive search pattern used after the learned bearings.
+ */
+enum class SearchPattern : uint8_t {
+    SWEEP,       ///< ±SEARCH_SWEEP_DEG pan sweep at the learned elevation
+    RASTER,      ///< Full pan range, one pass per tilt row (boustrophedon)
+    LISSAJOUS    ///< Continuous pan/tilt sinusoids at incommensurate rates
+};
+
+/** @brief Default search pattern. */
+constexpr SearchPattern SEARCH_PATTERN = SearchPattern::RASTER;
+
+/**
+ * @brief Lissajous tilt-to-pan frequency ratio.
+ * Non-integer so successive pan cycles cross at different elevations.
+ */
+constexpr float SEARCH_LISSAJOUS_RATIO = 2.7f;
+
 #endif // TURRET_CONFIG_H
@@ -0,0 +1,79 @@
+/**
+ * @file flight_recorder.h
+ * @brief Ring of the last FLIGHT_RECORDER_TICKS telemetry records in
+ *        memory that survives a reset.
+ *
+ * The Log lives in a no-init section (RTC_NOINIT_ATTR on target, see
+ * main.cpp; any static the test leaves alone on host).  At boot:
+ *
+ *     recorder.init(&log);          // keeps last run's records if valid
+ *     for (i < recorder.count())    // dump them, oldest first
+ *         ... recorder.at(i) ...
+ *     recorder.start();             // then record this run
+ *
+ * At power-on the region holds noise; init() recognises that from the
+ * header (magic + layout) and starts clean.  A record torn by the reset
+ * itself can show up as the last entry.
+ *
+ * record() is a 20-byte copy and an index bump, on the control task.
+ */
+
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <stdint.h>
+#include "config.h"
+#include "telemetry_stream.h"
+
+class FlightRecorder {
+public:
+    /** @brief The persistent region.  Only init() may judge its contents. */
+    struct Log {
+        uint32_t magic;      ///< MAGIC when the rest is meaningful
+        uint16_t capacity;   ///< FLIGHT_RECORDER_TICKS when written
+        uint16_t entryBytes; ///< sizeof(TelemetryRecord) when written
+        uint32_t boots;      ///< Resets seen since power-on
+        uint16_t head;       ///< Next slot to write
+        uint16_t count;      ///< Valid entries (≤ capacity)
+        TelemetryRecord entries[FLIGHT_RECORDER_TICKS];
+    };
+
+    static constexpr uint32_t MAGIC = 0x464C5202;   // "FLR" v2
+
+    /**
+     * @brief Adopt @p log.
+     *
+     * @return true if it held a previous run (count() entries to dump);
+     *         false if it was noise or another firmware's layout, in
+     *         which case it is cleared.
+     */
+    bool init(Log *log);
+
+    /** @brief Clear the entries and start recording this run. */
+    void start();
+
+    /** @brief Append one tick, overwriting the oldest when full. */
+    void record(const TelemetryRecord &rec) {
+        Log *l = log_;
+        l->entries[l->head] = rec;
+        l->head = (l->head + 1 == FLIGHT_RECORDER_TICKS) ? 0 : l->head + 1;
+        if (l->count < FLIGHT_RECORDER_TICKS) l->count++;
+    }
+
+    /** @brief Entries held (the previous run's until start()). */
+    uint16_t count() const;
+
+    /** @brief @p i-th oldest entry, i < count(). */
+    const TelemetryRecord &at(uint16_t i) const;
+
+    /** @brief Resets since power-on (0 on the first boot). */
+    uint32_t boots() const;
+
+private:
+    Log *log_ = nullptr;
+};
+
+static_assert(sizeof(FlightRecorder::Log) <= 4096,
+              "flight recorder must fit in half of RTC slow memory");
+
+#endif // FLIGHT_RECORDER_H
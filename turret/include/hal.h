@@ -0,0 +1,48 @@
+/**
+ * @file hal.h
+ * @brief Compile-time hardware abstraction: clock, GPIO (with LOW
+ *        latches), servo pulses, serial port and persistent storage.
+ *
+ * The modules reach the hardware only through `Hal`, a traits class
+ * picked here by the build:
+ *
+ *     Esp32Hal   target (hal_esp32.h): each call is an inline forward to
+ *                the Arduino core, ESP32Servo or Preferences, so the
+ *                firmware compiles to what calling those directly would
+ *     HostHal    UNIT_TEST and SENTRY_SIM (hal_host.h): deterministic
+ *                fakes.  The clock moves only when told to, pins read
+ *                whatever the installed reader says, and servo pulses,
+ *                serial bytes and storage sit in memory for inspection
+ *
+ * Both provide the same static members (see HostHal for the list), so
+ * the real sources build and link unchanged on the host: the unit tests,
+ * the simulator and the microbenchmarks all drive them through HostHal.
+ * No virtual calls and no function pointers stand between a module and
+ * the hardware.
+ */
+
+#ifndef HAL_H
+#define HAL_H
+
+/**
+ * @brief Storage class of the firmware's global state (the HAL fakes,
+ *        main.cpp's modules, the profiler).
+ *
+ * thread_local in the simulator, so each WorkPool thread runs a turret
+ * of its own (sim/sim_run.h); nothing anywhere else.
+ */
+#ifdef SENTRY_SIM
+#define HAL_PER_THREAD thread_local
+#else
+#define HAL_PER_THREAD
+#endif
+
+#if defined(UNIT_TEST) || defined(SENTRY_SIM)
+#include "hal_host.h"
+typedef HostHal Hal;
+#else
+#include "hal_esp32.h"
+typedef Esp32Hal Hal;
+#endif
+
+#endif // HAL_H
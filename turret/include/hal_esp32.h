@@ -0,0 +1,63 @@
+/**
+ * @file hal_esp32.h
+ * @brief Target HAL: inline forwards to the Arduino-ESP32 core,
+ *        ESP32Servo and NVS Preferences; sensor LOW latches on GPIO
+ *        interrupts.  Include hal.h, not this.
+ */
+
+#ifndef HAL_ESP32_H
+#define HAL_ESP32_H
+
+#include <Arduino.h>
+#include <ESP32Servo.h>
+#include <stdint.h>
+#include <stddef.h>
+
+struct Esp32Hal {
+    // --- Clock ---
+
+    /** @brief 32 bits: wraps every 49.7 days. */
+    static uint32_t millis() { return ::millis(); }
+
+    /** @brief 32 bits: wraps every 71.6 minutes. */
+    static uint32_t micros() { return ::micros(); }
+
+    static void delay(uint32_t ms) { ::delay(ms); }
+
+    /** @brief CPU cycle counter (Profiler's clock). */
+    static uint32_t cycleCount() { return ESP.getCycleCount(); }
+
+    static float cyclesPerUs() { return static_cast<float>(getCpuFrequencyMhz()); }
+
+    // --- GPIO ---
+
+    static void pinMode(uint8_t pin, uint8_t mode) { ::pinMode(pin, mode); }
+    static int  digitalRead(uint8_t pin) { return ::digitalRead(pin); }
+    static void digitalWrite(uint8_t pin, uint8_t level) { ::digitalWrite(pin, level); }
+
+    /** @brief Latch every falling edge on input @p pin (GPIO interrupt). */
+    static void armLowLatch(uint8_t pin);
+
+    /** @brief Whether @p pin fell (or is LOW) since the last take; clears it. */
+    static bool takeLowLatch(uint8_t pin);
+
+    // --- Servo pulses ---
+
+    typedef ::Servo Servo;
+
+    // --- Serial ---
+
+    typedef HardwareSerial SerialPort;
+
+    static SerialPort &serial() { return ::Serial; }
+
+    // --- Persistent storage (NVS) ---
+
+    /** @brief Read @p key of namespace @p ns into @p buf; bytes read, 0 if absent or too long. */
+    static size_t storageGet(const char *ns, const char *key, void *buf, size_t maxLen);
+
+    /** @brief Write @p len bytes to @p key of namespace @p ns; bytes written. */
+    static size_t storagePut(const char *ns, const char *key, const void *buf, size_t len);
+};
+
+#endif // HAL_ESP32_H
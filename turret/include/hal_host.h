@@ -0,0 +1,199 @@
+/**
+ * @file hal_host.h
+ * @brief Host HAL: deterministic fakes of the turret's hardware, for the
+ *        unit tests, the simulator (sim/) and the microbenchmarks.
+ *        Include hal.h, not this.
+ *
+ * Nothing runs on its own.  Time moves only when the caller says so
+ * (advanceUs(), or delay() from the firmware); millis() and micros()
+ * are the 64-bit virtual clock cut to 32 bits, so they wrap as on the
+ * ESP32.  Input pins read whatever the installed PinReader says (HIGH
+ * without one); a LOW latch asks the LatchReader about the whole time
+ * since the last take (the PinReader's level now, without one); output
+ * levels, servo pulse widths, serial TX and the storage are kept in
+ * memory.  Serial TX drains at the baud rate in
+ * virtual time, so availableForWrite() behaves as the UART FIFO would.
+ *
+ * setWallClock() makes the clock follow the host's steady clock instead,
+ * for tests that run the pipeline's tasks on real threads.
+ *
+ * One instance of the hardware per process, as on the ESP32 — per
+ * thread in the simulator (HAL_PER_THREAD, hal.h).
+ */
+
+#ifndef HAL_HOST_H
+#define HAL_HOST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#ifndef HIGH
+#define HIGH 1
+#define LOW  0
+#endif
+
+#ifndef INPUT
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+#endif
+
+#ifndef F
+#define F(s) (s)
+#endif
+
+class HostHal {
+public:
+    /** @brief Level of input @p pin right now (HIGH / LOW). */
+    typedef int (*PinReader)(uint8_t pin, void *ctx);
+
+    /** @brief Told of every digitalWrite(). */
+    typedef void (*PinWriter)(uint8_t pin, uint8_t level, void *ctx);
+
+    /** @brief Whether input @p pin was LOW at any time in (fromUs, toUs]. */
+    typedef bool (*LatchReader)(uint8_t pin, uint64_t fromUs, uint64_t toUs, void *ctx);
+
+    /** @brief Highest GPIO number + 1. */
+    static constexpr uint8_t PINS = 40;
+
+    /** @brief UART hardware TX FIFO (the ESP32 core's default buffer). */
+    static constexpr uint16_t UART_TX_FIFO = 128;
+
+    /**
+     * @brief Virtual clock to 0, pins idle and unhooked, servos detached,
+     *        serial empty.  Storage is kept: NVS survives a reboot.
+     */
+    static void reset();
+
+    // --- Clock ---
+
+    static uint32_t millis() { return static_cast<uint32_t>(nowUs() / 1000u); }
+    static uint32_t micros() { return static_cast<uint32_t>(nowUs()); }
+
+    /** @brief Time passes; nothing else moves until the caller's next step. */
+    static void delay(uint32_t ms) { advanceUs(static_cast<uint64_t>(ms) * 1000u); }
+
+    /** @brief Profiler's clock: the steady clock in ns (real cost, not virtual time). */
+    static uint32_t cycleCount();
+
+    static float cyclesPerUs() { return 1000.0f; }
+
+    /** @brief The clock, 64-bit: it never wraps. */
+    static uint64_t nowUs() { return wallClock_ ? wallUs() : clockUs_; }
+
+    /** @brief Move virtual time forward. */
+    static void advanceUs(uint64_t us) { clockUs_ += us; }
+
+    /** @brief Set virtual time (e.g. just short of a wrap). */
+    static void setNowUs(uint64_t us) { clockUs_ = us; }
+
+    /** @brief Follow the host's steady clock (true) or the virtual one. */
+    static void setWallClock(bool on) { wallClock_ = on; }
+
+    // --- GPIO ---
+
+    static void pinMode(uint8_t, uint8_t) {}
+
+    static int digitalRead(uint8_t pin) { return pinReader_ ? pinReader_(pin, pinCtx_) : HIGH; }
+
+    static void digitalWrite(uint8_t pin, uint8_t level);
+
+    /** @brief Source of input levels; nullptr reads every pin HIGH. */
+    static void setPinReader(PinReader reader, void *ctx);
+
+    /** @brief Observer of output writes, or nullptr. */
+    static void setPinWriter(PinWriter writer, void *ctx);
+
+    /** @brief Last level written to output @p pin. */
+    static uint8_t outputLevel(uint8_t pin);
+
+    /** @brief Start latching LOWs on input @p pin (the target's edge interrupt). */
+    static void armLowLatch(uint8_t pin);
+
+    /** @brief Whether @p pin was LOW since the last take (or arming); clears it. */
+    static bool takeLowLatch(uint8_t pin);
+
+    /** @brief Source of latched LOWs; nullptr takes digitalRead() now. */
+    static void setLatchReader(LatchReader reader, void *ctx);
+
+    // --- Servo pulses (ESP32Servo's interface) ---
+
+    class Servo {
+    public:
+        int attach(int pin);
+        int attach(int pin, int, int) { return attach(pin); }
+        void detach();
+        bool attached() const { return pin_ >= 0; }
+        void writeMicroseconds(int us);
+
+        /** @brief Angle 0–180° over the library's default 544–2400 µs. */
+        void write(int angle) { writeMicroseconds(544 + angle * (2400 - 544) / 180); }
+
+    private:
+        int pin_ = -1;
+    };
+
+    /** @brief Pulse width on @p pin, or 0 while detached (no pulses). */
+    static uint16_t servoPulseUs(uint8_t pin);
+
+    // --- Serial (the print / write subset of HardwareSerial) ---
+
+    class SerialPort {
+    public:
+        void begin(unsigned long baud);
+
+        int available();
+        int read();
+        int availableForWrite();
+
+        /** @brief Queue TX bytes; never blocks (virtual time does not pass). */
+        size_t write(uint8_t b) { return write(&b, 1); }
+        size_t write(const uint8_t *data, size_t len);
+
+        size_t print(const char *s);
+        size_t print(char c);
+        size_t print(int v);
+        size_t print(unsigned int v);
+        size_t print(long v);
+        size_t print(unsigned long v);
+        size_t print(double v, int digits = 2);
+
+        size_t println();
+        size_t println(double v, int digits) { return print(v, digits) + println(); }
+
+        template <typename T>
+        size_t println(T v) { return print(v) + println(); }
+    };
+
+    static SerialPort &serial() { return serial_; }
+
+    /** @brief Move everything written so far into @p out (appended). */
+    static void takeSerialTx(std::vector<uint8_t> &out);
+
+    /** @brief Queue a byte for the firmware to read. */
+    static void serialInject(uint8_t c);
+
+    // --- Persistent storage (NVS Preferences) ---
+
+    /** @brief Read @p key of namespace @p ns into @p buf; bytes read, 0 if absent or too long. */
+    static size_t storageGet(const char *ns, const char *key, void *buf, size_t maxLen);
+
+    /** @brief Write @p len bytes to @p key of namespace @p ns; bytes written. */
+    static size_t storagePut(const char *ns, const char *key, const void *buf, size_t len);
+
+    /** @brief Forget every stored key (a factory-fresh flash). */
+    static void storageErase();
+
+private:
+    static inline HAL_PER_THREAD uint64_t  clockUs_   = 0;
+    static inline HAL_PER_THREAD bool      wallClock_ = false;
+    static inline HAL_PER_THREAD PinReader pinReader_ = nullptr;
+    static inline HAL_PER_THREAD void     *pinCtx_    = nullptr;
+
+    static HAL_PER_THREAD SerialPort serial_;
+
+    static uint64_t wallUs();
+};
+
+#endif // HAL_HOST_H
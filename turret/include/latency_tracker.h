@@ -0,0 +1,121 @@
+/**
+ * @file latency_tracker.h
+ * @brief Detection → actuation latency, per stage, per event.
+ *
+ * An event opens on the first raw sensor hit after no sensor has been
+ * filtered ACTIVE for LATENCY_QUIET_MS (or at all since init()): the
+ * beacon arriving at boot, coming back into a sensor's view after an
+ * occlusion or a walk-out, or found again by a search.  It is stamped
+ * with the capture time.  Whether the monitor had given up does not
+ * matter; it stays TRACKING through a short occlusion.  Each stage is
+ * then stamped the first time it responds:
+ *
+ *   FILTER   — majority filter reports a sensor ACTIVE (capture time)
+ *   MONITOR  — signal monitor is TRACKING (at once if it never gave up)
+ *   COMMAND  — tracking engine drives the pan (ACQUIRING / LOCKED), after FILTER
+ *   SERVO    — first pan pulse-width commit after COMMAND
+ *
+ * SERVO closes the event; each stage's time since the raw hit goes into
+ * its histogram.  Stages are cumulative, not deltas, so one that never
+ * fires leaves the others meaningful.  A hit that has left the filter
+ * window (SENSOR_FILTER_WINDOW samples) without the filter going ACTIVE
+ * was noise, not a beacon: its event is discarded, uncounted, and the
+ * next hit may open one.  One that got through the filter but not to
+ * the servo is abandoned, and counted, once the filter has been quiet
+ * for LATENCY_QUIET_MS again or LATENCY_TIMEOUT_MS has passed.
+ *
+ * Used by one task (control); read the figures there or after stop().
+ */
+
+#ifndef LATENCY_TRACKER_H
+#define LATENCY_TRACKER_H
+
+#include <stdint.h>
+#include "config.h"
+
+/** @brief Stages timed from the raw hit. */
+enum class LatencyStage : uint8_t {
+    FILTER,
+    MONITOR,
+    COMMAND,
+    SERVO,
+    COUNT
+};
+
+/** @brief One stage's figures (µs since the raw hit). */
+struct LatencySummary {
+    uint32_t count  = 0;
+    uint32_t meanUs = 0;
+    uint32_t p50Us  = 0;   ///< Upper edge of the median's bin
+    uint32_t p99Us  = 0;   ///< Upper edge of the p99 bin
+    uint32_t maxUs  = 0;
+};
+
+/** @brief All stages, plus event counts. */
+struct LatencyStats {
+    uint32_t events    = 0;   ///< Completed (raw hit → servo)
+    uint32_t abandoned = 0;   ///< Timed out before the servo
+    LatencySummary stage[static_cast<uint8_t>(LatencyStage::COUNT)];
+};
+
+class LatencyTracker {
+public:
+    /**
+     * @brief One capture sample, as seen by the control task.
+     *
+     * @param tUs           Capture time.
+     * @param rawBits       Raw LOW mask.
+     * @param filterActive  Filtered reading has a sensor ACTIVE.
+     */
+    void sample(uint32_t tUs, uint8_t rawBits, bool filterActive);
+
+    /** @brief Stamp @p stage at @p tUs if an event is open and it is not stamped yet. */
+    void mark(LatencyStage stage, uint32_t tUs);
+
+    /** @brief True while an event is open and @p stage is not stamped. */
+    bool awaiting(LatencyStage stage) const;
+
+    /** @brief Current figures. */
+    LatencyStats stats() const;
+
+    /** @brief Start afresh: no event, no figures, no sensor seen ACTIVE yet. */
+    void init();
+
+    /** @brief Clear the figures (and any open event); the quiet timer is kept. */
+    void reset();
+
+    /** @brief Short name of @p stage ("filter", "monitor", ...). */
+    static const char *stageName(LatencyStage stage);
+
+private:
+    static constexpr uint8_t STAGES = static_cast<uint8_t>(LatencyStage::COUNT);
+
+    struct StageHist {
+        uint32_t count = 0;
+        uint64_t sumUs = 0;
+        uint32_t maxUs = 0;
+        uint32_t bins[LATENCY_BINS] = {};
+    };
+
+    bool          open_    = false;
+    uint32_t      startUs_ = 0;
+    uint8_t       marked_  = 0;            ///< Bit per stage
+    uint8_t       samples_ = 0;            ///< Since the event opened, up to the filter window
+    bool          seenActive_   = false;   ///< Any sensor filtered ACTIVE since init()
+    uint32_t      lastActiveUs_ = 0;
+    uint32_t      atUs_[STAGES] = {};      ///< Since startUs_
+
+    uint32_t  events_    = 0;
+    uint32_t  abandoned_ = 0;
+    StageHist hist_[STAGES];
+
+    /** @brief Fold the stamped stages into the histograms. */
+    void close();
+
+    /** @brief Stage already stamped in the open event. */
+    bool stamped(LatencyStage stage) const {
+        return marked_ & (1u << static_cast<uint8_t>(stage));
+    }
+};
+
+#endif // LATENCY_TRACKER_H
@@ -0,0 +1,109 @@
+/**
+ * @file loop_timer.h
+ * @brief Drift-free fixed-rate control tick with jitter statistics.
+ *
+ * Deadlines are absolute: tick n is due at start + n × period, whatever
+ * the previous tick cost, so the period never drifts.  The clock is
+ * micros(); on target an esp_timer wakes the loop at each deadline (see
+ * main.cpp), on host the test controls micros() directly.
+ *
+ *   - Jitter: how late a tick starts after its deadline (µs).  Online
+ *     min / max / mean and a p99 from a JITTER_BIN_US histogram.
+ *   - Overrun: a tick still running at the next deadline (tickDone()).
+ *   - Skipped: a deadline with no tick at all, because the loop got
+ *     there a whole period or more late.  Missed deadlines are dropped
+ *     (not run back to back); the serving tick's jitter is measured
+ *     against its own slot, and ticksElapsed() tells dead reckoning how
+ *     many periods passed.
+ *   - Idle: deadlines the loop chose to pass over (idle()) are neither
+ *     skipped nor jitter; ticksElapsed() includes them, and
+ *     idleElapsed() says how many of its periods they were.
+ */
+
+#ifndef LOOP_TIMER_H
+#define LOOP_TIMER_H
+
+#include <stdint.h>
+#include "config.h"
+
+/** @brief Snapshot of the tick-timing figures. */
+struct JitterStats {
+    uint32_t ticks    = 0;   ///< Ticks served
+    uint32_t overruns = 0;   ///< Ticks still running at the next deadline
+    uint32_t skipped  = 0;   ///< Deadlines with no tick
+    uint32_t maxCostUs = 0;  ///< Longest tick (poll() → tickDone())
+    uint32_t minUs    = 0;
+    uint32_t maxUs    = 0;
+    uint32_t meanUs   = 0;
+    uint32_t p99Us    = 0;   ///< Upper edge of the p99 histogram bin
+};
+
+class LoopTimer {
+public:
+    /**
+     * @brief Start the tick grid; the first tick is due @p phaseUs from now.
+     *
+     * Two timers initialised back to back with different phases keep a
+     * fixed offset (e.g. capture ahead of control).
+     */
+    void init(uint32_t periodUs = LOOP_PERIOD_US, uint32_t phaseUs = 0);
+
+    /**
+     * @brief Claim the current tick if its deadline has passed.
+     *
+     * Records the jitter (and any overrun) and advances to the next
+     * deadline.  Call from the main loop; run the control tick when it
+     * returns true.
+     */
+    bool poll();
+
+    /** @brief Mark the end of the tick claimed by poll() (cost, overrun). */
+    void tickDone();
+
+    /**
+     * @brief Let the next @p periods deadlines pass without a tick.
+     *
+     * Call after tickDone(), when the loop has nothing to do for a
+     * while.  The grid is kept; the next tick's ticksElapsed() covers the
+     * idle periods, which do not count as skipped.
+     */
+    void idle(uint32_t periods);
+
+    /** @brief Microseconds until the next deadline (0 if due). */
+    uint32_t usUntilDue() const;
+
+    /** @brief Periods covered by the last tick (1, or more after an overrun). */
+    uint32_t ticksElapsed() const;
+
+    /** @brief Of ticksElapsed(), the periods passed over by idle(). */
+    uint32_t idleElapsed() const;
+
+    /** @brief Jitter of the last tick (µs). */
+    uint32_t lastJitterUs() const;
+
+    /** @brief Current figures. */
+    JitterStats stats() const;
+
+    /** @brief Clear the figures (the tick grid is kept). */
+    void resetStats();
+
+private:
+    uint32_t periodUs_     = LOOP_PERIOD_US;
+    uint32_t nextUs_       = 0;     ///< Absolute deadline of the next tick
+    uint32_t ticksElapsed_ = 1;
+    uint32_t idlePeriods_  = 0;     ///< Passed over by idle() since the last tick
+    uint32_t idleElapsed_  = 0;
+    uint32_t lastJitterUs_ = 0;
+    uint32_t tickStartUs_  = 0;
+
+    uint32_t ticks_    = 0;
+    uint32_t overruns_ = 0;
+    uint32_t skipped_  = 0;
+    uint32_t minUs_    = 0;
+    uint32_t maxUs_    = 0;
+    uint32_t maxCostUs_ = 0;
+    uint64_t sumUs_    = 0;
+    uint32_t hist_[JITTER_BINS] = {};
+};
+
+#endif // LOOP_TIMER_H
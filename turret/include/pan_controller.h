@@ -7,12 +7,15 @@
  *   - Dead-reckoning position tracking (integrates speed × time)
  *   - Software rotation limits (±PAN_LIMIT_DEG) to protect cables (Issue #4)
  *   - Minimum speed threshold to overcome gear backlash (Issue #5)
+ *   - Decelerating park-to-home profile
+ *   - Cached, frame-aligned output (ServoOutput) — repeated commands of
+ *     the same speed never reach the LEDC layer
  */
 
 #ifndef PAN_CONTROLLER_H
 #define PAN_CONTROLLER_H
 
-#include <ESP32Servo.h>
+#include "servo_output.h"
 #include <stdint.h>
 
 class PanController {
@@ -47,27 +50,69 @@ public:
     /** @brief Return estimated angular position (degrees, 0 = home). */
     float getPositionDeg() const;
 
+    /** @brief Last commanded normalised speed (after limits / dead zone). */
+    float getSpeed() const;
+
     /** @brief True if within software limits. */
     bool isWithinLimits() const;
 
     /**
-     * @brief Drive to estimated home (0°) by reversing until position ≈ 0.
+     * @brief Drive to estimated home (0°) with a decelerating profile.
+     *
+     * Runs at PARK_PAN_SPEED_MAX until within PARK_DECEL_DEG of home, then
+     * slows in proportion to the remaining distance (see parkSpeedFor()).
      *
-     * Non-blocking: call repeatedly from the main loop.
-     * @return true when position is within 5° of home.
+     * Non-blocking: call repeatedly from the main loop.  Stopping the calls
+     * (e.g. the beacon reappears) leaves the position estimate intact.
+     * @return true when position is within PARK_HOME_TOLERANCE_DEG of home.
      */
     bool parkHome();
 
+    /**
+     * @brief Park speed magnitude for a given distance from home.
+     *
+     * @param distDeg  Absolute distance from home, in degrees.
+     * @return Normalised speed in [PAN_MIN_SPEED, PARK_PAN_SPEED_MAX].
+     */
+    static float parkSpeedFor(float distDeg);
+
     /** @brief Reset the estimated position to 0 (re-zero). */
     void resetPosition();
 
+    /** @brief Flush a frame-deferred write.  Call once per loop iteration. */
+    void serviceOutput();
+
+    /**
+     * @brief Stop the servo PWM (no holding current, no idle jitter).
+     *
+     * Commands issued while powered down are latched until wake().
+     */
+    void powerDown();
+
+    /**
+     * @brief Re-attach the servo, restoring the stop pulse width.
+     *
+     * The dead-reckoning estimate is untouched: a limp continuous servo
+     * does not rotate on its own.
+     */
+    void wake();
+
+    /** @brief True while the servo PWM is stopped. */
+    bool isPoweredDown() const;
+
+    /** @brief Output-stage statistics (writes/s, suppressed writes). */
+    const ServoOutput &output() const;
+
 private:
-    Servo servo_;
+    ServoOutput out_;
     float currentSpeed_  = 0.0f;   ///< Last commanded normalised speed
     float positionDeg_   = 0.0f;   ///< Estimated absolute angle from home
 
     /** @brief Convert normalised speed to servo microseconds. */
     uint16_t speedToMicroseconds(float speed) const;
+
+    /** @brief The inverse: normalised speed a pulse width turns the servo at. */
+    static float microsecondsToSpeed(uint16_t us);
 };
 
 #endif // PAN_CONTROLLER_H
@@ -0,0 +1,82 @@
+/**
+ * @file park_planner.h
+ * @brief Coordinated, cancellable pan/tilt park-to-home sequence.
+ *
+ * Drives both axes home when the signal monitor enters PARKED:
+ *
+ * Pan:
+ *   - PanController::parkHome() runs fast far from home and decelerates
+ *     proportionally inside PARK_DECEL_DEG, stopping within
+ *     PARK_HOME_TOLERANCE_DEG.
+ *
+ * Tilt:
+ *   - Follows the pan's progress: the tilt target is interpolated from
+ *     its starting angle to TILT_HOME_DEG by the fraction of pan distance
+ *     already covered, so both axes arrive together instead of the head
+ *     snapping down at the start of the park.
+ *   - Rate limited to PARK_TILT_STEP_DEG per update.
+ *
+ * Power-down:
+ *   - isSettled() turns true PARK_SETTLE_MS after completion; the main
+ *     loop then powers both servos down until the next detection.
+ *
+ * Cancellation:
+ *   - cancel() abandons the sequence immediately.  The pan position
+ *     estimate is left untouched so tracking can resume from wherever the
+ *     turret actually is.  A completed park does not re-zero it either:
+ *     the fan stopped within PARK_HOME_TOLERANCE_DEG of home, at the
+ *     estimate, not at 0°.
+ */
+
+#ifndef PARK_PLANNER_H
+#define PARK_PLANNER_H
+
+#include "pan_controller.h"
+#include "tilt_controller.h"
+
+class ParkPlanner {
+public:
+    /**
+     * @brief Store references to the controller objects.
+     *
+     * Call once after PanController::init() and TiltController::init().
+     */
+    void init(PanController *pan, TiltController *tilt);
+
+    /** @brief Latch the current pose and start a new park sequence. */
+    void begin();
+
+    /**
+     * @brief Advance the park sequence by one loop iteration.
+     *
+     * @return true once both axes are home (and on every call after).
+     */
+    bool update();
+
+    /** @brief Abandon the sequence and stop the pan.  Keeps the estimate. */
+    void cancel();
+
+    /** @brief True while a park sequence is in progress. */
+    bool isActive() const;
+
+    /** @brief True if the most recent sequence reached home. */
+    bool isComplete() const;
+
+    /** @brief True once complete for at least PARK_SETTLE_MS. */
+    bool isSettled() const;
+
+private:
+    PanController  *pan_  = nullptr;
+    TiltController *tilt_ = nullptr;
+
+    float   startPanDist_  = 0.0f;   ///< |pan position| when begin() was called
+    int16_t startTiltDeg_  = 0;      ///< Tilt angle when begin() was called
+    bool    active_        = false;
+    bool    complete_      = false;
+    uint32_t completeMs_   = 0;    ///< millis() when the park completed
+
+    /** @brief Tilt angle that keeps pace with the pan's remaining distance. */
+    int16_t tiltTargetFor(float panDist) const;
+};
+
+#endif // PARK_PLANNER_H
@@ -0,0 +1,217 @@
+/**
+ * @file pipeline.h
+ * @brief Capture → control → telemetry task pipeline.
+ *
+ *   capture   (CAPTURE_TASK_CORE, high priority, LOOP_PERIOD_US grid)
+ *       SensorArray::update(), then a timestamped SensorSnapshot into
+ *       the snapshot ring.
+ *
+ *   control   (CONTROL_TASK_CORE, LOOP_PERIOD_US grid, CAPTURE_LEAD_US
+ *              behind capture; every PARK_IDLE_TICKS periods while parked
+ *              with the servos off and no raw hit)
+ *       Every waiting snapshot → SignalMonitor evidence + state machine
+ *       (one sensor sample each, so none is lost if a tick is late),
+ *       with each stage's response to a returning beacon timed
+ *       (latency_tracker.h);
+ *       dead reckoning, servo output stages, status LED, scheduled jobs;
+ *       then one TelemetryFrame into the telemetry ring (and the flight
+ *       recorder).  Commands from
+ *       the command ring are handled here, so every module keeps a
+ *       single owner.
+ *
+ *   telemetry (TELEMETRY_TASK_CORE, low priority, TELEMETRY_POLL_MS)
+ *       Drains frames into the sink (serial output) and forwards
+ *       commands from the source (serial input).
+ *
+ * Nothing blocks on another task: a full ring drops (and counts) the
+ * newest item.  However slow the serial port, the control tick keeps
+ * its timing.
+ *
+ * The step functions are what each task body runs per iteration, and
+ * can be called directly for single-threaded tests.
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+#include <atomic>
+#include "config.h"
+#include "sensor_array.h"
+#include "turret_fsm.h"
+#include "scheduler.h"
+#include "loop_timer.h"
+#include "spsc_ring.h"
+#include "rtos_task.h"
+#include "telemetry_stream.h"
+#include "session_capture.h"
+#include "flight_recorder.h"
+#include "latency_tracker.h"
+
+/** @brief One capture tick, as handed to the control task. */
+struct SensorSnapshot {
+    uint32_t      seq       = 0;    ///< Capture tick number
+    uint32_t      tUs       = 0;    ///< micros() when sampled
+    uint32_t      jitterUs  = 0;    ///< Capture tick lateness
+    uint8_t       rawHits   = 0;    ///< SensorArray::getRawHits()
+    uint8_t       rawBits   = 0;    ///< SensorArray::getRawBits()
+    uint8_t       levelBits = 0;    ///< SensorArray::getLevelBits()
+    SensorReading filtered  = {};
+};
+
+/** @brief Control → telemetry record. */
+struct TelemetryFrame {
+    enum class Kind : uint8_t {
+        TICK,     ///< One per control tick
+        TIMING,   ///< Answer to the 'j' command
+        PROFILE,  ///< Answer to the 'p' command (read Profiler on receipt)
+        LATENCY   ///< Answer to the 'l' command
+    };
+
+    Kind          kind       = Kind::TICK;
+    uint32_t      tUs        = 0;            ///< Control tick start
+    uint32_t      seq        = 0;            ///< Newest snapshot used
+    uint32_t      ageUs      = 0;            ///< Snapshot age at the tick
+    TurretState   state      = TurretState::COUNT;
+    bool          transition = false;        ///< State changed this tick
+    float         panDeg     = 0.0f;
+    int16_t       tiltDeg    = 0;
+    SensorReading reading    = {};
+    uint8_t       rawBits    = 0;            ///< Raw sample behind reading
+    float         panCmd     = 0.0f;         ///< Commanded pan speed
+    uint32_t      loopUs     = 0;            ///< Tick cost up to this frame
+    uint16_t      panWritesPerSec  = 0;
+    uint16_t      tiltWritesPerSec = 0;
+
+    // TICK inputs, for session capture.
+    uint16_t      dtMs        = 0;           ///< Dead-reckoning period
+    uint8_t       samples     = 0;           ///< Snapshots consumed, up to MAX_SAMPLES ...
+    bool          samplesLost = false;       ///< ... or more
+    CaptureSample sample[CaptureTick::MAX_SAMPLES];   ///< Oldest first
+
+    // TIMING only.
+    JitterStats   control;                   ///< Control tick timing
+    uint32_t      maxAgeUs         = 0;      ///< Worst snapshot age
+    uint32_t      maxCaptureJitUs  = 0;      ///< Worst capture lateness
+    uint32_t      snapshotDrops    = 0;
+    uint32_t      frameDrops       = 0;
+    uint32_t      starvedTicks     = 0;      ///< Control ticks with no snapshot
+
+    // LATENCY only.
+    LatencyStats  latency;
+
+    /** @brief TICK fields as the binary wire record (telemetry_stream.h). */
+    TelemetryRecord record() const;
+
+    /** @brief record() with the tick's inputs (session_capture.h). */
+    CaptureTick capture() const;
+};
+
+class TurretPipeline {
+public:
+    /** @brief Receives every frame, on the telemetry task. */
+    typedef void (*FrameSink)(const TelemetryFrame &frame, void *ctx);
+
+    /** @brief Returns the next command byte, or −1; telemetry task. */
+    typedef int (*CommandSource)(void *ctx);
+
+    /** @brief Called on the control task (e.g. watchdog subscribe / feed). */
+    typedef void (*ControlHook)();
+
+    /**
+     * @brief Wire the modules.  Each one is then used by one task only:
+     *        sensors by capture, everything else by control.
+     */
+    void init(const TurretContext &ctx, TurretStateMachine *fsm, Scheduler *sched);
+
+    /** @brief Serial side; either may be nullptr. */
+    void setTelemetry(FrameSink sink, CommandSource source, void *ctx);
+
+    /** @brief Run @p onStart once on the control task, @p onTick every tick. */
+    void setControlHooks(ControlHook onStart, ControlHook onTick);
+
+    /** @brief Record every TICK frame into @p recorder (control task); may be nullptr. */
+    void setRecorder(FlightRecorder *recorder);
+
+    /** @brief Start both tick grids (capture now, control CAPTURE_LEAD_US later). */
+    void begin();
+
+    /** @brief begin() and spawn the three tasks. */
+    bool start();
+
+    /** @brief Host: stop the tasks and wait for them.  Target: never used. */
+    void stop();
+
+    /** @brief Capture task iteration.  @return true if a tick ran. */
+    bool captureStep();
+
+    /** @brief Control task iteration.  @return true if a tick ran. */
+    bool controlStep();
+
+    /** @brief Telemetry task iteration.  @return frames delivered. */
+    uint16_t telemetryStep();
+
+    /** @brief Push a command as if it came from the source. */
+    bool sendCommand(char c);
+
+    /** @brief Control timing (read on the control task, or after stop()). */
+    JitterStats controlStats() const;
+
+    /** @brief Frames dropped because the telemetry ring was full. */
+    uint32_t frameDrops() const;
+
+    /** @brief Snapshots dropped because the snapshot ring was full. */
+    uint32_t snapshotDrops() const;
+
+    /** @brief Detection latency (read on the control task, or after stop()). */
+    LatencyStats latencyStats() const;
+
+private:
+    TurretContext       ctx_;
+    TurretStateMachine *fsm_   = nullptr;
+    Scheduler          *sched_ = nullptr;
+
+    FrameSink     sink_    = nullptr;
+    CommandSource source_  = nullptr;
+    void         *ioCtx_   = nullptr;
+    ControlHook   onStart_ = nullptr;
+    ControlHook   onTick_  = nullptr;
+    FlightRecorder *recorder_ = nullptr;
+
+    SpscRing<SensorSnapshot, SNAPSHOT_RING_SIZE>  snapshots_;
+    SpscRing<TelemetryFrame, TELEMETRY_RING_SIZE> frames_;
+    SpscRing<char, COMMAND_RING_SIZE>             commands_;
+
+    // Capture task.
+    LoopTimer captureTimer_;
+    uint32_t  captureSeq_ = 0;
+
+    // Control task.
+    LoopTimer      controlTimer_;
+    SensorSnapshot latest_;
+    uint32_t       maxAgeUs_        = 0;
+    uint32_t       maxCaptureJitUs_ = 0;
+    uint32_t       starved_         = 0;
+    LatencyTracker latency_;
+    uint32_t       panCommits_      = 0;   ///< Pan commits already seen by latency_
+
+    std::atomic<bool> running_{false};
+    RtosTask captureTask_;
+    RtosTask controlTask_;
+    RtosTask telemetryTask_;
+
+    /** @brief One snapshot's worth of evidence and state machine. */
+    bool consume(const SensorSnapshot &snap);
+
+    /** @brief Stamp SERVO if the pan committed a write since the last look. */
+    void notePanCommit();
+
+    /** @brief Handle a command byte on the control task. */
+    void handleCommand(char c);
+
+    static void captureBody(RtosTask &task, void *self);
+    static void controlBody(RtosTask &task, void *self);
+    static void telemetryBody(RtosTask &task, void *self);
+};
+
+#endif // PIPELINE_H
@@ -0,0 +1,110 @@
+/**
+ * @file profiler.h
+ * @brief Per-stage timing with log2 histograms in static memory.
+ *
+ * Wrap a stage in a ProfScope:
+ *
+ *     { ProfScope p(ProfStage::MONITOR); monitor.updateEvidence(hits); }
+ *
+ * Clock: the CPU cycle counter on target (ESP.getCycleCount()), a
+ * steady clock in ns on host.  Each stage keeps a count, a running total,
+ * the maximum and a PROF_BUCKETS log2 histogram, from which summary()
+ * derives p50 / p99.  With PROFILING_ENABLED false a ProfScope is empty
+ * and the compiler removes it.
+ *
+ * Each stage is recorded by one task only; counters are relaxed atomics
+ * so another task can read them while it runs.  A report taken mid-run
+ * can be off by the sample in flight.  reset() does not touch the
+ * counters: it posts a request that each stage's recording task carries
+ * out before its next sample, so the stage keeps a single writer.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include "config.h"
+
+/** @brief Profiled stages.  Nested stages also count in their parent. */
+enum class ProfStage : uint8_t {
+    SENSORS,        ///< Capture: SensorArray::update() + snapshot
+    CONTROL_TICK,   ///< Whole control tick (parent of the next five)
+    MONITOR,        ///< SignalMonitor::updateEvidence()
+    FSM,            ///< TurretStateMachine::update() (parent of TRACKER)
+    TRACKER,        ///< TrackingEngine::update()
+    POSITION,       ///< PanController::updatePosition()
+    SERVO_OUTPUT,   ///< ServoOutput flushes
+    SCHEDULER,      ///< Scheduler::runDue()
+    TELEMETRY,      ///< Telemetry sink (serial output)
+    COUNT
+};
+
+/** @brief One stage's figures, in microseconds. */
+struct ProfSummary {
+    uint32_t count  = 0;
+    float    meanUs = 0.0f;
+    float    p50Us  = 0.0f;   ///< Upper edge of the median's bucket
+    float    p99Us  = 0.0f;   ///< Upper edge of the p99 bucket
+    float    maxUs  = 0.0f;
+};
+
+class Profiler {
+public:
+    /** @brief Current clock value (cycles on target, ns on host). */
+    static uint32_t now();
+
+    /** @brief Clock ticks per microsecond. */
+    static float ticksPerUs();
+
+    /** @brief Add one sample of @p ticks to @p stage. */
+    static void record(ProfStage stage, uint32_t ticks);
+
+    /** @brief Figures for @p stage. */
+    static ProfSummary summary(ProfStage stage);
+
+    /** @brief Samples in bucket @p bucket of @p stage. */
+    static uint32_t bucketCount(ProfStage stage, uint8_t bucket);
+
+    /** @brief Log2 bucket for a duration of @p ticks. */
+    static uint8_t bucketFor(uint32_t ticks);
+
+    /** @brief Short name of @p stage for reports. */
+    static const char *stageName(ProfStage stage);
+
+    /**
+     * @brief Clear every stage (from one task at a time).
+     *
+     * Stages read as empty at once; each is actually cleared by its own
+     * recording task on its next sample.
+     */
+    static void reset();
+
+#ifdef SENTRY_SIM
+    /** @brief Host simulator: receives every sample as it is recorded. */
+    typedef void (*Observer)(ProfStage stage, uint32_t startTicks, uint32_t ticks, void *ctx);
+
+    /** @brief Hand every sample to @p fn as well (trace export); nullptr stops. */
+    static void setObserver(Observer fn, void *ctx);
+#endif
+};
+
+/** @brief Times its own lifetime into a stage (nothing when disabled). */
+class ProfScope {
+public:
+    explicit ProfScope(ProfStage stage) : stage_(stage) {
+        if constexpr (PROFILING_ENABLED) start_ = Profiler::now();
+    }
+
+    ~ProfScope() {
+        if constexpr (PROFILING_ENABLED) Profiler::record(stage_, Profiler::now() - start_);
+    }
+
+    ProfScope(const ProfScope &) = delete;
+    ProfScope &operator=(const ProfScope &) = delete;
+
+private:
+    ProfStage stage_;
+    uint32_t  start_ = 0;
+};
+
+#endif // PROFILER_H
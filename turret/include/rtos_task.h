@@ -0,0 +1,64 @@
+/**
+ * @file rtos_task.h
+ * @brief Minimal task abstraction: FreeRTOS on target, std::thread on host.
+ *
+ * Target: xTaskCreatePinnedToCore() with the given priority and core,
+ * and a one-shot esp_timer per task so waitUs() blocks with microsecond
+ * resolution (the FreeRTOS tick is 1 ms).  Tasks never return.
+ *
+ * Host (UNIT_TEST, SENTRY_SIM): a std::thread; priority and core are
+ * ignored and waitUs() sleeps.  The body should return once its stop
+ * flag is set so join() can complete.
+ */
+
+#ifndef RTOS_TASK_H
+#define RTOS_TASK_H
+
+#include <stdint.h>
+
+#if defined(UNIT_TEST) || defined(SENTRY_SIM)
+#include <thread>
+#endif
+
+class RtosTask {
+public:
+    /** @brief Task entry point; @p arg is the pointer given to start(). */
+    typedef void (*Body)(RtosTask &self, void *arg);
+
+    /** @brief Where and how a task runs. */
+    struct Config {
+        const char *name       = "task";
+        uint8_t     priority   = 1;      ///< FreeRTOS priority (higher wins)
+        int8_t      core       = -1;     ///< 0 / 1, or -1 for no affinity
+        uint32_t    stackBytes = 4096;
+    };
+
+    /** @brief Spawn the task running body(*this, arg).  @return false on failure. */
+    bool start(const Config &cfg, Body body, void *arg);
+
+    /**
+     * @brief Block the calling task for @p us microseconds.
+     *
+     * Call only from this task's own body.
+     */
+    void waitUs(uint32_t us);
+
+    /** @brief Host: wait for the body to return.  Target: no-op. */
+    void join();
+
+private:
+    Body  body_ = nullptr;
+    void *arg_  = nullptr;
+
+#if defined(UNIT_TEST) || defined(SENTRY_SIM)
+    std::thread thread_;
+#else
+    void *handle_ = nullptr;   ///< TaskHandle_t
+    void *timer_  = nullptr;   ///< esp_timer_handle_t (wake-up alarm)
+
+    static void trampoline(void *self);
+    static void onTimer(void *self);
+#endif
+};
+
+#endif // RTOS_TASK_H
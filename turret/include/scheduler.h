@@ -0,0 +1,123 @@
+/**
+ * @file scheduler.h
+ * @brief Fixed-capacity deadline scheduler (binary min-heap, no allocation).
+ *
+ * Modules register one-shot or periodic deadlines; the main loop calls
+ * runDue() and then sleeps for msUntilNext().  Nothing polls millis()
+ * between deadlines, and both calls only look at the heap root.
+ *
+ *   - Capacity: SCHED_MAX_JOBS.  schedule calls return INVALID_JOB when
+ *     full.
+ *   - Periodic jobs are re-armed from their previous deadline (not from
+ *     the time they ran), so a late run does not shift later ones.
+ *   - Equal deadlines run in job-slot order (lowest first), so jobs
+ *     registered earlier (e.g. the control tick) run first.
+ *   - Job ids carry a generation, so cancelling a stale id (a one-shot
+ *     that already fired, its slot since reused) is a harmless no-op.
+ *   - Comparisons are millis()-wrap safe for deadlines < 24 days ahead.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include "config.h"
+
+class Scheduler {
+public:
+    /** @brief Job callback; @p ctx is the pointer given at registration. */
+    typedef void (*Callback)(void *ctx);
+
+    /** @brief Opaque job handle (slot + generation). */
+    typedef int16_t JobId;
+
+    static constexpr JobId INVALID_JOB = -1;
+
+    /** @brief Drop all jobs. */
+    void init();
+
+    /**
+     * @brief Run @p cb every @p periodMs, first after @p firstInMs.
+     *
+     * @return Job id, or INVALID_JOB if full or periodMs is 0.
+     */
+    JobId every(uint32_t periodMs, Callback cb, void *ctx = nullptr,
+                uint32_t firstInMs = 0);
+
+    /** @brief Run @p cb once, @p delayMs from now. */
+    JobId after(uint32_t delayMs, Callback cb, void *ctx = nullptr);
+
+    /**
+     * @brief Run @p cb at absolute millis() @p deadlineMs, then every
+     *        @p periodMs if non-zero.
+     */
+    JobId at(uint32_t deadlineMs, Callback cb, void *ctx = nullptr,
+             uint32_t periodMs = 0);
+
+    /** @brief Cancel a job.  @return true if it was pending. */
+    bool cancel(JobId id);
+
+    /** @brief True if @p id is still scheduled. */
+    bool isPending(JobId id) const;
+
+    /**
+     * @brief Run every job whose deadline has passed.
+     *
+     * Each job runs at most once per call; a periodic job still behind
+     * after its run waits for the next call without holding up the rest.
+     * Callbacks may schedule or cancel jobs (including themselves).
+     *
+     * @return Number of callbacks run.
+     */
+    uint8_t runDue();
+
+    /** @brief Milliseconds until the earliest deadline (0 if overdue). */
+    uint32_t msUntilNext() const;
+
+    /** @brief Number of scheduled jobs. */
+    uint8_t pending() const;
+
+    /** @brief Total callbacks run since init(). */
+    uint32_t firedCount() const;
+
+    /** @brief runDue() calls that ran at least one callback (wakeups). */
+    uint32_t wakeCount() const;
+
+private:
+    struct Job {
+        uint32_t      deadline = 0;
+        uint32_t      period   = 0;   ///< 0 = one-shot
+        Callback      cb       = nullptr;
+        void         *ctx      = nullptr;
+        uint8_t       gen      = 0;   ///< Bumped on every (re)use of the slot
+        bool          active   = false;
+        bool          lagging  = false;   ///< Ran this pass, still due: out of the heap
+    };
+
+    Job     jobs_[SCHED_MAX_JOBS];
+    uint8_t heap_[SCHED_MAX_JOBS];      ///< Slot indices, min-heap by deadline
+    uint8_t heapPos_[SCHED_MAX_JOBS];   ///< Slot → index in heap_
+    uint8_t size_ = 0;
+    uint8_t lagging_[SCHED_MAX_JOBS];   ///< Slots set aside by this runDue() pass
+    uint8_t laggingCount_ = 0;
+
+    uint32_t fired_ = 0;
+    uint32_t wakes_ = 0;
+
+    /** @brief Heap order: earlier deadline first, then lower slot. */
+    bool earlier(uint8_t a, uint8_t b) const;
+
+    void siftUp(uint8_t i);
+    void siftDown(uint8_t i);
+    void heapSwap(uint8_t i, uint8_t j);
+    void heapInsert(uint8_t slot);
+    void heapRemove(uint8_t i);
+
+    /** @brief Slot for @p id if it names a live job, else SCHED_MAX_JOBS. */
+    uint8_t slotOf(JobId id) const;
+
+    /** @brief Wrap-safe: has @p deadline been reached at @p now? */
+    static bool reached(uint32_t deadline, uint32_t now);
+};
+
+#endif // SCHEDULER_H
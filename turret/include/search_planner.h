@@ -0,0 +1,135 @@
+/**
+ * @file search_planner.h
+ * @brief SEARCHING-state pan/tilt pattern: learned bearings, then an
+ *        exhaustive, detection-limited pattern.
+ *
+ * On entry (begin()) the planner builds a short waypoint list:
+ *   1. The last-known bearing (where the beacon was lost).
+ *   2. Up to SEARCH_MAX_WAYPOINTS − 1 of the heaviest BearingPrior bins,
+ *      skipping any that overlap a waypoint already listed.
+ *
+ * Each waypoint is visited as two legs:
+ *   - TRANSIT: move to the near edge of the waypoint's bin at
+ *     SEARCH_TRANSIT_SPEED.
+ *   - SCAN:    cross the bin to its far edge at SEARCH_SWEEP_SPEED.
+ *
+ * With a hold time (SignalMonitor::getHoldMs()) the last-known bearing's
+ * bin is crossed back and forth (HOLD) until that time has passed since
+ * begin(): short, frequent absences usually end where they started.
+ *
+ * When the list is exhausted the planner runs the selected SearchPattern
+ * (see config.h) until the beacon is found, carrying on the way the last
+ * scan leg went:
+ *
+ *   SWEEP     — classic ±SEARCH_SWEEP_DEG pan sweep, tilt at the learned
+ *               elevation of the current bin (TILT_SCAN_DEG where nothing
+ *               has been learned).
+ *   RASTER    — SEARCH_RASTER_ROWS passes across the full pan range, one
+ *               per tilt row; the pan waits at each end while the tilt
+ *               steps to the next row, so every row pass is a complete,
+ *               detection-limited sweep of the pan/tilt envelope.
+ *   LISSAJOUS — pan and tilt follow sinusoids whose peak rates equal the
+ *               detection limits (SEARCH_MAX_*_DEG_PER_SEC), with tilt at
+ *               SEARCH_LISSAJOUS_RATIO × the pan frequency.  No stops,
+ *               but coverage of any one point is only statistical.
+ *
+ * Pan rates never exceed SEARCH_MAX_PAN_DEG_PER_SEC on detection legs;
+ * tilt moves at most TILT_STEP_DEG per update.
+ */
+
+#ifndef SEARCH_PLANNER_H
+#define SEARCH_PLANNER_H
+
+#include "bearing_prior.h"
+#include "pan_controller.h"
+#include "tilt_controller.h"
+
+class SearchPlanner {
+public:
+    /** @brief Search phase (exposed for diagnostics and tests). */
+    enum class Phase : uint8_t {
+        TRANSIT,   ///< Moving to the next learned bearing
+        SCAN,      ///< Crossing a learned bin at sweep speed
+        HOLD,      ///< Re-crossing the exit bearing's bin until the hold ends
+        PATTERN    ///< Exhaustive SearchPattern
+    };
+
+    /**
+     * @brief Store references to the controllers and the prior.
+     *
+     * Call once after PanController::init() and TiltController::init().
+     */
+    void init(PanController *pan, TiltController *tilt, const BearingPrior *prior);
+
+    /** @brief Select the exhaustive pattern.  Takes effect at begin(). */
+    void setPattern(SearchPattern pattern);
+
+    /** @brief Currently selected exhaustive pattern. */
+    SearchPattern getPattern() const;
+
+    /**
+     * @brief Plan a new search, starting from the last-known bearing.
+     *
+     * @param lastBearingDeg  Pan bearing at which the beacon was lost.
+     * @param holdMs          Time to keep scanning the last-known bearing
+     *                        before moving on (0 = one crossing).
+     */
+    void begin(float lastBearingDeg, uint32_t holdMs = 0);
+
+    /** @brief Run one search iteration.  Call once per loop in SEARCHING. */
+    void update();
+
+    /** @brief Current phase. */
+    Phase getPhase() const;
+
+    /** @brief Number of planned waypoints (including the last-known bearing). */
+    uint8_t waypointCount() const;
+
+private:
+    PanController      *pan_   = nullptr;
+    TiltController     *tilt_  = nullptr;
+    const BearingPrior *prior_ = nullptr;
+    SearchPattern pattern_     = SEARCH_PATTERN;
+
+    float   waypointDeg_[SEARCH_MAX_WAYPOINTS] = {};
+    uint8_t waypointCount_ = 0;
+    uint8_t nextWaypoint_  = 0;
+
+    Phase phase_       = Phase::PATTERN;
+    float legTargetDeg_ = 0.0f;   ///< End of the current TRANSIT / SCAN leg
+    float scanEndDeg_   = 0.0f;   ///< Far edge for the SCAN leg that follows
+    float focusDeg_     = 0.0f;   ///< Bearing whose elevation the tilt tracks
+    float scanStartDeg_ = 0.0f;   ///< Near edge of the current SCAN / HOLD leg
+
+    uint32_t holdStartMs_ = 0;   ///< millis() at begin()
+    uint32_t holdMs_      = 0;   ///< Exit-bearing hold time
+
+    // Pattern state.
+    bool     sweepCW_      = true;   ///< SWEEP / RASTER pan direction
+    uint8_t  rasterRow_    = 0;      ///< RASTER row index
+    int8_t   rasterRowDir_ = 1;      ///< RASTER row step (+1 / −1, ping-pong)
+    bool     rasterTurning_ = false; ///< RASTER: pan holding while tilt changes row
+    uint32_t patternTicks_ = 0;      ///< LISSAJOUS time base (loop ticks)
+    float    lissajousPhase_ = 0.0f; ///< LISSAJOUS pan phase offset (rad)
+
+    /** @brief Set up the legs for the next waypoint, or start the pattern. */
+    void startNextWaypoint();
+
+    /** @brief Initialise the selected pattern from the current pose. */
+    void startPattern();
+
+    void updateSweep();
+    void updateRaster();
+    void updateLissajous();
+
+    /** @brief Tilt angle of RASTER row @p row. */
+    static int16_t rasterRowDeg(uint8_t row);
+
+    /** @brief Drive the pan toward @p targetDeg; true once within tolerance. */
+    bool driveToward(float targetDeg, float speed);
+
+    /** @brief Clamp a bearing to the reachable pan range. */
+    static float clampBearing(float deg);
+};
+
+#endif // SEARCH_PLANNER_H
@@ -7,7 +7,10 @@
  * IR signal is detected, and HIGH when idle.
  *
  * This module provides:
- *   - Raw per-sensor reads
+ *   - Raw per-sensor samples: LOW at any time since the previous tick
+ *     (Hal::takeLowLatch()), not the level at the instant of the read.
+ *     The beacon's bursts cover ~2.4 % of its cycle; a tick-rate read
+ *     would see almost none of them.
  *   - A rolling majority-vote filter to reject brief reflections (Issue #6)
  *   - Saturation detection (stuck-LOW guard)
  *   - A combined Direction enum for the tracking engine
@@ -17,6 +20,8 @@
 #define SENSOR_ARRAY_H
 
 #include <stdint.h>
+#include <atomic>
+#include "config.h"
 
 // ---------------------------------------------------------------------------
 // Types
@@ -67,7 +72,7 @@ enum class Direction : uint8_t {
 
 class SensorArray {
 public:
-    /** @brief Configure sensor pins as INPUT_PULLUP. */
+    /** @brief Configure sensor pins as INPUT_PULLUP and arm their LOW latches. */
     void init();
 
     /**
@@ -81,10 +86,11 @@ public:
     /**
      * @brief Return the majority-vote-filtered reading.
      *
-     * A sensor is ACTIVE only if ≥ SENSOR_FILTER_THRESHOLD of the last
-     * SENSOR_FILTER_WINDOW samples were LOW.
+     * A sensor is ACTIVE only if ≥ the filter threshold (default
+     * SENSOR_FILTER_THRESHOLD) of the last SENSOR_FILTER_WINDOW samples
+     * were LOW.
      *
-     * A sensor is SATURATED if it has been continuously LOW for
+     * A sensor is SATURATED if it has read LOW at every tick for
      * SENSOR_SATURATED_MS — it is then reported as INACTIVE to prevent
      * the tracker from locking onto ambient IR.
      */
@@ -99,6 +105,42 @@ public:
      */
     Direction getDirection() const;
 
+    /**
+     * @brief Sensors LOW at some point during the last tick, as a bit
+     *        mask (bit 0..3 = top, bottom, left, right).
+     *
+     * Unfiltered per-tick evidence for the signal monitor's sequential
+     * test.  Saturated sensors are excluded.
+     */
+    uint8_t getRawHits() const;
+
+    /**
+     * @brief Most recent raw sample as a bit mask (1 = LOW).
+     *
+     * Bit 0..3 = top, bottom, left, right; saturated sensors included.
+     * For telemetry.
+     */
+    uint8_t getRawBits() const;
+
+    /**
+     * @brief Sensors that were also LOW at the instant of the last
+     *        update(), the saturation guard's input.  Same bits as
+     *        getRawBits(); for session capture.
+     */
+    uint8_t getLevelBits() const;
+
+    /**
+     * @brief Set the majority-vote threshold (clamped to 1..WINDOW).
+     *
+     * Lower = faster to report a sensor ACTIVE, more false triggers.
+     * Per-state values come from the turret state machine, which may run
+     * on another core than update() (the threshold is atomic).
+     */
+    void setFilterThreshold(uint8_t threshold);
+
+    /** @brief Current majority-vote threshold. */
+    uint8_t getFilterThreshold() const;
+
 private:
     // Per-sensor circular buffer for majority-vote filter.
     struct FilterState {
@@ -109,6 +151,10 @@ private:
     };
 
     FilterState filters_[4];          // [0]=top, [1]=bottom, [2]=left, [3]=right
+    uint8_t rawHits_ = 0;             // Raw LOW mask from the last update(), unsaturated
+    uint8_t rawBits_ = 0;             // Raw LOW mask from the last update()
+    uint8_t levelBits_ = 0;           // ... of those, LOW at the update itself
+    std::atomic<uint8_t> threshold_{SENSOR_FILTER_THRESHOLD};   // Majority-vote threshold
 
     /** @brief Count set bits in the lower SENSOR_FILTER_WINDOW bits. */
     static uint8_t popcount(uint8_t bits);
@@ -0,0 +1,148 @@
+/**
+ * @file servo_output.h
+ * @brief Cached, frame-aligned pulse-width output stage for one servo.
+ *
+ * Sits between a controller and the ESP32Servo/LEDC layer:
+ *   - Remembers the last pulse width actually written and drops
+ *     identical requests (no LEDC register traffic for "hold" ticks).
+ *   - Commits at most one new pulse width per servo PWM frame
+ *     (SERVO_FRAME_US).  A second request inside the same frame replaces
+ *     the pending value and is committed by service() once the next frame
+ *     starts, so the servo never sees a pulse width change mid-frame.
+ *   - Counts committed writes, suppressed writes, and writes per second.
+ *   - Power-down: detaches the PWM channel so the servo stops holding.
+ *     Requests made while powered down are latched, and powerUp()
+ *     re-attaches with the last committed pulse width so the horn does
+ *     not jump.  Time spent powered down and wake-to-first-command
+ *     latency are recorded.
+ */
+
+#ifndef SERVO_OUTPUT_H
+#define SERVO_OUTPUT_H
+
+#include "hal.h"
+#include <stdint.h>
+
+class ServoOutput {
+public:
+    /**
+     * @brief Attach the servo and write the initial pulse width.
+     *
+     * The attach time is the origin of the PWM frame grid.
+     */
+    void attach(uint8_t pin, uint16_t initialUs);
+
+    /**
+     * @brief Request a pulse width.
+     *
+     * Identical to the last committed value → dropped.  Otherwise committed
+     * immediately if no write has happened in the current frame, or held as
+     * pending until service() sees the next frame.  While powered down the
+     * request is only latched.
+     */
+    void write(uint16_t us);
+
+    /**
+     * @brief Commit a pending write once its frame has passed, and roll the
+     *        writes-per-second window.
+     *
+     * Call once per main-loop iteration.
+     */
+    void service();
+
+    /** @brief Stop the PWM output (servo goes limp).  Idempotent. */
+    void powerDown();
+
+    /**
+     * @brief Re-attach and restore the last committed pulse width.
+     *
+     * Starts a new frame grid; the first command after waking is committed
+     * without waiting for a frame boundary.  Idempotent.
+     */
+    void powerUp();
+
+    /** @brief True while the PWM output is stopped. */
+    bool isPoweredDown() const;
+
+    /** @brief Last pulse width committed to the hardware (µs). */
+    uint16_t lastUs() const;
+
+    /** @brief Pulse width the hardware will carry after service() (µs). */
+    uint16_t targetUs() const;
+
+    /**
+     * @brief Pulse width the servo carries from now on: targetUs() if
+     *        service() would commit it now, else lastUs().
+     *
+     * Unlike targetUs(), a write that a later one in the same frame will
+     * replace before it is ever sent does not count.
+     */
+    uint16_t outputUs() const;
+
+    /** @brief True if a write is waiting for the next frame (or for wake). */
+    bool hasPending() const;
+
+    /** @brief Total writes committed to the servo layer. */
+    uint32_t commitCount() const;
+
+    /** @brief micros() of the last committed write. */
+    uint32_t lastCommitUs() const;
+
+    /** @brief Total requests dropped because the value was unchanged. */
+    uint32_t suppressedCount() const;
+
+    /** @brief Writes committed during the last complete one-second window. */
+    uint16_t writesPerSecond() const;
+
+    /** @brief Number of powerDown() transitions. */
+    uint32_t powerDownCount() const;
+
+    /** @brief Total time spent powered down, including the current period (ms). */
+    uint32_t poweredDownMs() const;
+
+    /**
+     * @brief powerUp() → first command on the wire, most recent wake (µs).
+     *
+     * Includes the re-attach itself.  0 until a command follows a wake.
+     */
+    uint32_t lastWakeLatencyUs() const;
+
+    /** @brief Worst wake-to-first-command latency seen (µs). */
+    uint32_t maxWakeLatencyUs() const;
+
+private:
+    Hal::Servo servo_;
+    uint8_t  pin_              = 0;
+    uint16_t lastUs_           = 0;   ///< Last committed pulse width
+    uint16_t pendingUs_        = 0;   ///< Deferred pulse width (valid if pending_)
+    bool     pending_          = false;
+    bool     poweredDown_      = false;
+    bool     awaitingCommand_  = false;   ///< Woken, first command not yet out
+    bool     frameFree_        = false;   ///< Next write may share the current frame
+    uint32_t originUs_         = 0;   ///< micros() at attach — frame grid origin
+    uint32_t lastFrame_        = 0;   ///< Frame index of the last commit
+    uint32_t lastCommitUs_     = 0;   ///< micros() of the last commit
+    uint32_t commits_          = 0;
+    uint32_t suppressed_       = 0;
+    uint16_t windowCommits_    = 0;   ///< Commits in the current 1 s window
+    uint16_t writesPerSec_     = 0;   ///< Commits in the last complete window
+    uint32_t windowStartMs_    = 0;
+
+    uint32_t powerDowns_       = 0;
+    uint32_t downTotalMs_      = 0;   ///< Completed powered-down periods
+    uint32_t downSinceMs_      = 0;   ///< millis() at the current powerDown()
+    uint32_t wakeStartUs_      = 0;   ///< micros() at the last powerUp()
+    uint32_t lastWakeUs_       = 0;
+    uint32_t maxWakeUs_        = 0;
+
+    /** @brief PWM frame index for a micros() timestamp. */
+    uint32_t frameAt(uint32_t nowUs) const;
+
+    /** @brief Write @p us to the servo and record the commit. */
+    void commit(uint16_t us, uint32_t frame);
+
+    /** @brief Close the wake-latency measurement if one is open. */
+    void noteCommandOut();
+};
+
+#endif // SERVO_OUTPUT_H
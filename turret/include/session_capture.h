@@ -0,0 +1,154 @@
+/**
+ * @file session_capture.h
+ * @brief Session capture: every raw sensor sample of a run, framed on the
+ *        telemetry stream, for replay through the firmware modules on the
+ *        host (sim/tools/sentry_replay.cpp).
+ *
+ * With capture on ('c', from the next boot) the serial stream carries
+ * two more payloads, framed like the telemetry records (CRC-16, COBS,
+ * 0x00 — telemetry_stream.h), little-endian:
+ *
+ *   HEADER, once, just before setup() initialises the modules
+ *     off size  field
+ *       0   1   CaptureHeader::TAG
+ *       1   1   version (SessionCapture::VERSION)
+ *       2   4   bootUs   — micros() at module init
+ *       6   1   priorLen — 0 if no bearing prior was stored
+ *       7   n   the stored BearingPrior blob, as loadPrior() reads it
+ *
+ *   TICK, one per control tick, instead of the plain record
+ *       0   1   CaptureTick::TAG
+ *       1  18   the telemetry record (TelemetryRecord layout)
+ *      19   2   dtMs     — period passed to PanController::updatePosition()
+ *      21   1   samples in bits 0..6; bit 7 = more were consumed than fit
+ *      22  7×n  per consumed snapshot, oldest first:
+ *                 seq (low 16 bits), tUs (micros() at sampling), rawBits
+ *                 (bits 0..3 latched LOW, 4..7 LOW at the sampling instant)
+ *
+ * The raw bits, their timestamps and the tick times are every input the
+ * control path reads; replaying them through SensorArray, SignalMonitor
+ * and the state machine reproduces the recorded commands.  A TICK with
+ * one sample is 33 bytes on the wire, 1.7 kB/s at 50 Hz.
+ *
+ * The tags are not TelemetryRecord::VERSION, so CaptureDecoder reads
+ * capture and plain telemetry from the same stream.  Nothing here
+ * touches Arduino.
+ */
+
+#ifndef SESSION_CAPTURE_H
+#define SESSION_CAPTURE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "bearing_prior.h"
+#include "telemetry_stream.h"
+
+/** @brief One consumed sensor snapshot: what SensorArray::update() read. */
+struct CaptureSample {
+    uint16_t seq     = 0;    ///< Capture tick number, low 16 bits
+    uint32_t tUs     = 0;    ///< micros() when sampled
+    uint8_t  rawBits = 0;    ///< Bit 0..3 = top, bottom, left, right, 1 = LOW since
+                             ///< the last sample; bit 4..7 the same, LOW at the sample
+};
+
+/** @brief Start of a captured session: the state the modules begin from. */
+struct CaptureHeader {
+    static constexpr uint8_t TAG = 0xC1;
+
+    uint8_t  version  = 0;
+    uint32_t bootUs   = 0;
+    uint8_t  priorLen = 0;
+    uint8_t  prior[BearingPrior::BLOB_SIZE] = {};
+};
+
+/** @brief One captured control tick. */
+struct CaptureTick {
+    static constexpr uint8_t TAG         = 0xC2;
+    static constexpr uint8_t MAX_SAMPLES = SNAPSHOT_RING_SIZE;
+
+    TelemetryRecord rec;
+    uint16_t        dtMs        = 0;
+    uint8_t         samples     = 0;
+    bool            samplesLost = false;   ///< Consumed more than MAX_SAMPLES
+    CaptureSample   sample[MAX_SAMPLES];
+};
+
+class SessionCapture {
+public:
+    static constexpr uint8_t VERSION      = 3;
+    static constexpr size_t  SAMPLE_BYTES = 7;
+    static constexpr size_t  HEADER_MAX   = 7 + BearingPrior::BLOB_SIZE;
+    static constexpr size_t  TICK_MIN     = 1 + TelemetryRecord::BYTES + 3;
+    static constexpr size_t  TICK_MAX     = TICK_MIN + CaptureTick::MAX_SAMPLES * SAMPLE_BYTES;
+    static constexpr size_t  PAYLOAD_MAX  = HEADER_MAX > TICK_MAX ? HEADER_MAX : TICK_MAX;
+
+    /** @brief Longest frame on the wire, delimiter included. */
+    static constexpr size_t FRAME_MAX = TelemetryCodec::framedBytes(PAYLOAD_MAX);
+
+    /** @brief Serialise @p h.  @return payload bytes (HEADER_MAX at most). */
+    static size_t packHeader(const CaptureHeader &h, uint8_t *out);
+
+    /** @brief Parse a header.  @return false on wrong tag, version or length. */
+    static bool unpackHeader(const uint8_t *in, size_t len, CaptureHeader &h);
+
+    /** @brief Serialise @p t.  @return payload bytes (TICK_MAX at most). */
+    static size_t packTick(const CaptureTick &t, uint8_t *out);
+
+    /** @brief Parse a tick.  @return false on wrong tag or length. */
+    static bool unpackTick(const uint8_t *in, size_t len, CaptureTick &t);
+
+    /** @brief packHeader + framing.  @return bytes written (FRAME_MAX at most). */
+    static size_t encodeHeader(const CaptureHeader &h, uint8_t *out);
+
+    /** @brief packTick + framing.  @return bytes written (FRAME_MAX at most). */
+    static size_t encodeTick(const CaptureTick &t, uint8_t *out);
+};
+
+static_assert(SessionCapture::PAYLOAD_MAX <= TelemetryCodec::MAX_PAYLOAD,
+              "capture payload too long for one COBS block");
+static_assert(CaptureTick::MAX_SAMPLES < 0x80, "sample count shares a byte with a flag");
+
+/**
+ * @brief Byte-at-a-time receiver for a capture or telemetry stream.
+ *
+ * Like TelemetryDecoder, but each valid frame is a plain record, a
+ * capture header or a capture tick; text between frames is dropped.
+ */
+class CaptureDecoder {
+public:
+    enum class Frame : uint8_t { NONE, RECORD, HEADER, TICK };
+
+    /**
+     * @brief Feed one received byte.
+     *
+     * @return What @p b completed, NONE if nothing (or a bad frame).
+     */
+    Frame feed(uint8_t b);
+
+    /** @brief Last record: a RECORD, or the one inside the last TICK. */
+    const TelemetryRecord &record() const;
+
+    const CaptureHeader &header() const;
+    const CaptureTick   &tick() const;
+
+    /** @brief Valid frames decoded. */
+    uint32_t frames() const;
+
+    /** @brief Delimited chunks rejected (COBS, length, tag or CRC). */
+    uint32_t badFrames() const;
+
+private:
+    static constexpr size_t MAX_ENCODED = SessionCapture::FRAME_MAX - 1;
+
+    uint8_t         buf_[MAX_ENCODED];
+    size_t          len_      = 0;
+    bool            overflow_ = false;
+    uint32_t        frames_   = 0;
+    uint32_t        bad_      = 0;
+    TelemetryRecord rec_;
+    CaptureHeader   header_;
+    CaptureTick     tick_;
+};
+
+#endif // SESSION_CAPTURE_H
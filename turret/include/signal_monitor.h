@@ -4,26 +4,54 @@
  *
  * Three states:
  *
- *   TRACKING  — At least one sensor active within the last
- *               SIGNAL_PRESENT_HOLDOFF_MS.  Normal tracking.
+ *   TRACKING  — Beacon present.  Normal tracking.
  *
- *   SEARCHING — No signal for SIGNAL_LOSS_SEARCH_MS.  Pan servo
- *               executes a slow ±SEARCH_SWEEP_DEG sweep; tilt moves
- *               to TILT_SCAN_DEG.  If signal returns → TRACKING.
+ *   SEARCHING — Beacon lost.  Pan servo executes the search pattern;
+ *               if signal returns → TRACKING.
  *
  *   PARKED    — No signal for SIGNAL_LOSS_PARK_MS.  All servos stopped,
  *               fan parked at home position.  Resume on any detection.
  *
+ * Two ways to drive it:
+ *
+ *   update(bool)          — fixed timeouts on the filtered anyActive() bit:
+ *                           SIGNAL_PRESENT_HOLDOFF_MS hysteresis, SEARCHING
+ *                           after SIGNAL_LOSS_SEARCH_MS, any detection
+ *                           returns to TRACKING.
+ *
+ *   updateEvidence(hits)  — sequential probability ratio test on each
+ *                           sensor's raw per-tick hits (see config.h).
+ *                           TRACKING is entered when a sensor's
+ *                           log-likelihood ratio reaches the presence
+ *                           threshold and left for SEARCHING when every
+ *                           sensor's falls to the absence threshold, so how
+ *                           strong and consistent the evidence is decides
+ *                           the timing.  PARKED follows the adaptive
+ *                           park timeout after the last "present"
+ *                           decision.
+ *
+ * Adaptive timeouts (updateEvidence() path): each completed absence is
+ * counted in a bounded log-spaced histogram, from which the park timeout
+ * and the exit-bearing hold time are re-derived (see config.h).  Users who
+ * step out briefly and often keep the turret holding on the door; users
+ * who leave for hours get parked within seconds.
+ *
  * The built-in LED indicates state:
  *   solid ON   = TRACKING
  *   slow blink = SEARCHING
  *   OFF        = PARKED
+ *
+ * With a Scheduler attached, the blink is a scheduled job armed on entry
+ * to SEARCHING and cancelled on exit, so updateStatusLED() only needs to
+ * be called when the state changes.
  */
 
 #ifndef SIGNAL_MONITOR_H
 #define SIGNAL_MONITOR_H
 
 #include <stdint.h>
+#include "config.h"
+#include "scheduler.h"
 
 /** @brief Signal-loss state machine states. */
 enum class MonitorState : uint8_t {
@@ -38,7 +66,7 @@ public:
     void init();
 
     /**
-     * @brief Feed the monitor with the current signal status.
+     * @brief Feed the monitor with the current signal status (fixed timeouts).
      *
      * Call once per main-loop iteration.
      *
@@ -46,6 +74,66 @@ public:
      */
     void update(bool anySignalDetected);
 
+    /**
+     * @brief Feed the monitor with per-tick raw evidence (SPRT).
+     *
+     * Call once per main-loop iteration instead of update(bool).
+     *
+     * @param rawHits  SensorArray::getRawHits() — bit per sensor LOW this tick.
+     */
+    void updateEvidence(uint8_t rawHits);
+
+    /**
+     * @brief Count a completed absence and re-derive the adaptive timeouts.
+     *
+     * Called by updateEvidence() when presence is decided again after
+     * SEARCHING or PARKED; public so learned history can be replayed.
+     *
+     * @param durationMs  Time from the last "present" decision to this one.
+     */
+    void recordAbsence(uint32_t durationMs);
+
+    /** @brief Enable / disable adaptation (disabled = fixed constants). */
+    void setAdaptive(bool enable);
+
+    /** @brief Current park timeout (ms after the last "present" decision). */
+    uint32_t getParkMs() const;
+
+    /** @brief How long SEARCHING should hold on the exit bearing (ms). */
+    uint32_t getHoldMs() const;
+
+    /** @brief Absences counted in histogram bin @p bin. */
+    uint8_t getAbsenceCount(uint8_t bin) const;
+
+    /** @brief Histogram bin for an absence of @p durationMs. */
+    static uint8_t absenceBinFor(uint32_t durationMs);
+
+    /**
+     * @brief Count one absence in @p bin of an ABSENCE_BINS histogram,
+     *        halving every bin first if that one is full.
+     */
+    static void countAbsence(uint8_t *absence, uint8_t bin);
+
+    /**
+     * @brief The adaptive rule: park timeout and exit-bearing hold for
+     *        an ABSENCE_BINS histogram (fixed values if !adaptive or too
+     *        few samples).
+     *
+     * Static so batch simulations (sim/sim_batch.h) apply the same rule
+     * to their own histograms.
+     */
+    static void deriveTimeouts(const uint8_t *absence, bool adaptive,
+                               uint32_t &parkMs, uint32_t &holdMs);
+
+    /** @brief Current log-likelihood ratio (present vs absent), the best sensor's. */
+    float getLogLikelihood() const;
+
+    /** @brief SPRT presence threshold, ln((1 − β) / α). */
+    float getPresentThreshold() const;
+
+    /** @brief SPRT absence threshold, ln(β / (1 − α)). */
+    float getAbsentThreshold() const;
+
     /** @brief Return the current state. */
     MonitorState getState() const;
 
@@ -67,16 +155,52 @@ public:
     /**
      * @brief Drive the status LED according to the current state.
      *
-     * Call once per main-loop iteration (handles blink timing internally).
+     * Without a scheduler: call once per main-loop iteration (handles
+     * blink timing internally).  With one: call on state changes only.
      */
     void updateStatusLED();
 
+    /**
+     * @brief Drive the SEARCHING blink from @p sched instead of polling.
+     *
+     * nullptr restores polling.
+     */
+    void setScheduler(Scheduler *sched);
+
 private:
     MonitorState state_     = MonitorState::TRACKING;
     MonitorState prevState_ = MonitorState::TRACKING;
-    unsigned long lastSignalMs_  = 0;   ///< millis() of last detection
-    unsigned long lastBlinkMs_   = 0;   ///< LED blink timer
+    uint32_t     lastSignalMs_ = 0;   ///< millis() of last detection
+    uint32_t     lastBlinkMs_  = 0;   ///< LED blink timer
     bool ledState_ = false;
+
+    Scheduler        *sched_   = nullptr;
+    Scheduler::JobId  blinkJob_ = Scheduler::INVALID_JOB;
+
+    // Sequential test state (updateEvidence()).
+    float llr_[4]       = {};     ///< Clamped log-likelihood ratio per sensor
+    float llrHit_       = 0.0f;   ///< Increment for a tick with a raw hit
+    float llrMiss_      = 0.0f;   ///< Increment for a tick without one
+    float llrPresent_   = 0.0f;   ///< Upper (presence) threshold
+    float llrAbsent_    = 0.0f;   ///< Lower (absence) threshold
+
+    // Adaptive timeouts.
+    uint8_t  absence_[ABSENCE_BINS] = {};   ///< Absence-duration histogram
+    bool     adaptive_ = true;
+    uint32_t parkMs_   = SIGNAL_LOSS_PARK_MS;
+    uint32_t holdMs_   = 0;
+
+    /** @brief Toggle the SEARCHING blink and write the LED. */
+    void blink(uint32_t now);
+
+    /** @brief Scheduler callback: blink, then re-arm. */
+    static void onBlinkDue(void *self);
+
+    /** @brief Re-derive parkMs_ / holdMs_ from the histogram. */
+    void adaptTimeouts();
+
+    /** @brief Representative duration of bin @p bin (ms; last bin: open). */
+    static float absenceBinMs(uint8_t bin);
 };
 
 #endif // SIGNAL_MONITOR_H
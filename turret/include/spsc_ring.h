@@ -0,0 +1,66 @@
+/**
+ * @file spsc_ring.h
+ * @brief Lock-free single-producer / single-consumer ring buffer.
+ *
+ * Fixed capacity (N − 1 usable slots, N a power of two), no allocation.
+ * Exactly one task may push and exactly one (other) task may pop; head
+ * and tail are each written by one side only, with acquire / release
+ * ordering so an element is fully written before the consumer sees it.
+ * A full ring rejects the push (the producer counts a drop and moves on
+ * — it never blocks).
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <atomic>
+
+template <typename T, uint16_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+    /** @brief Producer: append @p item.  @return false (and count a drop) if full. */
+    bool push(const T &item) {
+        uint16_t head = head_.load(std::memory_order_relaxed);
+        uint16_t next = (head + 1) & (N - 1);
+        if (next == tail_.load(std::memory_order_acquire)) {
+            drops_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots_[head] = item;
+        head_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Consumer: remove the oldest item into @p out.  @return false if empty. */
+    bool pop(T &out) {
+        uint16_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return false;
+        out = slots_[tail];
+        tail_.store((tail + 1) & (N - 1), std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Items waiting (exact from either side, approximate from others). */
+    uint16_t size() const {
+        uint16_t head = head_.load(std::memory_order_acquire);
+        uint16_t tail = tail_.load(std::memory_order_acquire);
+        return (head - tail) & (N - 1);
+    }
+
+    /** @brief Usable capacity. */
+    static constexpr uint16_t capacity() { return N - 1; }
+
+    /** @brief Pushes rejected because the ring was full. */
+    uint32_t drops() const { return drops_.load(std::memory_order_relaxed); }
+
+private:
+    T slots_[N];
+    std::atomic<uint16_t> head_{0};    ///< Next slot to write (producer)
+    std::atomic<uint16_t> tail_{0};    ///< Next slot to read (consumer)
+    std::atomic<uint32_t> drops_{0};
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,210 @@
+/**
+ * @file telemetry_stream.h
+ * @brief Binary telemetry records: packing, CRC-16, COBS framing, decoder.
+ *
+ * One record per control tick, 18 bytes little-endian:
+ *
+ *   off size  field
+ *     0   1   version (TelemetryRecord::VERSION)
+ *     1   2   seq        — newest capture tick consumed (low 16 bits)
+ *     3   4   tUs        — control tick start, micros()
+ *     7   1   rawBits    — last raw sample, bit 0..3 = top, bottom, left, right
+ *     8   1   filtered   — SensorState, 2 bits per sensor, same order
+ *     9   1   state      — TurretState in bits 0..3, snapshots consumed
+ *                            in bits 4..6, bit 7 = transition
+ *    10   2   panCdeg    — pan position estimate, 0.01°
+ *    12   2   panCmd     — commanded pan speed, 1e-4 of full scale
+ *    14   2   tiltDeg
+ *    16   2   loopUs     — control tick cost up to the record
+ *
+ * seq moves on by the snapshots consumed: by none on a tick that found
+ * no new one, by several on a parked stride (PARK_IDLE_TICKS).  Further
+ * than that, frames or snapshots were lost (seqGap()).
+ *
+ * On the wire: record + CRC-16/CCITT-FALSE (little-endian), COBS
+ * encoded, then a 0x00 delimiter.  A receiver that starts mid-stream
+ * (or sees text between frames) loses at most one frame: the CRC
+ * rejects it and the next 0x00 resynchronises.
+ *
+ * Other payloads (session_capture.h) share the framing: encodePayload()
+ * and decodePayload() do CRC + COBS for any payload under 252 bytes.
+ *
+ * Nothing here touches Arduino: the host decoder
+ * (tools/telemetry_decode.cpp) builds this file as is.
+ */
+
+#ifndef TELEMETRY_STREAM_H
+#define TELEMETRY_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "spsc_ring.h"
+
+/** @brief One control tick, unpacked. */
+struct TelemetryRecord {
+    static constexpr uint8_t VERSION     = 2;
+    static constexpr uint8_t BYTES       = 18;
+    static constexpr uint8_t MAX_SAMPLES = 7;    ///< Held in 3 bits
+
+    uint16_t seq        = 0;
+    uint8_t  samples    = 0;      ///< Snapshots consumed, up to MAX_SAMPLES
+    uint32_t tUs        = 0;
+    uint8_t  rawBits    = 0;
+    uint8_t  filtered   = 0;
+    uint8_t  state      = 0;
+    bool     transition = false;
+    int16_t  panCdeg    = 0;
+    int16_t  panCmd     = 0;
+    int16_t  tiltDeg    = 0;
+    uint16_t loopUs     = 0;
+};
+
+class TelemetryCodec {
+public:
+    /** @brief Longest COBS output for @p n input bytes (without delimiter). */
+    static constexpr size_t cobsMax(size_t n) { return n + n / 254 + 1; }
+
+    /**
+     * @brief Bytes of one framed record, delimiter included: record + CRC
+     *        + one COBS code byte (the payload is under 254 bytes) + 0x00.
+     */
+    static constexpr size_t FRAME_BYTES = TelemetryRecord::BYTES + 2 + 1 + 1;
+
+    /** @brief Longest payload encodePayload() takes: one COBS block with the CRC. */
+    static constexpr size_t MAX_PAYLOAD = 254 - 2;
+
+    /** @brief Bytes of a framed @p payload-byte payload, delimiter included. */
+    static constexpr size_t framedBytes(size_t payload) { return cobsMax(payload + 2) + 1; }
+
+    /** @brief Serialise @p rec into TelemetryRecord::BYTES at @p out. */
+    static void pack(const TelemetryRecord &rec, uint8_t *out);
+
+    /** @brief Parse a record.  @return false on wrong length or version. */
+    static bool unpack(const uint8_t *in, size_t len, TelemetryRecord &rec);
+
+    /**
+     * @brief Whether frames or snapshots were lost between a record with
+     *        @p lastSeq and @p rec: seq moved on by more than rec.samples.
+     */
+    static bool seqGap(uint16_t lastSeq, const TelemetryRecord &rec) {
+        return static_cast<uint16_t>(rec.seq - lastSeq) > rec.samples;
+    }
+
+    /** @brief CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF). */
+    static uint16_t crc16(const uint8_t *data, size_t len);
+
+    /** @brief COBS-encode @p len bytes.  @return encoded length (no 0x00 in it). */
+    static size_t cobsEncode(const uint8_t *in, size_t len, uint8_t *out);
+
+    /**
+     * @brief Decode one COBS frame (delimiter excluded).
+     *
+     * @return Decoded length, or 0 if malformed or longer than @p outMax.
+     */
+    static size_t cobsDecode(const uint8_t *in, size_t len, uint8_t *out, size_t outMax);
+
+    /** @brief pack + CRC + COBS + delimiter.  @return bytes written (FRAME_BYTES max). */
+    static size_t encodeFrame(const TelemetryRecord &rec, uint8_t *out);
+
+    /**
+     * @brief CRC + COBS + delimiter around @p len (≤ MAX_PAYLOAD) bytes.
+     *
+     * @return Bytes written, framedBytes(len).
+     */
+    static size_t encodePayload(const uint8_t *payload, size_t len, uint8_t *out);
+
+    /**
+     * @brief Undo encodePayload() for one frame (delimiter excluded).
+     *
+     * @return Payload length (CRC stripped), or 0 if malformed, longer
+     *         than @p outMax or failing the CRC.
+     */
+    static size_t decodePayload(const uint8_t *in, size_t len, uint8_t *out, size_t outMax);
+
+    /** @brief Column names matching csvRow(), no line ending. */
+    static const char *const CSV_HEADER;
+
+    /**
+     * @brief One CSV line (no line ending) for @p rec into @p out.
+     *
+     * Sensors are split into columns (raw 1 = LOW; filtered 0 inactive,
+     * 1 active, 2 saturated); @p stateName labels rec.state.
+     *
+     * @return snprintf's result.
+     */
+    static int csvRow(const TelemetryRecord &rec, const char *stateName,
+                      char *out, size_t outLen);
+};
+
+static_assert(SNAPSHOT_RING_SIZE - 1 <= TelemetryRecord::MAX_SAMPLES,
+              "a tick can consume more snapshots than the record counts");
+static_assert(TelemetryCodec::cobsMax(TelemetryRecord::BYTES + 2) + 1 ==
+              TelemetryCodec::FRAME_BYTES, "record too long for one COBS block");
+
+/**
+ * @brief Outgoing frame queue, drained by the UART without blocking.
+ *
+ * push() queues a whole frame or drops it (counted); drain() writes as
+ * many queued bytes as the sink accepts.  One task owns both ends.
+ */
+class TelemetryStream {
+public:
+    /** @brief Writes up to @p len bytes; returns how many it took. */
+    typedef size_t (*WriteFn)(const uint8_t *data, size_t len, void *ctx);
+
+    /** @brief Frame and queue @p rec.  @return false if it did not fit. */
+    bool push(const TelemetryRecord &rec);
+
+    /** @brief Queue @p len bytes already framed (encodePayload()).  @return false if they did not fit. */
+    bool pushFrame(const uint8_t *frame, size_t len);
+
+    /**
+     * @brief Hand queued bytes to @p write, at most @p maxBytes.
+     *
+     * @return Bytes written.
+     */
+    size_t drain(WriteFn write, void *ctx, size_t maxBytes);
+
+    /** @brief Bytes waiting. */
+    uint16_t queued() const;
+
+    /** @brief Frames queued since start. */
+    uint32_t frames() const;
+
+    /** @brief Frames dropped because the ring was full. */
+    uint32_t drops() const;
+
+private:
+    SpscRing<uint8_t, TELEMETRY_TX_RING_BYTES> ring_;
+    uint32_t frames_ = 0;
+    uint32_t drops_  = 0;
+};
+
+/** @brief Byte-at-a-time receiver: COBS frames → checked records. */
+class TelemetryDecoder {
+public:
+    /**
+     * @brief Feed one received byte.
+     *
+     * @return true when @p b completed a valid frame, now in @p out.
+     */
+    bool feed(uint8_t b, TelemetryRecord &out);
+
+    /** @brief Valid records decoded. */
+    uint32_t records() const;
+
+    /** @brief Delimited chunks rejected (COBS, length, version or CRC). */
+    uint32_t badFrames() const;
+
+private:
+    static constexpr size_t MAX_ENCODED = TelemetryCodec::FRAME_BYTES - 1;
+
+    uint8_t  buf_[MAX_ENCODED];
+    size_t   len_      = 0;
+    bool     overflow_ = false;
+    uint32_t records_  = 0;
+    uint32_t bad_      = 0;
+};
+
+#endif // TELEMETRY_STREAM_H
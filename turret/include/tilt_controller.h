@@ -5,13 +5,18 @@
  * Wraps an MG996R standard servo with:
  *   - Clamped angle range (TILT_MIN_DEG … TILT_MAX_DEG)
  *   - Incremental nudge with rate limiting (Issue #8)
- *   - Park-to-home convenience method
+ *   - Stepped park-to-home (no jump) for the park planner
+ *   - Cached, frame-aligned output (ServoOutput) — re-asserting the same
+ *     angle every tick costs nothing
+ *
+ * Fix: currentAngle_ is now int16_t to avoid subtle signed/unsigned
+ *      issues when nudging near the lower bound.
  */
 
 #ifndef TILT_CONTROLLER_H
 #define TILT_CONTROLLER_H
 
-#include <ESP32Servo.h>
+#include "servo_output.h"
 #include <stdint.h>
 
 class TiltController {
@@ -23,7 +28,7 @@ public:
      * @brief Set absolute tilt angle.
      * @param degrees  Target angle, clamped to [TILT_MIN_DEG, TILT_MAX_DEG].
      */
-    void setAngle(uint8_t degrees);
+    void setAngle(int16_t degrees);
 
     /**
      * @brief Incremental adjustment, respecting rate limit.
@@ -36,19 +41,57 @@ public:
      */
     bool nudge(int8_t delta);
 
+    /**
+     * @brief Move toward @p target by at most @p maxStep degrees.
+     *
+     * Not subject to the nudge holdoff — the caller paces the steps.
+     *
+     * @return true once the current angle equals the (clamped) target.
+     */
+    bool stepToward(int16_t target, uint8_t maxStep);
+
     /** @brief Return current tilt angle (degrees). */
-    uint8_t getAngle() const;
+    int16_t getAngle() const;
 
-    /** @brief Move to TILT_HOME_DEG. */
-    void parkHome();
+    /**
+     * @brief Step toward TILT_HOME_DEG by at most PARK_TILT_STEP_DEG.
+     *
+     * Non-blocking: call repeatedly from the main loop.
+     * @return true when the tilt is at home.
+     */
+    bool parkHome();
 
     /** @brief Move to TILT_SCAN_DEG (used during SEARCHING state). */
     void goScanPosition();
 
+    /** @brief Flush a frame-deferred write.  Call once per loop iteration. */
+    void serviceOutput();
+
+    /**
+     * @brief Stop the servo PWM (no holding current, no idle jitter).
+     *
+     * Commands issued while powered down are latched until wake().
+     */
+    void powerDown();
+
+    /**
+     * @brief Re-attach the servo, restoring the last angle without a jump.
+     */
+    void wake();
+
+    /** @brief True while the servo PWM is stopped. */
+    bool isPoweredDown() const;
+
+    /** @brief Output-stage statistics (writes/s, suppressed writes). */
+    const ServoOutput &output() const;
+
 private:
-    Servo servo_;
-    uint8_t currentAngle_ = 0;
-    unsigned long lastStepMs_ = 0;   ///< millis() of last nudge application
+    ServoOutput out_;
+    int16_t currentAngle_ = 0;
+    uint32_t lastStepMs_ = 0;   ///< millis() of last nudge application
+
+    /** @brief Convert an angle to a pulse width (ESP32Servo mapping). */
+    static uint16_t angleToMicroseconds(int16_t degrees);
 };
 
 #endif // TILT_CONTROLLER_H
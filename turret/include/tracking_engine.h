@@ -6,13 +6,16 @@
  * commands for both axes:
  *
  * Pan (horizontal):
- *   - Only LEFT active  → pan left at TRACK_PAN_SPEED_FAST
- *   - Only RIGHT active → pan right at TRACK_PAN_SPEED_FAST
+ *   - Only LEFT active  → pan left at the fast gain
+ *   - Only RIGHT active → pan right at the fast gain
  *   - Both LEFT & RIGHT → centered, hold (dead band)
  *   - Neither           → hold (no information)
  *   - If the opposing sensor was recently active (within the last
- *     APPROACH_MEMORY_MS), reduce speed to TRACK_PAN_SPEED_SLOW for
- *     smooth convergence — the beacon is near center.
+ *     TRACK_APPROACH_MEMORY_MS), reduce speed to the slow gain for smooth
+ *     convergence — the beacon is near center.
+ *
+ * Gains default to TRACK_PAN_SPEED_FAST / _SLOW; the turret state machine
+ * swaps in per-state values (fast lock-on vs. steady low-gain hold).
  *
  * Tilt (vertical):
  *   - Only TOP active    → nudge up (+TILT_STEP_DEG)
@@ -24,10 +27,17 @@
 #ifndef TRACKING_ENGINE_H
 #define TRACKING_ENGINE_H
 
+#include "config.h"
 #include "sensor_array.h"
 #include "pan_controller.h"
 #include "tilt_controller.h"
 
+/** @brief Pan speeds used by the tracker (normalised 0.0–1.0). */
+struct TrackingGains {
+    float panFast;   ///< Beacon off to one side
+    float panSlow;   ///< Beacon near center (opposite side seen recently)
+};
+
 class TrackingEngine {
 public:
     /**
@@ -51,19 +61,19 @@ public:
     /** @brief Stop both axes (servos hold / stop). */
     void halt();
 
-    /**
-     * @brief Time window (ms) for "recently active" detection on the
-     *        opposing horizontal sensor.  If the other side was active
-     *        within this window, the beacon is near center → slow down.
-     */
-    static constexpr uint16_t APPROACH_MEMORY_MS = 400;
+    /** @brief Replace the pan gains (takes effect on the next update()). */
+    void setGains(const TrackingGains &gains);
+
+    /** @brief Current pan gains. */
+    const TrackingGains &getGains() const;
 
 private:
     PanController  *pan_  = nullptr;
     TiltController *tilt_ = nullptr;
 
-    unsigned long lastLeftActiveMs_  = 0;   ///< millis() when LEFT was last active
-    unsigned long lastRightActiveMs_ = 0;   ///< millis() when RIGHT was last active
+    uint32_t lastLeftActiveMs_  = 0;   ///< millis() when LEFT was last active
+    uint32_t lastRightActiveMs_ = 0;   ///< millis() when RIGHT was last active
+    TrackingGains gains_ = {TRACK_PAN_SPEED_FAST, TRACK_PAN_SPEED_SLOW};
 
     /**
      * @brief Determine proportional pan speed from horizontal sensor pair.
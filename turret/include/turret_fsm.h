@@ -0,0 +1,206 @@
+/**
+ * @file turret_fsm.h
+ * @brief Table-driven hierarchical state machine for the turret behaviour.
+ *
+ * States (TRACKING is a super-state; only leaves are ever current):
+ *
+ *   TRACKING
+ *     ├─ ACQUIRING — beacon (re)appeared: permissive filter, full gains.
+ *     ├─ LOCKED    — centered: strict filter, low gains, hold steady.
+ *     └─ COASTING  — reading blank but beacon still "present": keep the
+ *                    last pan motion, decaying, until it is seen again,
+ *                    then back to ACQUIRING or LOCKED, whichever it
+ *                    coasted from.
+ *   SEARCHING      — learned bearings, then the exhaustive pattern.
+ *   PARKED         — coordinated park, then servos powered down.
+ *
+ * Events come from two places each update():
+ *   - SignalMonitor state changes → PRESENT / LOST / PARK.
+ *   - The filtered reading while TRACKING → CENTERED / OFF_CENTER /
+ *     DROPOUT / REGAINED / RELOCKED.  A blank reading shorter than
+ *     COAST_DEBOUNCE_MS is no event at all.
+ *
+ * Transitions are listed once in TRANSITIONS (rows on TRACKING apply to
+ * all of its sub-states unless a sub-state has its own row).  The list is
+ * flattened at compile time into a [state][event] table, so dispatch is a
+ * single array lookup.  Entry / exit / tick handlers are plain function
+ * pointers in a per-state table — no virtuals.  Crossing into or out of
+ * TRACKING runs the super-state's entry / exit as well.
+ */
+
+#ifndef TURRET_FSM_H
+#define TURRET_FSM_H
+
+#include <stdint.h>
+#include "sensor_array.h"
+#include "pan_controller.h"
+#include "tilt_controller.h"
+#include "tracking_engine.h"
+#include "signal_monitor.h"
+#include "park_planner.h"
+#include "bearing_prior.h"
+#include "search_planner.h"
+
+/** @brief Turret behaviour states.  COUNT doubles as "none". */
+enum class TurretState : uint8_t {
+    TRACKING,    ///< Super-state of ACQUIRING / LOCKED / COASTING
+    ACQUIRING,
+    LOCKED,
+    COASTING,
+    SEARCHING,
+    PARKED,
+    COUNT
+};
+
+/** @brief Events dispatched to the state machine. */
+enum class TurretEvent : uint8_t {
+    PRESENT,      ///< Monitor decided the beacon is present
+    LOST,         ///< Monitor decided the beacon is gone
+    PARK,         ///< Monitor park timeout
+    CENTERED,     ///< L+R both active for LOCK_CENTERED_MS
+    OFF_CENTER,   ///< One side only for LOCK_BREAK_MS
+    DROPOUT,      ///< Filtered reading blank for COAST_DEBOUNCE_MS
+    REGAINED,     ///< Filtered reading active again, coasted from ACQUIRING
+    RELOCKED,     ///< Filtered reading active again, coasted from LOCKED
+    COUNT
+};
+
+/** @brief Modules the state handlers act on (all owned by main.cpp). */
+struct TurretContext {
+    SensorArray    *sensors = nullptr;
+    PanController  *pan     = nullptr;
+    TiltController *tilt    = nullptr;
+    TrackingEngine *tracker = nullptr;
+    SignalMonitor  *monitor = nullptr;
+    ParkPlanner    *parker  = nullptr;
+    BearingPrior   *prior   = nullptr;
+    SearchPlanner  *search  = nullptr;
+    void (*onParked)()      = nullptr;   ///< Optional hook on entry to PARKED
+};
+
+class TurretStateMachine {
+public:
+    /** @brief One row of the transition table. */
+    struct Transition {
+        TurretState from;
+        TurretEvent event;
+        TurretState to;
+    };
+
+    /** @brief The complete transition table. */
+    static constexpr Transition TRANSITIONS[] = {
+        { TurretState::ACQUIRING, TurretEvent::CENTERED,   TurretState::LOCKED    },
+        { TurretState::ACQUIRING, TurretEvent::DROPOUT,    TurretState::COASTING  },
+        { TurretState::LOCKED,    TurretEvent::OFF_CENTER, TurretState::ACQUIRING },
+        { TurretState::LOCKED,    TurretEvent::DROPOUT,    TurretState::COASTING  },
+        { TurretState::COASTING,  TurretEvent::REGAINED,   TurretState::ACQUIRING },
+        { TurretState::COASTING,  TurretEvent::RELOCKED,   TurretState::LOCKED    },
+        { TurretState::TRACKING,  TurretEvent::LOST,       TurretState::SEARCHING },
+        { TurretState::TRACKING,  TurretEvent::PARK,       TurretState::PARKED    },
+        { TurretState::SEARCHING, TurretEvent::PRESENT,    TurretState::ACQUIRING },
+        { TurretState::SEARCHING, TurretEvent::PARK,       TurretState::PARKED    },
+        { TurretState::PARKED,    TurretEvent::PRESENT,    TurretState::ACQUIRING },
+    };
+
+    static constexpr uint8_t TRANSITION_COUNT =
+        sizeof(TRANSITIONS) / sizeof(TRANSITIONS[0]);
+
+    /** @brief Super-state of @p s, or COUNT for a top-level state. */
+    static constexpr TurretState parentOf(TurretState s) {
+        return (s == TurretState::ACQUIRING || s == TurretState::LOCKED ||
+                s == TurretState::COASTING)
+                   ? TurretState::TRACKING
+                   : TurretState::COUNT;
+    }
+
+    /** @brief Target of @p e in leaf @p s, or COUNT if unhandled (O(1)). */
+    static TurretState lookup(TurretState s, TurretEvent e);
+
+    /** @brief Printable state name. */
+    static const char *stateName(TurretState s);
+
+    /**
+     * @brief Store the module pointers and enter the initial state
+     *        (TRACKING / ACQUIRING — the monitor also starts present).
+     */
+    void init(const TurretContext &ctx);
+
+    /**
+     * @brief Run one iteration: derive events, dispatch, tick the state.
+     *
+     * Call once per loop, after SignalMonitor::updateEvidence().
+     *
+     * @param reading  Filtered sensor reading for this tick.
+     */
+    void update(const SensorReading &reading);
+
+    /**
+     * @brief Dispatch one event.
+     *
+     * @return true if it caused a transition.
+     */
+    bool dispatch(TurretEvent e);
+
+    /** @brief Current (leaf) state. */
+    TurretState state() const;
+
+    /** @brief State before the most recent transition. */
+    TurretState previous() const;
+
+    /** @brief True if @p s is the current state or one of its ancestors. */
+    bool isIn(TurretState s) const;
+
+    /** @brief True if the last update() / dispatch() changed state. */
+    bool changed() const;
+
+private:
+    /** @brief Entry / exit / tick for one state (any may be null). */
+    struct Handlers {
+        void (*entry)(TurretStateMachine &m);
+        void (*exit)(TurretStateMachine &m);
+        void (*tick)(TurretStateMachine &m, const SensorReading &r);
+    };
+
+    static const Handlers HANDLERS[static_cast<uint8_t>(TurretState::COUNT)];
+
+    TurretContext ctx_;
+    TurretState   state_    = TurretState::ACQUIRING;
+    TurretState   previous_ = TurretState::COUNT;
+    bool          changed_  = false;
+
+    // Sensor-event timers (reset on entry to each tracking sub-state;
+    // a blank reading shorter than COAST_DEBOUNCE_MS leaves them running).
+    uint32_t      centeredSinceMs_ = 0;
+    uint32_t      oneSidedSinceMs_ = 0;
+    uint32_t      blankSinceMs_    = 0;
+    bool          centered_        = false;
+    bool          oneSided_        = false;
+    bool          blank_           = false;
+
+    // COASTING.
+    float         trackSpeed_   = 0.0f;   ///< Pan speed on the last non-blank tick
+    float         coastSpeed_   = 0.0f;
+    uint32_t      coastStartMs_ = 0;
+    TurretState   coastFrom_    = TurretState::ACQUIRING;
+
+    /** @brief Derive and dispatch CENTERED / OFF_CENTER / DROPOUT / REGAINED / RELOCKED. */
+    void deriveSensorEvents(const SensorReading &r);
+
+    void runEntry(TurretState s);
+    void runExit(TurretState s);
+
+    static void enterTracking(TurretStateMachine &m);
+    static void exitTracking(TurretStateMachine &m);
+    static void enterAcquiring(TurretStateMachine &m);
+    static void enterLocked(TurretStateMachine &m);
+    static void enterCoasting(TurretStateMachine &m);
+    static void enterSearching(TurretStateMachine &m);
+    static void enterParked(TurretStateMachine &m);
+
+    static void tickTracker(TurretStateMachine &m, const SensorReading &r);
+    static void tickCoasting(TurretStateMachine &m, const SensorReading &r);
+    static void tickSearching(TurretStateMachine &m, const SensorReading &r);
+    static void tickParked(TurretStateMachine &m, const SensorReading &r);
+};
+
+#endif // TURRET_FSM_H
@@ -0,0 +1,114 @@
+/**
+ * @file elf_symbols.cpp
+ * @brief ElfSymbols: a minimal .symtab reader.
+ */
+
+#include "elf_symbols.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <cxxabi.h>
+
+namespace {
+
+constexpr uint32_t SHT_SYMTAB_ = 2;
+constexpr uint8_t  STT_FUNC_   = 2;
+
+/** Little-endian field of @p n bytes at @p off; 0 past the end. */
+uint64_t field(const std::vector<uint8_t> &f, uint64_t off, unsigned n) {
+    if (off + n > f.size()) return 0;
+    uint64_t v = 0;
+    for (unsigned i = 0; i < n; i++) v |= static_cast<uint64_t>(f[off + i]) << (8 * i);
+    return v;
+}
+
+std::string demangle(const char *name) {
+    int status = 0;
+    char *d = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status != 0 || !d) return name;
+    std::string s(d);
+    free(d);
+    return s;
+}
+
+}  // namespace
+
+bool ElfSymbols::load(const char *path, std::string &err) {
+    functions_.clear();
+
+    FILE *in = fopen(path, "rb");
+    if (!in) {
+        err = "cannot open";
+        return false;
+    }
+    std::vector<uint8_t> f;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) f.insert(f.end(), buf, buf + n);
+    fclose(in);
+
+    if (f.size() < 64 || memcmp(f.data(), "\x7f" "ELF", 4) != 0) {
+        err = "not an ELF file";
+        return false;
+    }
+    if (f[5] != 1) {
+        err = "big-endian ELF";
+        return false;
+    }
+    const bool wide = (f[4] == 2);   // ELFCLASS64
+
+    // Header and entry layouts, ELF32 vs ELF64.
+    const uint64_t shoff     = wide ? field(f, 0x28, 8) : field(f, 0x20, 4);
+    const uint64_t shentsize = field(f, wide ? 0x3A : 0x2E, 2);
+    const uint64_t shnum     = field(f, wide ? 0x3C : 0x30, 2);
+    const unsigned addrBytes = wide ? 8 : 4;
+
+    auto shType   = [&](uint64_t s) { return field(f, s + 4, 4); };
+    auto shOffset = [&](uint64_t s) { return field(f, s + (wide ? 24 : 16), addrBytes); };
+    auto shSize   = [&](uint64_t s) { return field(f, s + (wide ? 32 : 20), addrBytes); };
+    auto shLink   = [&](uint64_t s) { return field(f, s + (wide ? 40 : 24), 4); };
+
+    bool found = false;
+    for (uint64_t i = 0; i < shnum; i++) {
+        uint64_t sh = shoff + i * shentsize;
+        if (shType(sh) != SHT_SYMTAB_) continue;
+        found = true;
+
+        uint64_t strSh   = shoff + shLink(sh) * shentsize;
+        uint64_t strOff  = shOffset(strSh);
+        uint64_t strSize = shSize(strSh);
+        uint64_t symOff  = shOffset(sh);
+        uint64_t symEnt  = wide ? 24 : 16;
+        uint64_t count   = shSize(sh) / symEnt;
+
+        for (uint64_t k = 0; k < count; k++) {
+            uint64_t s     = symOff + k * symEnt;
+            uint64_t name  = field(f, s, 4);
+            uint8_t  info  = static_cast<uint8_t>(field(f, s + (wide ? 4 : 12), 1));
+            uint64_t shndx = field(f, s + (wide ? 6 : 14), 2);
+            uint64_t size  = wide ? field(f, s + 16, 8) : field(f, s + 8, 4);
+            if ((info & 0x0F) != STT_FUNC_ || shndx == 0 || size == 0) continue;
+            if (name >= strSize || strOff + strSize > f.size()) continue;
+
+            const char *raw = reinterpret_cast<const char *>(&f[strOff + name]);
+            if (!memchr(raw, '\0', strSize - name)) continue;
+            functions_.push_back({demangle(raw), static_cast<uint32_t>(size)});
+        }
+    }
+    if (!found) {
+        err = "no symbol table (stripped?)";
+        return false;
+    }
+    return true;
+}
+
+uint32_t ElfSymbols::sizeOf(const char *qualified) const {
+    size_t len = strlen(qualified);
+    uint32_t total = 0;
+    for (const Function &fn : functions_) {
+        if (fn.name.compare(0, len, qualified) == 0 && fn.name.size() > len && fn.name[len] == '(') {
+            total += fn.bytes;
+        }
+    }
+    return total;
+}
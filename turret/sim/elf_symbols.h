@@ -0,0 +1,44 @@
+/**
+ * @file elf_symbols.h
+ * @brief Function sizes from an ELF file's symbol table.
+ *
+ * Reads .symtab of an object or linked image, 32- or 64-bit,
+ * little-endian: the ESP32 firmware (.pio/build/esp32/firmware.elf,
+ * Xtensa, built -Os) as well as host objects.  Names are demangled.
+ * No binutils needed, and no toolchain for the target's architecture.
+ *
+ * A function the compiler inlined everywhere has no symbol; one it
+ * cloned (".constprop", ".isra", ".part") has one per clone, each named
+ * with a " [clone ...]" suffix.  sizeOf() sums a function's clones.
+ */
+
+#ifndef ELF_SYMBOLS_H
+#define ELF_SYMBOLS_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class ElfSymbols {
+public:
+    struct Function {
+        std::string name;    ///< Demangled
+        uint32_t    bytes;
+    };
+
+    /** @brief Load @p path; false (and @p err) if it is not a readable ELF. */
+    bool load(const char *path, std::string &err);
+
+    const std::vector<Function> &functions() const { return functions_; }
+
+    /**
+     * @brief Bytes of every function named @p qualified ("Class::method"),
+     *        any overload or clone; 0 if none (inlined, or not linked).
+     */
+    uint32_t sizeOf(const char *qualified) const;
+
+private:
+    std::vector<Function> functions_;
+};
+
+#endif // ELF_SYMBOLS_H
@@ -0,0 +1,134 @@
+/**
+ * @file micro_bench.cpp
+ * @brief MicroBench: run loop, statistics and the instruction counter.
+ */
+
+#include "micro_bench.h"
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/** Retired user-space instructions of this thread; fd < 0 if unavailable. */
+class InsnCounter {
+public:
+    InsnCounter() {
+#ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.size           = sizeof(attr);
+        attr.config         = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        err_ = fd_ < 0 ? errno : 0;
+#endif
+    }
+
+    ~InsnCounter() {
+#ifdef __linux__
+        if (fd_ >= 0) close(fd_);
+#endif
+    }
+
+    InsnCounter(const InsnCounter &) = delete;
+    InsnCounter &operator=(const InsnCounter &) = delete;
+
+    bool ok() const { return fd_ >= 0; }
+
+    /** errno of the failed open; 0 if ok(). */
+    int error() const { return err_; }
+
+    void start() {
+#ifdef __linux__
+        if (fd_ < 0) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    /** Count since start(); 0 if unavailable. */
+    uint64_t stop() {
+        uint64_t n = 0;
+#ifdef __linux__
+        if (fd_ < 0) return 0;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd_, &n, sizeof(n)) != static_cast<ssize_t>(sizeof(n))) n = 0;
+#endif
+        return n;
+    }
+
+private:
+    int fd_  = -1;
+    int err_ = ENOSYS;
+};
+
+}  // namespace
+
+bool MicroBench::countersAvailable(int *err) {
+    InsnCounter c;
+    if (err) *err = c.error();
+    return c.ok();
+}
+
+void MicroBench::measure(const char *name, MicroBody body, void *ctx,
+                         const MicroConfig &cfg, MicroResult &out) {
+    typedef std::chrono::steady_clock Clock;
+
+    out      = MicroResult();
+    out.name = name;
+    if (cfg.runs == 0 || cfg.opsPerRun == 0) return;
+
+    for (uint32_t r = 0; r < cfg.warmupRuns; r++) body(ctx, cfg.opsPerRun);
+
+    // Timed and counted in separate runs: the counter's ioctls would
+    // otherwise land inside the timed window.
+    std::vector<double> ns(cfg.runs);
+    for (uint32_t r = 0; r < cfg.runs; r++) {
+        Clock::time_point t0 = Clock::now();
+        body(ctx, cfg.opsPerRun);
+        Clock::time_point t1 = Clock::now();
+        ns[r] = std::chrono::duration<double, std::nano>(t1 - t0).count() / cfg.opsPerRun;
+    }
+    out.nsMin    = *std::min_element(ns.begin(), ns.end());
+    out.nsMedian = median(ns);
+    out.nsMad    = mad(ns, out.nsMedian);
+
+    if (!cfg.countInsns) return;
+    InsnCounter counter;
+    if (!counter.ok()) return;
+    std::vector<double> insns(cfg.runs);
+    for (uint32_t r = 0; r < cfg.runs; r++) {
+        counter.start();
+        body(ctx, cfg.opsPerRun);
+        insns[r] = static_cast<double>(counter.stop()) / cfg.opsPerRun;
+    }
+    out.insnsPerOp = median(insns);
+}
+
+double MicroBench::median(std::vector<double> &v) {
+    if (v.empty()) return 0.0;
+    size_t mid = v.size() / 2;
+    std::nth_element(v.begin(), v.begin() + mid, v.end());
+    double hi = v[mid];
+    if (v.size() % 2) return hi;
+    double lo = *std::max_element(v.begin(), v.begin() + mid);
+    return 0.5 * (lo + hi);
+}
+
+double MicroBench::mad(std::vector<double> &v, double med) {
+    for (double &x : v) x = fabs(x - med);
+    return median(v);
+}
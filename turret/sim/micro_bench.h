@@ -0,0 +1,77 @@
+/**
+ * @file micro_bench.h
+ * @brief Timing of single functions on the host: warmup, repeated runs,
+ *        median and MAD per call, and retired instructions where the
+ *        kernel exposes a counter.
+ *
+ * A body makes @p ops calls of the function under test, inputs cycling
+ * through a table the caller prepared, so neither the compiler nor the
+ * branch predictor sees one constant argument.  measure() runs the body
+ * MicroConfig::warmupRuns times untimed (caches, predictors, the CPU
+ * clocking up), then MicroConfig::runs times timed, and reports
+ *
+ *     nsMedian    median over the runs of (run time / ops)
+ *     nsMad       median absolute deviation of the same, in ns: the
+ *                 spread, unmoved by the odd run an interrupt landed in
+ *     insnsPerOp  median retired user-space instructions per call, from
+ *                 perf_event_open() (Linux); < 0 where that is not
+ *                 available (other hosts, perf_event_paranoid, containers)
+ *                 or MicroConfig::countInsns is off
+ *
+ * Figures include the body's own loop and input fetch; time an empty
+ * body the same way and subtract it to compare against the target.
+ */
+
+#ifndef MICRO_BENCH_H
+#define MICRO_BENCH_H
+
+#include <stdint.h>
+#include <vector>
+
+/** @brief Run @p ops calls of the function under test. */
+typedef void (*MicroBody)(void *ctx, uint32_t ops);
+
+/** @brief How to time one function. */
+struct MicroConfig {
+    uint32_t warmupRuns = 5;
+    uint32_t runs       = 31;
+    uint32_t opsPerRun  = 20000;
+    bool     countInsns = true;    ///< Count runs too, where there is a counter
+};
+
+/** @brief One function's figures. */
+struct MicroResult {
+    const char *name       = nullptr;
+    double      nsMedian   = 0.0;
+    double      nsMad      = 0.0;
+    double      nsMin      = 0.0;
+    double      insnsPerOp = -1.0;   ///< < 0 without a counter
+};
+
+class MicroBench {
+public:
+    /**
+     * @brief Whether an instruction counter could be opened here.
+     * @param err  If not null, set to the errno of the failed open
+     *             (ENOSYS off Linux); 0 when available.
+     */
+    static bool countersAvailable(int *err = nullptr);
+
+    /** @brief Time @p body (see the file comment). */
+    static void measure(const char *name, MicroBody body, void *ctx,
+                        const MicroConfig &cfg, MicroResult &out);
+
+    /** @brief Median of @p v (reordered). */
+    static double median(std::vector<double> &v);
+
+    /** @brief Median absolute deviation of @p v about @p med (reordered). */
+    static double mad(std::vector<double> &v, double med);
+
+    /** @brief Stop the compiler discarding @p v (a function's result). */
+    static void consume(uint32_t v) { sink_ = sink_ + v; }
+
+private:
+    static inline volatile uint32_t sink_ = 0;
+};
+
+#endif // MICRO_BENCH_H
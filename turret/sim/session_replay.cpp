@@ -0,0 +1,155 @@
+/**
+ * @file session_replay.cpp
+ * @brief Captured session → firmware modules → telemetry records.
+ */
+
+#include "session_replay.h"
+#include "pipeline.h"
+#include "hal.h"
+
+const char *const SessionReplay::FIELD_NAMES[FIELD_COUNT] = {
+    "filtered", "state", "pan_cmd", "pan_pos", "tilt"
+};
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+void SessionReplay::begin(const CaptureHeader &h) {
+    HostHal::reset();
+    HostHal::advanceUs(h.bootUs);
+    HostHal::setPinReader(readPin, this);
+    HostHal::setLatchReader(readLatch, this);
+    pinBits_  = 0;
+    clamps_   = 0;
+    seq_      = 0;
+    rawBits_  = 0;
+    filtered_ = SensorReading{};
+
+    // main.cpp setup(), in its order.
+    sensors_.init();
+    pan_.init();
+    tilt_.init();
+    tracker_.init(&pan_, &tilt_);
+    parker_.init(&pan_, &tilt_);
+    prior_.load(h.prior, h.priorLen);
+    search_.init(&pan_, &tilt_, &prior_);
+    monitor_.init();
+
+    TurretContext ctx;
+    ctx.sensors = &sensors_;
+    ctx.pan     = &pan_;
+    ctx.tilt    = &tilt_;
+    ctx.tracker = &tracker_;
+    ctx.monitor = &monitor_;
+    ctx.parker  = &parker_;
+    ctx.prior   = &prior_;
+    ctx.search  = &search_;
+    fsm_.init(ctx);
+
+    sched_.init();
+    sched_.every(PRIOR_AGE_INTERVAL_MS, agePrior, this, PRIOR_AGE_INTERVAL_MS);
+    monitor_.setScheduler(&sched_);
+}
+
+TelemetryRecord SessionReplay::tick(const CaptureTick &t) {
+    // --- Capture task: one SensorArray::update() per sample ---
+    uint8_t       rawHits[CaptureTick::MAX_SAMPLES];
+    SensorReading filtered[CaptureTick::MAX_SAMPLES];
+    for (uint8_t i = 0; i < t.samples; i++) {
+        clockTo(t.sample[i].tUs);
+        pinBits_ = t.sample[i].rawBits;
+        sensors_.update();
+        rawHits[i]  = sensors_.getRawHits();
+        filtered[i] = sensors_.getFiltered();
+    }
+
+    // --- Control task: jobs that fell due between ticks ran before it ---
+    clockTo(t.rec.tUs - 1);
+    sched_.runDue();
+    clockTo(t.rec.tUs);
+
+    bool transition = false;
+    for (uint8_t i = 0; i < t.samples; i++) {
+        monitor_.updateEvidence(rawHits[i]);
+        fsm_.update(filtered[i]);
+        if (monitor_.stateChanged()) monitor_.updateStatusLED();
+        transition |= fsm_.changed();
+    }
+    if (t.samples > 0) {
+        seq_      = t.sample[t.samples - 1].seq;
+        rawBits_  = t.sample[t.samples - 1].rawBits & 0x0F;
+        filtered_ = filtered[t.samples - 1];
+    }
+
+    pan_.updatePosition(t.dtMs);
+    pan_.serviceOutput();
+    tilt_.serviceOutput();
+    sched_.runDue();
+
+    TelemetryFrame f;
+    f.tUs        = t.rec.tUs;
+    f.seq        = seq_;
+    f.state      = fsm_.state();
+    f.transition = transition;
+    f.panDeg     = pan_.getPositionDeg();
+    f.tiltDeg    = tilt_.getAngle();
+    f.reading    = filtered_;
+    f.rawBits    = rawBits_;
+    f.panCmd     = pan_.getSpeed();
+    return f.record();
+}
+
+uint8_t SessionReplay::compare(const TelemetryRecord &recorded, const TelemetryRecord &replayed) {
+    uint8_t diff = 0;
+    if (recorded.filtered != replayed.filtered) diff |= 1u << FILTERED;
+    if (recorded.state != replayed.state || recorded.transition != replayed.transition) {
+        diff |= 1u << STATE;
+    }
+    if (recorded.panCmd  != replayed.panCmd)  diff |= 1u << PAN_CMD;
+    if (recorded.panCdeg != replayed.panCdeg) diff |= 1u << PAN_POS;
+    if (recorded.tiltDeg != replayed.tiltDeg) diff |= 1u << TILT;
+    return diff;
+}
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+void SessionReplay::clockTo(uint32_t tUs) {
+    // The low 32 bits of the 64-bit clock are the turret's micros().
+    int32_t d = static_cast<int32_t>(tUs - static_cast<uint32_t>(HostHal::nowUs()));
+    if (d > 0) {
+        HostHal::advanceUs(static_cast<unsigned long>(d));
+    } else if (d < 0) {
+        clamps_++;
+    }
+}
+
+uint8_t SessionReplay::sensorBit(uint8_t pin) {
+    switch (pin) {
+        case PIN_SENSOR_TOP:    return 0;
+        case PIN_SENSOR_BOTTOM: return 1;
+        case PIN_SENSOR_LEFT:   return 2;
+        case PIN_SENSOR_RIGHT:  return 3;
+        default:                return 0xFF;
+    }
+}
+
+int SessionReplay::readPin(uint8_t pin, void *self) {
+    const SessionReplay *r = static_cast<const SessionReplay *>(self);
+    uint8_t bit = sensorBit(pin);
+    if (bit == 0xFF) return HIGH;
+    return (r->pinBits_ & (1u << (bit + 4))) ? LOW : HIGH;   // LOW at the sample
+}
+
+bool SessionReplay::readLatch(uint8_t pin, uint64_t, uint64_t, void *self) {
+    const SessionReplay *r = static_cast<const SessionReplay *>(self);
+    uint8_t bit = sensorBit(pin);
+    if (bit == 0xFF) return false;
+    return (r->pinBits_ & (1u << bit)) != 0;                  // Latched since the last
+}
+
+void SessionReplay::agePrior(void *self) {
+    static_cast<SessionReplay *>(self)->prior_.age();
+}
@@ -0,0 +1,102 @@
+/**
+ * @file session_replay.h
+ * @brief A captured session (session_capture.h) back through the
+ *        firmware modules, on HostHal's clock.
+ *
+ * SessionReplay builds the modules as main.cpp's setup() does and, per
+ * captured tick, does what the capture and control tasks did with the
+ * same inputs at the same (virtual) times:
+ *
+ *   each sample   clock to its tUs, sensor pins to its raw bits,
+ *                 SensorArray::update()
+ *   the tick      scheduled jobs due before it; then per sample
+ *                 SignalMonitor::updateEvidence() and the state machine
+ *                 (TrackingEngine, SearchPlanner, ParkPlanner through
+ *                 it), status LED; dead reckoning over dtMs, servo
+ *                 output stages, scheduled jobs
+ *
+ * and returns the telemetry record the firmware would have sent.
+ * compare() says which fields differ from the recorded one.  Nothing
+ * waits, so an hour of session takes a second or so.
+ *
+ * What the replay cannot know: the few milliseconds setup() spends
+ * between the header and each module's init (timeouts measured from
+ * boot shift by that much), where inside a tick the firmware read the
+ * clock (it uses the tick start for all of them), and the inputs of a
+ * tick whose frame was lost.  A sequence gap in the samples marks the
+ * latter; expect differences after one.
+ *
+ * Config tunables (TURRET_TUNABLE) are read at begin(); set them first
+ * to see what a change would have done to the recorded session.  That
+ * is open loop: the recorded sensors do not answer the new commands.
+ *
+ * One replay per process: the modules run on the global HostHal.
+ */
+
+#ifndef SESSION_REPLAY_H
+#define SESSION_REPLAY_H
+
+#include <stdint.h>
+#include "session_capture.h"
+#include "turret_fsm.h"
+#include "scheduler.h"
+
+class SessionReplay {
+public:
+    /** @brief Compared record fields, as bits of compare()'s result. */
+    enum Field : uint8_t {
+        FILTERED,     ///< Filtered sensor states
+        STATE,        ///< Turret state and transition flag
+        PAN_CMD,      ///< Commanded pan speed (1e-4 of full scale)
+        PAN_POS,      ///< Dead-reckoned pan position (0.01°)
+        TILT,         ///< Tilt angle
+        FIELD_COUNT
+    };
+
+    static const char *const FIELD_NAMES[FIELD_COUNT];
+
+    /** @brief Reset HostHal and initialise the modules from @p h, as setup() would. */
+    void begin(const CaptureHeader &h);
+
+    /** @brief Replay one tick.  @return The record the firmware would have sent (loopUs 0). */
+    TelemetryRecord tick(const CaptureTick &t);
+
+    /** @brief Fields of @p replayed that differ from @p recorded, one bit per Field. */
+    static uint8_t compare(const TelemetryRecord &recorded, const TelemetryRecord &replayed);
+
+    /** @brief Timestamps earlier than the clock already was (replayed at the clock). */
+    uint32_t clockClamps() const { return clamps_; }
+
+    TurretStateMachine &fsm() { return fsm_; }
+    const SignalMonitor &monitor() const { return monitor_; }
+
+private:
+    SensorArray        sensors_;
+    PanController      pan_;
+    TiltController     tilt_;
+    TrackingEngine     tracker_;
+    SignalMonitor      monitor_;
+    ParkPlanner        parker_;
+    BearingPrior       prior_;
+    SearchPlanner      search_;
+    TurretStateMachine fsm_;
+    Scheduler          sched_;
+
+    uint8_t       pinBits_ = 0;          ///< Captured sample the sensor pins replay
+    uint32_t      clamps_  = 0;
+    uint16_t      seq_     = 0;          ///< Newest sample consumed
+    uint8_t       rawBits_ = 0;          ///< ... its raw bits
+    SensorReading filtered_ = {};        ///< ... and filtered reading
+
+    /** @brief Clock to captured @p tUs, unwrapping micros() rollover. */
+    void clockTo(uint32_t tUs);
+
+    /** @brief CaptureSample::rawBits bit of sensor @p pin, or 0xFF. */
+    static uint8_t sensorBit(uint8_t pin);
+
+    static int readPin(uint8_t pin, void *self);
+    static bool readLatch(uint8_t pin, uint64_t fromUs, uint64_t toUs, void *self);
+    static void agePrior(void *self);
+};
+
+#endif // SESSION_REPLAY_H
@@ -0,0 +1,12 @@
+/**
+ * @file esp_attr.h
+ * @brief Simulator stand-in: no RTC memory, so no-init data is a plain
+ *        (zeroed) static and every run is a power-on.
+ */
+
+#ifndef SIM_ESP_ATTR_H
+#define SIM_ESP_ATTR_H
+
+#define RTC_NOINIT_ATTR
+
+#endif // SIM_ESP_ATTR_H
@@ -0,0 +1,17 @@
+/**
+ * @file esp_task_wdt.h
+ * @brief Simulator stand-in for the task watchdog (never fires: the
+ *        simulated control loop cannot stall in virtual time).
+ */
+
+#ifndef SIM_ESP_TASK_WDT_H
+#define SIM_ESP_TASK_WDT_H
+
+#include <stdint.h>
+#include "esp_system.h"
+
+inline esp_err_t esp_task_wdt_init(uint32_t, bool) { return ESP_OK; }
+inline esp_err_t esp_task_wdt_add(void *) { return ESP_OK; }
+inline esp_err_t esp_task_wdt_reset() { return ESP_OK; }
+
+#endif // SIM_ESP_TASK_WDT_H
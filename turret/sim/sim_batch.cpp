@@ -0,0 +1,601 @@
+/**
+ * @file sim_batch.cpp
+ * @brief Structure-of-arrays kernels and the scalar reference lane.
+ *
+ * Kernels are plain loops over lanes with branch-free bodies (selects,
+ * not ifs), so the compiler vectorizes them.  Config values and array
+ * bases are copied into locals first: a store through a uint8_t pointer
+ * may alias any global, which would force a reload per lane.  Lanes
+ * never share storage, which LANE_LOOP tells the compiler — it cannot
+ * prove it for a dozen arrays and would otherwise give up rather than
+ * emit the runtime overlap checks.
+ */
+
+#include "sim_batch.h"
+#include "hal.h"
+#include <math.h>
+
+#if defined(__clang__)
+#define LANE_LOOP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define LANE_LOOP _Pragma("GCC ivdep")
+#else
+#define LANE_LOOP
+#endif
+
+namespace {
+
+constexpr uint8_t TRACKING_ST  = static_cast<uint8_t>(MonitorState::TRACKING);
+constexpr uint8_t SEARCHING_ST = static_cast<uint8_t>(MonitorState::SEARCHING);
+constexpr uint8_t PARKED_ST    = static_cast<uint8_t>(MonitorState::PARKED);
+
+/** On-target band for the statistics (as SimRun::ACQUIRED_DEG). */
+constexpr float ON_TARGET_DEG = 5.0f;
+
+inline uint32_t xorshift(uint32_t x) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+/** Uniform in [lo, hi) from the top 24 bits of @p r. */
+inline float uniform(uint32_t r, float lo, float hi) {
+    return lo + static_cast<float>(r >> 8) * (1.0f / 16777216.0f) * (hi - lo);
+}
+
+/** Per-lane seed: splitmix64 of (seed, lane), never 0 (xorshift's fixed point). */
+uint32_t laneSeed(uint32_t seed, uint32_t lane) {
+    uint64_t z = (static_cast<uint64_t>(seed) << 32 | lane) + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    uint32_t s = static_cast<uint32_t>(z);
+    return s ? s : 1;
+}
+
+/** 1 if @p a < @p b, else 0 (both below 2^31): the borrow bit, no bool. */
+inline uint32_t below(uint32_t a, uint32_t b) {
+    return (a - b) >> 31;
+}
+
+/** @p a if @p cond (0 or 1), else @p b, as a blend rather than a branch. */
+inline uint32_t pick(uint32_t cond, uint32_t a, uint32_t b) {
+    return b ^ ((a ^ b) & (0u - cond));
+}
+
+/** @p v limited to [lo, hi], by blends: SSE2 has no 32-bit min/max. */
+inline int32_t clampInt(int32_t v, int32_t lo, int32_t hi) {
+    v = static_cast<int32_t>(pick(v < lo, static_cast<uint32_t>(lo), static_cast<uint32_t>(v)));
+    v = static_cast<int32_t>(pick(v > hi, static_cast<uint32_t>(hi), static_cast<uint32_t>(v)));
+    return v;
+}
+
+/** TiltController::setAngle()'s clamp.  Angles stay far inside int16_t. */
+inline int32_t clampTilt(int32_t d) {
+    return clampInt(d, TILT_MIN_DEG, TILT_MAX_DEG);
+}
+
+/** TiltController::stepToward(), as a value. */
+inline int32_t stepToward(int32_t angle, int32_t target, int32_t maxStep) {
+    int32_t error = clampInt(clampTilt(target) - angle, -maxStep, maxStep);
+    return clampTilt(angle + error);
+}
+
+inline uint8_t popcount8(uint8_t x) {
+    x = x - ((x >> 1) & 0x55);
+    x = (x & 0x33) + ((x >> 2) & 0x33);
+    return (x + (x >> 4)) & 0x0F;
+}
+
+}  // namespace
+
+// ===================================================================
+// SimBatch — public API
+// ===================================================================
+
+void SimBatch::init(uint32_t lanes, const Params &params) {
+    p_      = params;
+    lanes_  = lanes;
+    padded_ = (lanes + LANE_ALIGN - 1) / LANE_ALIGN * LANE_ALIGN;
+    ticks_  = 0;
+    const uint32_t n = padded_;
+
+    filterMask_ = static_cast<uint8_t>((1 << SENSOR_FILTER_WINDOW) - 1);
+    llrHit_     = logf(SPRT_P_HIT_PRESENT / SPRT_P_HIT_ABSENT);
+    llrMiss_    = logf((1.0f - SPRT_P_HIT_PRESENT) / (1.0f - SPRT_P_HIT_ABSENT));
+    llrPresent_ = logf((1.0f - SPRT_BETA) / SPRT_ALPHA);
+    llrAbsent_  = logf(SPRT_BETA / (1.0f - SPRT_ALPHA));
+
+    rng_.assign(n, 1);
+    az_.assign(n, 0.0f);
+    vel_.assign(n, 0.0f);
+    el_.assign(n, 0.0f);
+    truePan_.assign(n, 0.0f);
+    trueRate_.assign(n, PAN_DEG_PER_SEC);
+    present_.assign(n, 1);
+    remainTicks_.assign(n, 1);
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t r = laneSeed(p_.seed, i);
+        r = xorshift(r);
+        az_[i] = uniform(r, -p_.beaconAzMaxDeg, p_.beaconAzMaxDeg);
+        r = xorshift(r);
+        vel_[i] = uniform(r, p_.beaconSpeedMin, p_.beaconSpeedMax) * ((r & 1) ? 1.0f : -1.0f);
+        r = xorshift(r);
+        el_[i] = uniform(r, p_.beaconElMin, p_.beaconElMax);
+        r = xorshift(r);
+        trueRate_[i] = PAN_DEG_PER_SEC * (1.0f + uniform(r, -p_.panRateErrMax, p_.panRateErrMax));
+        r = xorshift(r);
+        remainTicks_[i] = 1 + static_cast<uint32_t>(uniform(r, p_.presentMinS, p_.presentMaxS) *
+                                                    (1000.0f / LOOP_PERIOD_MS));
+        rng_[i] = xorshift(r);
+    }
+
+    rawBits_.assign(n, 0);
+    rawHits_.assign(n, 0);
+    activeBits_.assign(n, 0);
+    satBits_.assign(n, 0);
+    for (uint8_t s = 0; s < 4; s++) {
+        window_[s].assign(n, 0);
+        lowRunMs_[s].assign(n, 0);
+    }
+
+    state_.assign(n, TRACKING_ST);
+    for (uint8_t s = 0; s < 4; s++) {
+        llr_[s].assign(n, llrPresent_);
+    }
+    lastSignalMs_.assign(n, 0);
+    absenceMs_.assign(n, 0);
+    absenceEnded_.assign(n, 0);
+    absence_.assign(static_cast<size_t>(n) * ABSENCE_BINS, 0);
+    uint32_t park, hold;
+    SignalMonitor::deriveTimeouts(absence_.data(), true, park, hold);
+    parkMs_.assign(n, park);
+    holdMs_.assign(n, hold);
+
+    // TrackingEngine::init() at millis() 0: neither side seen recently.
+    lastLeftMs_.assign(n, 0u - TRACK_APPROACH_MEMORY_MS);
+    lastRightMs_.assign(n, 0u - TRACK_APPROACH_MEMORY_MS);
+    sweepCW_.assign(n, 1);
+
+    panPos_.assign(n, 0.0f);
+    panSpeed_.assign(n, 0.0f);
+    tilt_.assign(n, TILT_HOME_DEG);
+    tiltStepMs_.assign(n, 0);
+
+    presentTicks_.assign(n, 0);
+    onTargetTicks_.assign(n, 0);
+    trackingTicks_.assign(n, 0);
+    falseTrackTicks_.assign(n, 0);
+    parkedTicks_.assign(n, 0);
+    sqErr_.assign(n, 0.0f);
+}
+
+void SimBatch::step() {
+    uint32_t now = ticks_ * LOOP_PERIOD_MS;
+    sense();
+    filter();
+    monitor(now);
+    control(now);
+    move();
+    ticks_++;
+}
+
+SimBatchTotals SimBatch::totals() const {
+    double present = 0, onTarget = 0, tracking = 0, falseTrack = 0, parked = 0, sq = 0;
+    for (uint32_t i = 0; i < lanes_; i++) {
+        present    += presentTicks_[i];
+        onTarget   += onTargetTicks_[i];
+        tracking   += trackingTicks_[i];
+        falseTrack += falseTrackTicks_[i];
+        parked     += parkedTicks_[i];
+        sq         += sqErr_[i];
+    }
+    double all    = static_cast<double>(ticks_) * lanes_;
+    double absent = all - present;
+
+    SimBatchTotals t;
+    t.presentS      = present * LOOP_PERIOD_MS / 1000.0;
+    t.onTargetPct   = present > 0 ? 100.0 * onTarget / present : 0.0;
+    t.trackingPct   = present > 0 ? 100.0 * tracking / present : 0.0;
+    t.falseTrackPct = absent > 0 ? 100.0 * falseTrack / absent : 0.0;
+    t.rmsErrDeg     = present > 0 ? sqrt(sq / present) : 0.0;
+    t.parkedPct     = all > 0 ? 100.0 * parked / all : 0.0;
+    return t;
+}
+
+SensorState SimBatch::sensorState(uint32_t lane, uint8_t sensor) const {
+    if (satBits_[lane] & (1u << sensor))    return SensorState::SATURATED;
+    if (activeBits_[lane] & (1u << sensor)) return SensorState::ACTIVE;
+    return SensorState::INACTIVE;
+}
+
+float SimBatch::logLikelihood(uint32_t lane) const {
+    float best = llr_[0][lane];
+    for (uint8_t s = 1; s < 4; s++) {
+        if (llr_[s][lane] > best) best = llr_[s][lane];
+    }
+    return best;
+}
+
+// ===================================================================
+// SimBatch — kernels
+// ===================================================================
+
+void SimBatch::sense() {
+    const uint32_t n        = padded_;
+    const float    ov       = p_.centerOverlapDeg;
+    const uint32_t hitThr   = static_cast<uint32_t>(p_.pHit * 65536.0f);
+    const uint32_t noiseThr = static_cast<uint32_t>(p_.pNoise * 65536.0f);
+
+    uint32_t       *__restrict rng      = rng_.data();
+    uint8_t        *__restrict raw      = rawBits_.data();
+    const float    *__restrict az       = az_.data();
+    const float    *__restrict el       = el_.data();
+    const float    *__restrict truePan  = truePan_.data();
+    const int16_t  *__restrict tilt     = tilt_.data();
+    const uint8_t  *__restrict present  = present_.data();
+    const uint8_t  *__restrict state    = state_.data();
+    uint32_t       *__restrict presentT = presentTicks_.data();
+    uint32_t       *__restrict onTarget = onTargetTicks_.data();
+    uint32_t       *__restrict tracking = trackingTicks_.data();
+    uint32_t       *__restrict falseTr  = falseTrackTicks_.data();
+    uint32_t       *__restrict parked   = parkedTicks_.data();
+    float          *__restrict sqErr    = sqErr_.data();
+
+    LANE_LOOP
+    for (uint32_t i = 0; i < n; i++) {
+        float d = az[i] - truePan[i];
+        float e = el[i] - static_cast<float>(tilt[i]);
+        uint32_t pres = present[i];
+
+        // SimWorld::inViewBits(): FOV, then which side of the dividers.
+        uint32_t view = pres & (fabsf(d) <= SENSOR_FOV_PAN_HALF_DEG) &
+                        (fabsf(e) <= SENSOR_FOV_TILT_HALF_DEG);
+        uint32_t side = static_cast<uint32_t>(e >= -ov)      |
+                        static_cast<uint32_t>(e <=  ov) << 1 |
+                        static_cast<uint32_t>(d <=  ov) << 2 |
+                        static_cast<uint32_t>(d >= -ov) << 3;
+        uint32_t seen = side & (0u - view);
+
+        // Per sensor: hit (top 16 bits) if seen, or noise (low 16).
+        uint32_t x = rng[i], bits = 0;
+        x = xorshift(x); bits |= (((seen >> 0) & below(x >> 16, hitThr)) | below(x & 0xFFFF, noiseThr)) << 0;
+        x = xorshift(x); bits |= (((seen >> 1) & below(x >> 16, hitThr)) | below(x & 0xFFFF, noiseThr)) << 1;
+        x = xorshift(x); bits |= (((seen >> 2) & below(x >> 16, hitThr)) | below(x & 0xFFFF, noiseThr)) << 2;
+        x = xorshift(x); bits |= (((seen >> 3) & below(x >> 16, hitThr)) | below(x & 0xFFFF, noiseThr)) << 3;
+        rng[i] = x;
+        raw[i] = static_cast<uint8_t>(bits);
+
+        // Statistics on the pose the firmware is reacting to.
+        uint32_t trk = state[i] == TRACKING_ST;
+        presentT[i] += pres;
+        onTarget[i] += pres & (fabsf(d) <= ON_TARGET_DEG);
+        tracking[i] += pres & trk;
+        falseTr[i]  += (pres ^ 1) & trk;
+        parked[i]   += state[i] == PARKED_ST;
+        sqErr[i]    += pres ? d * d : 0.0f;
+    }
+}
+
+void SimBatch::filter() {
+    const uint32_t n       = padded_;
+    const uint8_t  mask    = filterMask_;
+    const uint8_t  thresh  = SENSOR_FILTER_THRESHOLD;
+    const uint16_t satMs   = SENSOR_SATURATED_MS;
+    const uint16_t stepMs  = LOOP_PERIOD_MS;
+
+    const uint8_t *__restrict raw    = rawBits_.data();
+    uint8_t       *__restrict hits   = rawHits_.data();
+    uint8_t       *__restrict active = activeBits_.data();
+    uint8_t       *__restrict sat    = satBits_.data();
+
+    for (uint8_t s = 0; s < 4; s++) {
+        uint8_t  *__restrict win = window_[s].data();
+        uint16_t *__restrict low = lowRunMs_[s].data();
+        const bool first = (s == 0);
+
+        LANE_LOOP
+        for (uint32_t i = 0; i < n; i++) {
+            uint8_t a = (raw[i] >> s) & 1;
+
+            // pushSample(): the window's count, not its ring position, matters.
+            uint8_t w = static_cast<uint8_t>(((win[i] << 1) | a) & mask);
+            win[i] = w;
+
+            // Saturation: LOW run length; cleared by any HIGH.
+            uint16_t run = a ? static_cast<uint16_t>(low[i] + stepMs) : 0;
+            low[i] = run;
+            uint8_t wasSat = (sat[i] >> s) & 1;
+            uint8_t isSat  = a & (wasSat | (run >= satMs));
+
+            uint8_t h   = a & (isSat ^ 1);
+            uint8_t act = (isSat ^ 1) & (popcount8(w) >= thresh);
+
+            sat[i]    = static_cast<uint8_t>((sat[i] & ~(1u << s)) | (isSat << s));
+            hits[i]   = static_cast<uint8_t>((first ? 0 : hits[i]) | (h << s));
+            active[i] = static_cast<uint8_t>((first ? 0 : active[i]) | (act << s));
+        }
+    }
+}
+
+void SimBatch::monitor(uint32_t now) {
+    const uint32_t n       = padded_;
+    const float    hit     = llrHit_;
+    const float    miss    = llrMiss_;
+    const float    upper   = llrPresent_;
+    const float    lower   = llrAbsent_;
+
+    const uint8_t *__restrict hits       = rawHits_.data();
+    float         *__restrict llr0       = llr_[0].data();
+    float         *__restrict llr1       = llr_[1].data();
+    float         *__restrict llr2       = llr_[2].data();
+    float         *__restrict llr3       = llr_[3].data();
+    uint8_t       *__restrict state      = state_.data();
+    uint32_t      *__restrict lastSignal = lastSignalMs_.data();
+    const uint32_t *__restrict parkMs    = parkMs_.data();
+    uint32_t      *__restrict absenceMs  = absenceMs_.data();
+    uint8_t       *__restrict ended      = absenceEnded_.data();
+
+    uint32_t anyEnded = 0;
+    LANE_LOOP
+    for (uint32_t i = 0; i < n; i++) {
+        // One test per sensor; the best decides.
+        uint8_t h = hits[i];
+        float l0 = llr0[i] + ((h & 1) ? hit : miss);
+        float l1 = llr1[i] + ((h & 2) ? hit : miss);
+        float l2 = llr2[i] + ((h & 4) ? hit : miss);
+        float l3 = llr3[i] + ((h & 8) ? hit : miss);
+        l0 = (l0 > upper) ? upper : l0;  l0 = (l0 < lower) ? lower : l0;
+        l1 = (l1 > upper) ? upper : l1;  l1 = (l1 < lower) ? lower : l1;
+        l2 = (l2 > upper) ? upper : l2;  l2 = (l2 < lower) ? lower : l2;
+        l3 = (l3 > upper) ? upper : l3;  l3 = (l3 < lower) ? lower : l3;
+        llr0[i] = l0;
+        llr1[i] = l1;
+        llr2[i] = l2;
+        llr3[i] = l3;
+        float l = (l0 > l1) ? l0 : l1;
+        l = (l > l2) ? l : l2;
+        l = (l > l3) ? l : l3;
+
+        uint32_t st      = state[i];
+        uint32_t last    = lastSignal[i];
+        uint32_t since   = now - last;
+        uint32_t decided = l >= upper;
+
+        uint32_t fromTracking  = pick(l <= lower, SEARCHING_ST, TRACKING_ST);
+        uint32_t fromSearching = pick(since >= parkMs[i], PARKED_ST, SEARCHING_ST);
+        uint32_t undecided = pick(st == TRACKING_ST, fromTracking,
+                                  pick(st == SEARCHING_ST, fromSearching, st));
+
+        uint32_t e = decided & (st != TRACKING_ST);
+        ended[i]      = static_cast<uint8_t>(e);
+        absenceMs[i]  = since;
+        anyEnded     |= e;
+        lastSignal[i] = pick(decided, now, last);
+        state[i]      = static_cast<uint8_t>(pick(decided, TRACKING_ST, undecided));
+    }
+    if (!anyEnded) return;
+
+    // recordAbsence(): rare, lane by lane, with the monitor's own rule.
+    for (uint32_t i = 0; i < n; i++) {
+        if (!ended[i]) continue;
+        uint8_t *hist = &absence_[static_cast<size_t>(i) * ABSENCE_BINS];
+        SignalMonitor::countAbsence(hist, SignalMonitor::absenceBinFor(absenceMs[i]));
+        SignalMonitor::deriveTimeouts(hist, true, parkMs_[i], holdMs_[i]);
+    }
+}
+
+void SimBatch::control(uint32_t now) {
+    const uint32_t n          = padded_;
+    const float    fast       = TRACK_PAN_SPEED_FAST;
+    const float    slow       = TRACK_PAN_SPEED_SLOW;
+    const uint32_t memoryMs   = TRACK_APPROACH_MEMORY_MS;
+    const uint32_t holdoffMs  = TILT_HOLDOFF_MS;
+    const float    sweepSpeed = SEARCH_SWEEP_SPEED;
+    const int16_t  tiltStep   = TILT_STEP_DEG;
+
+    const uint8_t *__restrict state     = state_.data();
+    const uint8_t *__restrict active    = activeBits_.data();
+    const float   *__restrict panPos    = panPos_.data();
+    float         *__restrict panSpeed  = panSpeed_.data();
+    uint32_t      *__restrict lastLeft  = lastLeftMs_.data();
+    uint32_t      *__restrict lastRight = lastRightMs_.data();
+    uint8_t       *__restrict sweepCW   = sweepCW_.data();
+    int16_t       *__restrict tilt      = tilt_.data();
+    uint32_t      *__restrict tiltStepMs = tiltStepMs_.data();
+
+    LANE_LOOP
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t st     = state[i];
+        uint32_t act    = active[i];
+        uint32_t top    = act & 1;
+        uint32_t bottom = (act >> 1) & 1;
+        uint32_t left   = (act >> 2) & 1;
+        uint32_t right  = (act >> 3) & 1;
+        float    pos    = panPos[i];
+        int32_t  ang    = tilt[i];
+
+        // TRACKING — TrackingEngine::computePanSpeed() / computeTiltDelta(), nudge().
+        uint32_t trk   = st == TRACKING_ST;
+        uint32_t lastL = pick(trk & left,  now, lastLeft[i]);
+        uint32_t lastR = pick(trk & right, now, lastRight[i]);
+        lastLeft[i]  = lastL;
+        lastRight[i] = lastR;
+        uint32_t nearCenter = below(now - pick(left, lastR, lastL), memoryMs);
+        float    gain       = nearCenter ? slow : fast;
+        float    trackCmd   = (left == right) ? 0.0f : (left ? -gain : gain);
+
+        int32_t  delta  = static_cast<int32_t>(top) - static_cast<int32_t>(bottom);
+        uint32_t nudged = trk & (delta != 0) & (below(now - tiltStepMs[i], holdoffMs) ^ 1);
+        int32_t  trackTilt = clampTilt(ang + ((delta * tiltStep) & -static_cast<int32_t>(nudged)));
+        tiltStepMs[i] = pick(nudged, now, tiltStepMs[i]);
+
+        // SEARCHING — SearchPlanner::updateSweep(), tilt to the scan row.
+        uint32_t srch = st == SEARCHING_ST;
+        uint32_t cw   = sweepCW[i];
+        float    sweepCmd = cw ? sweepSpeed : -sweepSpeed;
+        uint32_t flip = cw ? pos >= SEARCH_SWEEP_DEG : pos <= -SEARCH_SWEEP_DEG;
+        sweepCW[i] = static_cast<uint8_t>(cw ^ (srch & flip));
+        int32_t searchTilt = stepToward(ang, TILT_SCAN_DEG, TILT_STEP_DEG);
+
+        // PARKED — PanController::parkHome() / parkSpeedFor(), TiltController::parkHome().
+        float dist  = fabsf(pos);
+        float speed = PARK_PAN_SPEED_MAX * (dist / PARK_DECEL_DEG);
+        speed = (speed > PARK_PAN_SPEED_MAX) ? PARK_PAN_SPEED_MAX : speed;
+        speed = (speed < PAN_MIN_SPEED) ? PAN_MIN_SPEED : speed;
+        float parkCmd = (dist < PARK_HOME_TOLERANCE_DEG) ? 0.0f
+                      : ((pos > 0.0f) ? -speed : speed);
+        int32_t parkTilt = stepToward(ang, TILT_HOME_DEG, PARK_TILT_STEP_DEG);
+
+        float cmd = trk ? trackCmd : (srch ? sweepCmd : parkCmd);
+        tilt[i]   = static_cast<int16_t>(trk ? trackTilt : (srch ? searchTilt : parkTilt));
+
+        // PanController::setSpeed(): the ±1 clamp with the pan limits
+        // folded in (at a limit, that side's bound is 0), then the dead zone.
+        float hi = (pos >=  PAN_LIMIT_DEG) ? 0.0f :  1.0f;
+        float lo = (pos <= -PAN_LIMIT_DEG) ? 0.0f : -1.0f;
+        cmd = (cmd > hi) ? hi : cmd;
+        cmd = (cmd < lo) ? lo : cmd;
+        cmd = (fabsf(cmd) < PAN_MIN_SPEED) ? 0.0f : cmd;
+        panSpeed[i] = cmd;
+    }
+}
+
+void SimBatch::move() {
+    const uint32_t n      = padded_;
+    const float    dtSec  = static_cast<float>(LOOP_PERIOD_MS) / 1000.0f;
+    const float    azMax  = p_.beaconAzMaxDeg;
+    const float    ticksPerS = 1000.0f / LOOP_PERIOD_MS;
+    const float    presLo = p_.presentMinS * ticksPerS, presHi = p_.presentMaxS * ticksPerS;
+    const float    awayLo = p_.awayMinS * ticksPerS,    awayHi = p_.awayMaxS * ticksPerS;
+
+    float         *__restrict panPos   = panPos_.data();
+    const float   *__restrict panSpeed = panSpeed_.data();
+    float         *__restrict truePan  = truePan_.data();
+    const float   *__restrict trueRate = trueRate_.data();
+    float         *__restrict az       = az_.data();
+    float         *__restrict vel      = vel_.data();
+    uint8_t       *__restrict present  = present_.data();
+    uint32_t      *__restrict remain   = remainTicks_.data();
+    uint32_t      *__restrict rng      = rng_.data();
+
+    LANE_LOOP
+    for (uint32_t i = 0; i < n; i++) {
+        // PanController::updatePosition() with speedToMicroseconds() /
+        // microsecondsToSpeed(): the servo gets, and the estimate counts,
+        // whole microseconds.  One span serves both directions, as the two
+        // are the same width.  lroundf() has no SSE2 form, so round by
+        // truncating w + 0.5: the same for a positive w, and exact below
+        // 2048 µs, where 0.5 is a whole number of ulps.
+        static_assert(PAN_STOP_US - PAN_CW_FULL_US == PAN_CCW_FULL_US - PAN_STOP_US,
+                      "lane pulse quantisation assumes a symmetric pan servo");
+        static_assert(PAN_CW_FULL_US > 0 && PAN_CCW_FULL_US < 2048,
+                      "lane pulse rounding needs widths in (0, 2048) µs");
+        float w  = static_cast<float>(PAN_STOP_US) - panSpeed[i] * (PAN_STOP_US - PAN_CW_FULL_US);
+        float us = static_cast<float>(static_cast<int32_t>(w + 0.5f));
+        float s  = (static_cast<float>(PAN_STOP_US) - us) / (PAN_STOP_US - PAN_CW_FULL_US);
+        float p = panPos[i] + s * PAN_DEG_PER_SEC * dtSec;
+        p = (p >  PAN_LIMIT_DEG) ?  PAN_LIMIT_DEG : p;
+        p = (p < -PAN_LIMIT_DEG) ? -PAN_LIMIT_DEG : p;
+        panPos[i] = p;
+
+        // World: the servo's real rate; the beacon walks and bounces.
+        truePan[i] += s * trueRate[i] * dtSec;
+        float a = az[i] + vel[i] * dtSec;
+        float v = vel[i];
+        v = (a >  azMax) ? -fabsf(v) : v;
+        v = (a < -azMax) ?  fabsf(v) : v;
+        az[i]  = a;
+        vel[i] = v;
+
+        // Visits and absences.
+        uint32_t x = xorshift(rng[i]);
+        rng[i] = x;
+        uint32_t r = remain[i] - 1;
+        uint8_t  flip = r == 0;
+        uint8_t  pres = present[i] ^ flip;
+        float    len  = pres ? uniform(x, presLo, presHi) : uniform(x, awayLo, awayHi);
+        remain[i]  = flip ? 1 + static_cast<uint32_t>(static_cast<int32_t>(len)) : r;
+        present[i] = pres;
+    }
+}
+
+// ===================================================================
+// ScalarLane
+// ===================================================================
+
+void ScalarLane::init() {
+    rawBits_ = 0;
+    sweepCW_ = true;
+    HostHal::setPinReader(readPin, this);
+    sensors.init();
+    monitor.init();
+    pan.init();
+    tilt.init();
+    tracker.init(&pan, &tilt);
+}
+
+void ScalarLane::step(uint8_t rawBits) {
+    rawBits_ = rawBits;
+    HostHal::setPinReader(readPin, this);
+
+    sensors.update();
+    monitor.updateEvidence(sensors.getRawHits());
+
+    switch (monitor.getState()) {
+        case MonitorState::TRACKING:
+            tracker.update(sensors.getFiltered());
+            break;
+
+        case MonitorState::SEARCHING: {
+            float pos = pan.getPositionDeg();
+            if (sweepCW_) {
+                pan.setSpeed(SEARCH_SWEEP_SPEED);
+                if (pos >= SEARCH_SWEEP_DEG) sweepCW_ = false;
+            } else {
+                pan.setSpeed(-SEARCH_SWEEP_SPEED);
+                if (pos <= -SEARCH_SWEEP_DEG) sweepCW_ = true;
+            }
+            tilt.stepToward(TILT_SCAN_DEG, TILT_STEP_DEG);
+            break;
+        }
+
+        case MonitorState::PARKED:
+            pan.parkHome();
+            tilt.parkHome();
+            break;
+    }
+
+    pan.updatePosition(LOOP_PERIOD_MS);
+}
+
+const char *ScalarLane::diff(const SimBatch &batch, uint32_t lane) const {
+    if (sensors.getRawHits() != batch.rawHits(lane)) return "raw hits";
+    SensorReading r = sensors.getFiltered();
+    if (r.top    != batch.sensorState(lane, 0)) return "top sensor";
+    if (r.bottom != batch.sensorState(lane, 1)) return "bottom sensor";
+    if (r.left   != batch.sensorState(lane, 2)) return "left sensor";
+    if (r.right  != batch.sensorState(lane, 3)) return "right sensor";
+    if (monitor.getState() != batch.monitorState(lane))       return "monitor state";
+    if (monitor.getLogLikelihood() != batch.logLikelihood(lane)) return "log-likelihood";
+    if (monitor.getParkMs() != batch.parkMs(lane))            return "park timeout";
+    if (monitor.getHoldMs() != batch.holdMs(lane))            return "hold time";
+    if (pan.getSpeed() != batch.panSpeed(lane))               return "pan speed";
+    if (pan.getPositionDeg() != batch.panDeg(lane))           return "pan position";
+    if (tilt.getAngle() != batch.tiltDeg(lane))               return "tilt angle";
+    return nullptr;
+}
+
+int ScalarLane::readPin(uint8_t pin, void *self) {
+    const ScalarLane *l = static_cast<const ScalarLane *>(self);
+    uint8_t bit;
+    switch (pin) {
+        case PIN_SENSOR_TOP:    bit = 0; break;
+        case PIN_SENSOR_BOTTOM: bit = 1; break;
+        case PIN_SENSOR_LEFT:   bit = 2; break;
+        case PIN_SENSOR_RIGHT:  bit = 3; break;
+        default:                return HIGH;
+    }
+    return (l->rawBits_ & (1u << bit)) ? LOW : HIGH;
+}
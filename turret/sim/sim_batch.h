@@ -0,0 +1,188 @@
+/**
+ * @file sim_batch.h
+ * @brief Thousands of turrets at once: structure-of-arrays state stepped
+ *        by one vectorizable kernel per firmware module.
+ *
+ * sentry-sim runs the real firmware, one turret per process, at the
+ * microsecond.  For Monte Carlo studies that is the wrong shape: the
+ * questions are statistical and the time goes into per-object dispatch.
+ * SimBatch keeps N turrets' state in flat arrays, one per field, and
+ * steps every lane through the same kernel, once per control tick
+ * (LOOP_PERIOD_MS):
+ *
+ *   sense    world → raw sensor bits (TSOP hits per tick, ambient noise)
+ *   filter   SensorArray::update(): majority-vote window, saturation,
+ *            raw hit mask, filtered ACTIVE bits
+ *   monitor  SignalMonitor::updateEvidence(): SPRT and park timeout.
+ *            Completed absences (rare) go through the monitor's own
+ *            adaptive rule, lane by lane.
+ *   control  the classic loop: TrackingEngine::update() while TRACKING
+ *            (TiltController::nudge()), a ±SEARCH_SWEEP_DEG sweep while
+ *            SEARCHING, PanController / TiltController::parkHome() when
+ *            PARKED; then PanController::setSpeed()
+ *   move     PanController::updatePosition(), then the world: true pan
+ *            at the servo's real rate, beacon motion and presence
+ *
+ * Each kernel is numerically the module it mirrors — same float
+ * expressions in the same order, same integer widths — so a lane and a
+ * set of the real scalar objects fed the same raw bits agree bit for
+ * bit.  ScalarLane is that set; sentry-batch --check compares them tick
+ * by tick.
+ *
+ * Not modelled: the turret state machine's ACQUIRING / LOCKED / COASTING
+ * gains, the bearing prior and search planner, servo output frames.
+ * The world is tick-level: a sensor that sees the beacon hits with
+ * probability pHit each tick, independently.
+ *
+ * Config tunables (TURRET_TUNABLE) are read at init(); set them first.
+ */
+
+#ifndef SIM_BATCH_H
+#define SIM_BATCH_H
+
+#include <stdint.h>
+#include <vector>
+#include "config.h"
+#include "pan_controller.h"
+#include "sensor_array.h"
+#include "signal_monitor.h"
+#include "tilt_controller.h"
+#include "tracking_engine.h"
+
+/** @brief Aggregate results over all lanes. */
+struct SimBatchTotals {
+    double presentS    = 0.0;   ///< Beacon in the room, summed over lanes
+    double onTargetPct = 0.0;   ///< Of present time, true pan error ≤ 5°
+    double trackingPct = 0.0;   ///< Of present time, monitor TRACKING
+    double falseTrackPct = 0.0; ///< Of absent time, monitor TRACKING
+    double rmsErrDeg   = 0.0;   ///< True pan error while present
+    double parkedPct   = 0.0;   ///< Of all time
+};
+
+class SimBatch {
+public:
+    /** @brief Lane arrays are padded to a multiple of this. */
+    static constexpr uint32_t LANE_ALIGN = 64;
+
+    struct Params {
+        uint32_t seed           = 1;
+        float    pHit           = SPRT_P_HIT_PRESENT;   ///< Raw hit chance per tick, sensor seeing the beacon
+        float    pNoise         = 0.002f;  ///< False hit chance per tick, any sensor
+        float    centerOverlapDeg = 3.0f;
+        float    panRateErrMax  = 0.1f;    ///< True full-speed rate = PAN_DEG_PER_SEC × (1 ± up to this)
+        float    beaconAzMaxDeg = 150.0f;  ///< Walks back and forth inside ±this
+        float    beaconSpeedMin = 2.0f;    ///< °/s
+        float    beaconSpeedMax = 15.0f;
+        float    beaconElMin    = 5.0f;
+        float    beaconElMax    = 35.0f;
+        float    presentMinS    = 30.0f;   ///< Each visit lasts this ...
+        float    presentMaxS    = 120.0f;
+        float    awayMinS       = 5.0f;    ///< ... and each absence this
+        float    awayMaxS       = 60.0f;
+    };
+
+    void init(uint32_t lanes, const Params &params);
+
+    /** @brief One control tick for every lane. */
+    void step();
+
+    uint32_t lanes() const { return lanes_; }
+    uint32_t ticks() const { return ticks_; }
+
+    SimBatchTotals totals() const;
+
+    // --- One lane, for the cross-check ---------------------------------
+    uint8_t      rawBits(uint32_t lane) const { return rawBits_[lane]; }   ///< Input to the last step()
+    uint8_t      rawHits(uint32_t lane) const { return rawHits_[lane]; }
+    SensorState  sensorState(uint32_t lane, uint8_t sensor) const;
+    MonitorState monitorState(uint32_t lane) const { return static_cast<MonitorState>(state_[lane]); }
+    float        logLikelihood(uint32_t lane) const;   ///< The best sensor's
+    uint32_t     parkMs(uint32_t lane) const { return parkMs_[lane]; }
+    uint32_t     holdMs(uint32_t lane) const { return holdMs_[lane]; }
+    float        panDeg(uint32_t lane) const { return panPos_[lane]; }
+    float        panSpeed(uint32_t lane) const { return panSpeed_[lane]; }
+    int16_t      tiltDeg(uint32_t lane) const { return tilt_[lane]; }
+
+private:
+    Params   p_;
+    uint32_t lanes_  = 0;
+    uint32_t padded_ = 0;
+    uint32_t ticks_  = 0;
+
+    // Constants of the modules, fixed at init().
+    uint8_t  filterMask_ = 0;
+    float    llrHit_ = 0.0f, llrMiss_ = 0.0f, llrPresent_ = 0.0f, llrAbsent_ = 0.0f;
+
+    // World
+    std::vector<uint32_t> rng_;
+    std::vector<float>    az_, vel_, el_, truePan_, trueRate_;
+    std::vector<uint8_t>  present_;
+    std::vector<uint32_t> remainTicks_;
+
+    // SensorArray
+    std::vector<uint8_t>  rawBits_, rawHits_, activeBits_, satBits_;
+    std::vector<uint8_t>  window_[4];      ///< Last SENSOR_FILTER_WINDOW samples, bit 0 newest
+    std::vector<uint16_t> lowRunMs_[4];
+
+    // SignalMonitor
+    std::vector<uint8_t>  state_;
+    std::vector<float>    llr_[4];         ///< Per sensor
+    std::vector<uint32_t> lastSignalMs_, parkMs_, holdMs_, absenceMs_;
+    std::vector<uint8_t>  absenceEnded_;
+    std::vector<uint8_t>  absence_;        ///< ABSENCE_BINS per lane
+
+    // TrackingEngine, search sweep
+    std::vector<uint32_t> lastLeftMs_, lastRightMs_;
+    std::vector<uint8_t>  sweepCW_;
+
+    // PanController, TiltController
+    std::vector<float>    panPos_, panSpeed_;
+    std::vector<int16_t>  tilt_;
+    std::vector<uint32_t> tiltStepMs_;
+
+    // Statistics
+    std::vector<uint32_t> presentTicks_, onTargetTicks_, trackingTicks_, falseTrackTicks_, parkedTicks_;
+    std::vector<float>    sqErr_;
+
+    void sense();
+    void filter();
+    void monitor(uint32_t now);
+    void control(uint32_t now);
+    void move();
+};
+
+/**
+ * @brief The scalar reference for one lane: the firmware's own module
+ *        objects, on HostHal's clock, driven by the same classic loop.
+ *
+ * All ScalarLanes share HostHal: step each at the same tick, then advance
+ * the clock by LOOP_PERIOD_MS once.
+ */
+class ScalarLane {
+public:
+    /** @brief Initialise at the current HostHal time (the batch's tick 0). */
+    void init();
+
+    /** @brief One tick with the sensors reading @p rawBits. */
+    void step(uint8_t rawBits);
+
+    /**
+     * @brief Compare with @p lane of @p batch.
+     * @return nullptr if identical, else the first differing field.
+     */
+    const char *diff(const SimBatch &batch, uint32_t lane) const;
+
+    SensorArray    sensors;
+    SignalMonitor  monitor;
+    PanController  pan;
+    TiltController tilt;
+    TrackingEngine tracker;
+
+private:
+    uint8_t rawBits_ = 0;
+    bool    sweepCW_ = true;
+
+    static int readPin(uint8_t pin, void *self);
+};
+
+#endif // SIM_BATCH_H
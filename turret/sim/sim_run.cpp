@@ -0,0 +1,552 @@
+/**
+ * @file sim_run.cpp
+ * @brief Simulation loop, telemetry tap and KPI scoring.
+ */
+
+#include "sim_run.h"
+#include "hal.h"
+#include "sim_tunables.h"
+#include "session_capture.h"
+#include "turret_trace.h"
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <random>
+#include <vector>
+
+void setup();
+void loop();
+void simPowerOn();   // main.cpp
+
+// ===================================================================
+// Scoring
+// ===================================================================
+
+namespace {
+
+/** Virtual time to run after the report commands, for the replies. */
+constexpr unsigned long REPORT_TAIL_US = 200000;
+
+/** Ground truth at one simulator step. */
+struct Truth {
+    uint32_t   tUs;
+    float      panDeg;
+    float      panErrDeg;
+    float      tiltDeg;
+    BeaconPose beacon;
+    uint8_t    inView;
+    uint32_t   lastInViewUs;
+};
+
+/** Scores ground truth (every step) and decoded records (every tick). */
+class Scorer {
+public:
+    Scorer(FILE *csv, TurretTrace *trace) : csv_(csv), trace_(trace) {
+        if (csv_) {
+            fprintf(csv_, "t_s,state,pan_est,pan_true,pan_err,pan_cmd,tilt_cmd,tilt_true,"
+                          "beacon_az,beacon_el,present,raw_bits,in_view\n");
+        }
+    }
+
+    /** Once per simulator step, after the world moved by @p dtUs. */
+    void observe(const SimWorld &world, unsigned long dtUs) {
+        Truth t;
+        t.tUs       = static_cast<uint32_t>(HostHal::nowUs());
+        t.panDeg    = world.panDeg();
+        t.panErrDeg = world.panErrorDeg();
+        t.tiltDeg   = world.tiltDeg();
+        t.beacon    = world.beacon();
+        t.inView    = world.inViewBits();
+        if (t.inView) lastInViewUs_ = t.tUs;
+        t.lastInViewUs = lastInViewUs_;
+        history_.push_back(t);
+
+        if (haveLast_) {
+            panTravel_ += fabsf(t.panDeg - lastPan_);
+            if (t.tiltDeg >= 0.0f && lastTilt_ >= 0.0f) tiltTravel_ += fabsf(t.tiltDeg - lastTilt_);
+        }
+        haveLast_ = true;
+        lastPan_  = t.panDeg;
+        lastTilt_ = t.tiltDeg;
+
+        float err  = t.panErrDeg;
+        float aerr = fabsf(err);
+
+        if (t.beacon.present && !present_) {
+            // A new appearance.
+            appearUs_     = t.tUs;
+            acquired_     = false;
+            holding_      = false;
+            approachSign_ = (err < 0.0f) ? -1.0f : 1.0f;
+            reached_      = false;
+            overshoot_    = 0.0f;
+            windowOpen_   = true;
+            k_.appearances++;
+        } else if (!t.beacon.present && present_) {
+            endEpisode(t.tUs);
+        }
+        present_ = t.beacon.present;
+        if (!present_) return;
+
+        double dt = dtUs * 1e-6;
+        presentS_  += dt;
+        presentSq_ += err * err * dt;
+        if (aerr <= SimRun::ACQUIRED_DEG) onTargetS_ += dt;
+
+        if (!acquired_) {
+            if (aerr <= SimRun::ACQUIRED_DEG) {
+                if (!holding_) {
+                    holding_     = true;
+                    holdStartUs_ = t.tUs;
+                } else if (t.tUs - holdStartUs_ >= SimRun::ACQUIRED_HOLD_MS * 1000UL) {
+                    acquired_     = true;
+                    acquiredAtUs_ = t.tUs;
+                    noteAcquire((holdStartUs_ - appearUs_) / 1000.0f);
+                }
+            } else {
+                holding_ = false;
+            }
+        } else {
+            acquiredS_  += dt;
+            acquiredSq_ += err * err * dt;
+        }
+
+        if (windowOpen_) {
+            // The side it approached from is the side it was on last
+            // before first reaching the beacon.
+            if (!reached_) {
+                if (aerr > SimRun::ACQUIRED_DEG) {
+                    approachSign_ = (err < 0.0f) ? -1.0f : 1.0f;
+                } else {
+                    reached_ = true;
+                }
+            }
+            float past = -approachSign_ * err;   // > 0: beyond the beacon
+            if (reached_ && aerr < 90.0f && past > overshoot_) overshoot_ = past;
+            if (acquired_ && t.tUs - acquiredAtUs_ >= SimRun::OVERSHOOT_WINDOW_MS * 1000UL) {
+                closeOvershoot();
+            }
+        }
+    }
+
+    /** One decoded control-tick record. */
+    void record(const TelemetryRecord &r) {
+        // Truth at the tick: the last step at or before it.
+        while (history_.size() > 1 && static_cast<int32_t>(history_[1].tUs - r.tUs) <= 0) {
+            history_.pop_front();
+        }
+        if (history_.empty()) return;
+        const Truth &t = history_.front();
+        // A record covers the periods since the one before: one while
+        // active, PARK_IDLE_TICKS while idling parked.
+        uint32_t periods = 1;
+        if (haveRecord_) {
+            periods = (r.tUs - lastRecordUs_ + LOOP_PERIOD_US / 2) / LOOP_PERIOD_US;
+            if (periods == 0) periods = 1;
+        }
+        haveRecord_   = true;
+        lastRecordUs_ = r.tUs;
+        const float tickS = periods * (LOOP_PERIOD_MS / 1000.0f);
+
+        k_.records++;
+        if (r.state < static_cast<uint8_t>(TurretState::COUNT)) k_.stateTicks[r.state] += periods;
+
+        float est = r.panCdeg / 100.0f;
+        k_.drErrEndDeg = fabsf(est - t.panDeg);
+        if (k_.drErrEndDeg > k_.drErrMaxDeg) k_.drErrMaxDeg = k_.drErrEndDeg;
+
+        if (t.beacon.present) {
+            int sign = (r.panCmd > 0) - (r.panCmd < 0);
+            if (sign != 0) {
+                if (lastCmdSign_ != 0 && sign != lastCmdSign_) reversals_++;
+                lastCmdSign_ = sign;
+            }
+        } else {
+            lastCmdSign_ = 0;
+        }
+
+        bool tracking = r.state == static_cast<uint8_t>(TurretState::ACQUIRING) ||
+                        r.state == static_cast<uint8_t>(TurretState::LOCKED);
+        if (tracking && t.inView == 0 &&
+            t.tUs - t.lastInViewUs > SimRun::FALSE_LOCK_GRACE_MS * 1000UL) {
+            k_.falseLockS += tickS;
+        }
+
+        if (trace_) {
+            trace_->tick(r, TurretTrace::monitorOf(r.state));
+            trace_->counter("pan_deg_true", r.tUs, t.panDeg);
+            trace_->counter("tilt_deg_true", r.tUs, t.tiltDeg);
+            trace_->counter("beacon_az_deg", r.tUs, t.beacon.azDeg);
+            trace_->counter("beacon_el_deg", r.tUs, t.beacon.elDeg);
+            trace_->counter("beacon_present", r.tUs, t.beacon.present ? 1 : 0);
+            trace_->counter("in_view_bits", r.tUs, t.inView);
+        }
+
+        if (csv_) {
+            fprintf(csv_, "%.3f,%s,%.2f,%.2f,%.2f,%.4f,%d,%.1f,%.2f,%.2f,%d,%u,%u\n",
+                    r.tUs * 1e-6,
+                    TurretStateMachine::stateName(static_cast<TurretState>(r.state)),
+                    est, t.panDeg, t.panErrDeg, r.panCmd / 10000.0f, r.tiltDeg, t.tiltDeg,
+                    t.beacon.azDeg, t.beacon.elDeg, t.beacon.present ? 1 : 0,
+                    r.rawBits, t.inView);
+        }
+    }
+
+    /** Close any open appearance and fill in the derived figures. */
+    SimKpis finish(double simS) {
+        uint32_t nowUs = static_cast<uint32_t>(HostHal::nowUs());
+        if (present_ && !acquired_ && nowUs - appearUs_ < SimRun::ACQUIRED_HOLD_MS * 1000UL) {
+            k_.appearances--;   // Cut off before it could be acquired
+            present_ = false;
+        }
+        if (present_) endEpisode(nowUs);
+
+        SimKpis k = k_;
+        k.simS     = simS;
+        k.presentS = static_cast<float>(presentS_);
+
+        if (!acquireMs_.empty()) k.acquireMs = acquireMs_.front();
+        if (acquireMs_.size() > 1) {
+            double sum = 0.0;
+            for (size_t i = 1; i < acquireMs_.size(); i++) {
+                sum += acquireMs_[i];
+                if (acquireMs_[i] > k.reacquireMaxMs) k.reacquireMaxMs = acquireMs_[i];
+            }
+            k.reacquireMs = static_cast<float>(sum / (acquireMs_.size() - 1));
+        }
+
+        if (acquiredS_ > 0.0) {
+            k.rmsErrDeg = static_cast<float>(sqrt(acquiredSq_ / acquiredS_));
+        } else if (presentS_ > 0.0) {
+            k.rmsErrDeg = static_cast<float>(sqrt(presentSq_ / presentS_));
+        }
+        if (k.presentS > 0.0f) {
+            k.onTargetPct     = static_cast<float>(100.0 * onTargetS_ / k.presentS);
+            k.reversalsPerMin = reversals_ / (k.presentS / 60.0f);
+        }
+        if (!overshoots_.empty()) {
+            double sum = 0.0;
+            for (float o : overshoots_) {
+                sum += o;
+                if (o > k.overshootMaxDeg) k.overshootMaxDeg = o;
+            }
+            k.overshootDeg = static_cast<float>(sum / overshoots_.size());
+        }
+        if (simS > 0.0) {
+            k.panTravelDegPerH  = static_cast<float>(panTravel_ * 3600.0 / simS);
+            k.tiltTravelDegPerH = static_cast<float>(tiltTravel_ * 3600.0 / simS);
+        }
+        return k;
+    }
+
+private:
+    FILE *csv_;
+    TurretTrace *trace_;
+    std::deque<Truth> history_;
+    SimKpis k_;
+
+    // Travel.
+    bool   haveLast_   = false;
+    float  lastPan_    = 0.0f;
+    float  lastTilt_   = -1.0f;
+    double panTravel_  = 0.0;
+    double tiltTravel_ = 0.0;
+
+    // Current appearance.
+    bool     present_      = false;
+    uint32_t appearUs_     = 0;
+    bool     acquired_     = false;
+    uint32_t acquiredAtUs_ = 0;
+    bool     holding_      = false;
+    uint32_t holdStartUs_  = 0;
+    float    approachSign_ = 1.0f;
+    bool     reached_      = false;   ///< Within ACQUIRED_DEG at least once
+    float    overshoot_    = 0.0f;
+    bool     windowOpen_   = false;
+
+    // Accumulated.
+    std::vector<float> acquireMs_;   ///< Per appearance; missed ones cost their length
+    std::vector<float> overshoots_;
+    double   presentS_    = 0.0;
+    double   presentSq_   = 0.0;
+    double   acquiredS_   = 0.0;
+    double   acquiredSq_  = 0.0;
+    double   onTargetS_   = 0.0;
+    uint32_t reversals_   = 0;
+    int      lastCmdSign_ = 0;
+    uint32_t lastInViewUs_ = 0;
+    bool     haveRecord_   = false;
+    uint32_t lastRecordUs_ = 0;
+
+    void noteAcquire(float ms) { acquireMs_.push_back(ms); }
+
+    void closeOvershoot() {
+        overshoots_.push_back(overshoot_ > 0.0f ? overshoot_ : 0.0f);
+        windowOpen_ = false;
+    }
+
+    void endEpisode(uint32_t nowUs) {
+        if (!acquired_) {
+            k_.missed++;
+            noteAcquire((nowUs - appearUs_) / 1000.0f);
+        } else if (windowOpen_) {
+            closeOvershoot();
+        }
+        windowOpen_ = false;
+        present_    = false;
+    }
+};
+
+/**
+ * Serial TX → telemetry records (plain or session capture ticks) and,
+ * when wanted, the text between them; a copy of the raw bytes to
+ * @p capture if set, captured samples to @p trace if set.
+ */
+class SerialTap {
+public:
+    SerialTap(Scorer &scorer, FILE *capture, TurretTrace *trace)
+        : scorer_(scorer), capture_(capture), trace_(trace) {}
+
+    void poll(bool keepText) {
+        bytes_.clear();
+        HostHal::takeSerialTx(bytes_);
+        if (capture_ && !bytes_.empty()) fwrite(bytes_.data(), 1, bytes_.size(), capture_);
+        for (uint8_t b : bytes_) {
+            chunk_.push_back(static_cast<char>(b));
+            CaptureDecoder::Frame got = decoder_.feed(b);
+            if (got == CaptureDecoder::Frame::TICK && trace_) {
+                const CaptureTick &t = decoder_.tick();
+                for (uint8_t i = 0; i < t.samples; i++) trace_->sample(t.sample[i].tUs, t.sample[i].rawBits);
+            }
+            if (got == CaptureDecoder::Frame::RECORD || got == CaptureDecoder::Frame::TICK) {
+                scorer_.record(decoder_.record());
+                chunk_.clear();
+            } else if (b == 0x00) {
+                if (keepText) {
+                    for (char c : chunk_) {
+                        if (c != '\r' && c != '\0') text_.push_back(c);
+                    }
+                }
+                chunk_.clear();
+            }
+        }
+    }
+
+    const std::string &text() const { return text_; }
+    uint32_t badFrames() const { return decoder_.badFrames(); }
+
+private:
+    Scorer              &scorer_;
+    FILE                *capture_;
+    TurretTrace         *trace_;
+    CaptureDecoder       decoder_;
+    std::vector<uint8_t> bytes_;
+    std::string          chunk_;
+    std::string          text_;
+};
+
+/** Profiler::Observer: stage timings onto the trace, at the virtual time. */
+void traceStage(ProfStage stage, uint32_t startTicks, uint32_t ticks, void *trace) {
+    static_cast<TurretTrace *>(trace)->stage(stage, static_cast<uint32_t>(HostHal::nowUs()),
+                                             startTicks, ticks);
+}
+
+}  // namespace
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+const SimKpiField SimRun::KPIS[] = {
+    {"acquire_ms",            [](const SimKpis &k) { return k.acquireMs; },                  false, 500.0f, 0.15f},
+    {"reacquire_ms",          [](const SimKpis &k) { return k.reacquireMs; },                false, 500.0f, 0.15f},
+    {"missed",                [](const SimKpis &k) { return static_cast<float>(k.missed); }, false, 0.5f,   0.0f},
+    {"rms_err_deg",           [](const SimKpis &k) { return k.rmsErrDeg; },                  false, 0.5f,   0.10f},
+    {"on_target_pct",         [](const SimKpis &k) { return k.onTargetPct; },                true,  3.0f,   0.05f},
+    {"overshoot_deg",         [](const SimKpis &k) { return k.overshootDeg; },               false, 1.0f,   0.15f},
+    {"reversals_per_min",     [](const SimKpis &k) { return k.reversalsPerMin; },            false, 3.0f,   0.15f},
+    {"false_lock_s",          [](const SimKpis &k) { return k.falseLockS; },                 false, 1.0f,   0.20f},
+    {"pan_travel_deg_per_h",  [](const SimKpis &k) { return k.panTravelDegPerH; },           false, 500.0f, 0.10f},
+    {"tilt_travel_deg_per_h", [](const SimKpis &k) { return k.tiltTravelDegPerH; },          false, 200.0f, 0.10f},
+};
+
+const uint8_t SimRun::KPI_COUNT = sizeof(KPIS) / sizeof(KPIS[0]);
+
+const SimKpiField *SimRun::findKpi(const char *name) {
+    for (uint8_t i = 0; i < KPI_COUNT; i++) {
+        if (strcmp(KPIS[i].name, name) == 0) return &KPIS[i];
+    }
+    return nullptr;
+}
+
+bool SimRun::run(const SimConfig &cfg, SimKpis &out, std::string *firmwareText) {
+    if (!cfg.scenario || cfg.stepUs == 0) return false;
+
+    SimParams params = cfg.world;
+    if (!params.path) params.path = cfg.scenario->path;
+    if (cfg.noiseLowP >= 0.0f) {
+        params.noiseLowP = cfg.noiseLowP;
+    } else if (cfg.scenario->noiseLowP >= 0.0f) {
+        params.noiseLowP = cfg.scenario->noiseLowP;
+    }
+    const BurstProfile &bp = params.bursts;
+    params.burstPhaseUs = static_cast<uint32_t>(std::mt19937(params.seed)() %
+                                                (bp.onUs + bp.offUs + bp.sleepUs));
+
+    double seconds = cfg.seconds > 0.0 ? cfg.seconds : cfg.scenario->seconds;
+    unsigned long endUs = cfg.startUs + static_cast<unsigned long>(seconds * 1e6);
+
+    // A thread may have run another turret, with other tunables, before.
+    SimTunables::apply(cfg.tunables ? cfg.tunables : SimTunables::defaults());
+
+    simPowerOn();
+    HostHal::reset();
+    HostHal::storageErase();
+    HostHal::advanceUs(cfg.startUs);
+    SimWorld world;
+    world.init(params);
+    std::unique_ptr<TraceWriter> writer;
+    std::unique_ptr<TurretTrace> trace;
+    if (cfg.trace) {
+        writer.reset(new TraceWriter(cfg.trace));
+        trace.reset(new TurretTrace(*writer, 1, cfg.scenario->name));
+        Profiler::setObserver(traceStage, trace.get());
+    }
+    Scorer scorer(cfg.csv, trace.get());
+    SerialTap tap(scorer, cfg.capture, trace.get());
+
+    if (cfg.capture) {
+        // The NVS flag 'c' sets, as if toggled before this boot (main.cpp).
+        const uint8_t on = 1;
+        HostHal::storagePut("sentry", "capture", &on, sizeof(on));
+    }
+
+    auto wallStart = std::chrono::steady_clock::now();
+
+    setup();
+    tap.poll(false);
+
+    bool reporting = false;
+    while (true) {
+        unsigned long now = HostHal::nowUs();
+        if (now >= endUs) {
+            if (!cfg.firmwareReport) break;
+            if (!reporting) {
+                HostHal::serialInject('l');
+                HostHal::serialInject('j');
+                reporting = true;
+            }
+            if (now >= endUs + REPORT_TAIL_US) break;
+        }
+
+        loop();
+        HostHal::advanceUs(cfg.stepUs);
+        world.step(cfg.stepUs);
+        if (!reporting) scorer.observe(world, cfg.stepUs);
+        tap.poll(reporting);
+    }
+
+    if (trace) {
+        Profiler::setObserver(nullptr, nullptr);
+        trace->finish();
+        writer->finish();
+    }
+
+    out = scorer.finish(seconds);
+    out.wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    out.badFrames = tap.badFrames();
+    if (firmwareText) *firmwareText = tap.text();
+    return true;
+}
+
+bool SimRun::runIsolated(const SimConfig &cfg, SimKpis &out) {
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        SimKpis k;
+        bool ok = run(cfg, k);
+        if (cfg.csv) fflush(cfg.csv);
+        ok = ok && write(fds[1], &k, sizeof(k)) == static_cast<ssize_t>(sizeof(k));
+        _exit(ok ? 0 : 1);
+    }
+
+    close(fds[1]);
+    size_t got = 0;
+    uint8_t *dst = reinterpret_cast<uint8_t *>(&out);
+    while (got < sizeof(out)) {
+        ssize_t n = read(fds[0], dst + got, sizeof(out) - got);
+        if (n <= 0) break;
+        got += static_cast<size_t>(n);
+    }
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return got == sizeof(out) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+void SimRun::printReport(FILE *f, const SimKpis &k) {
+    fprintf(f, "Simulated %.1f s in %.2f s wall (%.0fx real time), %lu records, %lu bad frames\n",
+            k.simS, k.wallS, k.wallS > 0.0 ? k.simS / k.wallS : 0.0,
+            static_cast<unsigned long>(k.records), static_cast<unsigned long>(k.badFrames));
+
+    // Every percentage comes from the same tick total, rounded to 0.1 %
+    // by largest remainder so the column sums to exactly 100.0.
+    constexpr uint8_t N = static_cast<uint8_t>(TurretState::COUNT);
+    uint64_t total = 0;
+    for (uint8_t s = 0; s < N; s++) total += k.stateTicks[s];
+    uint32_t tenths[N] = {};
+    if (total > 0) {
+        uint64_t rem[N];
+        uint32_t given = 0;
+        for (uint8_t s = 0; s < N; s++) {
+            uint64_t scaled = 1000ULL * k.stateTicks[s];
+            tenths[s] = static_cast<uint32_t>(scaled / total);
+            rem[s]    = scaled % total;
+            given    += tenths[s];
+        }
+        for (; given < 1000; given++) {
+            uint8_t best = 0;
+            for (uint8_t s = 1; s < N; s++) if (rem[s] > rem[best]) best = s;
+            tenths[best]++;
+            rem[best] = 0;
+        }
+    }
+    fprintf(f, "\nTime per state (%llu control periods):\n", static_cast<unsigned long long>(total));
+    for (uint8_t s = 0; s < N; s++) {
+        if (k.stateTicks[s] == 0) continue;
+        fprintf(f, "  %-10s %8.1f s  %3u.%u %%\n",
+                TurretStateMachine::stateName(static_cast<TurretState>(s)),
+                k.stateTicks[s] * (LOOP_PERIOD_MS / 1000.0),
+                static_cast<unsigned>(tenths[s] / 10), static_cast<unsigned>(tenths[s] % 10));
+    }
+
+    fprintf(f, "\nBeacon in the room %.1f s, %lu appearances, %lu missed\n", k.presentS,
+            static_cast<unsigned long>(k.appearances), static_cast<unsigned long>(k.missed));
+    fprintf(f, "  time to acquire     %8.0f ms\n", k.acquireMs);
+    fprintf(f, "  time to re-acquire  %8.0f ms mean, %.0f ms worst\n", k.reacquireMs, k.reacquireMaxMs);
+    fprintf(f, "  pointing error      %8.2f° RMS, on target (≤ %.0f°) %.1f %%\n",
+            k.rmsErrDeg, ACQUIRED_DEG, k.onTargetPct);
+    fprintf(f, "  overshoot           %8.2f° mean, %.2f° worst\n", k.overshootDeg, k.overshootMaxDeg);
+    fprintf(f, "  chatter             %8.1f reversals / min\n", k.reversalsPerMin);
+    fprintf(f, "  false lock          %8.1f s\n", k.falseLockS);
+    fprintf(f, "  servo travel        %8.0f °/h pan, %.0f °/h tilt\n",
+            k.panTravelDegPerH, k.tiltTravelDegPerH);
+    fprintf(f, "\nDead reckoning: error %.2f° at the end, %.2f° worst\n",
+            k.drErrEndDeg, k.drErrMaxDeg);
+}
@@ -0,0 +1,125 @@
+/**
+ * @file sim_run.h
+ * @brief One closed-loop simulation: the firmware's setup() / loop()
+ *        against a SimWorld, scored into tracking KPIs.
+ *
+ * The firmware keeps its modules in file statics (main.cpp), which are
+ * thread_local in the simulator (HAL_PER_THREAD, hal.h): a thread holds
+ * one turret, and run() power-cycles it before booting, so a WorkPool
+ * thread can take run after run and threads run side by side.
+ * runIsolated() does the run in a forked child instead and reads the
+ * KPIs back: slower, but a crash or hang in the firmware takes down only
+ * that run (the tools' --fork).
+ *
+ * KPIs come from the world's ground truth, sampled every step, plus
+ * the decoded telemetry for what the firmware believed:
+ *
+ *   appearance    the beacon comes into the room (or out from behind
+ *                 an occlusion); the first is acquisition, the rest
+ *                 re-acquisition
+ *   acquired      pan error within ACQUIRED_DEG for ACQUIRED_HOLD_MS;
+ *                 the time runs from the appearance to the start of
+ *                 that hold.  An appearance that ends unacquired counts
+ *                 as missed and costs its whole length; one the end of
+ *                 the run cuts shorter than ACQUIRED_HOLD_MS is dropped
+ *   pointing      RMS pan error while present, once acquired (over all
+ *                 present time if nothing ever was)
+ *   overshoot     furthest the pan went past the beacon, after first
+ *                 reaching it, against the side it came from; up to
+ *                 OVERSHOOT_WINDOW_MS after acquiring
+ *   chatter       sign changes of the commanded pan speed while the
+ *                 beacon is present, per minute present
+ *   false lock    time the firmware reports ACQUIRING / LOCKED while no
+ *                 sensor can see the beacon, after FALSE_LOCK_GRACE_MS
+ *   travel        true servo travel, degrees per hour of run time
+ */
+
+#ifndef SIM_RUN_H
+#define SIM_RUN_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include "sim_world.h"
+#include "turret_fsm.h"
+
+/** @brief What to run. */
+struct SimConfig {
+    const BeaconScenario *scenario = nullptr;
+    SimParams     world;                     ///< path (if unset) and burst phase come from the scenario and seed
+    float         noiseLowP = -1.0f;         ///< < 0: the scenario's (else world.noiseLowP)
+    double        seconds   = 0.0;           ///< 0 = scenario default
+    unsigned long startUs   = 0;             ///< Virtual clock at boot (e.g. just short of a millis() wrap)
+    unsigned long stepUs    = 1000;          ///< Divides the tick grids: ticks run exactly on time
+    FILE         *csv       = nullptr;       ///< Per-tick log with ground truth, or nullptr
+    FILE         *capture   = nullptr;       ///< Boot with session capture on, serial output here
+    FILE         *trace     = nullptr;       ///< Chrome trace-event JSON (turret_trace.h), or nullptr
+    bool          firmwareReport = false;    ///< Ask for 'l' and 'j' at the end
+    const double *tunables  = nullptr;       ///< SimTunables::COUNT values, or nullptr for config.h's
+};
+
+/** @brief Results of one run.  Plain data: crosses a pipe as bytes. */
+struct SimKpis {
+    double   simS      = 0.0;
+    double   wallS     = 0.0;
+    uint32_t records   = 0;
+    uint32_t badFrames = 0;
+
+    float    presentS  = 0.0f;               ///< Beacon in the room
+    uint32_t appearances = 0;
+    uint32_t missed      = 0;                ///< Appearances never acquired
+    float    acquireMs   = 0.0f;             ///< First appearance
+    float    reacquireMs = 0.0f;             ///< Mean over the later ones
+    float    reacquireMaxMs = 0.0f;
+    float    rmsErrDeg   = 0.0f;
+    float    onTargetPct = 0.0f;             ///< Present time within ACQUIRED_DEG
+    float    overshootDeg    = 0.0f;         ///< Mean per acquisition
+    float    overshootMaxDeg = 0.0f;
+    float    reversalsPerMin = 0.0f;
+    float    falseLockS      = 0.0f;
+    float    panTravelDegPerH  = 0.0f;
+    float    tiltTravelDegPerH = 0.0f;
+    float    drErrMaxDeg = 0.0f;             ///< Dead-reckoning error, worst
+    float    drErrEndDeg = 0.0f;
+    uint32_t stateTicks[static_cast<uint8_t>(TurretState::COUNT)] = {};   ///< Control periods per state
+};
+
+/** @brief One KPI as a named column (sentry-bench, sentry-tune). */
+struct SimKpiField {
+    const char *name;
+    float     (*get)(const SimKpis &k);
+    bool        higherIsBetter;
+    float       absTol;   ///< Default baseline tolerance, absolute ...
+    float       relTol;   ///< ... or relative to the baseline, whichever is larger
+};
+
+class SimRun {
+public:
+    static const SimKpiField KPIS[];
+    static const uint8_t     KPI_COUNT;
+
+    /** @return The KPI called @p name, or nullptr. */
+    static const SimKpiField *findKpi(const char *name);
+
+    static constexpr float    ACQUIRED_DEG        = 5.0f;
+    static constexpr uint32_t ACQUIRED_HOLD_MS    = 500;
+    static constexpr uint32_t OVERSHOOT_WINDOW_MS = 2000;
+    static constexpr uint32_t FALSE_LOCK_GRACE_MS = 1000;
+
+    /**
+     * @brief Run @p cfg on this thread, from a power-on turret with
+     *        config.h's tunables unless cfg.tunables says otherwise.
+     *
+     * @param firmwareText  Receives the firmware's text replies if
+     *                      cfg.firmwareReport; may be nullptr.
+     */
+    static bool run(const SimConfig &cfg, SimKpis &out, std::string *firmwareText = nullptr);
+
+    /** @brief run() in a forked child.  @return false if the child failed. */
+    static bool runIsolated(const SimConfig &cfg, SimKpis &out);
+
+    /** @brief Human-readable summary of @p k. */
+    static void printReport(FILE *f, const SimKpis &k);
+};
+
+#endif // SIM_RUN_H
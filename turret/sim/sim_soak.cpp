@@ -0,0 +1,391 @@
+/**
+ * @file sim_soak.cpp
+ * @brief Soak loop, daily routine and invariant checks.
+ */
+
+#include "sim_soak.h"
+#include "hal.h"
+#include "telemetry_stream.h"
+#include "session_capture.h"
+#include <math.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+void setup();
+void loop();
+
+namespace {
+
+constexpr double DAY_S  = 86400.0;
+constexpr double HOUR_S = 3600.0;
+constexpr double TWO_PI = 6.283185307179586;
+
+/** Routine length of one desk slot; a break takes a whole slot. */
+constexpr double SLOT_S = 600.0;
+
+/** A drift episode ends below this fraction of the bound. */
+constexpr float DRIFT_CLEAR = 0.8f;
+
+/** Pan at rest, for the drift check: the lag is in the speed, not the position. */
+constexpr float AT_REST_DEG_PER_SEC = 0.5f;
+
+/** Steps of ground truth kept for records still in the serial FIFO. */
+constexpr uint16_t TRUTH_RING = 1024;
+
+uint32_t routineSeed = 1;
+
+/** Uniform in [0, 1) from the routine seed, @p a and @p b. */
+double unitHash(uint32_t a, uint32_t b) {
+    uint32_t h = routineSeed * 0x9E3779B9u ^ a * 0x85EBCA6Bu ^ b * 0xC2B2AE35u;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h / 4294967296.0;
+}
+
+bool inSession(uint32_t day, double tod) {
+    if (day % 7 >= 5) {
+        // Weekends: an afternoon, one day in two.
+        return unitHash(day, 0) < 0.5 && tod >= 14.0 * HOUR_S && tod < 16.0 * HOUR_S;
+    }
+    return (tod >= 9.0 * HOUR_S && tod < 12.5 * HOUR_S) ||
+           (tod >= 13.5 * HOUR_S && tod < 18.0 * HOUR_S);
+}
+
+/** Ground truth at one simulator step. */
+struct Truth {
+    uint32_t tUs;
+    float    panDeg;
+    float    panRate;   ///< °/s
+};
+
+/** Checks decoded records against the world, per step and per record. */
+class Checker {
+public:
+    Checker(const SoakConfig &cfg, SoakReport &r) : cfg_(cfg), r_(r), truth_(TRUTH_RING) {}
+
+    /** Once per simulator step, the world as of now. */
+    void observe(const SimWorld &world) {
+        unsigned long now = HostHal::nowUs();
+        Truth &t = truth_[head_++ % TRUTH_RING];
+        t.tUs     = static_cast<uint32_t>(now);
+        t.panDeg  = world.panDeg();
+        t.panRate = world.panRateDegPerSec();
+
+        bool inView = world.inViewBits() != 0;
+        if (inView != inView_) {
+            inView_   = inView;
+            viewEdge_ = now;
+            acquired_ = false;
+            parked_   = false;
+            if (inView) r_.inViewRuns++;
+        }
+
+        if (now - lastRecordUs_ > SimSoak::STALL_MS * 1000UL) {
+            fail(SoakCheck::STALL, stall_, (now - lastRecordUs_) / 1000.0f);
+        }
+    }
+
+    /** One decoded control-tick record. */
+    void record(const TelemetryRecord &rec) {
+        unsigned long now = HostHal::nowUs();
+        r_.records++;
+        if (rec.state < static_cast<uint8_t>(TurretState::COUNT)) r_.stateTicks[rec.state]++;
+
+        // Tick spacing: whole periods only; anything else is a clock fault.
+        if (haveRecord_) {
+            uint32_t gap = rec.tUs - lastTUs_;
+            bool ok = gap != 0 && gap % LOOP_PERIOD_US == 0;
+            if (ok) r_.skipped += gap / LOOP_PERIOD_US - 1;
+            check(SoakCheck::TICK, tick_, ok, gap / 1000.0f);
+        }
+        haveRecord_   = true;
+        lastTUs_      = rec.tUs;
+        lastRecordUs_ = now;
+        stall_        = false;
+
+        auto state = static_cast<TurretState>(rec.state);
+        bool tracking = state == TurretState::ACQUIRING || state == TurretState::LOCKED;
+        float sinceEdgeMs = (now - viewEdge_) / 1000.0f;
+        if (inView_) {
+            if (tracking && !acquired_) {
+                acquired_ = true;
+                if (sinceEdgeMs > r_.reacquireMaxMs) r_.reacquireMaxMs = sinceEdgeMs;
+            }
+            check(SoakCheck::REACQUIRE, reacquire_,
+                  acquired_ || sinceEdgeMs <= SimSoak::REACQUIRE_BOUND_MS, sinceEdgeMs);
+        } else {
+            if (state == TurretState::PARKED && !parked_) {
+                parked_ = true;
+                if (sinceEdgeMs > r_.parkMaxMs) r_.parkMaxMs = sinceEdgeMs;
+            }
+            check(SoakCheck::PARK, park_,
+                  state == TurretState::PARKED || sinceEdgeMs <= SimSoak::parkBoundMs(), sinceEdgeMs);
+        }
+
+        float estDeg = rec.panCdeg / 100.0f;
+        float panAbs = fabsf(estDeg);
+        if (panAbs > r_.panMaxDeg) r_.panMaxDeg = panAbs;
+        bool inLimits = panAbs <= PAN_LIMIT_DEG + PAN_DEG_PER_SEC * LOOP_PERIOD_MS / 1000.0f &&
+                        rec.tiltDeg >= TILT_MIN_DEG && rec.tiltDeg <= TILT_MAX_DEG;
+        check(SoakCheck::LIMITS, limits_, inLimits, inLimits ? 0.0f : panAbs);
+
+        // Drift at rest only: moving, the servo lags the estimate by a few
+        // degrees, in and out on every start and stop.
+        const Truth *t = truthAt(rec.tUs);
+        if (t && rec.panCmd == 0 && fabsf(t->panRate) < AT_REST_DEG_PER_SEC) {
+            float drift = fabsf(estDeg - t->panDeg);
+            if (drift > r_.driftMaxDeg) r_.driftMaxDeg = drift;
+            if (drift > cfg_.driftDeg) {
+                fail(SoakCheck::DRIFT, drift_, drift);
+            } else if (drift < DRIFT_CLEAR * cfg_.driftDeg) {
+                drift_ = false;
+            }
+        }
+    }
+
+private:
+    const SoakConfig  &cfg_;
+    SoakReport        &r_;
+    std::vector<Truth> truth_;
+    uint32_t           head_ = 0;
+
+    bool          haveRecord_   = false;
+    uint32_t      lastTUs_      = 0;
+    unsigned long lastRecordUs_ = HostHal::nowUs();
+    bool          inView_       = false;
+    unsigned long viewEdge_     = HostHal::nowUs();   ///< Last change of inView_
+    bool          acquired_     = false;             ///< Tracked since the edge
+    bool          parked_       = false;             ///< Parked since the edge
+
+    // Episode open, per check.
+    bool tick_ = false, stall_ = false, park_ = false, reacquire_ = false;
+    bool drift_ = false, limits_ = false;
+
+    /** Step truth at micros() @p tUs, or nullptr if it has left the ring. */
+    const Truth *truthAt(uint32_t tUs) const {
+        uint32_t n = head_ < TRUTH_RING ? head_ : TRUTH_RING;
+        for (uint32_t i = 1; i <= n; i++) {
+            const Truth &t = truth_[(head_ - i) % TRUTH_RING];
+            if (t.tUs == tUs) return &t;
+        }
+        return nullptr;
+    }
+
+    void check(SoakCheck c, bool &open, bool ok, float value) {
+        if (ok) {
+            open = false;
+        } else {
+            fail(c, open, value);
+        }
+    }
+
+    void fail(SoakCheck c, bool &open, float value) {
+        if (open) return;
+        open = true;
+        r_.violations[static_cast<uint8_t>(c)]++;
+        if (r_.keptCount < SoakReport::MAX_KEPT) {
+            SoakViolation &v = r_.kept[r_.keptCount++];
+            v.check    = c;
+            v.atS      = (HostHal::nowUs() - cfg_.startUs) * 1e-6;
+            v.millisAt = static_cast<uint32_t>(HostHal::nowUs() / 1000UL);
+            v.value    = value;
+        }
+    }
+};
+
+/** Serial TX → telemetry records for the checker. */
+class RecordTap {
+public:
+    explicit RecordTap(Checker &checker) : checker_(checker) {}
+
+    void poll() {
+        bytes_.clear();
+        HostHal::takeSerialTx(bytes_);
+        for (uint8_t b : bytes_) {
+            CaptureDecoder::Frame got = decoder_.feed(b);
+            if (got == CaptureDecoder::Frame::RECORD || got == CaptureDecoder::Frame::TICK) {
+                checker_.record(decoder_.record());
+            }
+        }
+    }
+
+    uint32_t badFrames() const { return decoder_.badFrames(); }
+
+private:
+    Checker             &checker_;
+    CaptureDecoder       decoder_;
+    std::vector<uint8_t> bytes_;
+};
+
+/** Rollovers of a counter of 2^32 @p unit between @p fromUs and @p toUs. */
+uint32_t wrapsBetween(unsigned long fromUs, unsigned long toUs, unsigned long unit) {
+    return static_cast<uint32_t>(((toUs / unit) >> 32) - ((fromUs / unit) >> 32));
+}
+
+}  // namespace
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+uint32_t SoakReport::totalViolations() const {
+    uint32_t n = 0;
+    for (uint32_t v : violations) n += v;
+    return n;
+}
+
+const char *SimSoak::checkName(SoakCheck c) {
+    switch (c) {
+        case SoakCheck::TICK:      return "tick";
+        case SoakCheck::STALL:     return "stall";
+        case SoakCheck::PARK:      return "park";
+        case SoakCheck::REACQUIRE: return "reacquire";
+        case SoakCheck::DRIFT:     return "drift";
+        case SoakCheck::LIMITS:    return "limits";
+        default:                   return "?";
+    }
+}
+
+BeaconPose SimSoak::usagePath(double tS) {
+    BeaconPose b;
+    uint32_t day = static_cast<uint32_t>(tS / DAY_S);
+    double   tod = tS - day * DAY_S;
+    if (!inSession(day, tod)) return b;
+
+    // Ten-minute slots: one in six a break out of the room.
+    uint32_t slot = static_cast<uint32_t>(tod / SLOT_S);
+    double   in   = tod - slot * SLOT_S;
+    double   u    = unitHash(day, slot + 1);
+    if (u < 1.0 / 6.0) return b;
+    b.present = true;
+
+    // The desk moves from day to day.
+    double deskAz = -20.0 + 40.0 * unitHash(day, 1000);
+    double deskEl =   5.0 + 15.0 * unitHash(day, 1001);
+    uint32_t excursion = static_cast<uint32_t>(9.0 * HOUR_S / SLOT_S) +
+                         static_cast<uint32_t>(unitHash(day, 1002) * 6.0);
+
+    if (slot == excursion && in < 60.0) {
+        // Once a day: out past the pan limit on one side and back.
+        double side = unitHash(day, 1003) < 0.5 ? -1.0 : 1.0;
+        b.azDeg = static_cast<float>(deskAz + (side * 165.0 - deskAz) * sin(TWO_PI * in / 120.0));
+        b.elDeg = static_cast<float>(deskEl);
+    } else if (u > 0.85 && in < 40.0) {
+        // A walk across the room and back.
+        b.azDeg = static_cast<float>(deskAz + 90.0 * sin(TWO_PI * in / 40.0));
+        b.elDeg = static_cast<float>(deskEl + 6.0 * sin(TWO_PI * in / 40.0));
+    } else {
+        b.azDeg = static_cast<float>(deskAz + 2.0 * sin(TWO_PI * tS / 7.0));
+        b.elDeg = static_cast<float>(deskEl + 1.0 * sin(TWO_PI * tS / 11.0));
+    }
+    return b;
+}
+
+bool SimSoak::run(const SoakConfig &cfg, SoakReport &out) {
+    if (cfg.stepUs == 0 || cfg.days <= 0.0) return false;
+
+    SimParams params = cfg.world;
+    params.path = usagePath;
+    routineSeed = params.seed;
+    const BurstProfile &bp = params.bursts;
+    params.burstPhaseUs = static_cast<uint32_t>(std::mt19937(params.seed)() %
+                                                (bp.onUs + bp.offUs + bp.sleepUs));
+
+    out = SoakReport();
+    HostHal::reset();
+    HostHal::advanceUs(cfg.startUs);
+    SimWorld world;
+    world.init(params);
+    Checker checker(cfg, out);
+    RecordTap tap(checker);
+
+    const unsigned long dayUs = static_cast<unsigned long>(DAY_S * 1e6);
+    const unsigned long endUs = cfg.startUs + static_cast<unsigned long>(cfg.days * DAY_S * 1e6);
+    unsigned long nextDayUs = cfg.startUs + dayUs;
+    uint64_t dayRecords = 0;
+
+    auto wallStart = std::chrono::steady_clock::now();
+    auto dayStart  = wallStart;
+
+    setup();
+    tap.poll();
+    checker.observe(world);
+
+    while (HostHal::nowUs() < endUs) {
+        loop();
+        tap.poll();
+        HostHal::advanceUs(cfg.stepUs);
+        world.step(cfg.stepUs);
+        checker.observe(world);
+
+        if (HostHal::nowUs() >= nextDayUs) {
+            auto t = std::chrono::steady_clock::now();
+            double wall = std::chrono::duration<double>(t - dayStart).count();
+            if (cfg.progress) {
+                fprintf(cfg.progress, "day %4lu  millis() %10lu  %8.0f ticks/s  %3lu violations\n",
+                        static_cast<unsigned long>((nextDayUs - cfg.startUs) / dayUs),
+                        static_cast<unsigned long>(static_cast<uint32_t>(nextDayUs / 1000UL)),
+                        wall > 0.0 ? (out.records - dayRecords) / wall : 0.0,
+                        static_cast<unsigned long>(out.totalViolations()));
+                fflush(cfg.progress);
+            }
+            dayRecords = out.records;
+            dayStart   = t;
+            nextDayUs += dayUs;
+        }
+    }
+
+    out.simS      = (HostHal::nowUs() - cfg.startUs) * 1e-6;
+    out.wallS     = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    out.badFrames = tap.badFrames();
+    out.msWraps   = wrapsBetween(cfg.startUs, HostHal::nowUs(), 1000UL);
+    out.usWraps   = wrapsBetween(cfg.startUs, HostHal::nowUs(), 1UL);
+    return true;
+}
+
+void SimSoak::printReport(FILE *f, const SoakReport &r) {
+    fprintf(f, "Soaked %.1f days in %.1f s wall (%.0fx real time), %.0f ticks/s\n",
+            r.simS / DAY_S, r.wallS, r.wallS > 0.0 ? r.simS / r.wallS : 0.0,
+            r.wallS > 0.0 ? r.records / r.wallS : 0.0);
+    fprintf(f, "  %llu records, %llu ticks without one, %lu bad frames\n",
+            static_cast<unsigned long long>(r.records), static_cast<unsigned long long>(r.skipped),
+            static_cast<unsigned long>(r.badFrames));
+    fprintf(f, "  rollovers crossed: millis() %lu, micros() %lu\n",
+            static_cast<unsigned long>(r.msWraps), static_cast<unsigned long>(r.usWraps));
+
+    fprintf(f, "\nTime per state:\n");
+    for (uint8_t s = 0; s < static_cast<uint8_t>(TurretState::COUNT); s++) {
+        if (r.stateTicks[s] == 0) continue;
+        double h = r.stateTicks[s] * (LOOP_PERIOD_MS / 1000.0) / HOUR_S;
+        fprintf(f, "  %-10s %10.1f h  %5.1f %%\n",
+                TurretStateMachine::stateName(static_cast<TurretState>(s)), h,
+                r.records > 0 ? 100.0 * r.stateTicks[s] / r.records : 0.0);
+    }
+
+    fprintf(f, "\nBeacon came into view %lu times\n", static_cast<unsigned long>(r.inViewRuns));
+    fprintf(f, "  in view → tracking    %8.0f ms worst (bound %lu)\n",
+            r.reacquireMaxMs, static_cast<unsigned long>(REACQUIRE_BOUND_MS));
+    fprintf(f, "  out of view → parked  %8.0f ms worst (bound %lu)\n",
+            r.parkMaxMs, static_cast<unsigned long>(parkBoundMs()));
+    fprintf(f, "  dead-reckoning drift  %8.2f° worst\n", r.driftMaxDeg);
+    fprintf(f, "  estimated pan         %8.2f° furthest (limit %.0f°)\n", r.panMaxDeg, PAN_LIMIT_DEG);
+
+    fprintf(f, "\nViolations:");
+    for (uint8_t c = 0; c < static_cast<uint8_t>(SoakCheck::COUNT); c++) {
+        fprintf(f, "  %s %lu", checkName(static_cast<SoakCheck>(c)),
+                static_cast<unsigned long>(r.violations[c]));
+    }
+    fprintf(f, "\n");
+    for (uint8_t i = 0; i < r.keptCount; i++) {
+        const SoakViolation &v = r.kept[i];
+        uint32_t s = static_cast<uint32_t>(v.atS);
+        fprintf(f, "  day %3lu %02lu:%02lu:%02lu  millis() %10lu  %-9s %.1f\n",
+                static_cast<unsigned long>(s / 86400), static_cast<unsigned long>(s / 3600 % 24),
+                static_cast<unsigned long>(s / 60 % 60), static_cast<unsigned long>(s % 60),
+                static_cast<unsigned long>(v.millisAt), checkName(v.check), v.value);
+    }
+}
@@ -0,0 +1,118 @@
+/**
+ * @file sim_soak.h
+ * @brief Long soak: the firmware's setup() / loop() for weeks or months
+ *        of virtual time against a daily routine, with invariants checked
+ *        on every control tick.
+ *
+ * The clock starts wherever SoakConfig::startUs says, by default an hour
+ * short of the 49.7-day millis() wrap; micros() wraps every 71.6 minutes
+ * on its own.  HostHal's clocks are 32-bit, as on the ESP32, so every
+ * elapsed-time comparison in the firmware goes through both.
+ *
+ * The beacon keeps a weekly routine (usagePath()): weekday desk sessions
+ * with breaks out of the room, walks across it, one excursion a day past
+ * the pan limit; nights and most of the weekend away.
+ *
+ * Invariants, from the decoded telemetry against the world's ground truth:
+ *
+ *   tick       a record every LOOP_PERIOD_US (a whole number of periods
+ *              after a lost frame); none for STALL_MS is a stall
+ *   park       nothing in any sensor's view for parkBoundMs() → PARKED
+ *   reacquire  the beacon in view for REACQUIRE_BOUND_MS → ACQUIRING or
+ *              LOCKED somewhere in that time
+ *   drift      dead-reckoned pan within driftDeg of the true pan, with
+ *              the pan at rest (moving, the servo's lag adds a few degrees)
+ *   limits     estimated pan within ±PAN_LIMIT_DEG (plus one tick at
+ *              full speed); tilt within [TILT_MIN_DEG, TILT_MAX_DEG]
+ *
+ * A violation counts once per episode (failing until it passes again);
+ * the first MAX_KEPT are kept with their times.
+ *
+ * The firmware keeps its modules in file statics (main.cpp): one run
+ * per process, as SimRun.
+ */
+
+#ifndef SIM_SOAK_H
+#define SIM_SOAK_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "sim_world.h"
+#include "turret_fsm.h"
+
+/** @brief What to soak. */
+struct SoakConfig {
+    SimParams     world;                     ///< path is usagePath(); seed picks the routine
+    double        days     = 60.0;
+    unsigned long startUs  = ((1ULL << 32) - 3600000ULL) * 1000ULL;   ///< millis() wraps an hour in
+    unsigned long stepUs   = 2000;           ///< Divides the tick grids (CAPTURE_LEAD_US, LOOP_PERIOD_US)
+    float         driftDeg = 30.0f;          ///< Dead-reckoning bound
+    FILE         *progress = nullptr;        ///< A line per simulated day, or nullptr
+};
+
+/** @brief One invariant. */
+enum class SoakCheck : uint8_t {
+    TICK,
+    STALL,
+    PARK,
+    REACQUIRE,
+    DRIFT,
+    LIMITS,
+    COUNT
+};
+
+/** @brief Start of one violation episode. */
+struct SoakViolation {
+    SoakCheck check;
+    double    atS;        ///< Since boot
+    uint32_t  millisAt;   ///< The firmware's millis() then
+    float     value;      ///< What failed: gap ms, age ms, degrees
+};
+
+/** @brief Results of one soak. */
+struct SoakReport {
+    static constexpr uint8_t MAX_KEPT = 16;
+
+    double   simS    = 0.0;
+    double   wallS   = 0.0;
+    uint64_t records = 0;
+    uint64_t skipped = 0;                    ///< Ticks with no record (lost frames)
+    uint32_t badFrames  = 0;
+    uint32_t msWraps    = 0;                 ///< millis() rollovers crossed
+    uint32_t usWraps    = 0;                 ///< micros() rollovers crossed
+    uint64_t stateTicks[static_cast<uint8_t>(TurretState::COUNT)] = {};
+
+    uint32_t inViewRuns   = 0;               ///< Beacon came into some sensor's view
+    float    reacquireMaxMs = 0.0f;          ///< In view → ACQUIRING / LOCKED, worst
+    float    parkMaxMs      = 0.0f;          ///< Out of view → PARKED, worst
+    float    driftMaxDeg    = 0.0f;
+    float    panMaxDeg      = 0.0f;          ///< Estimated, either side
+
+    uint32_t      violations[static_cast<uint8_t>(SoakCheck::COUNT)] = {};
+    SoakViolation kept[MAX_KEPT];
+    uint8_t       keptCount = 0;
+
+    uint32_t totalViolations() const;
+};
+
+class SimSoak {
+public:
+    static constexpr uint32_t STALL_MS           = 1000;
+    static constexpr uint32_t REACQUIRE_BOUND_MS = 60000;
+
+    /** @brief Longest out of view before PARKED: the adaptive ceiling plus a minute. */
+    static uint32_t parkBoundMs() { return ADAPT_PARK_MAX_MS + 60000; }
+
+    static const char *checkName(SoakCheck c);
+
+    /** @brief Beacon pose @p tS into the routine (SimWorld path; seed from run()). */
+    static BeaconPose usagePath(double tS);
+
+    /** @brief Soak @p cfg in this process (once per process). */
+    static bool run(const SoakConfig &cfg, SoakReport &out);
+
+    /** @brief Human-readable summary of @p r. */
+    static void printReport(FILE *f, const SoakReport &r);
+};
+
+#endif // SIM_SOAK_H
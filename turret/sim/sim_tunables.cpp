@@ -0,0 +1,91 @@
+/**
+ * @file sim_tunables.cpp
+ * @brief The tunables table.
+ */
+
+#include "sim_tunables.h"
+#include "config.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <type_traits>
+
+namespace {
+
+template <typename T>
+void assign(T &dst, double v) {
+    dst = std::is_integral<T>::value ? static_cast<T>(llround(v)) : static_cast<T>(v);
+}
+
+}  // namespace
+
+#define SIM_TUNABLE(type, name, lo, hi, step)                       \
+    {#name, #type,                                                  \
+     [] { return static_cast<double>(name); },                      \
+     [](double v) { assign(name, v); },                             \
+     lo, hi, step, std::is_integral<type>::value}
+
+const SimTunable SimTunables::TUNABLES[] = {
+    SIM_TUNABLE(uint8_t,  SENSOR_FILTER_WINDOW,      7,     8,     1),
+    SIM_TUNABLE(uint8_t,  ACQUIRE_FILTER_THRESHOLD,  1,     4,     1),
+    SIM_TUNABLE(uint8_t,  LOCK_FILTER_THRESHOLD,     1,     6,     1),
+    SIM_TUNABLE(float,    TRACK_PAN_SPEED_FAST,      0.40,  1.00,  0.05),
+    SIM_TUNABLE(float,    TRACK_PAN_SPEED_SLOW,      0.15,  0.50,  0.05),
+    SIM_TUNABLE(uint16_t, TRACK_APPROACH_MEMORY_MS,  100,   1000,  100),
+    SIM_TUNABLE(float,    LOCK_PAN_SPEED_FAST,       0.20,  0.80,  0.05),
+    SIM_TUNABLE(float,    LOCK_PAN_SPEED_SLOW,       0.15,  0.40,  0.05),
+    SIM_TUNABLE(uint16_t, LOCK_CENTERED_MS,          100,   800,   100),
+    SIM_TUNABLE(uint16_t, LOCK_BREAK_MS,             100,   1000,  100),
+    SIM_TUNABLE(uint16_t, COAST_MAX_MS,              100,   1500,  100),
+    SIM_TUNABLE(uint16_t, COAST_DEBOUNCE_MS,         0,     400,   20),
+    SIM_TUNABLE(uint16_t, TILT_HOLDOFF_MS,           20,    300,   20),
+    SIM_TUNABLE(float,    SPRT_P_HIT_ABSENT,         0.002, 0.040, 0.002),
+    SIM_TUNABLE(float,    SPRT_ALPHA,                5e-5,  1e-3,  5e-5),
+    SIM_TUNABLE(float,    SPRT_BETA,                 5e-7,  1e-5,  5e-7),
+    SIM_TUNABLE(uint16_t, SIGNAL_LOSS_PARK_MS,       5000,  60000, 5000),
+    SIM_TUNABLE(uint32_t, ADAPT_PARK_MIN_MS,         1000,  20000, 1000),
+    SIM_TUNABLE(uint32_t, ADAPT_PARK_MAX_MS,         30000, 300000, 30000),
+    SIM_TUNABLE(float,    ADAPT_HOLD_QUANTILE,       0.50,  0.95,  0.05),
+    SIM_TUNABLE(uint32_t, ADAPT_HOLD_MAX_MS,         10000, 120000, 10000),
+    SIM_TUNABLE(float,    SEARCH_SWEEP_SPEED,        0.15,  1.00,  0.05),
+};
+
+#undef SIM_TUNABLE
+
+const uint8_t SimTunables::COUNT = sizeof(TUNABLES) / sizeof(TUNABLES[0]);
+
+int SimTunables::indexOf(const char *name) {
+    for (uint8_t i = 0; i < COUNT; i++) {
+        if (strcmp(TUNABLES[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+const double *SimTunables::defaults() {
+    // Taken once, by the first caller, before any apply(): each thread's
+    // tunables start at config.h's values.
+    struct Values {
+        double v[sizeof(TUNABLES) / sizeof(TUNABLES[0])];
+    };
+    static const Values values = [] {
+        Values d;
+        for (uint8_t i = 0; i < COUNT; i++) d.v[i] = TUNABLES[i].get();
+        return d;
+    }();
+    return values.v;
+}
+
+void SimTunables::apply(const double *values) {
+    defaults();
+    for (uint8_t i = 0; i < COUNT; i++) TUNABLES[i].set(values[i]);
+}
+
+void SimTunables::format(const SimTunable &t, double v, char *buf, size_t len) {
+    if (t.integral) {
+        snprintf(buf, len, "%lld", llround(v));
+    } else {
+        snprintf(buf, len, "%.3gf", v);
+        // "1f" is not a float literal.
+        if (!strpbrk(buf, ".e")) snprintf(buf, len, "%.1ff", v);
+    }
+}
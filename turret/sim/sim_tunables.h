@@ -0,0 +1,52 @@
+/**
+ * @file sim_tunables.h
+ * @brief The config.h tunables a simulation may override.
+ *
+ * Under SENTRY_SIM, TURRET_TUNABLE constants are plain variables, one
+ * per thread (config.h).  This table names them, reads and writes them as doubles
+ * (integers round), and gives each a default search range for
+ * sentry-tune.
+ *
+ * Set them before setup(), on the thread that runs it: the firmware
+ * copies some into its modules at init.  SimRun::run() does so from
+ * SimConfig::tunables.
+ */
+
+#ifndef SIM_TUNABLES_H
+#define SIM_TUNABLES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief One tunable and its default search range. */
+struct SimTunable {
+    const char *name;
+    const char *type;              ///< As declared in config.h
+    double    (*get)();
+    void      (*set)(double v);
+    double      lo, hi, step;      ///< Default range; step is the grid spacing
+    bool        integral;
+};
+
+class SimTunables {
+public:
+    static const SimTunable TUNABLES[];
+    static const uint8_t    COUNT;
+
+    /** @return Index into TUNABLES, or −1. */
+    static int indexOf(const char *name);
+
+    /**
+     * @brief The compiled-in values, COUNT entries.  Taken once, before
+     *        anything in this process calls apply(); safe from any thread.
+     */
+    static const double *defaults();
+
+    /** @brief Set every tunable from @p values (COUNT entries). */
+    static void apply(const double *values);
+
+    /** @brief @p v as a config.h literal ("0.45f", "400"). */
+    static void format(const SimTunable &t, double v, char *buf, size_t len);
+};
+
+#endif // SIM_TUNABLES_H
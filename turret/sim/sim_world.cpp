@@ -0,0 +1,280 @@
+/**
+ * @file sim_world.cpp
+ * @brief Servo mechanics, beacon scenarios and the TSOP model.
+ */
+
+#include "sim_world.h"
+#include "hal.h"
+#include <math.h>
+#include <string.h>
+
+// ===================================================================
+// Beacon scenarios
+// ===================================================================
+
+namespace {
+
+constexpr double TWO_PI = 6.283185307179586;
+
+/** Sitting at a desk 40° right: small fidgets. */
+BeaconPose seatedPath(double tS) {
+    BeaconPose b;
+    b.present = true;
+    b.azDeg   = static_cast<float>(40.0 + 2.0 * sin(TWO_PI * tS / 7.0));
+    b.elDeg   = static_cast<float>(15.0 + 1.0 * sin(TWO_PI * tS / 11.0));
+    return b;
+}
+
+/** Walks back and forth across the room, ±60° at up to ~13°/s. */
+BeaconPose walkPath(double tS) {
+    BeaconPose b;
+    b.present = true;
+    b.azDeg   = static_cast<float>(60.0 * sin(TWO_PI * tS / 30.0));
+    b.elDeg   = static_cast<float>(12.0 + 6.0 * sin(TWO_PI * tS / 23.0));
+    return b;
+}
+
+/** Every 30 s: 10 s crossing from −80° to +80° (or back) at 16°/s, then gone. */
+BeaconPose passbyPath(double tS) {
+    const double cycleS = 30.0, crossS = 10.0;
+    unsigned long pass = static_cast<unsigned long>(tS / cycleS);
+    double in = tS - pass * cycleS;
+
+    BeaconPose b;
+    b.present = in < crossS;
+    float along = static_cast<float>(-80.0 + 160.0 * in / crossS);
+    b.azDeg   = (pass % 2) ? -along : along;
+    b.elDeg   = 10.0f;
+    return b;
+}
+
+/** Slow walk, ±30°, blocked for 2 s every 15 s (someone in between). */
+BeaconPose occlusionPath(double tS) {
+    BeaconPose b;
+    b.present = fmod(tS, 15.0) >= 2.0;
+    b.azDeg   = static_cast<float>(30.0 * sin(TWO_PI * tS / 60.0));
+    b.elDeg   = 12.0f;
+    return b;
+}
+
+/** 60 s in the room near one of four spots, then 30 s away. */
+BeaconPose awayPath(double tS) {
+    static const float SPOTS[] = {35.0f, -70.0f, 100.0f, -25.0f};
+    const double cycleS = 90.0;
+    unsigned long visit = static_cast<unsigned long>(tS / cycleS);
+    double inVisit = tS - visit * cycleS;
+
+    BeaconPose b;
+    b.present = inVisit < 60.0;
+    b.azDeg   = SPOTS[visit % 4] + static_cast<float>(8.0 * sin(TWO_PI * tS / 20.0));
+    b.elDeg   = 12.0f;
+    return b;
+}
+
+/** Wanders ±160°, past the pan limit (PAN_LIMIT_DEG) each way. */
+BeaconPose beyondPath(double tS) {
+    BeaconPose b;
+    b.present = true;
+    b.azDeg   = static_cast<float>(160.0 * sin(TWO_PI * tS / 120.0));
+    b.elDeg   = 10.0f;
+    return b;
+}
+
+/** Sunlit room: seated for 60 s, then away for 4 min while ambient IR keeps hitting. */
+BeaconPose noisePath(double tS) {
+    BeaconPose b = seatedPath(tS);
+    b.present = fmod(tS, 300.0) < 60.0;
+    return b;
+}
+
+float wrap180(float deg) {
+    deg = fmodf(deg + 180.0f, 360.0f);
+    if (deg < 0.0f) deg += 360.0f;
+    return deg - 180.0f;
+}
+
+}  // namespace
+
+const BeaconScenario SimWorld::SCENARIOS[] = {
+    {"seated",    seatedPath,    "seated 40° right, small fidgets",                     300.0f, -1.0f},
+    {"walk",      walkPath,      "walks ±60° across the room (up to ~13°/s)",           300.0f, -1.0f},
+    {"passby",    passbyPath,    "10 s crossings at 16°/s, 20 s apart",                 300.0f, -1.0f},
+    {"occlusion", occlusionPath, "slow ±30° walk, blocked 2 s in every 15 s",           300.0f, -1.0f},
+    {"away",      awayPath,      "60 s at one of four spots, then 30 s out of range",   360.0f, -1.0f},
+    {"beyond",    beyondPath,    "wanders ±160°, past the pan limit",                   360.0f, -1.0f},
+    {"noise",     noisePath,     "seated 60 s then away 4 min, heavy ambient IR",       300.0f, 0.03f},
+};
+
+const uint8_t SimWorld::SCENARIO_COUNT = sizeof(SCENARIOS) / sizeof(SCENARIOS[0]);
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+const BeaconScenario *SimWorld::findScenario(const char *name) {
+    for (uint8_t i = 0; i < SCENARIO_COUNT; i++) {
+        if (strcmp(SCENARIOS[i].name, name) == 0) return &SCENARIOS[i];
+    }
+    return nullptr;
+}
+
+void SimWorld::init(const SimParams &params) {
+    p_       = params;
+    panDeg_  = 0.0f;
+    panRate_ = 0.0f;
+    tiltDeg_ = -1.0f;
+    lagDtUs_ = 0;
+    startUs_ = HostHal::nowUs();
+    pose_    = p_.path ? p_.path(0.0) : BeaconPose{};
+    rng_.seed(params.seed);
+
+    started_      = false;
+    hadPrev_      = false;
+    nextBurstUs_  = HostHal::nowUs() + params.burstPhaseUs;
+    burstInTrain_ = 0;
+
+    HostHal::setPinReader(readPin, this);
+    HostHal::setLatchReader(readLatch, this);
+}
+
+void SimWorld::step(unsigned long dtUs) {
+    float dtS = dtUs * 1e-6f;
+
+    // Pan: commanded speed from the pulse, then the motor's lag.
+    float target = 0.0f;
+    uint16_t panUs = HostHal::servoPulseUs(PIN_PAN_SERVO);
+    if (panUs != 0) {
+        int delta = static_cast<int>(p_.panNeutralUs) - panUs;   // > 0 = CW
+        if (abs(delta) > p_.panDeadbandUs) {
+            float cmd = static_cast<float>(delta) / (PAN_STOP_US - PAN_CW_FULL_US);
+            if (cmd >  1.0f) cmd =  1.0f;
+            if (cmd < -1.0f) cmd = -1.0f;
+            target = cmd * p_.panFullDegPerSec;
+        }
+    }
+    if (dtUs != lagDtUs_) {
+        lagDtUs_ = dtUs;
+        lagGain_ = 1.0f - expf(-dtS * 1000.0f / p_.panLagMs);
+    }
+    panRate_ += (target - panRate_) * lagGain_;
+    // Spun down: stop the decay at zero, not in denormals (which make
+    // every step of a long parked stretch many times slower).
+    if (target == 0.0f && fabsf(panRate_) < 1e-6f) panRate_ = 0.0f;
+    panDeg_  += panRate_ * dtS;
+
+    // Tilt: slew towards the commanded angle.
+    uint16_t tiltUs = HostHal::servoPulseUs(PIN_TILT_SERVO);
+    if (tiltUs != 0) {
+        float goal = (tiltUs - SERVO_MIN_PULSE_US) * 180.0f /
+                     (SERVO_MAX_PULSE_US - SERVO_MIN_PULSE_US);
+        if (tiltDeg_ < 0.0f) {
+            tiltDeg_ = goal;   // Wherever it was, it starts where first told
+        } else {
+            float maxStep = p_.tiltSlewDegPerSec * dtS;
+            float err = goal - tiltDeg_;
+            tiltDeg_ += (err > maxStep) ? maxStep : (err < -maxStep) ? -maxStep : err;
+        }
+    }
+
+    if (p_.path) pose_ = p_.path((HostHal::nowUs() - startUs_) * 1e-6);
+}
+
+float SimWorld::panErrorDeg() const {
+    return wrap180(pose_.azDeg - panDeg_);
+}
+
+float SimWorld::tiltErrorDeg() const {
+    return pose_.elDeg - (tiltDeg_ < 0.0f ? 0.0f : tiltDeg_);
+}
+
+uint8_t SimWorld::inViewBits() const {
+    if (!pose_.present) return 0;
+
+    float d  = panErrorDeg();
+    float e  = tiltErrorDeg();
+    float ov = p_.centerOverlapDeg;
+    if (fabsf(d) > SENSOR_FOV_PAN_HALF_DEG || fabsf(e) > SENSOR_FOV_TILT_HALF_DEG) return 0;
+
+    uint8_t bits = 0;
+    if (e >= -ov) bits |= 1u << 0;   // top
+    if (e <=  ov) bits |= 1u << 1;   // bottom
+    if (d <=  ov) bits |= 1u << 2;   // left
+    if (d >= -ov) bits |= 1u << 3;   // right
+    return bits;
+}
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+void SimWorld::catchUp(unsigned long tUs) {
+    const BurstProfile &bp = p_.bursts;
+
+    // Only the latest two bursts matter: the TSOP's release delay is
+    // shorter than any gap, so the one before the latest is the last
+    // that can have been LOW while the latest has not started to be.
+    while (nextBurstUs_ <= tUs) {
+        if (started_) {
+            prevLowEndUs_ = burstStartUs_ + bp.onUs + p_.tsopOffDelayUs;
+            hadPrev_      = true;
+        }
+        burstStartUs_ = nextBurstUs_;
+        started_      = true;
+
+        float gap = bp.offUs + bp.offJitterUs * spread();
+        if (++burstInTrain_ >= bp.bursts) {
+            burstInTrain_ = 0;
+            gap += bp.sleepUs * (1.0f + bp.sleepJitterPct / 100.0f * spread());
+        }
+        nextBurstUs_ = burstStartUs_ + bp.onUs + static_cast<unsigned long>(gap);
+    }
+}
+
+bool SimWorld::tsopActive(unsigned long tUs) {
+    catchUp(tUs);
+    if (!started_) return false;
+    unsigned long since = tUs - burstStartUs_;
+    return since >= p_.tsopOnDelayUs && since < static_cast<unsigned long>(p_.bursts.onUs) + p_.tsopOffDelayUs;
+}
+
+bool SimWorld::tsopActiveIn(unsigned long fromUs, unsigned long toUs) {
+    catchUp(toUs);
+    if (!started_) return false;
+
+    // LOW over [start + on delay, start + burst + off delay).
+    unsigned long lowFrom = burstStartUs_ + p_.tsopOnDelayUs;
+    unsigned long lowEnd  = burstStartUs_ + p_.bursts.onUs + p_.tsopOffDelayUs;
+    if (lowFrom <= toUs) return lowEnd > fromUs;
+    return hadPrev_ && prevLowEndUs_ > fromUs;
+}
+
+uint8_t SimWorld::sensorBit(uint8_t pin) {
+    switch (pin) {
+        case PIN_SENSOR_TOP:    return 0;
+        case PIN_SENSOR_BOTTOM: return 1;
+        case PIN_SENSOR_LEFT:   return 2;
+        case PIN_SENSOR_RIGHT:  return 3;
+        default:                return 0xFF;
+    }
+}
+
+int SimWorld::readPin(uint8_t pin, void *self) {
+    SimWorld *w = static_cast<SimWorld *>(self);
+    uint8_t bit = sensorBit(pin);
+    if (bit == 0xFF) return HIGH;
+
+    // TSOP38238 is active-low.
+    if ((w->inViewBits() & (1u << bit)) && w->tsopActive(HostHal::nowUs())) return LOW;
+    if (w->unit_(w->rng_) < w->p_.noiseLowP) return LOW;
+    return HIGH;
+}
+
+bool SimWorld::readLatch(uint8_t pin, uint64_t fromUs, uint64_t toUs, void *self) {
+    SimWorld *w = static_cast<SimWorld *>(self);
+    uint8_t bit = sensorBit(pin);
+    if (bit == 0xFF) return false;
+
+    // In view as of now: the pan moves well under a FOV per tick.
+    if ((w->inViewBits() & (1u << bit)) && w->tsopActiveIn(fromUs, toUs)) return true;
+    return w->unit_(w->rng_) < w->p_.noiseLowP;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file sim_world.h
+ * @brief What the turret's hardware sees: servo mechanics, the beacon's
+ *        path and emission timing, and the TSOP sensors' response.
+ *
+ * Angles share the firmware's frame: pan 0° is the boot position and
+ * positive is clockwise (PanController); tilt is the servo angle.  A
+ * beacon at azimuth az is "to the left" when az − pan < 0.
+ *
+ *   Pan   continuous-rotation servo: speed from the pulse width around
+ *         its true neutral, a dead band, a first-order lag, and a
+ *         full-speed rate that need not match PAN_DEG_PER_SEC (the
+ *         firmware's dead reckoning then drifts, as on the bench).
+ *         No pulses (detached) → spins down.
+ *   Tilt  positional servo: slews towards the commanded angle at a
+ *         fixed rate; holds when detached.
+ *   TSOP  each sensor sees the beacon inside the cross's field of view
+ *         (SENSOR_FOV_*_HALF_DEG) on its side of the divider, plus a
+ *         small overlap across the centre so left and right (top and
+ *         bottom) both see a centred beacon.  While it sees it, the
+ *         output is LOW from tsopOnDelayUs after each burst starts to
+ *         tsopOffDelayUs after it ends.  Ambient noise adds independent
+ *         false LOWs.
+ *
+ * Pin levels are computed when the firmware reads them, at the exact
+ * virtual time, and a LOW latch (Hal::takeLowLatch()) asks whether any
+ * LOW fell since the previous take, so burst timing against the capture
+ * tick is faithful whatever the simulator's step.
+ */
+
+#ifndef SIM_WORLD_H
+#define SIM_WORLD_H
+
+#include <stdint.h>
+#include <random>
+#include "config.h"
+
+/** @brief Beacon emission timing. */
+struct BurstProfile {
+    const char *name;
+    uint16_t    onUs;         ///< Carrier burst
+    uint16_t    offUs;        ///< Gap after each burst
+    uint8_t     bursts;       ///< Bursts per train
+    uint32_t    sleepUs;      ///< Quiet time after the train
+    uint16_t    offJitterUs;  ///< Each gap drawn from offUs ± this
+    uint8_t     sleepJitterPct; ///< Each sleep drawn from sleepUs ± this %
+};
+
+/**
+ * @brief Shipped beacon firmware (beacon/include/config.h): 5 × (600 +
+ *        600) µs, then the ~120 ms watchdog sleep (its RC oscillator
+ *        is good to about ±10 %).  A TSOP that sees it is LOW for ~2–3 %
+ *        of the time; its latch catches a train on ~20 % of the ticks
+ *        (SPRT_P_HIT_PRESENT).
+ */
+constexpr BurstProfile BURSTS_FIRMWARE = {"firmware", BEACON_BURST_ON_US, BEACON_BURST_OFF_US,
+                                          BEACON_BURSTS, BEACON_SLEEP_MS * 1000UL, 0, 10};
+
+/**
+ * @brief 600 / 600 µs with no sleep.  ~50 % LOW, latched on every tick;
+ *        the level at the tick, which the saturation guard reads, is
+ *        locked to the 20 ms sample grid in a fixed 1-in-3 or 2-in-3
+ *        pattern.
+ */
+constexpr BurstProfile BURSTS_CONTINUOUS = {"continuous", 600, 600, 1, 0, 0, 0};
+
+/**
+ * @brief 600 µs bursts, gaps 300–900 µs at random: ~50 % LOW, latched
+ *        on every tick, with the level at the tick close to independent.
+ *        Far easier to see than the shipped beacon: tracking with
+ *        detection out of the way.
+ */
+constexpr BurstProfile BURSTS_DITHERED = {"dithered", 600, 600, 1, 0, 300, 0};
+
+/** @brief Where the beacon is at one instant. */
+struct BeaconPose {
+    bool  present = false;   ///< In the room (in range)
+    float azDeg   = 0.0f;
+    float elDeg   = 0.0f;
+};
+
+/** @brief Beacon trajectory: pose @p tS seconds of virtual time after SimWorld::init(). */
+typedef BeaconPose (*BeaconPath)(double tS);
+
+/** @brief Named trajectory and the room it plays in. */
+struct BeaconScenario {
+    const char *name;
+    BeaconPath  path;
+    const char *description;
+    float       seconds;     ///< Default run length
+    float       noiseLowP;   ///< Ambient false-LOW chance per read; < 0 = SimParams default
+};
+
+/** @brief Physical parameters; the defaults are a plausible bench build. */
+struct SimParams {
+    // Pan (continuous-rotation servo)
+    float    panFullDegPerSec = PAN_DEG_PER_SEC * 1.05f;   ///< True rate at full command
+    float    panLagMs         = 80.0f;                     ///< Speed time constant
+    uint16_t panNeutralUs     = PAN_STOP_US;               ///< Where it really stops
+    uint16_t panDeadbandUs    = 8;
+
+    // Tilt (positional servo)
+    float    tiltSlewDegPerSec = 400.0f;
+
+    // Sensors
+    float    centerOverlapDeg = 3.0f;
+    uint16_t tsopOnDelayUs    = 200;
+    uint16_t tsopOffDelayUs   = 150;
+    float    noiseLowP        = 0.005f;   ///< Chance of a false LOW per read or latch take
+
+    // Beacon
+    BurstProfile bursts        = BURSTS_FIRMWARE;
+    BeaconPath   path          = nullptr;
+    uint32_t     burstPhaseUs  = 0;       ///< First burst starts here
+    uint32_t     seed          = 1;
+};
+
+class SimWorld {
+public:
+    static const BeaconScenario SCENARIOS[];
+    static const uint8_t        SCENARIO_COUNT;
+
+    /** @brief Scenario called @p name, or nullptr. */
+    static const BeaconScenario *findScenario(const char *name);
+
+    /**
+     * @brief Reset to rest at pan 0°, and install the sensor pins in HostHal.
+     *        The path starts now, whatever the clock reads.
+     */
+    void init(const SimParams &params);
+
+    /**
+     * @brief Advance the mechanics by @p dtUs (the clock has already
+     *        moved) and move the beacon to the current time.
+     */
+    void step(unsigned long dtUs);
+
+    float panDeg() const { return panDeg_; }
+    float panRateDegPerSec() const { return panRate_; }
+    float tiltDeg() const { return tiltDeg_; }
+
+    /** @brief Beacon pose as of the last step(). */
+    const BeaconPose &beacon() const { return pose_; }
+
+    /** @brief Beacon azimuth − pan, wrapped to ±180°. */
+    float panErrorDeg() const;
+
+    /** @brief Beacon elevation − tilt. */
+    float tiltErrorDeg() const;
+
+    /** @brief Sensors with the beacon in view (SensorArray bit order). */
+    uint8_t inViewBits() const;
+
+private:
+    SimParams   p_;
+    float       panDeg_  = 0.0f;
+    float       panRate_ = 0.0f;
+    float       tiltDeg_ = -1.0f;   ///< < 0 until the first pulse
+    unsigned long lagDtUs_ = 0;     ///< Step the pan lag gain is for
+    float       lagGain_ = 0.0f;
+    BeaconPose  pose_;
+    unsigned long startUs_ = 0;     ///< Virtual time of init(): the path's 0
+    std::mt19937 rng_;
+    std::uniform_real_distribution<float> unit_{0.0f, 1.0f};
+
+    // Burst schedule, generated as time reaches it.
+    unsigned long burstStartUs_ = 0;
+    unsigned long nextBurstUs_  = 0;
+    unsigned long prevLowEndUs_ = 0;       ///< TSOP release of the burst before
+    bool          started_      = false;   ///< burstStartUs_ is valid
+    bool          hadPrev_      = false;   ///< prevLowEndUs_ is valid
+    uint8_t       burstInTrain_ = 0;
+
+    /** @brief Generate the schedule up to @p tUs (non-decreasing). */
+    void catchUp(unsigned long tUs);
+
+    /** @brief TSOP output would be LOW at @p tUs (non-decreasing) for a beacon in view. */
+    bool tsopActive(unsigned long tUs);
+
+    /** @brief ... at any time in (@p fromUs, @p toUs] (toUs non-decreasing). */
+    bool tsopActiveIn(unsigned long fromUs, unsigned long toUs);
+
+    /** @brief Uniform in [−1, 1). */
+    float spread() { return 2.0f * unit_(rng_) - 1.0f; }
+
+    /** @brief Sensor bit of @p pin (SensorArray order), or 0xFF. */
+    static uint8_t sensorBit(uint8_t pin);
+
+    static int readPin(uint8_t pin, void *self);
+    static bool readLatch(uint8_t pin, uint64_t fromUs, uint64_t toUs, void *self);
+};
+
+#endif // SIM_WORLD_H
@@ -0,0 +1,148 @@
+/**
+ * @file sentry_batch.cpp
+ * @brief sentry-batch: Monte Carlo over thousands of turrets with the
+ *        structure-of-arrays kernels (SimBatch).
+ *
+ * Build and run (from turret/):
+ *
+ *     pio run -e batch && .pio/build/batch/program --lanes 4096 --seconds 600
+ *
+ * Options:
+ *
+ *     --lanes N      turrets stepped together (default 4096)
+ *     --seconds S    simulated time per turret (default 600)
+ *     --seed N       world seed (default 1)
+ *     --p-hit P      raw hit chance per tick for a sensor that sees the beacon
+ *                    (default SPRT_P_HIT_PRESENT, the shipped beacon)
+ *     --noise P      false hit chance per tick, any sensor
+ *     --check K      step K lanes through the real modules too (ScalarLane)
+ *                    and compare every tick; exit 1 on the first difference
+ *                    (default 64, 0 to skip)
+ *
+ * Throughput is lane-ticks per second: one lane through one
+ * LOOP_PERIOD_MS control tick.  With --check the checked lanes are
+ * timed too, and the ratio is like for like: the same loop, the same
+ * arithmetic, through the real module objects one lane at a time
+ * (ScalarLane).  It is printed against the ×100 the batch was asked for.
+ * It is not a speedup over sentry-sim: the lanes run the classic
+ * track / sweep / park loop (sim_batch.h), without the turret state
+ * machine, bearing prior, search planner or servo output frames that
+ * sentry-sim spends its time in.  It depends on the kernels vectorizing,
+ * which env:batch's -O3 -fno-trapping-math gets and its
+ * -fopt-info-vec-optimized report shows: every kernel loop in
+ * sim_batch.cpp should be listed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "sim_batch.h"
+#include "hal.h"
+
+namespace {
+
+/** @brief Speedup over the scalar path the batch was built for. */
+constexpr double SPEEDUP_GOAL = 100.0;
+
+struct Options {
+    uint32_t          lanes   = 4096;
+    double            seconds = 600.0;
+    uint32_t          check   = 64;
+    SimBatch::Params  params;
+};
+
+void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [--lanes N] [--seconds S] [--seed N] [--p-hit P] [--noise P]\n"
+            "          [--check K]\n", argv0);
+}
+
+bool parseArgs(int argc, char **argv, Options &o) {
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!v) return false;
+        if      (strcmp(a, "--lanes") == 0)   o.lanes         = static_cast<uint32_t>(strtoul(v, nullptr, 0));
+        else if (strcmp(a, "--seconds") == 0) o.seconds       = atof(v);
+        else if (strcmp(a, "--seed") == 0)    o.params.seed   = static_cast<uint32_t>(strtoul(v, nullptr, 0));
+        else if (strcmp(a, "--p-hit") == 0)   o.params.pHit   = static_cast<float>(atof(v));
+        else if (strcmp(a, "--noise") == 0)   o.params.pNoise = static_cast<float>(atof(v));
+        else if (strcmp(a, "--check") == 0)   o.check         = static_cast<uint32_t>(strtoul(v, nullptr, 0));
+        else return false;
+        i++;
+    }
+    if (o.check > o.lanes) o.check = o.lanes;
+    return o.lanes > 0 && o.seconds > 0.0 &&
+           o.params.pHit >= 0.0f && o.params.pHit <= 1.0f &&
+           o.params.pNoise >= 0.0f && o.params.pNoise <= 1.0f;
+}
+
+double since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    const uint32_t ticks = static_cast<uint32_t>(opt.seconds * 1000.0 / LOOP_PERIOD_MS);
+
+    SimBatch batch;
+    batch.init(opt.lanes, opt.params);
+
+    HostHal::reset();
+    std::vector<ScalarLane> scalar(opt.check);
+    for (ScalarLane &l : scalar) l.init();
+
+    double batchS = 0.0, scalarS = 0.0;
+    for (uint32_t t = 0; t < ticks; t++) {
+        auto t0 = std::chrono::steady_clock::now();
+        batch.step();
+        batchS += since(t0);
+
+        if (scalar.empty()) continue;
+        t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < opt.check; i++) scalar[i].step(batch.rawBits(i));
+        scalarS += since(t0);
+        HostHal::advanceUs(LOOP_PERIOD_US);
+
+        for (uint32_t i = 0; i < opt.check; i++) {
+            const char *what = scalar[i].diff(batch, i);
+            if (!what) continue;
+            fprintf(stderr, "lane %lu tick %lu: %s differs from the scalar modules\n",
+                    static_cast<unsigned long>(i), static_cast<unsigned long>(t), what);
+            return 1;
+        }
+    }
+
+    SimBatchTotals tot = batch.totals();
+    double laneTicks = static_cast<double>(ticks) * opt.lanes;
+    printf("%lu lanes × %.0f s (%lu ticks), p(hit) %.3f, noise %.3f\n",
+           static_cast<unsigned long>(opt.lanes), opt.seconds, static_cast<unsigned long>(ticks),
+           opt.params.pHit, opt.params.pNoise);
+    printf("  beacon present   %.0f lane-s\n", tot.presentS);
+    printf("  on target        %.1f %% of present\n", tot.onTargetPct);
+    printf("  tracking         %.1f %% of present\n", tot.trackingPct);
+    printf("  false tracking   %.2f %% of absent\n", tot.falseTrackPct);
+    printf("  rms pan error    %.1f°\n", tot.rmsErrDeg);
+    printf("  parked           %.1f %% of all\n", tot.parkedPct);
+    printf("batch    %.2f s wall, %.3g lane-ticks/s\n", batchS, laneTicks / batchS);
+
+    if (!scalar.empty()) {
+        double scalarRate = static_cast<double>(ticks) * opt.check / scalarS;
+        double speedup    = laneTicks / batchS / scalarRate;
+        printf("check    %lu lanes identical to the scalar modules for every tick\n",
+               static_cast<unsigned long>(opt.check));
+        printf("scalar   %.3g lane-ticks/s, same loop through the modules\n", scalarRate);
+        printf("speedup  batch ×%.1f like for like (goal ×%.0f, ×%.0f short)\n",
+               speedup, SPEEDUP_GOAL, SPEEDUP_GOAL / speedup);
+    }
+    return 0;
+}
@@ -0,0 +1,313 @@
+/**
+ * @file sentry_bench.cpp
+ * @brief sentry-bench: the scenario library through the closed-loop
+ *        simulator, KPIs against a checked-in baseline.
+ *
+ * Build and run (from turret/):
+ *
+ *     pio run -e bench && .pio/build/bench/program
+ *
+ * Every scenario in SimWorld::SCENARIOS runs for its default length with
+ * --seeds seeds (in this process; --fork runs each in a child of its
+ * own, SimRun::runIsolated()), and the KPIs (SimRun::KPIS) are averaged
+ * over the seeds.  The runs are
+ * deterministic: same source, same compiler, same numbers.
+ *
+ * Results go to --out as CSV, one row per scenario and KPI:
+ *
+ *     scenario,kpi,value,baseline,tolerance,status
+ *
+ * status is ok, improved, REGRESSED (worse than the baseline by more
+ * than the tolerance), new (no baseline row) or FLOOR (worse than the
+ * absolute floor in FLOORS below).  Any REGRESSED or FLOOR row makes the
+ * exit status 1.
+ *
+ * The baseline (sim/baseline.csv) is scenario,kpi,value,tolerance.  Its
+ * path is fixed at build time from the source tree (SENTRY_BENCH_BASELINE,
+ * set by the bench env), so the bench finds it from any working
+ * directory; --baseline overrides it.  A missing baseline is an error
+ * (exit 2) unless --write-baseline is creating it.
+ * After an intended change in behaviour, regenerate it with
+ * --write-baseline and commit it with the change; tolerances can then be
+ * tightened or loosened by hand.  The floors are not in the baseline: a
+ * regenerated baseline that breaks one still fails, --write-baseline
+ * included.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "sim_run.h"
+
+namespace {
+
+/**
+ * sim/baseline.csv in the source tree: SENTRY_BENCH_BASELINE if the build
+ * sets it, else found from this file's own path (sim/tools/).
+ */
+const char *defaultBaselinePath() {
+#ifdef SENTRY_BENCH_BASELINE
+    return SENTRY_BENCH_BASELINE;
+#else
+    static std::string path;
+    if (path.empty()) {
+        std::string here = __FILE__;
+        size_t cut = here.rfind("tools/sentry_bench.cpp");
+        path = (cut == std::string::npos ? std::string("sim/") : here.substr(0, cut)) + "baseline.csv";
+    }
+    return path.c_str();
+#endif
+}
+
+struct Options {
+    const char *baselinePath  = defaultBaselinePath();
+    const char *outPath       = "bench-results.csv";
+    bool        writeBaseline = false;
+    bool        fork          = false;     ///< Each run in a child process
+    uint32_t    seeds         = 3;
+    const char *only          = nullptr;   ///< One scenario, or all
+};
+
+struct BaselineRow {
+    float value;
+    float tolerance;
+};
+
+typedef std::map<std::string, BaselineRow> Baseline;   // "scenario/kpi" → row
+
+/** Worst acceptable seed-averaged value of a KPI in a scenario. */
+struct KpiFloor {
+    const char *scenario;   ///< nullptr: every scenario without its own row
+    const char *kpi;
+    float       worst;
+};
+
+/**
+ * The absolute floors.  Every scenario but two may miss at most one
+ * appearance; passby's 16°/s crossings outrun the tracker and away's
+ * later spots are outside the parked turret's view, so theirs are
+ * capped at today's structural misses instead.  Seated, the easiest
+ * case, must be acquired within 8 s of boot (one search raster's first
+ * pass plus the presence test).
+ *
+ * Pointing quality is floored where the beacon stays in the room:
+ * seated, walk and occlusion.  Each floor lies beyond the baseline's
+ * tolerance band (8–28 % off the seed-averaged value), so a baseline
+ * re-recorded after a slow drift cannot carry the product past it.
+ * rms_err_deg includes the acquisition, which is why seated's is large.
+ */
+const KpiFloor FLOORS[] = {
+    {"seated",    "acquire_ms",    8000.0f},
+    {"seated",    "on_target_pct", 85.0f},
+    {"seated",    "rms_err_deg",   18.0f},
+    {"walk",      "on_target_pct", 65.0f},
+    {"walk",      "rms_err_deg",   28.0f},
+    {"occlusion", "on_target_pct", 90.0f},
+    {"occlusion", "rms_err_deg",   3.0f},
+    {"passby",    "missed",        6.0f},
+    {"away",      "missed",        3.0f},
+    {nullptr,     "missed",        1.0f},
+};
+
+/** The floor for @p kpi in @p scenario, or nullptr. */
+const KpiFloor *findFloor(const char *scenario, const char *kpi) {
+    const KpiFloor *any = nullptr;
+    for (const KpiFloor &f : FLOORS) {
+        if (strcmp(f.kpi, kpi) != 0) continue;
+        if (!f.scenario) {
+            if (!any) any = &f;
+        } else if (strcmp(f.scenario, scenario) == 0) {
+            return &f;
+        }
+    }
+    return any;
+}
+
+void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [--baseline FILE] [--out FILE] [--write-baseline]\n"
+            "          [--seeds N] [--scenario NAME] [--fork]\n"
+            "baseline: %s\n", argv0, defaultBaselinePath());
+}
+
+bool parseArgs(int argc, char **argv, Options &o) {
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (strcmp(a, "--write-baseline") == 0) {
+            o.writeBaseline = true;
+            continue;
+        }
+        if (strcmp(a, "--fork") == 0) {
+            o.fork = true;
+            continue;
+        }
+        const char *v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!v) return false;
+        if      (strcmp(a, "--baseline") == 0) o.baselinePath = v;
+        else if (strcmp(a, "--out") == 0)      o.outPath      = v;
+        else if (strcmp(a, "--seeds") == 0)    o.seeds        = static_cast<uint32_t>(strtoul(v, nullptr, 0));
+        else if (strcmp(a, "--scenario") == 0) o.only         = v;
+        else return false;
+        i++;
+    }
+    return o.seeds > 0 && (!o.only || SimWorld::findScenario(o.only));
+}
+
+/** Load "scenario,kpi,value,tolerance" rows; '#' starts a comment. */
+bool loadBaseline(const char *path, Baseline &out) {
+    FILE *f = fopen(path, "r");
+    if (!f) return false;
+
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        char scenario[64], kpi[64];
+        float value, tol;
+        if (sscanf(line, "%63[^,],%63[^,],%f,%f", scenario, kpi, &value, &tol) != 4) continue;
+        out[std::string(scenario) + "/" + kpi] = BaselineRow{value, tol};
+    }
+    fclose(f);
+    return true;
+}
+
+float defaultTolerance(const SimKpiField &kpi, float baseline) {
+    float rel = kpi.relTol * fabsf(baseline);
+    return rel > kpi.absTol ? rel : kpi.absTol;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    Baseline baseline;
+    bool haveBaseline = !opt.writeBaseline && loadBaseline(opt.baselinePath, baseline);
+    if (!opt.writeBaseline && !haveBaseline) {
+        fprintf(stderr, "%s: no baseline (pass --baseline FILE, or run with "
+                        "--write-baseline to create it)\n", opt.baselinePath);
+        return 2;
+    }
+
+    FILE *out = fopen(opt.writeBaseline ? opt.baselinePath : opt.outPath, "w");
+    if (!out) {
+        perror(opt.writeBaseline ? opt.baselinePath : opt.outPath);
+        return 2;
+    }
+    if (opt.writeBaseline) {
+        fprintf(out, "# sentry-bench baseline: scenario,kpi,value,tolerance\n"
+                     "# Regenerate with: sentry-bench --write-baseline (%lu seeds, beacon %s)\n",
+                static_cast<unsigned long>(opt.seeds), SimParams().bursts.name);
+    } else {
+        fprintf(out, "scenario,kpi,value,baseline,tolerance,status\n");
+    }
+
+    printf("sentry-bench: beacon %s, %lu seeds per scenario\n\n",
+           SimParams().bursts.name, static_cast<unsigned long>(opt.seeds));
+
+    printf("%-10s", "scenario");
+    for (uint8_t i = 0; i < SimRun::KPI_COUNT; i++) printf(" %11.11s", SimRun::KPIS[i].name);
+    printf("\n");
+
+    uint32_t regressions = 0, floorsBroken = 0;
+    double simS = 0.0, wallS = 0.0;
+    std::vector<std::string> notes;
+
+    for (uint8_t s = 0; s < SimWorld::SCENARIO_COUNT; s++) {
+        const BeaconScenario &sc = SimWorld::SCENARIOS[s];
+        if (opt.only && strcmp(opt.only, sc.name) != 0) continue;
+
+        std::vector<SimKpis> runs;
+        for (uint32_t seed = 1; seed <= opt.seeds; seed++) {
+            SimConfig cfg;
+            cfg.scenario   = &sc;
+            cfg.world.seed = seed;
+            SimKpis k;
+            if (!(opt.fork ? SimRun::runIsolated(cfg, k) : SimRun::run(cfg, k))) {
+                fprintf(stderr, "%s seed %lu: run failed\n", sc.name, static_cast<unsigned long>(seed));
+                fclose(out);
+                return 2;
+            }
+            runs.push_back(k);
+        }
+        for (const SimKpis &k : runs) {
+            simS  += k.simS;
+            wallS += k.wallS;
+        }
+
+        printf("%-10s", sc.name);
+        for (uint8_t i = 0; i < SimRun::KPI_COUNT; i++) {
+            const SimKpiField &kpi = SimRun::KPIS[i];
+            double sum = 0.0;
+            for (const SimKpis &k : runs) sum += kpi.get(k);
+            float v = static_cast<float>(sum / runs.size());
+            std::string key = std::string(sc.name) + "/" + kpi.name;
+
+            bool broken = false;
+            const KpiFloor *bound = findFloor(sc.name, kpi.name);
+            if (bound && (kpi.higherIsBetter ? v < bound->worst : v > bound->worst)) {
+                broken = true;
+                floorsBroken++;
+                char note[160];
+                snprintf(note, sizeof(note), "  %s %s: %.2f (floor %.2f)",
+                         sc.name, kpi.name, v, bound->worst);
+                notes.push_back(note);
+            }
+
+            if (opt.writeBaseline) {
+                fprintf(out, "%s,%s,%.3f,%.3f\n", sc.name, kpi.name, v, defaultTolerance(kpi, v));
+                printf(" %10.2f%c", v, broken ? '!' : ' ');
+                continue;
+            }
+
+            const char *status = "new";
+            float base = NAN, tol = NAN;
+            auto it = baseline.find(key);
+            if (it != baseline.end()) {
+                base = it->second.value;
+                tol  = it->second.tolerance;
+                float worse = kpi.higherIsBetter ? base - v : v - base;
+                if (worse > tol) {
+                    status = "REGRESSED";
+                    regressions++;
+                    char note[160];
+                    snprintf(note, sizeof(note), "  %s %s: %.2f (baseline %.2f, tolerance %.2f)",
+                             sc.name, kpi.name, v, base, tol);
+                    notes.push_back(note);
+                } else if (-worse > tol) {
+                    status = "improved";
+                } else {
+                    status = "ok";
+                }
+            }
+            if (broken) status = "FLOOR";
+            fprintf(out, "%s,%s,%.3f,%.3f,%.3f,%s\n", sc.name, kpi.name, v, base, tol, status);
+            printf(" %10.2f%c", v, (status[0] == 'R' || broken) ? '!' : status[0] == 'i' ? '+' : ' ');
+        }
+        printf("\n");
+    }
+    fclose(out);
+
+    printf("\n%.0f s simulated in %.2f s of run time (%lu seeds per scenario)\n",
+           simS, wallS, static_cast<unsigned long>(opt.seeds));
+    if (opt.writeBaseline) {
+        printf("Baseline written to %s  (! below a floor)\n", opt.baselinePath);
+    } else {
+        printf("Results written to %s  (! regressed or below a floor, + improved beyond tolerance)\n",
+               opt.outPath);
+    }
+    if (regressions + floorsBroken > 0) {
+        printf("\n%lu KPI regression(s), %lu below a floor:\n",
+               static_cast<unsigned long>(regressions), static_cast<unsigned long>(floorsBroken));
+        for (const std::string &n : notes) printf("%s\n", n.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,427 @@
+/**
+ * @file sentry_micro.cpp
+ * @brief sentry-micro: per-call cost of the turret's hot-path functions
+ *        on the host (MicroBench), and their code size from any ELF
+ *        (ElfSymbols).
+ *
+ * Build and run (from turret/):
+ *
+ *     pio run -e micro && .pio/build/micro/program
+ *
+ * Each function runs against HostHal: sensor pins read a prepared table
+ * of masks (a random walk, each sensor flipping one tick in eight), the
+ * virtual clock moves LOOP_PERIOD_US per call where the function reads
+ * millis(), and servo writes land in HostHal.  Arguments cycle through
+ * tables too.  The first row, "(loop)", is the harness alone (clock
+ * step, table fetch, result sink): subtract it from the others.
+ *
+ * Options:
+ *
+ *     --runs N      timed runs per function (default 31)
+ *     --ops N       calls per run (default 20000)
+ *     --warmup N    untimed runs first (default 5)
+ *     --only NAME   one function ("SensorArray::update")
+ *     --out FILE    also write function,ns_median,ns_mad,ns_min,insns
+ *     --elf FILE    add a column of code sizes from FILE; repeatable
+ *     --no-insns       time only, without the instruction counter
+ *     --require-insns  exit 2 if the instruction counter cannot be opened
+ *
+ * Instructions per call need perf_event_open() (Linux, with
+ * kernel.perf_event_paranoid ≤ 2 and not blocked by a container).  If
+ * the counter cannot be opened the tool says why in one line and leaves
+ * the insns column out; --require-insns makes that an error (exit 2),
+ * for runs whose figures must include it.
+ *
+ * The size table always prints.  Its first column is this program's own
+ * image: env:micro builds at -Os, as env:esp32 builds the firmware, so
+ * that is the host's -Os code.  Each --elf FILE adds a column from
+ * whatever built FILE, e.g. the firmware for the flash cost on target:
+ *
+ *     pio run -e esp32
+ *     .pio/build/micro/program --elf .pio/build/esp32/firmware.elf
+ *
+ * "-" in the size table: no symbol, i.e. inlined into its callers.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "micro_bench.h"
+#include "elf_symbols.h"
+#include "hal.h"
+#include "sensor_array.h"
+#include "signal_monitor.h"
+#include "pan_controller.h"
+#include "tilt_controller.h"
+#include "tracking_engine.h"
+
+namespace {
+
+// ===================================================================
+// Fixture: the modules and their input tables
+// ===================================================================
+
+constexpr uint32_t TABLE = 1024;        ///< Inputs per table (power of two)
+constexpr uint32_t ARRAYS = 64;         ///< SensorArrays with distinct histories
+
+struct Fixture {
+    uint8_t       masks[TABLE];         ///< Bit 0..3 = top, bottom, left, right LOW
+    SensorReading readings[TABLE];      ///< masks as filtered readings
+    float         speeds[TABLE];        ///< setSpeed() arguments, past ±1 too
+    int8_t        deltas[TABLE];        ///< nudge() arguments
+    uint32_t      at = 0;               ///< Index of the mask on the pins
+
+    SensorArray    sensors;
+    SensorArray    histories[ARRAYS];   ///< getFiltered() / getDirection() inputs
+    SignalMonitor  monitor;
+    PanController  pan;
+    TiltController tilt;
+    TrackingEngine tracker;
+};
+
+Fixture fx;
+
+uint32_t rng = 0x2545F491u;
+
+uint32_t nextRandom() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+SensorState stateOf(uint8_t mask, uint8_t bit) {
+    return (mask >> bit) & 1u ? SensorState::ACTIVE : SensorState::INACTIVE;
+}
+
+int readPins(uint8_t pin, void *) {
+    uint8_t mask = fx.masks[fx.at & (TABLE - 1)];
+    uint8_t bit;
+    switch (pin) {
+        case PIN_SENSOR_TOP:    bit = 0; break;
+        case PIN_SENSOR_BOTTOM: bit = 1; break;
+        case PIN_SENSOR_LEFT:   bit = 2; break;
+        case PIN_SENSOR_RIGHT:  bit = 3; break;
+        default:                return HIGH;
+    }
+    return (mask >> bit) & 1u ? LOW : HIGH;
+}
+
+void prepare() {
+    HostHal::reset();
+    HostHal::setPinReader(readPins, nullptr);
+
+    uint8_t mask = 0;
+    for (uint32_t i = 0; i < TABLE; i++) {
+        for (uint8_t b = 0; b < 4; b++) {
+            if (nextRandom() % 8 == 0) mask ^= static_cast<uint8_t>(1u << b);
+        }
+        fx.masks[i]    = mask;
+        fx.readings[i] = {stateOf(mask, 0), stateOf(mask, 1), stateOf(mask, 2), stateOf(mask, 3)};
+        fx.speeds[i]   = static_cast<float>(nextRandom() % 2401) / 1000.0f - 1.2f;
+        fx.deltas[i]   = static_cast<int8_t>(static_cast<int>(nextRandom() % 7) - 3);
+    }
+
+    fx.sensors.init();
+    for (uint32_t a = 0; a < ARRAYS; a++) {
+        fx.histories[a].init();
+        for (uint32_t k = 0; k < SENSOR_FILTER_WINDOW; k++) {
+            fx.at = a * 13 + k;
+            fx.histories[a].update();
+        }
+    }
+    fx.at = 0;
+
+    fx.monitor.init();
+    fx.pan.init();
+    fx.tilt.init();
+    fx.tracker.init(&fx.pan, &fx.tilt);
+}
+
+// ===================================================================
+// Bodies
+// ===================================================================
+
+void benchLoop(void *, uint32_t ops) {
+    for (uint32_t k = 0; k < ops; k++) {
+        HostHal::advanceUs(LOOP_PERIOD_US);
+        MicroBench::consume(fx.masks[k & (TABLE - 1)]);
+    }
+}
+
+void benchSensorUpdate(void *, uint32_t ops) {
+    for (uint32_t k = 0; k < ops; k++) {
+        fx.at = k;
+        fx.sensors.update();
+    }
+    MicroBench::consume(fx.sensors.getRawBits());
+}
+
+void benchGetFiltered(void *, uint32_t ops) {
+    for (uint32_t k = 0; k < ops; k++) {
+        SensorReading r = fx.histories[k & (ARRAYS - 1)].getFiltered();
+        MicroBench::consume(static_cast<uint32_t>(r.left) + static_cast<uint32_t>(r.top));
+    }
+}
+
+void benchGetDirection(void *, uint32_t ops) {
+    for (uint32_t k = 0; k < ops; k++) {
+        MicroBench::consume(static_cast<uint32_t>(fx.histories[k & (ARRAYS - 1)].getDirection()));
+    }
+}
+
+void benchMonitorUpdate(void *, uint32_t ops) {
+    for (uint32_t k = 0; k < ops; k++) {
+        HostHal::advanceUs(LOOP_PERIOD_US);
+        fx.monitor.update(fx.masks[k & (TABLE - 1)] != 0);
+    }
+    MicroBench::consume(static_cast<uint32_t>(fx.monitor.getState()));
+}
+
+void benchMonitorEvidence(void *, uint32_t ops) {
+    for (uint32_t k = 0; k < ops; k++) {
+        HostHal::advanceUs(LOOP_PERIOD_US);
+        fx.monitor.updateEvidence(fx.masks[k & (TABLE - 1)]);
+    }
+    MicroBench::consume(static_cast<uint32_t>(fx.monitor.getState()));
+}
+
+void benchTrackerUpdate(void *, uint32_t ops) {
+    for (uint32_t k = 0; k < ops; k++) {
+        HostHal::advanceUs(LOOP_PERIOD_US);
+        fx.tracker.update(fx.readings[k & (TABLE - 1)]);
+    }
+    MicroBench::consume(static_cast<uint32_t>(fx.tilt.getAngle()));
+}
+
+void benchSetSpeed(void *, uint32_t ops) {
+    for (uint32_t k = 0; k < ops; k++) {
+        fx.pan.setSpeed(fx.speeds[k & (TABLE - 1)]);
+    }
+    MicroBench::consume(static_cast<uint32_t>(fx.pan.getSpeed() * 1000.0f));
+}
+
+void benchUpdatePosition(void *, uint32_t ops) {
+    for (uint32_t k = 0; k < ops; k++) {
+        // Turn round every 256 calls so the integration spends time
+        // between the limits as well as clamped at them.
+        if ((k & 255) == 0) fx.pan.setSpeed(fx.pan.getPositionDeg() > 0.0f ? -0.8f : 0.8f);
+        fx.pan.updatePosition(LOOP_PERIOD_MS);
+    }
+    MicroBench::consume(static_cast<uint32_t>(fx.pan.getPositionDeg()));
+}
+
+void benchNudge(void *, uint32_t ops) {
+    for (uint32_t k = 0; k < ops; k++) {
+        HostHal::advanceUs(LOOP_PERIOD_US);
+        MicroBench::consume(fx.tilt.nudge(fx.deltas[k & (TABLE - 1)]));
+    }
+}
+
+struct Bench {
+    const char *name;
+    MicroBody   body;
+};
+
+const Bench BENCHES[] = {
+    {"(loop)",                       benchLoop},
+    {"SensorArray::update",          benchSensorUpdate},
+    {"SensorArray::getFiltered",     benchGetFiltered},
+    {"SensorArray::getDirection",    benchGetDirection},
+    {"SignalMonitor::update",        benchMonitorUpdate},
+    {"SignalMonitor::updateEvidence", benchMonitorEvidence},
+    {"TrackingEngine::update",       benchTrackerUpdate},
+    {"PanController::setSpeed",      benchSetSpeed},
+    {"PanController::updatePosition", benchUpdatePosition},
+    {"TiltController::nudge",        benchNudge},
+};
+
+/** The size table's first column: this program, as env:micro built it. */
+constexpr const char *SELF_IMAGE = "/proc/self/exe";
+#ifdef __OPTIMIZE_SIZE__
+constexpr const char *SELF_LABEL = "host -Os";
+#else
+constexpr const char *SELF_LABEL = "host (not -Os)";
+#endif
+
+/** The size table: the benchmarked functions, then what they call. */
+const char *const SIZED[] = {
+    "SensorArray::update",
+    "SensorArray::getFiltered",
+    "SensorArray::getDirection",
+    "SignalMonitor::update",
+    "SignalMonitor::updateEvidence",
+    "TrackingEngine::update",
+    "PanController::setSpeed",
+    "PanController::updatePosition",
+    "TiltController::nudge",
+    nullptr,
+    "SensorArray::pushSample",
+    "SensorArray::evaluateSensor",
+    "SensorArray::popcount",
+    "TrackingEngine::computePanSpeed",
+    "TrackingEngine::computeTiltDelta",
+    "PanController::speedToMicroseconds",
+    "TiltController::setAngle",
+    "TiltController::angleToMicroseconds",
+    "ServoOutput::write",
+};
+
+// ===================================================================
+// Options
+// ===================================================================
+
+struct Options {
+    MicroConfig                micro;
+    const char                *only    = nullptr;
+    const char                *outPath = nullptr;
+    std::vector<const char *>  elves;
+    bool                       requireInsns = false;
+};
+
+void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [--runs N] [--ops N] [--warmup N] [--only NAME]\n"
+            "          [--out FILE] [--elf FILE]... [--no-insns | --require-insns]\n"
+            "\n"
+            "Instructions per call need perf_event_open(); without it the insns\n"
+            "column is left out, or with --require-insns the tool exits 2.  Code\n"
+            "sizes: this program (-Os) always, plus one column per --elf FILE\n"
+            "(e.g. the ESP32 firmware).\n",
+            argv0);
+}
+
+bool parseArgs(int argc, char **argv, Options &o) {
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (strcmp(a, "--no-insns") == 0) {
+            o.micro.countInsns = false;
+            continue;
+        }
+        if (strcmp(a, "--require-insns") == 0) {
+            o.requireInsns = true;
+            continue;
+        }
+        const char *v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!v) return false;
+        if      (strcmp(a, "--runs") == 0)   o.micro.runs       = static_cast<uint32_t>(strtoul(v, nullptr, 0));
+        else if (strcmp(a, "--ops") == 0)    o.micro.opsPerRun  = static_cast<uint32_t>(strtoul(v, nullptr, 0));
+        else if (strcmp(a, "--warmup") == 0) o.micro.warmupRuns = static_cast<uint32_t>(strtoul(v, nullptr, 0));
+        else if (strcmp(a, "--only") == 0)   o.only             = v;
+        else if (strcmp(a, "--out") == 0)    o.outPath          = v;
+        else if (strcmp(a, "--elf") == 0)    o.elves.push_back(v);
+        else return false;
+        i++;
+    }
+    if (o.micro.runs == 0 || o.micro.opsPerRun == 0) return false;
+    if (o.requireInsns && !o.micro.countInsns) return false;
+    if (o.only) {
+        for (const Bench &b : BENCHES) {
+            if (strcmp(b.name, o.only) == 0) return true;
+        }
+        return false;
+    }
+    return true;
+}
+
+const char *baseName(const char *path) {
+    const char *slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+bool printSizes(const std::vector<const char *> &elves) {
+    std::vector<const char *> paths(1, SELF_IMAGE);
+    paths.insert(paths.end(), elves.begin(), elves.end());
+
+    std::vector<ElfSymbols> files(paths.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        std::string err;
+        if (!files[i].load(paths[i], err)) {
+            fprintf(stderr, "%s: %s\n", paths[i], err.c_str());
+            return false;
+        }
+    }
+
+    printf("\n%-36s %14s", "code size (bytes)", SELF_LABEL);
+    for (const char *p : elves) printf(" %14.14s", baseName(p));
+    printf("\n");
+    for (const char *name : SIZED) {
+        if (!name) {
+            printf("  called from the above:\n");
+            continue;
+        }
+        printf("%-36s", name);
+        for (const ElfSymbols &f : files) {
+            uint32_t bytes = f.sizeOf(name);
+            if (bytes) printf(" %14lu", static_cast<unsigned long>(bytes));
+            else       printf(" %14s", "-");
+        }
+        printf("\n");
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    const char *counter = opt.micro.countInsns ? "on" : "off (--no-insns)";
+    int err = 0;
+    if (opt.micro.countInsns && !MicroBench::countersAvailable(&err)) {
+        if (opt.requireInsns) {
+            fprintf(stderr,
+                    "sentry-micro: no instruction counter: perf_event_open() failed (%s).\n"
+                    "  Allow it (kernel.perf_event_paranoid <= 2, a container that permits\n"
+                    "  the syscall), or drop --require-insns for the timings alone.\n",
+                    strerror(err));
+            return 2;
+        }
+        fprintf(stderr, "sentry-micro: no instruction counter (perf_event_open: %s); "
+                        "insns column omitted\n", strerror(err));
+        opt.micro.countInsns = false;
+        counter = "unavailable";
+    }
+    const bool counted = opt.micro.countInsns;
+
+    FILE *out = nullptr;
+    if (opt.outPath) {
+        out = fopen(opt.outPath, "w");
+        if (!out) {
+            fprintf(stderr, "%s: cannot write\n", opt.outPath);
+            return 2;
+        }
+        fprintf(out, "function,ns_median,ns_mad,ns_min,insns\n");
+    }
+
+    prepare();
+    printf("sentry-micro: %lu runs of %lu calls after %lu warmup runs; instruction counter %s\n\n",
+           static_cast<unsigned long>(opt.micro.runs), static_cast<unsigned long>(opt.micro.opsPerRun),
+           static_cast<unsigned long>(opt.micro.warmupRuns), counter);
+    if (counted) printf("%-36s %9s %8s %8s %9s\n", "function", "ns/op", "MAD", "min", "insns/op");
+    else         printf("%-36s %9s %8s %8s\n", "function", "ns/op", "MAD", "min");
+
+    for (const Bench &b : BENCHES) {
+        if (opt.only && strcmp(b.name, opt.only) != 0) continue;
+        MicroResult r;
+        MicroBench::measure(b.name, b.body, nullptr, opt.micro, r);
+        printf("%-36s %9.2f %8.2f %8.2f", r.name, r.nsMedian, r.nsMad, r.nsMin);
+        if (counted) printf(" %9.1f", r.insnsPerOp);
+        printf("\n");
+        if (out) {
+            fprintf(out, "%s,%.3f,%.3f,%.3f,", r.name, r.nsMedian, r.nsMad, r.nsMin);
+            if (counted) fprintf(out, "%.1f\n", r.insnsPerOp);
+            else         fprintf(out, "\n");
+        }
+    }
+    if (out) fclose(out);
+
+    if (!printSizes(opt.elves)) return 2;
+    return 0;
+}
@@ -0,0 +1,294 @@
+/**
+ * @file sentry_replay.cpp
+ * @brief sentry-replay: a captured turret session back through the
+ *        firmware modules, diffed against what the turret commanded.
+ *
+ * Build and run (from turret/):
+ *
+ *     pio run -e replay && .pio/build/replay/program session.bin
+ *
+ * Capture on the turret: send 'c', reset it, then record the raw serial
+ * stream from boot (session_capture.h):
+ *
+ *     stty -F /dev/ttyUSB0 115200 raw && cat /dev/ttyUSB0 > session.bin
+ *
+ * or in the simulator: sentry-sim --capture session.bin.
+ *
+ * Every captured tick goes through SessionReplay (session_replay.h):
+ * the same SensorArray, SignalMonitor, TrackingEngine and state machine
+ * code, fed the recorded raw samples at their recorded times.  The
+ * replayed record is compared with the recorded one field by field;
+ * the report gives the first difference, differing ticks per field,
+ * sample sequence gaps (lost snapshots or frames, after which
+ * differences are expected) and time per state both ways.  A new header
+ * (the turret rebooted) starts a new session.
+ *
+ * Options:
+ *
+ *     --set TUNABLE=VALUE   override a config.h tunable (sim_tunables.h)
+ *                           and see what the change would have done to
+ *                           the same session
+ *     --csv FILE            per tick: recorded and replayed state, pan
+ *                           command, pan position, tilt; differing fields
+ *     --trace FILE          both as Chrome trace-event JSON
+ *                           (turret_trace.h), recorded and replayed one
+ *                           above the other; the recorded control track
+ *                           has the turret's own tick cost (loopUs)
+ *
+ * Exit status 0 if every tick matched, 1 if any differed, 2 on bad
+ * arguments or no session in the file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "session_replay.h"
+#include "sim_tunables.h"
+#include "turret_trace.h"
+
+namespace {
+
+struct Options {
+    const char *inPath  = nullptr;
+    const char *csvPath = nullptr;
+    const char *tracePath = nullptr;
+};
+
+struct Totals {
+    uint32_t sessions    = 0;
+    uint32_t ticks       = 0;
+    uint32_t samples     = 0;
+    uint32_t orphans     = 0;    ///< Ticks before any header
+    uint32_t records     = 0;    ///< Plain telemetry records (capture off)
+    uint32_t seqGaps     = 0;
+    uint32_t lostInTick  = 0;    ///< Ticks that consumed more samples than they carry
+    uint32_t diffTicks   = 0;
+    uint32_t fieldDiffs[SessionReplay::FIELD_COUNT] = {};
+    double   sessionS    = 0.0;
+    double   stateS[2][static_cast<uint8_t>(TurretState::COUNT)] = {};   ///< Recorded, replayed
+};
+
+void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--set TUNABLE=VALUE]... [--csv FILE] [--trace FILE] CAPTURE\n",
+            argv0);
+}
+
+/** "NAME=VALUE" into @p values (SimTunables order). */
+bool parseSet(const char *arg, std::vector<double> &values) {
+    const char *eq = strchr(arg, '=');
+    if (!eq) return false;
+    int idx = SimTunables::indexOf(std::string(arg, eq).c_str());
+    if (idx < 0) return false;
+    values[idx] = atof(eq + 1);
+    return true;
+}
+
+bool parseArgs(int argc, char **argv, Options &o, std::vector<double> &tunables) {
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (a[0] != '-' || strcmp(a, "-") == 0) {
+            if (o.inPath) return false;
+            o.inPath = a;
+            continue;
+        }
+        const char *v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!v) return false;
+        if      (strcmp(a, "--csv") == 0)   o.csvPath = v;
+        else if (strcmp(a, "--trace") == 0) o.tracePath = v;
+        else if (strcmp(a, "--set") == 0) {
+            if (!parseSet(v, tunables)) return false;
+        }
+        else return false;
+        i++;
+    }
+    return o.inPath != nullptr;
+}
+
+const char *stateName(uint8_t s) {
+    return TurretStateMachine::stateName(static_cast<TurretState>(s));
+}
+
+void printDiff(const TelemetryRecord &rec, const TelemetryRecord &rep, uint8_t diff,
+               uint32_t tick) {
+    printf("first difference: session tick %lu, seq %u, t %.3f s:",
+           static_cast<unsigned long>(tick), rec.seq, rec.tUs / 1e6);
+    for (uint8_t f = 0; f < SessionReplay::FIELD_COUNT; f++) {
+        if (diff & (1u << f)) printf(" %s", SessionReplay::FIELD_NAMES[f]);
+    }
+    printf("\n  recorded  %-7s%s pan %.2f° cmd %+.4f tilt %d° filtered 0x%02X\n",
+           stateName(rec.state), rec.transition ? "*" : " ",
+           rec.panCdeg / 100.0, rec.panCmd / 10000.0, rec.tiltDeg, rec.filtered);
+    printf("  replayed  %-7s%s pan %.2f° cmd %+.4f tilt %d° filtered 0x%02X\n",
+           stateName(rep.state), rep.transition ? "*" : " ",
+           rep.panCdeg / 100.0, rep.panCmd / 10000.0, rep.tiltDeg, rep.filtered);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Options opt;
+    const double *def = SimTunables::defaults();
+    std::vector<double> tunables(def, def + SimTunables::COUNT);
+    if (!parseArgs(argc, argv, opt, tunables)) {
+        usage(argv[0]);
+        return 2;
+    }
+    SimTunables::apply(tunables.data());
+
+    FILE *in = strcmp(opt.inPath, "-") == 0 ? stdin : fopen(opt.inPath, "rb");
+    if (!in) {
+        perror(opt.inPath);
+        return 2;
+    }
+    FILE *csv = nullptr;
+    if (opt.csvPath) {
+        csv = fopen(opt.csvPath, "w");
+        if (!csv) {
+            perror(opt.csvPath);
+            return 2;
+        }
+        fprintf(csv, "session,seq,t_us,state,state_replay,pan_cmd,pan_cmd_replay,"
+                     "pan_deg,pan_deg_replay,tilt_deg,tilt_deg_replay,diff\n");
+    }
+    FILE *traceFile = nullptr;
+    std::unique_ptr<TraceWriter> writer;
+    std::unique_ptr<TurretTrace> traced[2];   // Recorded, replayed
+    if (opt.tracePath) {
+        traceFile = fopen(opt.tracePath, "w");
+        if (!traceFile) {
+            perror(opt.tracePath);
+            return 2;
+        }
+        writer.reset(new TraceWriter(traceFile));
+        traced[0].reset(new TurretTrace(*writer, 1, "recorded"));
+        traced[1].reset(new TurretTrace(*writer, 2, "replayed"));
+    }
+
+    CaptureDecoder decoder;
+    SessionReplay  replay;
+    Totals         tot;
+    bool           inSession = false;
+    bool           haveSeq   = false;
+    uint16_t       lastSeq   = 0;
+    uint32_t       lastTUs   = 0;
+    uint32_t       sessionTicks = 0;
+    bool           reported  = false;
+
+    auto wallStart = std::chrono::steady_clock::now();
+    int c;
+    while ((c = fgetc(in)) != EOF) {
+        CaptureDecoder::Frame got = decoder.feed(static_cast<uint8_t>(c));
+        if (got == CaptureDecoder::Frame::RECORD) {
+            tot.records++;
+            continue;
+        }
+        if (got == CaptureDecoder::Frame::HEADER) {
+            if (writer && tot.sessions > 0) {
+                traced[0]->reboot();
+                traced[1]->reboot();
+            }
+            replay.begin(decoder.header());
+            inSession    = true;
+            haveSeq      = false;
+            lastTUs      = decoder.header().bootUs;
+            sessionTicks = 0;
+            tot.sessions++;
+            continue;
+        }
+        if (got != CaptureDecoder::Frame::TICK) continue;
+        if (!inSession) {
+            tot.orphans++;
+            continue;
+        }
+
+        const CaptureTick &t = decoder.tick();
+        for (uint8_t i = 0; i < t.samples; i++) {
+            if (haveSeq && t.sample[i].seq != static_cast<uint16_t>(lastSeq + 1)) tot.seqGaps++;
+            lastSeq = t.sample[i].seq;
+            haveSeq = true;
+        }
+        if (t.samplesLost) tot.lostInTick++;
+
+        TelemetryRecord rep = replay.tick(t);
+        uint8_t diff = SessionReplay::compare(t.rec, rep);
+        if (diff) {
+            tot.diffTicks++;
+            for (uint8_t f = 0; f < SessionReplay::FIELD_COUNT; f++) {
+                if (diff & (1u << f)) tot.fieldDiffs[f]++;
+            }
+            if (!reported) printDiff(t.rec, rep, diff, sessionTicks);
+            reported = true;
+        }
+
+        double dtS = static_cast<uint32_t>(t.rec.tUs - lastTUs) / 1e6;
+        lastTUs = t.rec.tUs;
+        tot.sessionS += dtS;
+        if (t.rec.state < static_cast<uint8_t>(TurretState::COUNT)) tot.stateS[0][t.rec.state] += dtS;
+        if (rep.state < static_cast<uint8_t>(TurretState::COUNT))   tot.stateS[1][rep.state]   += dtS;
+        tot.ticks++;
+        tot.samples += t.samples;
+        sessionTicks++;
+
+        if (writer) {
+            for (uint8_t i = 0; i < t.samples; i++) {
+                traced[0]->sample(t.sample[i].tUs, t.sample[i].rawBits);
+                traced[1]->sample(t.sample[i].tUs, t.sample[i].rawBits);
+            }
+            traced[0]->tick(t.rec, TurretTrace::monitorOf(t.rec.state));
+            traced[1]->tick(rep, replay.monitor().getState());
+        }
+
+        if (csv) {
+            fprintf(csv, "%lu,%u,%lu,%s,%s,%.4f,%.4f,%.2f,%.2f,%d,%d,%u\n",
+                    static_cast<unsigned long>(tot.sessions), t.rec.seq,
+                    static_cast<unsigned long>(t.rec.tUs),
+                    stateName(t.rec.state), stateName(rep.state),
+                    t.rec.panCmd / 10000.0, rep.panCmd / 10000.0,
+                    t.rec.panCdeg / 100.0, rep.panCdeg / 100.0,
+                    t.rec.tiltDeg, rep.tiltDeg, diff);
+        }
+    }
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    if (in != stdin) fclose(in);
+    if (csv) fclose(csv);
+    if (writer) {
+        traced[0]->finish();
+        traced[1]->finish();
+        writer->finish();
+        fclose(traceFile);
+    }
+
+    if (tot.sessions == 0) {
+        fprintf(stderr, "%s: no session header (capture off, or not recorded from boot?)\n",
+                opt.inPath);
+        return 2;
+    }
+
+    printf("%lu session(s), %lu ticks, %lu samples, %.1f s of turret time\n",
+           static_cast<unsigned long>(tot.sessions), static_cast<unsigned long>(tot.ticks),
+           static_cast<unsigned long>(tot.samples), tot.sessionS);
+    printf("replayed in %.2f s wall (%.0fx real time)\n",
+           wallS, wallS > 0.0 ? tot.sessionS / wallS : 0.0);
+    printf("decoder: %lu bad frames, %lu plain records, %lu ticks before a header\n",
+           static_cast<unsigned long>(decoder.badFrames()), static_cast<unsigned long>(tot.records),
+           static_cast<unsigned long>(tot.orphans));
+    printf("gaps: %lu in the sample sequence, %lu ticks with samples not captured\n",
+           static_cast<unsigned long>(tot.seqGaps), static_cast<unsigned long>(tot.lostInTick));
+    printf("clock: %lu timestamps out of order\n",
+           static_cast<unsigned long>(replay.clockClamps()));
+
+    printf("\ndiffering ticks: %lu", static_cast<unsigned long>(tot.diffTicks));
+    for (uint8_t f = 0; f < SessionReplay::FIELD_COUNT; f++) {
+        printf("  %s %lu", SessionReplay::FIELD_NAMES[f], static_cast<unsigned long>(tot.fieldDiffs[f]));
+    }
+    printf("\n\nTime per state     recorded    replayed\n");
+    for (uint8_t s = 0; s < static_cast<uint8_t>(TurretState::COUNT); s++) {
+        if (tot.stateS[0][s] <= 0.0 && tot.stateS[1][s] <= 0.0) continue;
+        printf("  %-10s %9.1f s %9.1f s\n", stateName(s), tot.stateS[0][s], tot.stateS[1][s]);
+    }
+    return tot.diffTicks == 0 ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+/**
+ * @file sentry_sim.cpp
+ * @brief sentry-sim: the turret firmware, closed loop against a simulated
+ *        room, on a virtual clock.
+ *
+ * Build and run (from turret/):
+ *
+ *     pio run -e sim && .pio/build/sim/program --scenario walk --seconds 600
+ *
+ * or without PlatformIO:
+ *
+ *     g++ -std=c++17 -O2 -DSENTRY_SIM -Iinclude -Isim -Isim/shim \
+ *         $(ls src/[a-z]*.cpp sim/[a-z]*.cpp) sim/tools/sentry_sim.cpp \
+ *         -o sentry-sim -lpthread
+ *
+ * (sim/tools/ holds one main() per tool; the rest of sim/ is shared.)
+ *
+ * main.cpp's setup() and loop() run unchanged apart from the SENTRY_SIM
+ * branch that steps the three pipeline tasks from loop() instead of
+ * spawning them.  Each iteration: loop(), advance the clock by --step-us,
+ * step the world (sim_world.h).  Nothing sleeps, so an hour of turret
+ * time takes about a second.
+ *
+ * The firmware's binary telemetry is decoded as it would be on the host
+ * (telemetry_stream.h) and scored against the world's ground truth
+ * (sim_run.h).  At the end the firmware is asked for its own 'l' and 'j'
+ * reports.  For the whole scenario library against the baseline, see
+ * sentry_bench.cpp.
+ *
+ * --beacon picks the emission timing (sim_world.h).  The default,
+ * firmware, is the shipped beacon: LOW for ~2–3 % of the time, one train
+ * per 126 ms, which the sensors' LOW latches catch on the ~20 % of ticks
+ * the detector assumes (SPRT_P_HIT_PRESENT).  dithered and continuous
+ * are ~50 % LOW and caught on every tick: far easier, for looking at
+ * the tracker with detection out of the way.
+ *
+ * --start-ms boots the turret with millis() at MS instead of 0, e.g.
+ * 4294960000 to cross the 49.7-day millis() wrap a few seconds in (the
+ * HAL's clocks are 32-bit, as on the ESP32; micros() wraps every 71.6
+ * minutes regardless).  The beacon's path starts at boot either way.
+ *
+ * --set overrides a config.h tunable for the run (sim_tunables.h), e.g.
+ * to try what sentry-tune found before copying it into config.h.
+ *
+ * --capture boots the firmware with session capture on, as 'c' would,
+ * and writes its serial output to FILE, byte for byte what a turret
+ * would send: sentry-replay FILE must then reproduce every tick.
+ *
+ * --trace writes the run as Chrome trace-event JSON (turret_trace.h) for
+ * ui.perfetto.dev: state and monitor spans, raw and filtered sensors,
+ * pan / tilt commands and position against the ground truth, and each
+ * control tick's stages.  The simulator's clock stands still inside a
+ * tick, so stage slices show host CPU time, not the ESP32's.  With
+ * --capture as well the raw sensor tracks have every sample.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "sim_run.h"
+#include "sim_tunables.h"
+
+namespace {
+
+void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [--scenario NAME] [--seconds S] [--beacon dithered|continuous|firmware]\n"
+            "          [--seed N] [--step-us US] [--start-ms MS] [--pan-rate-error F] [--noise P]\n"
+            "          [--csv FILE] [--capture FILE] [--trace FILE] [--set TUNABLE=VALUE]...\n"
+            "scenarios:\n", argv0);
+    for (uint8_t i = 0; i < SimWorld::SCENARIO_COUNT; i++) {
+        fprintf(stderr, "  %-10s %s (%.0f s)\n", SimWorld::SCENARIOS[i].name,
+                SimWorld::SCENARIOS[i].description, SimWorld::SCENARIOS[i].seconds);
+    }
+}
+
+/** "NAME=VALUE" into @p values (SimTunables order). */
+bool parseSet(const char *arg, std::vector<double> &values) {
+    const char *eq = strchr(arg, '=');
+    if (!eq) return false;
+    int idx = SimTunables::indexOf(std::string(arg, eq).c_str());
+    if (idx < 0) return false;
+    values[idx] = atof(eq + 1);
+    return true;
+}
+
+bool parseArgs(int argc, char **argv, SimConfig &c, const char *&csvPath,
+               const char *&capturePath, const char *&tracePath, std::vector<double> &tunables) {
+    c.scenario = SimWorld::findScenario("walk");
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(a, "--help") == 0 || strcmp(a, "-h") == 0 || !v) return false;
+
+        if      (strcmp(a, "--seconds") == 0)  c.seconds  = atof(v);
+        else if (strcmp(a, "--scenario") == 0) c.scenario = SimWorld::findScenario(v);
+        else if (strcmp(a, "--seed") == 0)     c.world.seed = static_cast<uint32_t>(strtoul(v, nullptr, 0));
+        else if (strcmp(a, "--step-us") == 0)  c.stepUs   = strtoul(v, nullptr, 0);
+        else if (strcmp(a, "--start-ms") == 0) c.startUs  = strtoull(v, nullptr, 0) * 1000UL;
+        else if (strcmp(a, "--noise") == 0)    c.noiseLowP = static_cast<float>(atof(v));
+        else if (strcmp(a, "--csv") == 0)      csvPath    = v;
+        else if (strcmp(a, "--capture") == 0)  capturePath = v;
+        else if (strcmp(a, "--trace") == 0)    tracePath  = v;
+        else if (strcmp(a, "--set") == 0) {
+            if (!parseSet(v, tunables)) return false;
+        }
+        else if (strcmp(a, "--pan-rate-error") == 0) {
+            c.world.panFullDegPerSec = PAN_DEG_PER_SEC * (1.0f + static_cast<float>(atof(v)));
+        } else if (strcmp(a, "--beacon") == 0) {
+            if      (strcmp(v, BURSTS_FIRMWARE.name) == 0)   c.world.bursts = BURSTS_FIRMWARE;
+            else if (strcmp(v, BURSTS_CONTINUOUS.name) == 0) c.world.bursts = BURSTS_CONTINUOUS;
+            else if (strcmp(v, BURSTS_DITHERED.name) == 0)   c.world.bursts = BURSTS_DITHERED;
+            else return false;
+        } else {
+            return false;
+        }
+        i++;
+    }
+    return c.scenario && c.seconds >= 0.0 && c.stepUs > 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    SimConfig cfg;
+    const char *csvPath = nullptr;
+    const char *capturePath = nullptr;
+    const char *tracePath = nullptr;
+    const double *def = SimTunables::defaults();
+    std::vector<double> tunables(def, def + SimTunables::COUNT);
+    if (!parseArgs(argc, argv, cfg, csvPath, capturePath, tracePath, tunables)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (csvPath) {
+        cfg.csv = fopen(csvPath, "w");
+        if (!cfg.csv) {
+            perror(csvPath);
+            return 1;
+        }
+    }
+    if (capturePath) {
+        cfg.capture = fopen(capturePath, "wb");
+        if (!cfg.capture) {
+            perror(capturePath);
+            return 1;
+        }
+    }
+    if (tracePath) {
+        cfg.trace = fopen(tracePath, "w");
+        if (!cfg.trace) {
+            perror(tracePath);
+            return 1;
+        }
+    }
+    cfg.firmwareReport = true;
+    cfg.tunables = tunables.data();
+
+    printf("sentry-sim: scenario %s, beacon %s, %.0f s, step %lu us, seed %lu\n\n",
+           cfg.scenario->name, cfg.world.bursts.name,
+           cfg.seconds > 0.0 ? cfg.seconds : cfg.scenario->seconds, cfg.stepUs,
+           static_cast<unsigned long>(cfg.world.seed));
+
+    SimKpis kpis;
+    std::string text;
+    SimRun::run(cfg, kpis, &text);
+    SimRun::printReport(stdout, kpis);
+    printf("\nFirmware report:\n%s", text.c_str());
+
+    if (cfg.csv) fclose(cfg.csv);
+    if (cfg.capture) fclose(cfg.capture);
+    if (cfg.trace) fclose(cfg.trace);
+    return 0;
+}
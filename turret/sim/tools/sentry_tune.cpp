@@ -0,0 +1,510 @@
+/**
+ * @file sentry_tune.cpp
+ * @brief sentry-tune: search the config.h tunables against the closed-loop
+ *        simulator, on every core.
+ *
+ * Build and run (from turret/):
+ *
+ *     pio run -e tune && .pio/build/tune/program --search coord
+ *     .pio/build/tune/program --list          # tunables, ranges, weights
+ *
+ * A candidate is one value per tunable (sim_tunables.h); the ones not
+ * being searched keep their config.h value.  Each candidate runs every
+ * selected scenario with seeds 1..--seeds, one run per job on a
+ * work-stealing pool (work_pool.h), so throughput scales with cores.
+ * Runs share the process, each on its worker's own turret (sim_run.h);
+ * --fork gives every run a child process of its own instead
+ * (SimRun::runIsolated), so a firmware crash costs one candidate, not
+ * the search.  Every candidate sees the same seeds, so
+ * the comparison is not swamped by run-to-run noise.
+ *
+ * The objective, lower is better, sums over the scenarios the mean over
+ * seeds of
+ *
+ *     Σ weight(kpi) × kpi        (× −1 for KPIs where higher is better)
+ *
+ * with the KPIs of SimRun::KPIS.  --weight KPI=W overrides a weight;
+ * 0 drops the KPI.
+ *
+ * Searches:
+ *   grid    every combination of the parameters' grids (--max-evals caps it)
+ *   random  --samples candidates drawn from the grids
+ *   coord   coordinate descent from config.h: each parameter in turn over
+ *           its whole grid, the others held, for up to --rounds rounds or
+ *           until a round changes nothing
+ *
+ * The best candidate is written to --out as config.h lines.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "sim_run.h"
+#include "sim_tunables.h"
+#include "work_pool.h"
+
+namespace {
+
+typedef std::vector<double> Point;   // SimTunables::COUNT values
+
+/** @brief Default objective weights (per unit of the KPI). */
+struct Weight {
+    const char *kpi;
+    double      weight;
+};
+
+const Weight DEFAULT_WEIGHTS[] = {
+    {"acquire_ms",            0.001},      // 1 per second
+    {"reacquire_ms",          0.001},
+    {"missed",                2.0},
+    {"rms_err_deg",           0.5},
+    {"on_target_pct",         0.2},
+    {"overshoot_deg",         0.2},
+    {"reversals_per_min",     0.05},
+    {"false_lock_s",          1.0},
+    {"pan_travel_deg_per_h",  0.00005},    // 5 per 100 000 °/h
+    {"tilt_travel_deg_per_h", 0.0001},
+};
+
+/** @brief One searched parameter: index into SimTunables::TUNABLES and its grid. */
+struct Range {
+    int    index;
+    double lo, hi, step;
+
+    std::vector<double> values() const {
+        std::vector<double> v;
+        for (double x = lo; x <= hi + step * 1e-6; x += step) v.push_back(x);
+        return v;
+    }
+};
+
+struct Options {
+    const char *search   = "coord";
+    std::vector<Range> params;
+    std::vector<const BeaconScenario *> scenarios;
+    uint32_t    seeds    = 2;
+    double      seconds  = 0.0;          ///< 0 = each scenario's default
+    uint32_t    samples  = 64;
+    uint32_t    rounds   = 3;
+    uint32_t    maxEvals = 5000;
+    uint32_t    rngSeed  = 1;
+    unsigned    jobs     = 0;
+    const char *outPath  = "tuned_config.h";
+    bool        list     = false;
+    bool        fork     = false;        ///< Each run in a child process
+    std::vector<double> weights;         ///< One per SimRun::KPIS
+};
+
+/** @brief A candidate's objective and its KPIs averaged over scenarios and seeds. */
+struct Score {
+    double              objective = INFINITY;
+    std::vector<double> kpis;
+};
+
+void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [--search grid|random|coord] [--param NAME[=LO:HI[:STEP]]]...\n"
+            "          [--scenarios A,B,...] [--seeds N] [--seconds S] [--weight KPI=W]...\n"
+            "          [--samples N] [--rounds N] [--max-evals N] [--rng-seed N]\n"
+            "          [--jobs N] [--fork] [--out FILE] [--list]\n", argv0);
+}
+
+bool parseParam(const char *arg, Range &r) {
+    char name[64];
+    const char *eq = strchr(arg, '=');
+    size_t len = eq ? static_cast<size_t>(eq - arg) : strlen(arg);
+    if (len >= sizeof(name)) return false;
+    memcpy(name, arg, len);
+    name[len] = '\0';
+
+    r.index = SimTunables::indexOf(name);
+    if (r.index < 0) return false;
+    const SimTunable &t = SimTunables::TUNABLES[r.index];
+    r.lo = t.lo;
+    r.hi = t.hi;
+    r.step = t.step;
+    if (eq && sscanf(eq + 1, "%lf:%lf:%lf", &r.lo, &r.hi, &r.step) < 2) return false;
+    if (t.integral && r.step < 1.0) r.step = 1.0;
+    return r.step > 0.0 && r.hi >= r.lo;
+}
+
+bool parseScenarios(const char *arg, Options &o) {
+    std::string list(arg);
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == std::string::npos) comma = list.size();
+        const BeaconScenario *sc = SimWorld::findScenario(list.substr(start, comma - start).c_str());
+        if (!sc) return false;
+        o.scenarios.push_back(sc);
+        start = comma + 1;
+    }
+    return true;
+}
+
+bool parseWeight(const char *arg, Options &o) {
+    const char *eq = strchr(arg, '=');
+    if (!eq) return false;
+    std::string name(arg, eq);
+    const SimKpiField *k = SimRun::findKpi(name.c_str());
+    if (!k) return false;
+    o.weights[k - SimRun::KPIS] = atof(eq + 1);
+    return true;
+}
+
+bool parseArgs(int argc, char **argv, Options &o) {
+    o.weights.assign(SimRun::KPI_COUNT, 0.0);
+    for (const Weight &w : DEFAULT_WEIGHTS) {
+        const SimKpiField *k = SimRun::findKpi(w.kpi);
+        if (k) o.weights[k - SimRun::KPIS] = w.weight;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (strcmp(a, "--list") == 0) {
+            o.list = true;
+            continue;
+        }
+        if (strcmp(a, "--fork") == 0) {
+            o.fork = true;
+            continue;
+        }
+        const char *v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!v) return false;
+        if (strcmp(a, "--param") == 0) {
+            Range r;
+            if (!parseParam(v, r)) return false;
+            o.params.push_back(r);
+        } else if (strcmp(a, "--scenarios") == 0) {
+            if (!parseScenarios(v, o)) return false;
+        } else if (strcmp(a, "--weight") == 0) {
+            if (!parseWeight(v, o)) return false;
+        }
+        else if (strcmp(a, "--search") == 0)    o.search   = v;
+        else if (strcmp(a, "--seeds") == 0)     o.seeds    = static_cast<uint32_t>(strtoul(v, nullptr, 0));
+        else if (strcmp(a, "--seconds") == 0)   o.seconds  = atof(v);
+        else if (strcmp(a, "--samples") == 0)   o.samples  = static_cast<uint32_t>(strtoul(v, nullptr, 0));
+        else if (strcmp(a, "--rounds") == 0)    o.rounds   = static_cast<uint32_t>(strtoul(v, nullptr, 0));
+        else if (strcmp(a, "--max-evals") == 0) o.maxEvals = static_cast<uint32_t>(strtoul(v, nullptr, 0));
+        else if (strcmp(a, "--rng-seed") == 0)  o.rngSeed  = static_cast<uint32_t>(strtoul(v, nullptr, 0));
+        else if (strcmp(a, "--jobs") == 0)      o.jobs     = static_cast<unsigned>(strtoul(v, nullptr, 0));
+        else if (strcmp(a, "--out") == 0)       o.outPath  = v;
+        else return false;
+        i++;
+    }
+
+    if (o.params.empty()) {
+        for (uint8_t t = 0; t < SimTunables::COUNT; t++) {
+            const SimTunable &st = SimTunables::TUNABLES[t];
+            o.params.push_back(Range{t, st.lo, st.hi, st.step});
+        }
+    }
+    if (o.scenarios.empty()) {
+        for (uint8_t s = 0; s < SimWorld::SCENARIO_COUNT; s++) o.scenarios.push_back(&SimWorld::SCENARIOS[s]);
+    }
+    return o.seeds > 0 &&
+           (strcmp(o.search, "grid") == 0 || strcmp(o.search, "random") == 0 ||
+            strcmp(o.search, "coord") == 0);
+}
+
+void printList(const Options &o) {
+    const double *def = SimTunables::defaults();
+    printf("Tunables (config.h value, default search range):\n");
+    for (uint8_t t = 0; t < SimTunables::COUNT; t++) {
+        const SimTunable &st = SimTunables::TUNABLES[t];
+        printf("  %-26s %-8s %8g   %g:%g:%g\n", st.name, st.type, def[t], st.lo, st.hi, st.step);
+    }
+    printf("\nObjective weights (lower objective is better):\n");
+    for (uint8_t k = 0; k < SimRun::KPI_COUNT; k++) {
+        printf("  %-22s %10g%s\n", SimRun::KPIS[k].name, o.weights[k],
+               SimRun::KPIS[k].higherIsBetter ? "  (higher is better)" : "");
+    }
+    printf("\nScenarios:\n");
+    for (uint8_t s = 0; s < SimWorld::SCENARIO_COUNT; s++) {
+        printf("  %-10s %s\n", SimWorld::SCENARIOS[s].name, SimWorld::SCENARIOS[s].description);
+    }
+}
+
+// ===================================================================
+// Evaluation
+// ===================================================================
+
+/** Scores candidates on the pool, remembering every score. */
+class Evaluator {
+public:
+    Evaluator(const Options &opt, WorkPool &pool) : opt_(opt), pool_(pool) {}
+
+    std::vector<Score> score(const std::vector<Point> &points) {
+        std::vector<Score> out(points.size());
+        std::vector<const Point *> todo;
+        for (size_t i = 0; i < points.size(); i++) {
+            auto it = cache_.find(points[i]);
+            if (it != cache_.end()) {
+                out[i] = it->second;
+            } else {
+                todo.push_back(&points[i]);
+            }
+        }
+        if (todo.empty()) return out;
+
+        const size_t perPoint = opt_.scenarios.size() * opt_.seeds;
+        std::vector<SimKpis> results(todo.size() * perPoint);
+        std::vector<char>    ok(results.size(), 0);
+
+        for (size_t p = 0; p < todo.size(); p++) {
+            for (size_t s = 0; s < opt_.scenarios.size(); s++) {
+                for (uint32_t seed = 1; seed <= opt_.seeds; seed++) {
+                    size_t slot = p * perPoint + s * opt_.seeds + (seed - 1);
+                    SimConfig cfg;
+                    cfg.scenario   = opt_.scenarios[s];
+                    cfg.world.seed = seed;
+                    cfg.seconds    = opt_.seconds;
+                    cfg.tunables   = todo[p]->data();
+                    bool isolate = opt_.fork;
+                    pool_.submit([cfg, slot, isolate, &results, &ok] {
+                        ok[slot] = isolate ? SimRun::runIsolated(cfg, results[slot])
+                                           : SimRun::run(cfg, results[slot]);
+                    });
+                }
+            }
+        }
+        pool_.wait();
+
+        for (size_t p = 0; p < todo.size(); p++) {
+            Score sc;
+            sc.objective = 0.0;
+            sc.kpis.assign(SimRun::KPI_COUNT, 0.0);
+            for (size_t r = 0; r < perPoint; r++) {
+                size_t slot = p * perPoint + r;
+                runs_++;
+                simS_ += results[slot].simS;
+                if (!ok[slot]) {
+                    sc.objective = INFINITY;
+                    continue;
+                }
+                for (uint8_t k = 0; k < SimRun::KPI_COUNT; k++) {
+                    const SimKpiField &f = SimRun::KPIS[k];
+                    double v = f.get(results[slot]);
+                    sc.kpis[k]   += v / perPoint;
+                    sc.objective += opt_.weights[k] * (f.higherIsBetter ? -v : v) / opt_.seeds;
+                }
+            }
+            cache_[*todo[p]] = sc;
+        }
+
+        for (size_t i = 0; i < points.size(); i++) out[i] = cache_[points[i]];
+        return out;
+    }
+
+    uint64_t runs() const { return runs_; }
+    double   simS() const { return simS_; }
+    size_t   evaluated() const { return cache_.size(); }
+
+private:
+    const Options &opt_;
+    WorkPool      &pool_;
+    std::map<Point, Score> cache_;
+    uint64_t runs_ = 0;
+    double   simS_ = 0.0;
+};
+
+// ===================================================================
+// Searches
+// ===================================================================
+
+struct Best {
+    Point p;
+    Score s;
+};
+
+void consider(Best &best, const std::vector<Point> &pts, const std::vector<Score> &scores) {
+    for (size_t i = 0; i < pts.size(); i++) {
+        if (scores[i].objective < best.s.objective) best = Best{pts[i], scores[i]};
+    }
+}
+
+void searchGrid(const Options &o, Evaluator &ev, Best &best) {
+    double count = 1.0;
+    for (const Range &r : o.params) count *= r.values().size();
+    if (count > o.maxEvals) {
+        fprintf(stderr, "grid: %.0f candidates > --max-evals %lu; narrow the ranges\n",
+                count, static_cast<unsigned long>(o.maxEvals));
+        return;
+    }
+
+    std::vector<Point> pts(1, best.p);
+    for (const Range &r : o.params) {
+        std::vector<Point> next;
+        for (const Point &p : pts) {
+            for (double v : r.values()) {
+                Point q = p;
+                q[r.index] = v;
+                next.push_back(q);
+            }
+        }
+        pts.swap(next);
+    }
+    consider(best, pts, ev.score(pts));
+    printf("grid: %zu candidates, best %.3f\n", pts.size(), best.s.objective);
+}
+
+void searchRandom(const Options &o, Evaluator &ev, Best &best) {
+    std::mt19937 rng(o.rngSeed);
+    std::vector<Point> pts;
+    for (uint32_t i = 0; i < o.samples; i++) {
+        Point p = best.p;
+        for (const Range &r : o.params) {
+            std::vector<double> vals = r.values();
+            p[r.index] = vals[rng() % vals.size()];
+        }
+        pts.push_back(p);
+    }
+    consider(best, pts, ev.score(pts));
+    printf("random: %zu candidates, best %.3f\n", pts.size(), best.s.objective);
+}
+
+void searchCoord(const Options &o, Evaluator &ev, Best &best) {
+    for (uint32_t round = 1; round <= o.rounds; round++) {
+        bool moved = false;
+        for (const Range &r : o.params) {
+            std::vector<Point> pts;
+            for (double v : r.values()) {
+                Point q = best.p;
+                q[r.index] = v;
+                pts.push_back(q);
+            }
+            double before = best.s.objective;
+            consider(best, pts, ev.score(pts));
+
+            const SimTunable &t = SimTunables::TUNABLES[r.index];
+            char val[32];
+            SimTunables::format(t, best.p[r.index], val, sizeof(val));
+            printf("round %lu  %-26s %-8s objective %.3f%s\n",
+                   static_cast<unsigned long>(round), t.name, val, best.s.objective,
+                   best.s.objective < before ? "  *" : "");
+            fflush(stdout);
+            if (best.s.objective < before) moved = true;
+        }
+        if (!moved) break;
+    }
+}
+
+// ===================================================================
+// Output
+// ===================================================================
+
+bool writeHeader(const Options &o, const Best &best, const Score &base, uint64_t runs) {
+    FILE *f = fopen(o.outPath, "w");
+    if (!f) return false;
+
+    const double *def = SimTunables::defaults();
+    fprintf(f, "/**\n"
+               " * @file tuned_config.h\n"
+               " * @brief config.h tunables chosen by sentry-tune.  Generated; do not edit.\n"
+               " *\n"
+               " * %s search over %zu parameters, %llu simulation runs.\n"
+               " * Scenarios:",
+            o.search, o.params.size(), static_cast<unsigned long long>(runs));
+    for (const BeaconScenario *sc : o.scenarios) fprintf(f, " %s", sc->name);
+    fprintf(f, "; seeds 1-%lu.\n"
+               " * Objective %.3f (config.h: %.3f).\n"
+               " *\n"
+               " * Copy the changed lines into include/config.h, then regenerate\n"
+               " * sim/baseline.csv with sentry-bench --write-baseline.\n"
+               " */\n\n"
+               "#ifndef TURRET_TUNED_CONFIG_H\n"
+               "#define TURRET_TUNED_CONFIG_H\n\n",
+            static_cast<unsigned long>(o.seeds), best.s.objective, base.objective);
+
+    for (const Range &r : o.params) {
+        const SimTunable &t = SimTunables::TUNABLES[r.index];
+        char now[32], was[32], line[128];
+        SimTunables::format(t, best.p[r.index], now, sizeof(now));
+        SimTunables::format(t, def[r.index], was, sizeof(was));
+        snprintf(line, sizeof(line), "TURRET_TUNABLE(%s, %s, %s);", t.type, t.name, now);
+        if (strcmp(now, was) == 0) {
+            fprintf(f, "%-64s // unchanged\n", line);
+        } else {
+            fprintf(f, "%-64s // was %s\n", line, was);
+        }
+    }
+    fprintf(f, "\n#endif // TURRET_TUNED_CONFIG_H\n");
+    fclose(f);
+    return true;
+}
+
+void printSummary(const Options &o, const Best &best, const Score &base) {
+    const double *def = SimTunables::defaults();
+    printf("\n%-26s %10s %10s\n", "parameter", "config.h", "best");
+    for (const Range &r : o.params) {
+        const SimTunable &t = SimTunables::TUNABLES[r.index];
+        printf("%-26s %10g %10g%s\n", t.name, def[r.index], best.p[r.index],
+               def[r.index] != best.p[r.index] ? "  *" : "");
+    }
+    printf("\n%-22s %12s %12s  (mean over scenarios and seeds)\n", "kpi", "config.h", "best");
+    for (uint8_t k = 0; k < SimRun::KPI_COUNT; k++) {
+        printf("%-22s %12.2f %12.2f\n", SimRun::KPIS[k].name, base.kpis[k], best.s.kpis[k]);
+    }
+    printf("%-22s %12.3f %12.3f\n", "objective", base.objective, best.s.objective);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (opt.list) {
+        printList(opt);
+        return 0;
+    }
+
+    WorkPool pool(opt.jobs);
+    Evaluator ev(opt, pool);
+    auto wallStart = std::chrono::steady_clock::now();
+
+    printf("sentry-tune: %s search, %zu parameters, %zu scenarios x %lu seeds, %u threads\n",
+           opt.search, opt.params.size(), opt.scenarios.size(),
+           static_cast<unsigned long>(opt.seeds), pool.threads());
+
+    const double *def = SimTunables::defaults();
+    Best best{Point(def, def + SimTunables::COUNT), Score()};
+    Score base = ev.score({best.p})[0];
+    best.s = base;
+    if (!isfinite(base.objective)) {
+        fprintf(stderr, "config.h values: simulation failed\n");
+        return 1;
+    }
+    printf("config.h objective %.3f\n", base.objective);
+
+    if (strcmp(opt.search, "grid") == 0) {
+        searchGrid(opt, ev, best);
+    } else if (strcmp(opt.search, "random") == 0) {
+        searchRandom(opt, ev, best);
+    } else {
+        searchCoord(opt, ev, best);
+    }
+
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    printSummary(opt, best, base);
+    printf("\n%zu candidates, %llu runs, %.0f s simulated in %.1f s on %u threads "
+           "(%.1f runs/s, %.0fx real time), %llu steals\n",
+           ev.evaluated(), static_cast<unsigned long long>(ev.runs()), ev.simS(), wallS,
+           pool.threads(), ev.runs() / wallS, ev.simS() / wallS,
+           static_cast<unsigned long long>(pool.steals()));
+
+    if (!writeHeader(opt, best, base, ev.runs())) {
+        perror(opt.outPath);
+        return 2;
+    }
+    printf("Written to %s\n", opt.outPath);
+    return 0;
+}
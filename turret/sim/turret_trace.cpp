@@ -0,0 +1,257 @@
+/**
+ * @file turret_trace.cpp
+ * @brief Trace-event JSON writer and the turret's tracks.
+ */
+
+#include "turret_trace.h"
+#include "sensor_array.h"
+
+namespace {
+
+/** Timeline gap left for a reboot (its real length is not captured). */
+constexpr double REBOOT_GAP_US = 1e6;
+
+const char *const TRACK_NAMES[TurretTrace::TRACK_COUNT] = {
+    "state", "monitor",
+    "raw top", "raw bottom", "raw left", "raw right",
+    "filtered top", "filtered bottom", "filtered left", "filtered right",
+    "control", "capture", "telemetry"
+};
+
+const char *monitorName(MonitorState m) {
+    switch (m) {
+        case MonitorState::TRACKING:  return "TRACKING";
+        case MonitorState::SEARCHING: return "SEARCHING";
+        case MonitorState::PARKED:    return "PARKED";
+        default:                      return "?";
+    }
+}
+
+const char *sensorStateName(uint8_t s) {
+    switch (static_cast<SensorState>(s)) {
+        case SensorState::ACTIVE:    return "ACTIVE";
+        case SensorState::SATURATED: return "SATURATED";
+        default:                     return nullptr;
+    }
+}
+
+/** @p s as a JSON string body (names from the command line may hold anything). */
+void putEscaped(FILE *f, const char *s) {
+    for (; *s; s++) {
+        unsigned char c = static_cast<unsigned char>(*s);
+        if (c == '"' || c == '\\') {
+            fputc('\\', f);
+            fputc(c, f);
+        } else if (c < 0x20) {
+            fprintf(f, "\\u%04x", c);
+        } else {
+            fputc(c, f);
+        }
+    }
+}
+
+}  // namespace
+
+// ===================================================================
+// TraceWriter
+// ===================================================================
+
+TraceWriter::TraceWriter(FILE *f) : f_(f) {
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f_);
+}
+
+void TraceWriter::next() {
+    if (events_++) fputs(",\n", f_);
+}
+
+void TraceWriter::processName(uint32_t pid, const char *name, int sortIndex) {
+    next();
+    fprintf(f_, "{\"ph\":\"M\",\"pid\":%lu,\"name\":\"process_name\",\"args\":{\"name\":\"",
+            static_cast<unsigned long>(pid));
+    putEscaped(f_, name);
+    fputs("\"}}", f_);
+    next();
+    fprintf(f_, "{\"ph\":\"M\",\"pid\":%lu,\"name\":\"process_sort_index\","
+                "\"args\":{\"sort_index\":%d}}",
+            static_cast<unsigned long>(pid), sortIndex);
+}
+
+void TraceWriter::threadName(uint32_t pid, uint32_t tid, const char *name, int sortIndex) {
+    next();
+    fprintf(f_, "{\"ph\":\"M\",\"pid\":%lu,\"tid\":%lu,\"name\":\"thread_name\",\"args\":{\"name\":\"",
+            static_cast<unsigned long>(pid), static_cast<unsigned long>(tid));
+    putEscaped(f_, name);
+    fputs("\"}}", f_);
+    next();
+    fprintf(f_, "{\"ph\":\"M\",\"pid\":%lu,\"tid\":%lu,\"name\":\"thread_sort_index\","
+                "\"args\":{\"sort_index\":%d}}",
+            static_cast<unsigned long>(pid), static_cast<unsigned long>(tid), sortIndex);
+}
+
+void TraceWriter::complete(uint32_t pid, uint32_t tid, const char *name, double tsUs, double durUs) {
+    next();
+    fprintf(f_, "{\"ph\":\"X\",\"pid\":%lu,\"tid\":%lu,\"name\":\"%s\",\"ts\":%.3f,\"dur\":%.3f}",
+            static_cast<unsigned long>(pid), static_cast<unsigned long>(tid), name, tsUs, durUs);
+}
+
+void TraceWriter::instant(uint32_t pid, uint32_t tid, const char *name, double tsUs) {
+    next();
+    fprintf(f_, "{\"ph\":\"i\",\"s\":\"p\",\"pid\":%lu,\"tid\":%lu,\"name\":\"%s\",\"ts\":%.3f}",
+            static_cast<unsigned long>(pid), static_cast<unsigned long>(tid), name, tsUs);
+}
+
+void TraceWriter::counter(uint32_t pid, const char *name, double tsUs, double value) {
+    next();
+    fprintf(f_, "{\"ph\":\"C\",\"pid\":%lu,\"name\":\"%s\",\"ts\":%.3f,\"args\":{\"value\":%.6g}}",
+            static_cast<unsigned long>(pid), name, tsUs, value);
+}
+
+void TraceWriter::finish() {
+    fputs("\n]}\n", f_);
+}
+
+// ===================================================================
+// TurretTrace
+// ===================================================================
+
+TurretTrace::TurretTrace(TraceWriter &w, uint32_t pid, const char *name) : w_(w), pid_(pid) {
+    w_.processName(pid_, name, static_cast<int>(pid_));
+    for (uint8_t t = 0; t < TRACK_COUNT; t++) {
+        w_.threadName(pid_, t, TRACK_NAMES[t], t);
+    }
+}
+
+void TurretTrace::sample(uint32_t tUs, uint8_t rawBits) {
+    rawSpans(rawBits, unwrap(tUs));
+    sampled_ = true;
+}
+
+void TurretTrace::tick(const TelemetryRecord &r, MonitorState monitor) {
+    double t = unwrap(r.tUs);
+    if (!sampled_) rawSpans(r.rawBits, t);
+    sampled_ = false;
+
+    setSpan(STATE, r.state < static_cast<uint8_t>(TurretState::COUNT)
+                       ? TurretStateMachine::stateName(static_cast<TurretState>(r.state))
+                       : "?",
+            t);
+    setSpan(MONITOR, monitorName(monitor), t);
+    for (uint8_t k = 0; k < 4; k++) {
+        setSpan(FILTERED + k, sensorStateName((r.filtered >> (2 * k)) & 3), t);
+    }
+
+    setCounter("pan_cmd", t, r.panCmd / 10000.0);
+    setCounter("pan_deg", t, r.panCdeg / 100.0);
+    setCounter("tilt_deg", t, r.tiltDeg);
+
+    // The turret's own tick cost (a recorded session; 0 in the simulator).
+    if (r.loopUs > 0) w_.complete(pid_, CONTROL, "tick", t, r.loopUs);
+}
+
+void TurretTrace::counter(const char *name, uint32_t tUs, double value) {
+    setCounter(name, unwrap(tUs), value);
+}
+
+void TurretTrace::stage(ProfStage stage, uint32_t tUs, uint32_t startTicks, uint32_t ticks) {
+    double perUs = Profiler::ticksPerUs();
+    switch (stage) {
+        case ProfStage::SENSORS:
+            w_.complete(pid_, CAPTURE, Profiler::stageName(stage), unwrap(tUs), ticks / perUs);
+            return;
+        case ProfStage::TELEMETRY:
+            w_.complete(pid_, TELEMETRY, Profiler::stageName(stage), unwrap(tUs), ticks / perUs);
+            return;
+        case ProfStage::CONTROL_TICK:
+            break;
+        default:
+            // Inside the control tick, which ends (and is recorded) last.
+            if (pendingCount_ < MAX_STAGES) {
+                pending_[pendingCount_++] = {stage, startTicks, ticks};
+            } else {
+                stageDrops_++;
+            }
+            return;
+    }
+
+    double t = unwrap(tUs);
+    w_.complete(pid_, CONTROL, Profiler::stageName(stage), t, ticks / perUs);
+    for (uint8_t i = 0; i < pendingCount_; i++) {
+        const Stage &s = pending_[i];
+        uint32_t offset = s.startTicks - startTicks;
+        if (offset > ticks) continue;   // Left over from before this tick
+        w_.complete(pid_, CONTROL, Profiler::stageName(s.stage), t + offset / perUs, s.ticks / perUs);
+    }
+    pendingCount_ = 0;
+}
+
+void TurretTrace::reboot() {
+    finish();
+    w_.instant(pid_, STATE, "reboot", nowUs_);
+    rebase_  = true;
+    sampled_ = false;
+    pendingCount_ = 0;
+}
+
+void TurretTrace::finish() {
+    for (uint8_t t = 0; t < TRACK_COUNT; t++) setSpan(t, nullptr, nowUs_);
+}
+
+MonitorState TurretTrace::monitorOf(uint8_t state) {
+    switch (static_cast<TurretState>(state)) {
+        case TurretState::SEARCHING: return MonitorState::SEARCHING;
+        case TurretState::PARKED:    return MonitorState::PARKED;
+        default:                     return MonitorState::TRACKING;
+    }
+}
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+double TurretTrace::unwrap(uint32_t tUs) {
+    if (!haveTime_ || rebase_) {
+        // The turret's clock as it is for the first boot; the next one
+        // carries on a little after the last event.
+        epochUs_   = haveTime_ ? nowUs_ + REBOOT_GAP_US - tUs : 0.0;
+        unwrapped_ = tUs;
+        lastUs_    = tUs;
+        haveTime_  = true;
+        rebase_    = false;
+    }
+    unwrapped_ += static_cast<int32_t>(tUs - lastUs_);
+    lastUs_ = tUs;
+
+    double t = epochUs_ + static_cast<double>(unwrapped_);
+    if (t > nowUs_) nowUs_ = t;
+    return t;
+}
+
+void TurretTrace::setSpan(uint8_t track, const char *name, double tsUs) {
+    Span &s = span_[track];
+    if (s.name == name) return;   // Names are static strings
+    if (s.name && tsUs > s.startUs) w_.complete(pid_, track, s.name, s.startUs, tsUs - s.startUs);
+    s.name    = name;
+    s.startUs = tsUs;
+}
+
+void TurretTrace::setCounter(const char *name, double tsUs, double value) {
+    for (uint8_t i = 0; i < MAX_COUNTERS; i++) {
+        Counter &c = counter_[i];
+        if (c.name == nullptr) {
+            c.name = name;
+        } else if (c.name != name) {
+            continue;
+        } else if (c.value == value) {
+            return;
+        }
+        c.value = value;
+        w_.counter(pid_, name, tsUs, value);
+        return;
+    }
+}
+
+void TurretTrace::rawSpans(uint8_t rawBits, double tsUs) {
+    for (uint8_t k = 0; k < 4; k++) {
+        setSpan(RAW + k, (rawBits & (1u << k)) ? "LOW" : nullptr, tsUs);
+    }
+}
@@ -0,0 +1,165 @@
+/**
+ * @file turret_trace.h
+ * @brief Turret timelines as Chrome trace-event JSON, streamed: load the
+ *        file in ui.perfetto.dev or chrome://tracing.
+ *
+ * TraceWriter writes the JSON event array as it goes; TurretTrace turns
+ * telemetry into tracks of one process (a turret, recorded or replayed):
+ *
+ *   state            TurretState spans
+ *   monitor          MonitorState spans
+ *   raw T/B/L/R      LOW spans, per captured sample
+ *   filtered T/B/L/R ACTIVE / SATURATED spans
+ *   control          tick slices (loopUs, when the record has it) and
+ *                    the stages under them (Profiler samples)
+ *   counters         pan command, estimated pan, tilt; plus any the
+ *                    caller adds (ground truth in the simulator)
+ *
+ * Memory is fixed: one open span per track and the last value of each
+ * counter (repeats are not written).  A span is written when it ends,
+ * so finish() closes the ones still open before the closing bracket.
+ *
+ * Timestamps are the turret's 32-bit micros(), unwrapped; reboot()
+ * continues the timeline after a restart instead of going back to 0.
+ */
+
+#ifndef TURRET_TRACE_H
+#define TURRET_TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "profiler.h"
+#include "signal_monitor.h"
+#include "telemetry_stream.h"
+#include "turret_fsm.h"
+
+/** @brief Chrome trace-event JSON onto a FILE, one event per line. */
+class TraceWriter {
+public:
+    /** @brief Start the event array on @p f (not owned). */
+    explicit TraceWriter(FILE *f);
+
+    /** @brief Process / thread names and display order (metadata events). */
+    void processName(uint32_t pid, const char *name, int sortIndex);
+    void threadName(uint32_t pid, uint32_t tid, const char *name, int sortIndex);
+
+    /** @brief A slice of @p durUs from @p tsUs ("X"). */
+    void complete(uint32_t pid, uint32_t tid, const char *name, double tsUs, double durUs);
+
+    /** @brief A point event on a thread ("i"). */
+    void instant(uint32_t pid, uint32_t tid, const char *name, double tsUs);
+
+    /** @brief One value of counter @p name ("C"). */
+    void counter(uint32_t pid, const char *name, double tsUs, double value);
+
+    /** @brief Close the array.  Nothing may be written after. */
+    void finish();
+
+    uint64_t events() const { return events_; }
+
+private:
+    FILE    *f_;
+    uint64_t events_ = 0;
+
+    void next();
+};
+
+class TurretTrace {
+public:
+    /** @brief Tracks (trace thread ids) of one turret. */
+    enum Track : uint8_t {
+        STATE,
+        MONITOR,
+        RAW,                       ///< RAW + sensor (top, bottom, left, right)
+        FILTERED = RAW + 4,        ///< FILTERED + sensor
+        CONTROL  = FILTERED + 4,
+        CAPTURE,                   ///< Capture stage (Profiler SENSORS)
+        TELEMETRY,                 ///< Serial output stage (Profiler TELEMETRY)
+        TRACK_COUNT
+    };
+
+    /** @brief Counters one trace can hold, its own three included. */
+    static constexpr uint8_t MAX_COUNTERS = 12;
+
+    /** @brief Pending stage samples of one control tick. */
+    static constexpr uint8_t MAX_STAGES = 48;
+
+    /** @brief Name the process and its tracks on @p w. */
+    TurretTrace(TraceWriter &w, uint32_t pid, const char *name);
+
+    /** @brief One capture sample, ahead of the tick that consumes it. */
+    void sample(uint32_t tUs, uint8_t rawBits);
+
+    /**
+     * @brief One control tick.  Ticks with no sample() before them take
+     *        their raw bits from the record.
+     */
+    void tick(const TelemetryRecord &r, MonitorState monitor);
+
+    /** @brief An extra counter (@p name must outlive the trace). */
+    void counter(const char *name, uint32_t tUs, double value);
+
+    /**
+     * @brief One Profiler sample (Profiler clock ticks) in the control
+     *        tick or capture at @p tUs.  Virtual time stands still in a
+     *        tick, so stages are laid out by their host offsets from the
+     *        tick's start; the ones inside it are held until it ends.
+     */
+    void stage(ProfStage stage, uint32_t tUs, uint32_t startTicks, uint32_t ticks);
+
+    /** @brief The turret restarted: close every span, mark it, continue after. */
+    void reboot();
+
+    /** @brief Close every open span at the last timestamp seen. */
+    void finish();
+
+    /** @brief The monitor state implied by a turret state (for traces without one). */
+    static MonitorState monitorOf(uint8_t state);
+
+    /** @brief Profiler stages dropped because a tick held more than MAX_STAGES. */
+    uint32_t stageDrops() const { return stageDrops_; }
+
+private:
+    struct Span {
+        const char *name    = nullptr;
+        double      startUs = 0.0;
+    };
+
+    struct Counter {
+        const char *name  = nullptr;
+        double      value = 0.0;
+    };
+
+    struct Stage {
+        ProfStage stage;
+        uint32_t  startTicks;
+        uint32_t  ticks;
+    };
+
+    TraceWriter &w_;
+    uint32_t     pid_;
+    Span         span_[TRACK_COUNT];
+    Counter      counter_[MAX_COUNTERS];
+    Stage        pending_[MAX_STAGES];
+    uint8_t      pendingCount_ = 0;
+    uint32_t     stageDrops_   = 0;
+
+    bool     haveTime_  = false;
+    bool     rebase_    = false;     ///< Next timestamp starts a new boot
+    uint32_t lastUs_    = 0;         ///< As received
+    int64_t  unwrapped_ = 0;         ///< ... unwrapped
+    double   epochUs_   = 0.0;       ///< Timeline time of this boot's clock 0
+    double   nowUs_     = 0.0;       ///< Latest event on the timeline
+    bool     sampled_   = false;     ///< sample() since the last tick
+
+    /** @brief @p tUs on the unwrapped timeline. */
+    double unwrap(uint32_t tUs);
+
+    /** @brief Move @p track to @p name (nullptr: nothing) at @p tsUs. */
+    void setSpan(uint8_t track, const char *name, double tsUs);
+
+    void setCounter(const char *name, double tsUs, double value);
+    void rawSpans(uint8_t rawBits, double tsUs);
+};
+
+#endif // TURRET_TRACE_H
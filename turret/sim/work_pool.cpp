@@ -0,0 +1,96 @@
+/**
+ * @file work_pool.cpp
+ * @brief Work-stealing thread pool.
+ */
+
+#include "work_pool.h"
+
+WorkPool::WorkPool(unsigned threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    for (unsigned i = 0; i < threads; i++) queues_.emplace_back(new Queue);
+    for (unsigned i = 0; i < threads; i++) workers_.emplace_back(&WorkPool::run, this, i);
+}
+
+WorkPool::~WorkPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> g(lock_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread &t : workers_) t.join();
+}
+
+void WorkPool::submit(Job job) {
+    pending_.fetch_add(1);
+    {
+        Queue &q = *queues_[next_];
+        next_ = (next_ + 1) % queues_.size();
+        std::lock_guard<std::mutex> g(q.lock);
+        q.jobs.push_back(std::move(job));
+        queued_.fetch_add(1);
+    }
+
+    // Taking the lock orders this against a worker's check-then-sleep.
+    { std::lock_guard<std::mutex> g(lock_); }
+    wake_.notify_one();
+}
+
+void WorkPool::wait() {
+    std::unique_lock<std::mutex> lk(lock_);
+    idle_.wait(lk, [this] { return pending_.load() == 0; });
+}
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+bool WorkPool::take(unsigned self, Job &job) {
+    const unsigned n = static_cast<unsigned>(queues_.size());
+
+    // Own deque, newest first.
+    {
+        Queue &q = *queues_[self];
+        std::lock_guard<std::mutex> g(q.lock);
+        if (!q.jobs.empty()) {
+            job = std::move(q.jobs.back());
+            q.jobs.pop_back();
+            queued_.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // Someone else's, oldest first.
+    for (unsigned i = 1; i < n; i++) {
+        Queue &q = *queues_[(self + i) % n];
+        std::lock_guard<std::mutex> g(q.lock);
+        if (!q.jobs.empty()) {
+            job = std::move(q.jobs.front());
+            q.jobs.pop_front();
+            queued_.fetch_sub(1);
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkPool::run(unsigned self) {
+    while (true) {
+        Job job;
+        if (take(self, job)) {
+            job();
+            if (pending_.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> g(lock_);
+                idle_.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lk(lock_);
+        wake_.wait(lk, [this] { return stop_ || queued_.load() > 0; });
+        if (stop_ && queued_.load() == 0) return;
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * @file work_pool.h
+ * @brief Work-stealing thread pool for the host tools.
+ *
+ * One deque per worker.  submit() deals jobs round-robin; a worker takes
+ * from the back of its own deque and, when that is empty, steals from
+ * the front of the others'.  Simulation runs differ in length by a factor
+ * of several (scenario, and how long the turret spends searching), so
+ * without stealing a batch finishes at the pace of its unluckiest
+ * worker.
+ *
+ * Jobs must not throw.  wait() returns once every submitted job has
+ * finished; the pool can then take another batch.
+ */
+
+#ifndef WORK_POOL_H
+#define WORK_POOL_H
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkPool {
+public:
+    typedef std::function<void()> Job;
+
+    /** @param threads  Workers; 0 = one per hardware thread. */
+    explicit WorkPool(unsigned threads = 0);
+    ~WorkPool();
+
+    WorkPool(const WorkPool &) = delete;
+    WorkPool &operator=(const WorkPool &) = delete;
+
+    void submit(Job job);
+
+    /** @brief Block until every submitted job has finished. */
+    void wait();
+
+    unsigned threads() const { return static_cast<unsigned>(workers_.size()); }
+
+    /** @brief Jobs taken from another worker's deque, since construction. */
+    uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue {
+        std::mutex      lock;
+        std::deque<Job> jobs;
+    };
+
+    void run(unsigned self);
+    bool take(unsigned self, Job &job);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread>            workers_;
+
+    std::mutex              lock_;       ///< Guards the sleeps and stop_
+    std::condition_variable wake_;       ///< Work queued, or stopping
+    std::condition_variable idle_;       ///< pending_ reached 0
+    std::atomic<size_t>     queued_{0};  ///< In a deque
+    std::atomic<size_t>     pending_{0}; ///< Submitted, not finished
+    std::atomic<uint64_t>   steals_{0};
+    unsigned                next_ = 0;   ///< Round-robin target for submit()
+    bool                    stop_ = false;
+};
+
+#endif // WORK_POOL_H
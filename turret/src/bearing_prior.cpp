@@ -0,0 +1,179 @@
+/**
+ * @file bearing_prior.cpp
+ * @brief Bearing / elevation histogram with aging and persistence.
+ */
+
+#include "bearing_prior.h"
+#include "hal.h"
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+void BearingPrior::clear() {
+    for (uint8_t i = 0; i < PRIOR_BINS; i++) {
+        weight_[i]    = 0;
+        elevation_[i] = NO_ELEVATION;
+    }
+    lastAgeMs_ = Hal::millis();
+    dirty_     = true;
+}
+
+void BearingPrior::recordAcquired(float bearingDeg, int16_t tiltDeg) {
+    record(bearingDeg, tiltDeg);
+}
+
+void BearingPrior::recordLost(float bearingDeg, int16_t tiltDeg) {
+    record(bearingDeg, tiltDeg);
+}
+
+void BearingPrior::ageIfDue() {
+    uint32_t now = Hal::millis();
+    if ((now - lastAgeMs_) >= PRIOR_AGE_INTERVAL_MS) {
+        lastAgeMs_ = now;
+        age();
+    }
+}
+
+void BearingPrior::age() {
+    for (uint8_t i = 0; i < PRIOR_BINS; i++) {
+        weight_[i] -= weight_[i] >> 3;
+        if (weight_[i] == 0) {
+            elevation_[i] = NO_ELEVATION;
+        }
+    }
+    dirty_ = true;
+}
+
+uint8_t BearingPrior::binFor(float bearingDeg) {
+    float offset = (bearingDeg + PAN_LIMIT_DEG) / PRIOR_BIN_DEG;
+    if (offset < 0.0f) return 0;
+    uint8_t bin = static_cast<uint8_t>(offset);
+    return (bin >= PRIOR_BINS) ? PRIOR_BINS - 1 : bin;
+}
+
+float BearingPrior::binCenterDeg(uint8_t bin) {
+    return -PAN_LIMIT_DEG + (bin + 0.5f) * PRIOR_BIN_DEG;
+}
+
+uint16_t BearingPrior::weight(uint8_t bin) const {
+    return (bin < PRIOR_BINS) ? weight_[bin] : 0;
+}
+
+uint32_t BearingPrior::totalWeight() const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < PRIOR_BINS; i++) {
+        total += weight_[i];
+    }
+    return total;
+}
+
+int16_t BearingPrior::elevationAt(float bearingDeg) const {
+    uint8_t e = elevation_[binFor(bearingDeg)];
+    return (e == NO_ELEVATION) ? TILT_SCAN_DEG : e;
+}
+
+uint8_t BearingPrior::rankBins(uint8_t *out, uint8_t maxBins) const {
+    // Insertion sort of the non-empty bins — PRIOR_BINS is tiny.
+    uint8_t sorted[PRIOR_BINS];
+    uint8_t n = 0;
+    for (uint8_t bin = 0; bin < PRIOR_BINS; bin++) {
+        if (weight_[bin] == 0) continue;
+
+        uint8_t pos = n++;
+        while (pos > 0 && weight_[sorted[pos - 1]] < weight_[bin]) {
+            sorted[pos] = sorted[pos - 1];
+            pos--;
+        }
+        sorted[pos] = bin;
+    }
+
+    if (n > maxBins) n = maxBins;
+    for (uint8_t i = 0; i < n; i++) {
+        out[i] = sorted[i];
+    }
+    return n;
+}
+
+bool BearingPrior::isDirty() const {
+    return dirty_;
+}
+
+void BearingPrior::markClean() {
+    dirty_ = false;
+}
+
+size_t BearingPrior::save(uint8_t *out) const {
+    size_t n = 0;
+    out[n++] = BLOB_MAGIC & 0xFF;
+    out[n++] = BLOB_MAGIC >> 8;
+    out[n++] = BLOB_VERSION;
+    out[n++] = PRIOR_BINS;
+    for (uint8_t i = 0; i < PRIOR_BINS; i++) {
+        out[n++] = weight_[i] & 0xFF;
+        out[n++] = weight_[i] >> 8;
+        out[n++] = elevation_[i];
+    }
+    uint16_t sum = checksum(out, n);
+    out[n++] = sum & 0xFF;
+    out[n++] = sum >> 8;
+    return n;
+}
+
+bool BearingPrior::load(const uint8_t *in, size_t len) {
+    clear();
+    dirty_ = false;
+
+    if (len != BLOB_SIZE) return false;
+    if ((in[0] | (in[1] << 8)) != BLOB_MAGIC) return false;
+    if (in[2] != BLOB_VERSION || in[3] != PRIOR_BINS) return false;
+
+    uint16_t stored = in[BLOB_SIZE - 2] | (in[BLOB_SIZE - 1] << 8);
+    if (checksum(in, BLOB_SIZE - 2) != stored) return false;
+
+    size_t n = 4;
+    for (uint8_t i = 0; i < PRIOR_BINS; i++) {
+        weight_[i]    = in[n] | (in[n + 1] << 8);
+        elevation_[i] = in[n + 2];
+        n += 3;
+    }
+    return true;
+}
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+void BearingPrior::record(float bearingDeg, int16_t tiltDeg) {
+    uint8_t bin = binFor(bearingDeg);
+
+    // Keep headroom: halving everything preserves the ranking.
+    if (weight_[bin] > 0xFFFF - PRIOR_EVENT_WEIGHT) {
+        for (uint8_t i = 0; i < PRIOR_BINS; i++) {
+            weight_[i] >>= 1;
+        }
+    }
+    weight_[bin] += PRIOR_EVENT_WEIGHT;
+
+    if (tiltDeg < TILT_MIN_DEG) tiltDeg = TILT_MIN_DEG;
+    if (tiltDeg > TILT_MAX_DEG) tiltDeg = TILT_MAX_DEG;
+
+    // First sample seeds the bin; later ones blend in with weight 1/4.
+    if (elevation_[bin] == NO_ELEVATION) {
+        elevation_[bin] = static_cast<uint8_t>(tiltDeg);
+    } else {
+        int16_t e = elevation_[bin];
+        e += (tiltDeg - e) / 4;
+        elevation_[bin] = static_cast<uint8_t>(e);
+    }
+    dirty_ = true;
+}
+
+uint16_t BearingPrior::checksum(const uint8_t *data, size_t len) {
+    uint16_t a = 0, b = 0;
+    for (size_t i = 0; i < len; i++) {
+        a = (a + data[i]) % 255;
+        b = (b + a) % 255;
+    }
+    return static_cast<uint16_t>((b << 8) | a);
+}
@@ -0,0 +1,53 @@
+/**
+ * @file flight_recorder.cpp
+ * @brief Reset-surviving tick record ring.
+ */
+
+#include "flight_recorder.h"
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+bool FlightRecorder::init(Log *log) {
+    log_ = log;
+
+    bool valid = log->magic      == MAGIC &&
+                 log->capacity   == FLIGHT_RECORDER_TICKS &&
+                 log->entryBytes == sizeof(TelemetryRecord) &&
+                 log->head  < FLIGHT_RECORDER_TICKS &&
+                 log->count <= FLIGHT_RECORDER_TICKS;
+    if (valid) {
+        log->boots++;
+        return log->count > 0;
+    }
+
+    log->magic      = MAGIC;
+    log->capacity   = FLIGHT_RECORDER_TICKS;
+    log->entryBytes = sizeof(TelemetryRecord);
+    log->boots      = 0;
+    log->head       = 0;
+    log->count      = 0;
+    return false;
+}
+
+void FlightRecorder::start() {
+    log_->head  = 0;
+    log_->count = 0;
+}
+
+uint16_t FlightRecorder::count() const {
+    return log_->count;
+}
+
+const TelemetryRecord &FlightRecorder::at(uint16_t i) const {
+    // Oldest entry is at head once the ring has wrapped, else at 0.
+    uint16_t first = (log_->count == FLIGHT_RECORDER_TICKS) ? log_->head : 0;
+    uint16_t slot  = first + i;
+    if (slot >= FLIGHT_RECORDER_TICKS) slot -= FLIGHT_RECORDER_TICKS;
+    return log_->entries[slot];
+}
+
+uint32_t FlightRecorder::boots() const {
+    return log_->boots;
+}
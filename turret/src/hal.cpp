@@ -0,0 +1,303 @@
+/**
+ * @file hal.cpp
+ * @brief HAL back ends: the host fakes' state, and the target's NVS.
+ */
+
+#include "hal.h"
+
+#if defined(UNIT_TEST) || defined(SENTRY_SIM)
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <string>
+#else
+#include <Preferences.h>
+#endif
+
+// ===================================================================
+// Host: deterministic fakes
+// ===================================================================
+
+#if defined(UNIT_TEST) || defined(SENTRY_SIM)
+
+namespace {
+
+HAL_PER_THREAD HostHal::PinWriter   pinWriter   = nullptr;
+HAL_PER_THREAD void                *writerCtx   = nullptr;
+HAL_PER_THREAD HostHal::LatchReader latchReader = nullptr;
+HAL_PER_THREAD void                *latchCtx    = nullptr;
+HAL_PER_THREAD uint8_t              outLevel[HostHal::PINS];
+HAL_PER_THREAD uint64_t             latchFromUs[HostHal::PINS];   ///< Last take (or arming) per pin
+
+HAL_PER_THREAD uint16_t servoUs[HostHal::PINS];
+HAL_PER_THREAD bool     servoOn[HostHal::PINS];
+
+HAL_PER_THREAD unsigned long        baud        = 0;
+HAL_PER_THREAD double               txBusyUntil = 0.0;   ///< Virtual µs the FIFO empties at
+HAL_PER_THREAD std::vector<uint8_t> tx;
+HAL_PER_THREAD std::vector<uint8_t> rx;
+HAL_PER_THREAD size_t               rxHead = 0;
+
+HAL_PER_THREAD std::map<std::string, std::vector<uint8_t>> nvs;   ///< "namespace/key" → value
+
+double byteUs() {
+    return baud > 0 ? 10.0e6 / baud : 0.0;   // 8N1: 10 bits per byte
+}
+
+size_t writeText(const char *s, size_t len) {
+    return HostHal::serial().write(reinterpret_cast<const uint8_t *>(s), len);
+}
+
+}  // namespace
+
+HAL_PER_THREAD HostHal::SerialPort HostHal::serial_;
+
+void HostHal::reset() {
+    clockUs_    = 0;
+    wallClock_  = false;
+    pinReader_  = nullptr;
+    pinCtx_     = nullptr;
+    pinWriter   = nullptr;
+    writerCtx   = nullptr;
+    latchReader = nullptr;
+    latchCtx    = nullptr;
+    memset(outLevel, LOW, sizeof(outLevel));
+    memset(latchFromUs, 0, sizeof(latchFromUs));
+    memset(servoUs, 0, sizeof(servoUs));
+    memset(servoOn, 0, sizeof(servoOn));
+    baud        = 0;
+    txBusyUntil = 0.0;
+    tx.clear();
+    rx.clear();
+    rxHead = 0;
+}
+
+uint64_t HostHal::wallUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint32_t HostHal::cycleCount() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// --- GPIO ---
+
+void HostHal::digitalWrite(uint8_t pin, uint8_t level) {
+    if (pin < PINS) outLevel[pin] = level;
+    if (pinWriter) pinWriter(pin, level, writerCtx);
+}
+
+void HostHal::setPinReader(PinReader reader, void *ctx) {
+    pinReader_ = reader;
+    pinCtx_    = ctx;
+}
+
+void HostHal::setPinWriter(PinWriter writer, void *ctx) {
+    pinWriter = writer;
+    writerCtx = ctx;
+}
+
+uint8_t HostHal::outputLevel(uint8_t pin) {
+    return pin < PINS ? outLevel[pin] : LOW;
+}
+
+void HostHal::armLowLatch(uint8_t pin) {
+    if (pin < PINS) latchFromUs[pin] = nowUs();
+}
+
+bool HostHal::takeLowLatch(uint8_t pin) {
+    if (!latchReader || pin >= PINS) return digitalRead(pin) == LOW;
+    uint64_t now  = nowUs();
+    bool     low  = latchReader(pin, latchFromUs[pin], now, latchCtx);
+    latchFromUs[pin] = now;
+    return low;
+}
+
+void HostHal::setLatchReader(LatchReader reader, void *ctx) {
+    latchReader = reader;
+    latchCtx    = ctx;
+}
+
+// --- Servo ---
+
+int HostHal::Servo::attach(int pin) {
+    pin_ = pin;
+    if (pin >= 0 && pin < PINS) servoOn[pin] = true;
+    return 1;
+}
+
+void HostHal::Servo::detach() {
+    if (pin_ >= 0 && pin_ < PINS) servoOn[pin_] = false;
+    pin_ = -1;
+}
+
+void HostHal::Servo::writeMicroseconds(int us) {
+    if (pin_ >= 0 && pin_ < PINS) servoUs[pin_] = static_cast<uint16_t>(us);
+}
+
+uint16_t HostHal::servoPulseUs(uint8_t pin) {
+    return (pin < PINS && servoOn[pin]) ? servoUs[pin] : 0;
+}
+
+// --- Serial ---
+
+void HostHal::SerialPort::begin(unsigned long rate) {
+    baud = rate;
+}
+
+int HostHal::SerialPort::available() {
+    return static_cast<int>(rx.size() - rxHead);
+}
+
+int HostHal::SerialPort::read() {
+    if (rxHead == rx.size()) return -1;
+    int c = rx[rxHead++];
+    if (rxHead == rx.size()) {
+        rx.clear();
+        rxHead = 0;
+    }
+    return c;
+}
+
+int HostHal::SerialPort::availableForWrite() {
+    double per = byteUs();
+    if (per <= 0.0) return UART_TX_FIFO;
+    double pending = (txBusyUntil - static_cast<double>(nowUs())) / per;
+    if (pending <= 0.0) return UART_TX_FIFO;
+    int room = UART_TX_FIFO - static_cast<int>(ceil(pending));
+    return room > 0 ? room : 0;
+}
+
+size_t HostHal::SerialPort::write(const uint8_t *data, size_t len) {
+    double now = static_cast<double>(nowUs());
+    if (txBusyUntil < now) txBusyUntil = now;
+    txBusyUntil += len * byteUs();
+    tx.insert(tx.end(), data, data + len);
+    return len;
+}
+
+size_t HostHal::SerialPort::print(const char *s) {
+    return writeText(s, strlen(s));
+}
+
+size_t HostHal::SerialPort::print(char c) {
+    return writeText(&c, 1);
+}
+
+size_t HostHal::SerialPort::print(int v) {
+    return print(static_cast<long>(v));
+}
+
+size_t HostHal::SerialPort::print(unsigned int v) {
+    return print(static_cast<unsigned long>(v));
+}
+
+size_t HostHal::SerialPort::print(long v) {
+    char buf[24];
+    int n = snprintf(buf, sizeof(buf), "%ld", v);
+    return writeText(buf, static_cast<size_t>(n));
+}
+
+size_t HostHal::SerialPort::print(unsigned long v) {
+    char buf[24];
+    int n = snprintf(buf, sizeof(buf), "%lu", v);
+    return writeText(buf, static_cast<size_t>(n));
+}
+
+size_t HostHal::SerialPort::print(double v, int digits) {
+    char buf[48];
+    int n = snprintf(buf, sizeof(buf), "%.*f", digits, v);
+    if (n < 0) return 0;
+    return writeText(buf, static_cast<size_t>(n) < sizeof(buf) ? static_cast<size_t>(n) : sizeof(buf) - 1);
+}
+
+size_t HostHal::SerialPort::println() {
+    return writeText("\r\n", 2);
+}
+
+void HostHal::takeSerialTx(std::vector<uint8_t> &out) {
+    out.insert(out.end(), tx.begin(), tx.end());
+    tx.clear();
+}
+
+void HostHal::serialInject(uint8_t c) {
+    rx.push_back(c);
+}
+
+// --- Storage ---
+
+size_t HostHal::storageGet(const char *ns, const char *key, void *buf, size_t maxLen) {
+    auto it = nvs.find(std::string(ns) + "/" + key);
+    if (it == nvs.end() || it->second.size() > maxLen) return 0;
+    memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+size_t HostHal::storagePut(const char *ns, const char *key, const void *buf, size_t len) {
+    const uint8_t *p = static_cast<const uint8_t *>(buf);
+    nvs[std::string(ns) + "/" + key].assign(p, p + len);
+    return len;
+}
+
+void HostHal::storageErase() {
+    nvs.clear();
+}
+
+// ===================================================================
+// Target: sensor LOW latches and NVS through Preferences (the rest of
+// Esp32Hal is inline)
+// ===================================================================
+
+#else
+
+namespace {
+
+volatile uint64_t lowLatched = 0;   ///< One bit per GPIO, set by the edge ISR
+portMUX_TYPE      latchMux   = portMUX_INITIALIZER_UNLOCKED;
+
+void IRAM_ATTR onFallingEdge(void *arg) {
+    uint64_t bit = 1ULL << reinterpret_cast<uintptr_t>(arg);
+    portENTER_CRITICAL_ISR(&latchMux);
+    lowLatched |= bit;
+    portEXIT_CRITICAL_ISR(&latchMux);
+}
+
+}  // namespace
+
+void Esp32Hal::armLowLatch(uint8_t pin) {
+    attachInterruptArg(digitalPinToInterrupt(pin), onFallingEdge,
+                       reinterpret_cast<void *>(static_cast<uintptr_t>(pin)), FALLING);
+}
+
+bool Esp32Hal::takeLowLatch(uint8_t pin) {
+    uint64_t bit = 1ULL << pin;
+    portENTER_CRITICAL(&latchMux);
+    bool fell = (lowLatched & bit) != 0;
+    lowLatched &= ~bit;
+    portEXIT_CRITICAL(&latchMux);
+
+    // Held LOW since before the last take: no new edge, still LOW.
+    return fell || ::digitalRead(pin) == LOW;
+}
+
+size_t Esp32Hal::storageGet(const char *ns, const char *key, void *buf, size_t maxLen) {
+    Preferences prefs;
+    if (!prefs.begin(ns, true)) return 0;
+    size_t len = prefs.getBytes(key, buf, maxLen);
+    prefs.end();
+    return len;
+}
+
+size_t Esp32Hal::storagePut(const char *ns, const char *key, const void *buf, size_t len) {
+    Preferences prefs;
+    if (!prefs.begin(ns, false)) return 0;
+    size_t n = prefs.putBytes(key, buf, len);
+    prefs.end();
+    return n;
+}
+
+#endif
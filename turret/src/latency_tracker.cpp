@@ -0,0 +1,151 @@
+/**
+ * @file latency_tracker.cpp
+ * @brief Per-event detection latency and its histograms.
+ */
+
+#include "latency_tracker.h"
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+void LatencyTracker::init() {
+    reset();
+    seenActive_   = false;
+    lastActiveUs_ = 0;
+}
+
+void LatencyTracker::sample(uint32_t tUs, uint8_t rawBits, bool filterActive) {
+    if (open_ && static_cast<uint32_t>(tUs - startUs_) >= LATENCY_TIMEOUT_MS * 1000UL) {
+        open_ = false;
+        abandoned_++;
+    }
+
+    bool quiet = !seenActive_ ||
+                 static_cast<uint32_t>(tUs - lastActiveUs_) >= LATENCY_QUIET_MS * 1000UL;
+
+    // Through the filter, then quiet again before the servo: whatever it
+    // was has gone.  Don't let it hold the slot until the timeout.
+    if (open_ && quiet && stamped(LatencyStage::FILTER)) {
+        open_ = false;
+        abandoned_++;
+    }
+
+    if (filterActive) {
+        seenActive_   = true;
+        lastActiveUs_ = tUs;
+    }
+
+    if (!open_) {
+        if (!quiet || rawBits == 0) return;
+        open_    = true;
+        startUs_ = tUs;
+        marked_  = 0;
+        samples_ = 0;
+    }
+
+    if (filterActive) mark(LatencyStage::FILTER, tUs);
+
+    // The opening hit has left the filter window without the filter
+    // going ACTIVE: noise.  Free the slot for the next hit.
+    if (!stamped(LatencyStage::FILTER) && ++samples_ >= SENSOR_FILTER_WINDOW) {
+        open_ = false;
+    }
+}
+
+void LatencyTracker::mark(LatencyStage stage, uint32_t tUs) {
+    if (!awaiting(stage)) return;
+    if (stage == LatencyStage::COMMAND && !stamped(LatencyStage::FILTER)) {
+        return;   // The tracker acts on the filtered reading
+    }
+    if (stage == LatencyStage::SERVO && !stamped(LatencyStage::COMMAND)) {
+        return;   // Only a write the tracker asked for counts
+    }
+
+    uint8_t i = static_cast<uint8_t>(stage);
+    marked_ |= static_cast<uint8_t>(1u << i);
+    atUs_[i] = static_cast<uint32_t>(tUs - startUs_);
+
+    if (stage == LatencyStage::SERVO) close();
+}
+
+bool LatencyTracker::awaiting(LatencyStage stage) const {
+    return open_ && !(marked_ & (1u << static_cast<uint8_t>(stage)));
+}
+
+LatencyStats LatencyTracker::stats() const {
+    LatencyStats s;
+    s.events    = events_;
+    s.abandoned = abandoned_;
+
+    for (uint8_t st = 0; st < STAGES; st++) {
+        const StageHist &h = hist_[st];
+        LatencySummary &out = s.stage[st];
+        out.count = h.count;
+        if (h.count == 0) continue;
+        out.maxUs  = h.maxUs;
+        out.meanUs = static_cast<uint32_t>(h.sumUs / h.count);
+
+        // Upper edge of the bin holding each percentile, capped at the max.
+        uint32_t p50 = h.count - h.count / 2;
+        uint32_t p99 = h.count - h.count / 100;
+        uint32_t seen = 0;
+        bool have50 = false;
+        for (uint8_t i = 0; i < LATENCY_BINS; i++) {
+            seen += h.bins[i];
+            uint32_t upper = (i == LATENCY_BINS - 1)
+                ? h.maxUs : (i + 1) * static_cast<uint32_t>(LATENCY_BIN_MS) * 1000UL;
+            if (upper > h.maxUs) upper = h.maxUs;
+            if (!have50 && seen >= p50) {
+                out.p50Us = upper;
+                have50 = true;
+            }
+            if (seen >= p99) {
+                out.p99Us = upper;
+                break;
+            }
+        }
+    }
+    return s;
+}
+
+void LatencyTracker::reset() {
+    open_      = false;
+    events_    = 0;
+    abandoned_ = 0;
+    for (uint8_t st = 0; st < STAGES; st++) {
+        hist_[st] = StageHist{};
+    }
+}
+
+const char *LatencyTracker::stageName(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::FILTER:  return "filter";
+        case LatencyStage::MONITOR: return "monitor";
+        case LatencyStage::COMMAND: return "command";
+        case LatencyStage::SERVO:   return "servo";
+        default:                    return "?";
+    }
+}
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+void LatencyTracker::close() {
+    open_ = false;
+    events_++;
+
+    for (uint8_t st = 0; st < STAGES; st++) {
+        if (!stamped(static_cast<LatencyStage>(st))) continue;
+        StageHist &h = hist_[st];
+        uint32_t us = atUs_[st];
+        uint32_t bin = us / (LATENCY_BIN_MS * 1000UL);
+        if (bin >= LATENCY_BINS) bin = LATENCY_BINS - 1;
+
+        h.bins[bin]++;
+        h.count++;
+        h.sumUs += us;
+        if (us > h.maxUs) h.maxUs = us;
+    }
+}
@@ -0,0 +1,114 @@
+/**
+ * @file loop_timer.cpp
+ * @brief Absolute-deadline tick accounting.
+ */
+
+#include "loop_timer.h"
+#include "hal.h"
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+void LoopTimer::init(uint32_t periodUs, uint32_t phaseUs) {
+    periodUs_ = periodUs;
+    nextUs_   = Hal::micros() + phaseUs;
+    ticksElapsed_ = 1;
+    idlePeriods_  = 0;
+    idleElapsed_  = 0;
+    lastJitterUs_ = 0;
+    resetStats();
+}
+
+bool LoopTimer::poll() {
+    uint32_t now = Hal::micros();
+    int32_t late = static_cast<int32_t>(now - nextUs_);
+    if (late < 0) return false;
+
+    // Whole periods missed: skip those deadlines, keep the phase.
+    uint32_t missed = static_cast<uint32_t>(late) / periodUs_;
+    uint32_t jitter = static_cast<uint32_t>(late) - missed * periodUs_;
+    skipped_      += missed;
+    tickStartUs_   = now;
+    nextUs_       += (missed + 1) * periodUs_;
+    ticksElapsed_  = idlePeriods_ + missed + 1;
+    idleElapsed_   = idlePeriods_;
+    idlePeriods_   = 0;
+    lastJitterUs_  = jitter;
+
+    if (ticks_ == 0 || jitter < minUs_) minUs_ = jitter;
+    if (jitter > maxUs_) maxUs_ = jitter;
+    sumUs_ += jitter;
+    uint32_t bin = jitter / JITTER_BIN_US;
+    hist_[(bin < JITTER_BINS) ? bin : JITTER_BINS - 1]++;
+    ticks_++;
+    return true;
+}
+
+void LoopTimer::tickDone() {
+    uint32_t now = Hal::micros();
+    uint32_t cost = static_cast<uint32_t>(now - tickStartUs_);
+    if (cost > maxCostUs_) maxCostUs_ = cost;
+    if (static_cast<int32_t>(now - nextUs_) >= 0) overruns_++;
+}
+
+void LoopTimer::idle(uint32_t periods) {
+    nextUs_      += periods * periodUs_;
+    idlePeriods_ += periods;
+}
+
+uint32_t LoopTimer::usUntilDue() const {
+    int32_t wait = static_cast<int32_t>(nextUs_ - Hal::micros());
+    return (wait > 0) ? static_cast<uint32_t>(wait) : 0;
+}
+
+uint32_t LoopTimer::ticksElapsed() const {
+    return ticksElapsed_;
+}
+
+uint32_t LoopTimer::idleElapsed() const {
+    return idleElapsed_;
+}
+
+uint32_t LoopTimer::lastJitterUs() const {
+    return lastJitterUs_;
+}
+
+JitterStats LoopTimer::stats() const {
+    JitterStats s;
+    s.ticks    = ticks_;
+    s.overruns = overruns_;
+    s.skipped  = skipped_;
+    s.maxCostUs = maxCostUs_;
+    if (ticks_ == 0) return s;
+
+    s.minUs  = minUs_;
+    s.maxUs  = maxUs_;
+    s.meanUs = static_cast<uint32_t>(sumUs_ / ticks_);
+
+    // p99: first bin where the cumulative count reaches 99 %.
+    uint32_t target = ticks_ - ticks_ / 100;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < JITTER_BINS; i++) {
+        seen += hist_[i];
+        if (seen >= target) {
+            uint32_t upper = (i + 1) * static_cast<uint32_t>(JITTER_BIN_US);
+            s.p99Us = (i == JITTER_BINS - 1 || upper > maxUs_) ? maxUs_ : upper;
+            break;
+        }
+    }
+    return s;
+}
+
+void LoopTimer::resetStats() {
+    ticks_    = 0;
+    overruns_ = 0;
+    skipped_  = 0;
+    minUs_    = 0;
+    maxUs_    = 0;
+    maxCostUs_ = 0;
+    sumUs_    = 0;
+    for (uint8_t i = 0; i < JITTER_BINS; i++) {
+        hist_[i] = 0;
+    }
+}
@@ -1,103 +1,463 @@
 /**
  * @file main.cpp
- * @brief Turret (Fan Base) entry point — sensor → track → actuate loop.
+ * @brief Turret (Fan Base) entry point — sensor → track → actuate pipeline.
  *
- * Main loop runs at ~50 Hz (LOOP_PERIOD_MS = 20 ms):
- *   1. Feed the ESP32 watchdog timer.
- *   2. Sample sensors and push into majority-vote filter.
- *   3. Evaluate signal-loss state machine.
- *   4. Handle one-time state-entry actions on transitions.
- *   5. Depending on state:
- *        TRACKING  — run proportional tracking engine.
- *        SEARCHING — slow sweep ± SEARCH_SWEEP_DEG.
- *        PARKED    — park servos at home, idle.
- *   6. Update dead-reckoning pan position.
- *   7. Update status LED.
- *   8. Yield remaining time until next loop tick.
+ * setup() wires the modules and starts three FreeRTOS tasks (pipeline.h);
+ * the Arduino loopTask then deletes itself.
+ *
+ *   capture   — core 0, high priority, every LOOP_PERIOD_US:
+ *                 sample sensors, majority-vote filter, timestamped
+ *                 snapshot → control.
+ *   control   — core 1 (alone), every LOOP_PERIOD_US on an absolute
+ *               grid CAPTURE_LEAD_US behind capture (loop_timer.h); while
+ *               parked with the servos off, every PARK_IDLE_TICKS periods
+ *               until a raw hit.  Sleeps until that tick or the earliest
+ *               scheduled job:
+ *     1. Feed the ESP32 watchdog timer.
+ *     2. For each waiting snapshot: signal-loss state machine (SPRT on
+ *        raw sensor hits), then the turret state machine (turret_fsm.h):
+ *        map monitor decisions and the filtered reading to events, run
+ *        entry / exit actions and tick the current state:
+ *          ACQUIRING / LOCKED — tracking engine (fast vs. low-gain settings).
+ *          COASTING  — carry on the last pan motion through a brief dropout.
+ *          SEARCHING — learned bearings first, then the exhaustive pattern.
+ *          PARKED    — coordinated park of both axes, then power the
+ *                      servos down until the next detection.
+ *        Status LED on monitor state changes (the SEARCHING blink is a
+ *        scheduled job).
+ *     3. Update dead-reckoning pan position (over every period since the
+ *        last tick, skipped ones included); flush frame-deferred servo writes.
+ *     4. Serial commands, scheduled jobs (LED blink, prior aging).
+ *     5. Telemetry frame → telemetry task.
+ *   telemetry — core 0, low priority: one binary record per tick
+ *               (telemetry_stream.h; decode with tools/telemetry_decode.cpp),
+ *               or in text mode a status line every DEBUG_PRINT_MS plus
+ *               transitions; serial commands.
+ *
+ * Serial commands (single characters):
+ *   j — print control tick timing: jitter, overruns, skipped ticks,
+ *       snapshot age, ring drops.
+ *   p — print the per-stage profile (profiler.h).
+ *   l — print detection → actuation latency per stage (latency_tracker.h).
+ *   r — reset the timing figures, the profile and the latency figures.
+ *   b — toggle binary telemetry / text status line.
+ *   c — toggle session capture from the next boot (kept in NVS): every
+ *       raw sensor sample and the tick inputs go out with the binary
+ *       records, for replay on the host (session_capture.h,
+ *       sim/tools/sentry_replay.cpp).  Binary only while it is on.
  *
  * Fixes applied:
- *   - ESP32 hardware watchdog resets the MCU if the loop stalls for > 4 s.
- *   - State transitions trigger one-time entry actions (sweep reset,
- *     tracker halt, position re-zero on recovery from PARKED).
- *   - Search sweep direction is reset based on current pan position
- *     when entering SEARCHING, preventing asymmetric sweeps.
+ *   - ESP32 hardware watchdog resets the MCU if the control task stalls
+ *     for > 4 s.
+ *   - State transitions trigger one-time entry / exit actions (tracker
+ *     halt, servo wake on recovery from PARKED), all defined by the
+ *     table-driven state machine.
+ *   - The exhaustive search pattern carries on the way the last scan leg
+ *     went instead of turning back over the bin it just crossed.
+ *   - Acquired / lost bearings feed a learned BearingPrior (persisted in
+ *     NVS) so SEARCHING visits the usual bearings before sweeping.
+ *   - A beacon that reappears mid-park cancels the park and resumes
+ *     tracking from the current estimate.  No park re-zeros it: the
+ *     estimate counts what the servo was sent, which is closer than 0°.
+ *   - Park timeout and exit-bearing hold adapt to how long the user's
+ *     absences usually last.
+ *   - Serial output runs on its own task, so a slow or busy serial port
+ *     no longer stretches the control tick.
+ *   - The last FLIGHT_RECORDER_TICKS ticks survive a watchdog reset in
+ *     RTC memory and are printed, with the reset reason, on the next boot.
+ *
+ * Built with SENTRY_SIM (platformio env:sim), this file runs unchanged in
+ * the host simulator (sim/tools/sentry_sim.cpp) except that loop() steps the
+ * three tasks in turn on the virtual clock.
  */
 
-#include <Arduino.h>
+#include "hal.h"
+#include <stdio.h>
+#ifdef SENTRY_SIM
+#include <new>
+#endif
 #include <esp_task_wdt.h>
+#include <esp_attr.h>
+#include <esp_system.h>
 #include "config.h"
 #include "sensor_array.h"
 #include "pan_controller.h"
 #include "tilt_controller.h"
 #include "tracking_engine.h"
 #include "signal_monitor.h"
+#include "park_planner.h"
+#include "bearing_prior.h"
+#include "search_planner.h"
+#include "turret_fsm.h"
+#include "scheduler.h"
+#include "pipeline.h"
+#include "profiler.h"
+#include "telemetry_stream.h"
+#include "session_capture.h"
+#include "flight_recorder.h"
 
 // ===================================================================
 // Watchdog configuration
 // ===================================================================
 
-/** @brief Watchdog timeout in seconds.  If the main loop doesn't feed
- *         the WDT within this time, the ESP32 resets. */
+/** @brief Watchdog timeout in seconds.  If the control task doesn't
+ *         feed the WDT within this time, the ESP32 resets. */
 static constexpr uint32_t WDT_TIMEOUT_S = 4;
 
 // ===================================================================
-// Module instances
+// Module instances (one turret per thread in the simulator, hal.h)
 // ===================================================================
 
-static SensorArray    sensors;
-static PanController  pan;
-static TiltController tilt;
-static TrackingEngine tracker;
-static SignalMonitor  monitor;
+static HAL_PER_THREAD SensorArray    sensors;
+static HAL_PER_THREAD PanController  pan;
+static HAL_PER_THREAD TiltController tilt;
+static HAL_PER_THREAD TrackingEngine tracker;
+static HAL_PER_THREAD SignalMonitor  monitor;
+static HAL_PER_THREAD ParkPlanner    parker;
+static HAL_PER_THREAD BearingPrior   prior;
+static HAL_PER_THREAD SearchPlanner  search;
+static HAL_PER_THREAD TurretStateMachine fsm;
+static HAL_PER_THREAD Scheduler      sched;
+static HAL_PER_THREAD TurretPipeline pipeline;
+
+/** @brief Status text, telemetry and commands. */
+static HAL_PER_THREAD Hal::SerialPort &console = Hal::serial();
 
 // ===================================================================
-// Search sweep state
+// Bearing prior persistence (NVS)
 // ===================================================================
 
-static bool  sweepDirectionCW = true;   ///< Current sweep direction
+/** @brief NVS namespace / key for the learned bearing histogram. */
+static const char *PREFS_NAMESPACE = "sentry";
+static const char *PREFS_PRIOR_KEY = "prior";
+static const char *PREFS_CAPTURE_KEY = "capture";
+
+/** @brief Restore the learned prior; start empty if missing or corrupt. */
+static void loadPrior() {
+    uint8_t blob[BearingPrior::BLOB_SIZE];
+    size_t len = Hal::storageGet(PREFS_NAMESPACE, PREFS_PRIOR_KEY, blob, sizeof(blob));
+
+    if (!prior.load(blob, len)) {
+        console.println(F("Bearing prior: none stored, starting fresh."));
+    }
+}
+
+/**
+ * @brief Persist the prior if it changed.
+ *
+ * Called on entry to PARKED — rare enough to spare the flash, and the
+ * moment a power-off is most likely to follow.
+ */
+static void savePrior() {
+    if (!prior.isDirty()) return;
+
+    uint8_t blob[BearingPrior::BLOB_SIZE];
+    size_t len = prior.save(blob);
+    Hal::storagePut(PREFS_NAMESPACE, PREFS_PRIOR_KEY, blob, len);
+    prior.markClean();
+}
 
 // ===================================================================
-// State-transition entry actions
+// Flight recorder
 // ===================================================================
 
+/** @brief Survives resets (not power loss); see flight_recorder.h. */
+RTC_NOINIT_ATTR static HAL_PER_THREAD FlightRecorder::Log flightLog;
+static HAL_PER_THREAD FlightRecorder recorder;
+
+static const char *resetReasonName(esp_reset_reason_t reason) {
+    switch (reason) {
+        case ESP_RST_POWERON:   return "power-on";
+        case ESP_RST_EXT:       return "external pin";
+        case ESP_RST_SW:        return "software";
+        case ESP_RST_PANIC:     return "panic";
+        case ESP_RST_INT_WDT:   return "interrupt watchdog";
+        case ESP_RST_TASK_WDT:  return "task watchdog";
+        case ESP_RST_WDT:       return "other watchdog";
+        case ESP_RST_DEEPSLEEP: return "deep sleep";
+        case ESP_RST_BROWNOUT:  return "brownout";
+        case ESP_RST_SDIO:      return "SDIO";
+        default:                return "unknown";
+    }
+}
+
 /**
- * @brief Called once when transitioning INTO the TRACKING state.
+ * @brief Print the reset reason and the previous run's last ticks
+ *        (CSV, oldest first), then start recording this run.
  */
-static void onEnterTracking(MonitorState fromState) {
-    // Coming from PARKED: the dead-reckoning position may have drifted
-    // while the fan was stationary, so re-zero it.  The fan should be
-    // at (or very near) home after parking, making 0° a good estimate.
-    if (fromState == MonitorState::PARKED) {
-        pan.resetPosition();
+static void dumpFlightRecorder() {
+    bool previous = recorder.init(&flightLog);
+
+    console.print(F("Reset reason: "));
+    console.print(resetReasonName(esp_reset_reason()));
+    console.print(F("  resets since power-on: "));
+    console.println(recorder.boots());
+
+    if (previous) {
+        console.print(F("Flight recorder: last "));
+        console.print(recorder.count());
+        console.println(F(" ticks before reset"));
+        console.println(TelemetryCodec::CSV_HEADER);
+        char line[128];
+        for (uint16_t i = 0; i < recorder.count(); i++) {
+            const TelemetryRecord &r = recorder.at(i);
+            TelemetryCodec::csvRow(r, TurretStateMachine::stateName(static_cast<TurretState>(r.state)),
+                                   line, sizeof(line));
+            console.println(line);
+        }
+        console.println(F("Flight recorder: end"));
     }
 
-    Serial.println(F("[Transition] → TRACKING"));
+    recorder.start();
+}
+
+// ===================================================================
+// Control task hooks and scheduled jobs
+// ===================================================================
+
+/** @brief Subscribe the control task to the watchdog. */
+static void controlStarted() {
+    esp_task_wdt_add(NULL);
+}
+
+/** @brief Feed the watchdog from the control tick. */
+static void controlTicked() {
+    esp_task_wdt_reset();
+}
+
+/** @brief Decay the learned bearing prior. */
+static void agePrior(void *) {
+    prior.age();
+}
+
+// ===================================================================
+// Telemetry task: serial output and commands
+// ===================================================================
+
+static HAL_PER_THREAD TelemetryStream stream;
+static HAL_PER_THREAD bool binaryTelemetry = TELEMETRY_BINARY_DEFAULT;
+
+/** @brief Session capture on for this boot (read from NVS in setup()). */
+static HAL_PER_THREAD bool captureSession = false;
+
+/** @brief Frame time of the last status line. */
+static HAL_PER_THREAD uint32_t lastDebugMs = 0;
+
+/** @brief TelemetryStream sink: the UART's TX buffer. */
+static size_t serialWrite(const uint8_t *data, size_t len, void *) {
+    return console.write(data, len);
 }
 
 /**
- * @brief Called once when transitioning INTO the SEARCHING state.
+ * @brief Send every queued frame (blocking), before text goes out.
+ *
+ * The trailing 0x00 closes the text that follows for the decoder, which
+ * then drops it as one bad frame instead of the next record.
  */
-static void onEnterSearching() {
-    // Stop the tracker cleanly before the sweep takes over.
-    tracker.halt();
+static void flushStream() {
+    while (stream.queued() > 0) {
+        stream.drain(serialWrite, nullptr, TELEMETRY_TX_RING_BYTES);
+    }
+}
 
-    // Reset sweep direction based on current pan position so the sweep
-    // is roughly centered.  If we're left of center, sweep CW first
-    // (toward center); if right, sweep CCW first.
-    sweepDirectionCW = (pan.getPositionDeg() <= 0.0f);
+/** @brief Debug status line (~2 Hz to avoid flooding). */
+static void printStatus(const TelemetryFrame &f) {
+    const SensorReading &reading = f.reading;
+    console.print(F("State="));
+    console.print(TurretStateMachine::stateName(f.state));
+    console.print(F("  Pan="));
+    console.print(f.panDeg, 1);
+    console.print(F("°  Tilt="));
+    console.print(f.tiltDeg);
+    console.print(F("°  Sensors: T="));
+    console.print(reading.top    == SensorState::ACTIVE ? '1' : '0');
+    console.print(F(" B="));
+    console.print(reading.bottom == SensorState::ACTIVE ? '1' : '0');
+    console.print(F(" L="));
+    console.print(reading.left   == SensorState::ACTIVE ? '1' : '0');
+    console.print(F(" R="));
+    console.print(reading.right  == SensorState::ACTIVE ? '1' : '0');
+    console.print(F("  Wr/s P="));
+    console.print(f.panWritesPerSec);
+    console.print(F(" T="));
+    console.println(f.tiltWritesPerSec);
+}
 
-    Serial.println(F("[Transition] → SEARCHING"));
+/** @brief Print the control tick's timing figures ('j'). */
+static void printTiming(const TelemetryFrame &f) {
+    const JitterStats &st = f.control;
+    console.print(F("Tick jitter us: min="));
+    console.print(st.minUs);
+    console.print(F(" mean="));
+    console.print(st.meanUs);
+    console.print(F(" p99="));
+    console.print(st.p99Us);
+    console.print(F(" max="));
+    console.print(st.maxUs);
+    console.print(F("  ticks="));
+    console.print(st.ticks);
+    console.print(F(" overruns="));
+    console.print(st.overruns);
+    console.print(F(" skipped="));
+    console.print(st.skipped);
+    console.print(F(" maxCost="));
+    console.println(st.maxCostUs);
+    console.print(F("Pipeline: maxAge="));
+    console.print(f.maxAgeUs);
+    console.print(F("us captureJitMax="));
+    console.print(f.maxCaptureJitUs);
+    console.print(F("us starved="));
+    console.print(f.starvedTicks);
+    console.print(F(" drops snap="));
+    console.print(f.snapshotDrops);
+    console.print(F(" frame="));
+    console.println(f.frameDrops);
+}
+
+/** @brief Print every stage's timing ('p'), in µs and % of the tick. */
+static void printProfile() {
+    console.println(F("Stage        count    mean     p50     p99     max  %tick"));
+    for (uint8_t i = 0; i < static_cast<uint8_t>(ProfStage::COUNT); i++) {
+        ProfStage stage = static_cast<ProfStage>(i);
+        ProfSummary s = Profiler::summary(stage);
+        char line[80];
+        snprintf(line, sizeof(line), "%-10s %7lu %7.1f %7.1f %7.1f %7.1f %5.1f",
+                 Profiler::stageName(stage), static_cast<unsigned long>(s.count),
+                 s.meanUs, s.p50Us, s.p99Us, s.maxUs,
+                 100.0f * s.meanUs / LOOP_PERIOD_US);
+        console.println(line);
+    }
+}
+
+/** @brief Print raw hit → stage latency ('l'), in ms. */
+static void printLatency(const TelemetryFrame &f) {
+    const LatencyStats &st = f.latency;
+    console.print(F("Detection latency: events="));
+    console.print(st.events);
+    console.print(F(" abandoned="));
+    console.println(st.abandoned);
+    console.println(F("Stage      count    mean     p50     p99     max  (ms since raw hit)"));
+    for (uint8_t i = 0; i < static_cast<uint8_t>(LatencyStage::COUNT); i++) {
+        const LatencySummary &s = st.stage[i];
+        char line[80];
+        snprintf(line, sizeof(line), "%-9s %6lu %7.1f %7.1f %7.1f %7.1f",
+                 LatencyTracker::stageName(static_cast<LatencyStage>(i)),
+                 static_cast<unsigned long>(s.count),
+                 s.meanUs / 1000.0f, s.p50Us / 1000.0f, s.p99Us / 1000.0f, s.maxUs / 1000.0f);
+        console.println(line);
+    }
+}
+
+/** @brief Telemetry sink: binary records or text status, timing, profile, latency. */
+static void onFrame(const TelemetryFrame &f, void *) {
+    if (f.kind != TelemetryFrame::Kind::TICK) {
+        if (binaryTelemetry) flushStream();
+        if (f.kind == TelemetryFrame::Kind::TIMING) {
+            printTiming(f);
+        } else if (f.kind == TelemetryFrame::Kind::LATENCY) {
+            printLatency(f);
+        } else {
+            printProfile();
+        }
+        if (binaryTelemetry) console.write(static_cast<uint8_t>(0x00));
+        return;
+    }
+
+    if (binaryTelemetry) {
+        // Never waits on the UART: queue, then send what fits now.
+        if (captureSession) {
+            uint8_t frame[SessionCapture::FRAME_MAX];
+            stream.pushFrame(frame, SessionCapture::encodeTick(f.capture(), frame));
+        } else {
+            stream.push(f.record());
+        }
+        stream.drain(serialWrite, nullptr, console.availableForWrite());
+        return;
+    }
+
+    if (f.transition) {
+        console.print(F("[Transition] → "));
+        console.println(TurretStateMachine::stateName(f.state));
+    }
+
+    uint32_t nowMs = f.tUs / 1000;
+    if (nowMs - lastDebugMs >= DEBUG_PRINT_MS) {
+        lastDebugMs = nowMs;
+        printStatus(f);
+    }
 }
 
 /**
- * @brief Called once when transitioning INTO the PARKED state.
+ * @brief Flip the stored session capture flag ('c') and say what the
+ *        next boot will do.
+ *
+ * Each storage call opens its own NVS handle, so the control task may be
+ * saving the prior at the same time.
  */
-static void onEnterParked() {
-    // Stop everything.  parkHome() will be called each loop iteration,
-    // but we also halt the tracker to ensure no stale commands linger.
-    tracker.halt();
+static void toggleCapture() {
+    uint8_t on = 0;
+    Hal::storageGet(PREFS_NAMESPACE, PREFS_CAPTURE_KEY, &on, sizeof(on));
+    on = on ? 0 : 1;
+    Hal::storagePut(PREFS_NAMESPACE, PREFS_CAPTURE_KEY, &on, sizeof(on));
+
+    if (binaryTelemetry) flushStream();
+    console.print(F("Session capture "));
+    console.println(on ? F("on from the next boot.") : F("off from the next boot."));
+    if (binaryTelemetry) console.write(static_cast<uint8_t>(0x00));
+}
 
-    Serial.println(F("[Transition] → PARKED"));
+/**
+ * @brief Command source: single characters from the serial monitor.
+ *
+ * 'b' (output mode) and 'c' (session capture) belong to this task and
+ * are handled here; the rest go to the control task.
+ */
+static int readCommand(void *) {
+    while (console.available() > 0) {
+        int c = console.read();
+        if (c == 'c') {
+            toggleCapture();
+            continue;
+        }
+        if (c != 'b') return c;
+        if (captureSession) continue;   // A capture must not lose ticks
+
+        if (binaryTelemetry) {
+            flushStream();
+            console.write(static_cast<uint8_t>(0x00));
+        }
+        binaryTelemetry = !binaryTelemetry;
+    }
+    return -1;
+}
+
+// ===================================================================
+// Session capture
+// ===================================================================
+
+/**
+ * @brief If capture is on, send the session header: the clock and the
+ *        stored prior the modules are about to start from.
+ *
+ * Called right before the modules initialise; blocking is fine here.
+ */
+static void beginCapture() {
+    uint8_t on = 0;
+    Hal::storageGet(PREFS_NAMESPACE, PREFS_CAPTURE_KEY, &on, sizeof(on));
+    if (!on) return;
+
+    CaptureHeader h;
+    h.priorLen = static_cast<uint8_t>(Hal::storageGet(PREFS_NAMESPACE, PREFS_PRIOR_KEY, h.prior, sizeof(h.prior)));
+
+    captureSession  = true;
+    binaryTelemetry = true;
+    console.println(F("Session capture on ('c' to stop from the next boot)."));
+
+    uint8_t frame[SessionCapture::FRAME_MAX];
+    h.bootUs = static_cast<uint32_t>(Hal::micros());
+    size_t n = SessionCapture::encodeHeader(h, frame);
+    console.write(static_cast<uint8_t>(0x00));   // Close the text before it
+    console.write(frame, n);
 }
 
 // ===================================================================
@@ -105,116 +465,111 @@ static void onEnterParked() {
 // ===================================================================
 
 void setup() {
-    Serial.begin(SERIAL_BAUD);
-    Serial.println(F("The Sentry — Turret v1.1"));
-    Serial.println(F("Initialising..."));
+    console.begin(SERIAL_BAUD);
+    console.println(F("The Sentry — Turret v1.1"));
+    console.println(F("Initialising..."));
+    dumpFlightRecorder();
+    beginCapture();
 
     sensors.init();
     pan.init();
     tilt.init();
     tracker.init(&pan, &tilt);
+    parker.init(&pan, &tilt);
+    loadPrior();
+    search.init(&pan, &tilt, &prior);
     monitor.init();
 
+    TurretContext ctx;
+    ctx.sensors  = &sensors;
+    ctx.pan      = &pan;
+    ctx.tilt     = &tilt;
+    ctx.tracker  = &tracker;
+    ctx.monitor  = &monitor;
+    ctx.parker   = &parker;
+    ctx.prior    = &prior;
+    ctx.search   = &search;
+    ctx.onParked = savePrior;   // Rare enough to spare the flash
+    fsm.init(ctx);
+
+    sched.init();
+    sched.every(PRIOR_AGE_INTERVAL_MS, agePrior, nullptr, PRIOR_AGE_INTERVAL_MS);
+    monitor.setScheduler(&sched);
+
     // Configure the ESP32 Task Watchdog Timer.
-    // If the main loop stalls (e.g., I²C hang, library deadlock), the
+    // If the control task stalls (e.g., I²C hang, library deadlock), the
     // WDT resets the MCU rather than leaving the fan running uncontrolled.
     esp_task_wdt_init(WDT_TIMEOUT_S, true);   // true = trigger reset on timeout
-    esp_task_wdt_add(NULL);                    // Subscribe the current task (loopTask)
 
-    Serial.println(F("Ready. Waiting for beacon signal."));
+    pipeline.init(ctx, &fsm, &sched);
+    pipeline.setTelemetry(onFrame, readCommand, nullptr);
+    pipeline.setControlHooks(controlStarted, controlTicked);   // Control task subscribes itself
+    pipeline.setRecorder(&recorder);
+#ifdef SENTRY_SIM
+    pipeline.begin();   // Host simulator: loop() steps the tasks (sim/)
+#else
+    if (!pipeline.start()) {
+        console.println(F("Task start failed."));
+        return;
+    }
+#endif
+
+    console.println(F("Ready. Waiting for beacon signal."));
+    if (binaryTelemetry) console.write(static_cast<uint8_t>(0x00));   // Text ends before the first record
 }
 
 // ===================================================================
-// Main loop
+// Arduino loop (unused on target)
 // ===================================================================
 
 void loop() {
-    unsigned long loopStart = millis();
-
-    // --- 1. Feed the watchdog ---
-    esp_task_wdt_reset();
-
-    // --- 2. Sample sensors ---
-    sensors.update();
-    SensorReading reading = sensors.getFiltered();
-
-    // --- 3. Signal monitor ---
-    monitor.update(reading.anyActive());
-    MonitorState state = monitor.getState();
-
-    // --- 4. Handle state transitions (one-time entry actions) ---
-    if (monitor.stateChanged()) {
-        MonitorState prev = monitor.getPreviousState();
-        switch (state) {
-            case MonitorState::TRACKING:  onEnterTracking(prev); break;
-            case MonitorState::SEARCHING: onEnterSearching();    break;
-            case MonitorState::PARKED:    onEnterParked();       break;
-        }
-    }
+#ifdef SENTRY_SIM
+    // Host simulator: one thread, virtual clock; each step runs when due.
+    pipeline.captureStep();
+    if (!pipeline.controlStep()) sched.runDue();   // As the control task: jobs between ticks too
+    pipeline.telemetryStep();
+#else
+    // Everything runs on the pipeline tasks.
+    vTaskDelete(NULL);
+#endif
+}
 
-    // --- 5. Act based on current state ---
-    switch (state) {
-
-        case MonitorState::TRACKING:
-            tracker.update(reading);
-            break;
-
-        case MonitorState::SEARCHING:
-            // Slow sweep: alternate CW and CCW.
-            tilt.goScanPosition();
-
-            if (sweepDirectionCW) {
-                pan.setSpeed(SEARCH_SWEEP_SPEED);
-                if (pan.getPositionDeg() >= SEARCH_SWEEP_DEG) {
-                    sweepDirectionCW = false;
-                }
-            } else {
-                pan.setSpeed(-SEARCH_SWEEP_SPEED);
-                if (pan.getPositionDeg() <= -SEARCH_SWEEP_DEG) {
-                    sweepDirectionCW = true;
-                }
-            }
-            break;
-
-        case MonitorState::PARKED:
-            pan.parkHome();
-            tilt.parkHome();
-            break;
-    }
+#ifdef SENTRY_SIM
+// ===================================================================
+// Host simulator: power cycle
+// ===================================================================
 
-    // --- 6. Update pan position estimate ---
-    pan.updatePosition(LOOP_PERIOD_MS);
-
-    // --- 7. Status LED ---
-    monitor.updateStatusLED();
-
-    // --- 8. Debug output (throttled to ~2 Hz to avoid flooding) ---
-    static unsigned long lastDebugMs = 0;
-    if (millis() - lastDebugMs >= 500) {
-        lastDebugMs = millis();
-        Serial.print(F("State="));
-        switch (state) {
-            case MonitorState::TRACKING:  Serial.print(F("TRACK")); break;
-            case MonitorState::SEARCHING: Serial.print(F("SEARCH")); break;
-            case MonitorState::PARKED:    Serial.print(F("PARK")); break;
-        }
-        Serial.print(F("  Pan="));
-        Serial.print(pan.getPositionDeg(), 1);
-        Serial.print(F("°  Tilt="));
-        Serial.print(tilt.getAngle());
-        Serial.print(F("°  Sensors: T="));
-        Serial.print(reading.top    == SensorState::ACTIVE ? '1' : '0');
-        Serial.print(F(" B="));
-        Serial.print(reading.bottom == SensorState::ACTIVE ? '1' : '0');
-        Serial.print(F(" L="));
-        Serial.print(reading.left   == SensorState::ACTIVE ? '1' : '0');
-        Serial.print(F(" R="));
-        Serial.println(reading.right  == SensorState::ACTIVE ? '1' : '0');
-    }
+/** @brief Destroy @p x and construct it afresh, as a power cycle would. */
+template <typename T>
+static void renew(T &x) {
+    x.~T();
+    new (&x) T();
+}
 
-    // --- Yield: wait for remainder of the loop period ---
-    unsigned long elapsed = millis() - loopStart;
-    if (elapsed < LOOP_PERIOD_MS) {
-        delay(LOOP_PERIOD_MS - elapsed);
-    }
+/**
+ * @brief Put this thread's turret back to power-on: every module as
+ *        constructed, the RTC log cleared, telemetry settings at their
+ *        defaults.  SimRun::run() calls it before setup(), so one thread
+ *        can boot turret after turret.  The HAL fakes are reset apart.
+ */
+void simPowerOn() {
+    renew(sensors);
+    renew(pan);
+    renew(tilt);
+    renew(tracker);
+    renew(monitor);
+    renew(parker);
+    renew(prior);
+    renew(search);
+    renew(fsm);
+    renew(sched);
+    renew(pipeline);
+    renew(recorder);
+    renew(stream);
+    flightLog = FlightRecorder::Log();   // Zeroed: no magic, nothing to dump
+    binaryTelemetry = TELEMETRY_BINARY_DEFAULT;
+    captureSession  = false;
+    lastDebugMs     = 0;
+    Profiler::reset();
 }
+#endif
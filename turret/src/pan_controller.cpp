@@ -5,15 +5,15 @@
 
 #include "pan_controller.h"
 #include "config.h"
-#include <Arduino.h>
+#include "hal.h"
+#include <math.h>
 
 // ===================================================================
 // Public API
 // ===================================================================
 
 void PanController::init() {
-    servo_.attach(PIN_PAN_SERVO);
-    servo_.writeMicroseconds(PAN_STOP_US);
+    out_.attach(PIN_PAN_SERVO, PAN_STOP_US);
     currentSpeed_ = 0.0f;
     positionDeg_  = 0.0f;
 }
@@ -34,18 +34,24 @@ void PanController::setSpeed(float speed) {
     if (positionDeg_ <= -PAN_LIMIT_DEG && speed < 0.0f) speed = 0.0f;
 
     currentSpeed_ = speed;
-    servo_.writeMicroseconds(speedToMicroseconds(speed));
+    out_.write(speedToMicroseconds(speed));
 }
 
 void PanController::stop() {
     currentSpeed_ = 0.0f;
-    servo_.writeMicroseconds(PAN_STOP_US);
+    out_.write(PAN_STOP_US);
 }
 
 void PanController::updatePosition(uint16_t dt_ms) {
-    // Integrate: Δθ = speed × degPerSec × Δt
+    // A detached continuous servo does not turn, whatever was latched.
+    if (out_.isPoweredDown()) return;
+
+    // Integrate what the servo is actually sent, not what was asked for:
+    // a request replaced within its PWM frame never reaches the servo, and
+    // the pulse width is whole microseconds.
+    // Δθ = speed × degPerSec × Δt
     float dt_sec = static_cast<float>(dt_ms) / 1000.0f;
-    positionDeg_ += currentSpeed_ * PAN_DEG_PER_SEC * dt_sec;
+    positionDeg_ += microsecondsToSpeed(out_.outputUs()) * PAN_DEG_PER_SEC * dt_sec;
 
     // Hard-clamp to limits (safety net for accumulation drift).
     if (positionDeg_ >  PAN_LIMIT_DEG) positionDeg_ =  PAN_LIMIT_DEG;
@@ -56,42 +62,86 @@ float PanController::getPositionDeg() const {
     return positionDeg_;
 }
 
+float PanController::getSpeed() const {
+    return currentSpeed_;
+}
+
 bool PanController::isWithinLimits() const {
     return (positionDeg_ > -PAN_LIMIT_DEG) && (positionDeg_ < PAN_LIMIT_DEG);
 }
 
 bool PanController::parkHome() {
-    constexpr float HOME_TOLERANCE = 5.0f;  // degrees
+    float dist = fabsf(positionDeg_);
 
-    if (fabsf(positionDeg_) < HOME_TOLERANCE) {
+    if (dist < PARK_HOME_TOLERANCE_DEG) {
         stop();
         return true;
     }
 
     // Drive toward home: if position is positive, go negative (CCW) and vice versa.
-    float homeSpeed = (positionDeg_ > 0.0f) ? -TRACK_PAN_SPEED_SLOW
-                                              :  TRACK_PAN_SPEED_SLOW;
-    setSpeed(homeSpeed);
+    float homeSpeed = parkSpeedFor(dist);
+    setSpeed((positionDeg_ > 0.0f) ? -homeSpeed : homeSpeed);
     return false;
 }
 
+float PanController::parkSpeedFor(float distDeg) {
+    // Full speed outside the deceleration zone, proportional inside it.
+    float speed = PARK_PAN_SPEED_MAX * (distDeg / PARK_DECEL_DEG);
+    if (speed > PARK_PAN_SPEED_MAX) speed = PARK_PAN_SPEED_MAX;
+
+    // Never command below the backlash threshold — setSpeed() would
+    // zero it and the park would stall short of home (Issue #5).
+    if (speed < PAN_MIN_SPEED) speed = PAN_MIN_SPEED;
+    return speed;
+}
+
 void PanController::resetPosition() {
     positionDeg_ = 0.0f;
 }
 
+void PanController::serviceOutput() {
+    out_.service();
+}
+
+void PanController::powerDown() {
+    out_.powerDown();
+}
+
+void PanController::wake() {
+    out_.powerUp();
+}
+
+bool PanController::isPoweredDown() const {
+    return out_.isPoweredDown();
+}
+
+const ServoOutput &PanController::output() const {
+    return out_;
+}
+
 // ===================================================================
 // Private helpers
 // ===================================================================
 
+float PanController::microsecondsToSpeed(uint16_t us) {
+    if (us <= PAN_STOP_US) {
+        return static_cast<float>(PAN_STOP_US - us) / (PAN_STOP_US - PAN_CW_FULL_US);
+    }
+    return -static_cast<float>(us - PAN_STOP_US) / (PAN_CCW_FULL_US - PAN_STOP_US);
+}
+
 uint16_t PanController::speedToMicroseconds(float speed) const {
     // speed: -1.0 → PAN_CCW_FULL_US,  0.0 → PAN_STOP_US,  +1.0 → PAN_CW_FULL_US
+    // Rounded, not truncated: truncation pulls both directions towards
+    // the lower pulse width, so ±v would turn at different rates and the
+    // dead-reckoned position would drift one way.
     if (speed >= 0.0f) {
         // CW: interpolate from STOP down to CW_FULL.
         return static_cast<uint16_t>(
-            PAN_STOP_US - speed * (PAN_STOP_US - PAN_CW_FULL_US));
+            lroundf(PAN_STOP_US - speed * (PAN_STOP_US - PAN_CW_FULL_US)));
     } else {
         // CCW: interpolate from STOP up to CCW_FULL.
         return static_cast<uint16_t>(
-            PAN_STOP_US + (-speed) * (PAN_CCW_FULL_US - PAN_STOP_US));
+            lroundf(PAN_STOP_US + (-speed) * (PAN_CCW_FULL_US - PAN_STOP_US)));
     }
 }
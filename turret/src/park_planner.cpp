@@ -0,0 +1,92 @@
+/**
+ * @file park_planner.cpp
+ * @brief Coordinated park sequence for the pan and tilt axes.
+ */
+
+#include "park_planner.h"
+#include "config.h"
+#include "hal.h"
+#include <math.h>
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+void ParkPlanner::init(PanController *pan, TiltController *tilt) {
+    pan_      = pan;
+    tilt_     = tilt;
+    active_   = false;
+    complete_ = false;
+}
+
+void ParkPlanner::begin() {
+    if (!pan_ || !tilt_) return;
+
+    startPanDist_ = fabsf(pan_->getPositionDeg());
+    startTiltDeg_ = tilt_->getAngle();
+    active_       = true;
+    complete_     = false;
+}
+
+bool ParkPlanner::update() {
+    if (!pan_ || !tilt_) return false;
+    if (complete_) return true;
+    if (!active_) begin();
+
+    bool panHome = pan_->parkHome();
+
+    // Once the pan is home the tilt finishes on its own; until then it
+    // tracks the pan's progress so both axes arrive together.
+    bool tiltHome;
+    if (panHome) {
+        tiltHome = tilt_->parkHome();
+    } else {
+        float panDist = fabsf(pan_->getPositionDeg());
+        tilt_->stepToward(tiltTargetFor(panDist), PARK_TILT_STEP_DEG);
+        tiltHome = (tilt_->getAngle() == TILT_HOME_DEG);
+    }
+
+    if (panHome && tiltHome) {
+        active_     = false;
+        complete_   = true;
+        completeMs_ = Hal::millis();
+    }
+    return complete_;
+}
+
+void ParkPlanner::cancel() {
+    if (active_ && pan_) {
+        pan_->stop();
+    }
+    active_   = false;
+    complete_ = false;
+}
+
+bool ParkPlanner::isActive() const {
+    return active_;
+}
+
+bool ParkPlanner::isComplete() const {
+    return complete_;
+}
+
+bool ParkPlanner::isSettled() const {
+    return complete_ && (Hal::millis() - completeMs_) >= PARK_SETTLE_MS;
+}
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+int16_t ParkPlanner::tiltTargetFor(float panDist) const {
+    // Pan was already (nearly) home at begin(): nothing to pace against.
+    if (startPanDist_ < PARK_HOME_TOLERANCE_DEG) {
+        return TILT_HOME_DEG;
+    }
+
+    float remaining = panDist / startPanDist_;
+    if (remaining > 1.0f) remaining = 1.0f;
+
+    float target = TILT_HOME_DEG + (startTiltDeg_ - TILT_HOME_DEG) * remaining;
+    return static_cast<int16_t>(lroundf(target));
+}
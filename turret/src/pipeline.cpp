@@ -0,0 +1,382 @@
+/**
+ * @file pipeline.cpp
+ * @brief Capture / control / telemetry task bodies and steps.
+ */
+
+#include "pipeline.h"
+#include "profiler.h"
+#include "hal.h"
+#include <math.h>
+
+// ===================================================================
+// TelemetryFrame
+// ===================================================================
+
+TelemetryRecord TelemetryFrame::record() const {
+    TelemetryRecord r;
+    r.seq        = static_cast<uint16_t>(seq);
+    r.tUs        = static_cast<uint32_t>(tUs);
+    r.rawBits    = rawBits;
+    r.filtered   = static_cast<uint8_t>( static_cast<uint8_t>(reading.top)            |
+                                        (static_cast<uint8_t>(reading.bottom) << 2) |
+                                        (static_cast<uint8_t>(reading.left)   << 4) |
+                                        (static_cast<uint8_t>(reading.right)  << 6));
+    r.state      = static_cast<uint8_t>(state);
+    r.samples    = samplesLost ? TelemetryRecord::MAX_SAMPLES : samples;
+    r.transition = transition;
+    r.panCdeg    = static_cast<int16_t>(lroundf(panDeg * 100.0f));
+    r.panCmd     = static_cast<int16_t>(lroundf(panCmd * 10000.0f));
+    r.tiltDeg    = tiltDeg;
+    r.loopUs     = loopUs > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(loopUs);
+    return r;
+}
+
+CaptureTick TelemetryFrame::capture() const {
+    CaptureTick t;
+    t.rec         = record();
+    t.dtMs        = dtMs;
+    t.samples     = samples;
+    t.samplesLost = samplesLost;
+    for (uint8_t i = 0; i < samples; i++) t.sample[i] = sample[i];
+    return t;
+}
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+void TurretPipeline::init(const TurretContext &ctx, TurretStateMachine *fsm,
+                          Scheduler *sched) {
+    ctx_   = ctx;
+    fsm_   = fsm;
+    sched_ = sched;
+}
+
+void TurretPipeline::setTelemetry(FrameSink sink, CommandSource source, void *ctx) {
+    sink_   = sink;
+    source_ = source;
+    ioCtx_  = ctx;
+}
+
+void TurretPipeline::setControlHooks(ControlHook onStart, ControlHook onTick) {
+    onStart_ = onStart;
+    onTick_  = onTick;
+}
+
+void TurretPipeline::setRecorder(FlightRecorder *recorder) {
+    recorder_ = recorder;
+}
+
+void TurretPipeline::begin() {
+    captureSeq_      = 0;
+    latest_          = SensorSnapshot{};
+    maxAgeUs_        = 0;
+    maxCaptureJitUs_ = 0;
+    starved_         = 0;
+    latency_.init();
+    panCommits_      = ctx_.pan->output().commitCount();
+
+    captureTimer_.init(LOOP_PERIOD_US);
+    controlTimer_.init(LOOP_PERIOD_US, CAPTURE_LEAD_US);
+}
+
+bool TurretPipeline::start() {
+    begin();
+    running_.store(true);
+
+    RtosTask::Config cfg;
+    cfg.stackBytes = TASK_STACK_BYTES;
+
+    cfg.name = "capture";
+    cfg.priority = CAPTURE_TASK_PRIORITY;
+    cfg.core     = CAPTURE_TASK_CORE;
+    if (!captureTask_.start(cfg, captureBody, this)) return false;
+
+    cfg.name = "control";
+    cfg.priority = CONTROL_TASK_PRIORITY;
+    cfg.core     = CONTROL_TASK_CORE;
+    if (!controlTask_.start(cfg, controlBody, this)) return false;
+
+    cfg.name = "telemetry";
+    cfg.priority = TELEMETRY_TASK_PRIORITY;
+    cfg.core     = TELEMETRY_TASK_CORE;
+    return telemetryTask_.start(cfg, telemetryBody, this);
+}
+
+void TurretPipeline::stop() {
+    running_.store(false);
+    captureTask_.join();
+    controlTask_.join();
+    telemetryTask_.join();
+}
+
+bool TurretPipeline::captureStep() {
+    if (!captureTimer_.poll()) return false;
+    ProfScope prof(ProfStage::SENSORS);
+
+    ctx_.sensors->update();
+
+    SensorSnapshot snap;
+    snap.seq       = ++captureSeq_;
+    snap.tUs       = Hal::micros();
+    snap.jitterUs  = captureTimer_.lastJitterUs();
+    snap.rawHits   = ctx_.sensors->getRawHits();
+    snap.rawBits   = ctx_.sensors->getRawBits();
+    snap.levelBits = ctx_.sensors->getLevelBits();
+    snap.filtered  = ctx_.sensors->getFiltered();
+    snapshots_.push(snap);
+
+    captureTimer_.tickDone();
+    return true;
+}
+
+bool TurretPipeline::controlStep() {
+    if (!controlTimer_.poll()) return false;
+    ProfScope prof(ProfStage::CONTROL_TICK);
+    uint32_t tickUs = Hal::micros();
+    if (onTick_) onTick_();
+
+    TelemetryFrame f;
+
+    // --- Evidence and state machine, once per captured sample ---
+    bool transition = false;
+    bool any = false;
+    bool hit = false;
+    SensorSnapshot snap;
+    while (snapshots_.pop(snap)) {
+        if (f.samples < CaptureTick::MAX_SAMPLES) {
+            CaptureSample &s = f.sample[f.samples++];
+            s.seq     = static_cast<uint16_t>(snap.seq);
+            s.tUs     = static_cast<uint32_t>(snap.tUs);
+            s.rawBits = static_cast<uint8_t>(snap.rawBits | (snap.levelBits << 4));
+        } else {
+            f.samplesLost = true;
+        }
+        transition |= consume(snap);
+        any = true;
+        hit |= snap.rawHits != 0;
+    }
+    if (!any) starved_++;
+
+    // --- Dead reckoning over every elapsed period, servo output stages ---
+    // Periods passed over while parked had both servos powered down, so
+    // they moved nothing; counting them would integrate a command the
+    // state machine has only just given on waking, for up to
+    // PARK_IDLE_TICKS periods.
+    {
+        ProfScope p(ProfStage::POSITION);
+        uint32_t periods = controlTimer_.ticksElapsed() - controlTimer_.idleElapsed();
+        uint32_t dtMs = LOOP_PERIOD_MS * periods;
+        f.dtMs = dtMs > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(dtMs);
+        ctx_.pan->updatePosition(f.dtMs);
+    }
+    {
+        ProfScope p(ProfStage::SERVO_OUTPUT);
+        ctx_.pan->serviceOutput();
+        ctx_.tilt->serviceOutput();
+    }
+    notePanCommit();   // A write deferred to this frame
+
+    // --- Commands, scheduled jobs ---
+    char c;
+    while (commands_.pop(c)) {
+        handleCommand(c);
+    }
+    if (sched_) {
+        ProfScope p(ProfStage::SCHEDULER);
+        sched_->runDue();
+    }
+
+    // --- Telemetry (dropped, never waited for, if the ring is full) ---
+    uint32_t age = any ? static_cast<uint32_t>(tickUs - latest_.tUs) : 0;
+    if (age > maxAgeUs_) maxAgeUs_ = age;
+
+    f.kind       = TelemetryFrame::Kind::TICK;
+    f.tUs        = tickUs;
+    f.seq        = latest_.seq;
+    f.ageUs      = age;
+    f.state      = fsm_->state();
+    f.transition = transition;
+    f.panDeg     = ctx_.pan->getPositionDeg();
+    f.tiltDeg    = ctx_.tilt->getAngle();
+    f.reading    = latest_.filtered;
+    f.rawBits    = latest_.rawBits;
+    f.panCmd     = ctx_.pan->getSpeed();
+    f.panWritesPerSec  = ctx_.pan->output().writesPerSecond();
+    f.tiltWritesPerSec = ctx_.tilt->output().writesPerSecond();
+    f.loopUs     = static_cast<uint32_t>(Hal::micros() - tickUs);
+    frames_.push(f);
+    if (recorder_) recorder_->record(f.record());
+
+    controlTimer_.tickDone();
+
+    // Parked and powered down: wake less often until the next raw hit.
+    if (!hit && fsm_->state() == TurretState::PARKED &&
+        ctx_.pan->isPoweredDown() && ctx_.tilt->isPoweredDown()) {
+        controlTimer_.idle(PARK_IDLE_TICKS - 1);
+    }
+    return true;
+}
+
+uint16_t TurretPipeline::telemetryStep() {
+    uint16_t n = 0;
+    TelemetryFrame f;
+    while (frames_.pop(f)) {
+        if (sink_) {
+            ProfScope p(ProfStage::TELEMETRY);
+            sink_(f, ioCtx_);
+        }
+        n++;
+    }
+
+    if (source_) {
+        int c;
+        while ((c = source_(ioCtx_)) >= 0) {
+            commands_.push(static_cast<char>(c));
+        }
+    }
+    return n;
+}
+
+bool TurretPipeline::sendCommand(char c) {
+    return commands_.push(c);
+}
+
+JitterStats TurretPipeline::controlStats() const {
+    return controlTimer_.stats();
+}
+
+uint32_t TurretPipeline::frameDrops() const {
+    return frames_.drops();
+}
+
+uint32_t TurretPipeline::snapshotDrops() const {
+    return snapshots_.drops();
+}
+
+LatencyStats TurretPipeline::latencyStats() const {
+    return latency_.stats();
+}
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+bool TurretPipeline::consume(const SensorSnapshot &snap) {
+    latest_ = snap;
+    if (snap.jitterUs > maxCaptureJitUs_) maxCaptureJitUs_ = snap.jitterUs;
+
+    latency_.sample(snap.tUs, snap.rawBits, snap.filtered.anyActive());
+    {
+        ProfScope p(ProfStage::MONITOR);
+        ctx_.monitor->updateEvidence(snap.rawHits);
+    }
+    if (ctx_.monitor->getState() == MonitorState::TRACKING) {
+        latency_.mark(LatencyStage::MONITOR, Hal::micros());
+    }
+    {
+        ProfScope p(ProfStage::FSM);
+        uint32_t fsmUs = Hal::micros();
+        fsm_->update(snap.filtered);
+
+        TurretState s = fsm_->state();
+        if (s == TurretState::ACQUIRING || s == TurretState::LOCKED) {
+            latency_.mark(LatencyStage::COMMAND, fsmUs);
+        }
+        notePanCommit();
+    }
+    if (ctx_.monitor->stateChanged()) {
+        ctx_.monitor->updateStatusLED();
+    }
+    return fsm_->changed();
+}
+
+void TurretPipeline::notePanCommit() {
+    uint32_t commits = ctx_.pan->output().commitCount();
+    if (commits == panCommits_) return;
+    panCommits_ = commits;
+    latency_.mark(LatencyStage::SERVO, ctx_.pan->output().lastCommitUs());
+}
+
+void TurretPipeline::handleCommand(char c) {
+    switch (c) {
+        case 'j': {
+            TelemetryFrame f;
+            f.kind            = TelemetryFrame::Kind::TIMING;
+            f.tUs             = Hal::micros();
+            f.state           = fsm_->state();
+            f.control         = controlTimer_.stats();
+            f.maxAgeUs        = maxAgeUs_;
+            f.maxCaptureJitUs = maxCaptureJitUs_;
+            f.snapshotDrops   = snapshots_.drops();
+            f.frameDrops      = frames_.drops();
+            f.starvedTicks    = starved_;
+            frames_.push(f);
+            break;
+        }
+        case 'p': {
+            TelemetryFrame f;
+            f.kind  = TelemetryFrame::Kind::PROFILE;
+            f.tUs   = Hal::micros();
+            f.state = fsm_->state();
+            frames_.push(f);
+            break;
+        }
+        case 'l': {
+            TelemetryFrame f;
+            f.kind    = TelemetryFrame::Kind::LATENCY;
+            f.tUs     = Hal::micros();
+            f.state   = fsm_->state();
+            f.latency = latency_.stats();
+            frames_.push(f);
+            break;
+        }
+        case 'r':
+            // Posted, not applied: each stage clears on its own task.
+            Profiler::reset();
+            latency_.reset();
+            controlTimer_.resetStats();
+            maxAgeUs_        = 0;
+            maxCaptureJitUs_ = 0;
+            starved_         = 0;
+            break;
+        default:
+            break;
+    }
+}
+
+void TurretPipeline::captureBody(RtosTask &task, void *self) {
+    TurretPipeline *p = static_cast<TurretPipeline *>(self);
+    while (p->running_.load(std::memory_order_relaxed)) {
+        task.waitUs(p->captureTimer_.usUntilDue());
+        p->captureStep();
+    }
+}
+
+void TurretPipeline::controlBody(RtosTask &task, void *self) {
+    TurretPipeline *p = static_cast<TurretPipeline *>(self);
+    if (p->onStart_) p->onStart_();
+
+    while (p->running_.load(std::memory_order_relaxed)) {
+        // Sleep until the next tick, or an earlier scheduled job.
+        uint32_t waitUs = p->controlTimer_.usUntilDue();
+        if (p->sched_) {
+            uint32_t jobUs = p->sched_->msUntilNext() * 1000UL;
+            if (jobUs < waitUs) waitUs = jobUs;
+        }
+        task.waitUs(waitUs);
+
+        if (!p->controlStep() && p->sched_) {
+            p->sched_->runDue();
+        }
+    }
+}
+
+void TurretPipeline::telemetryBody(RtosTask &task, void *self) {
+    TurretPipeline *p = static_cast<TurretPipeline *>(self);
+    while (p->running_.load(std::memory_order_relaxed)) {
+        p->telemetryStep();
+        task.waitUs(TELEMETRY_POLL_MS * 1000UL);
+    }
+    p->telemetryStep();   // Host: flush what is left
+}
@@ -0,0 +1,174 @@
+/**
+ * @file profiler.cpp
+ * @brief Stage statistics and the platform clock.
+ */
+
+#include "profiler.h"
+#include "hal.h"
+#include <atomic>
+
+// ===================================================================
+// Static storage
+// ===================================================================
+
+namespace {
+
+constexpr uint8_t STAGE_COUNT = static_cast<uint8_t>(ProfStage::COUNT);
+
+/** Single writer per stage: relaxed load + store, no read-modify-write. */
+struct StageStats {
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint32_t> totalLo{0};   ///< Sum of ticks, low word
+    std::atomic<uint32_t> totalHi{0};   ///< Carries out of totalLo
+    std::atomic<uint32_t> maxTicks{0};
+    std::atomic<uint32_t> buckets[PROF_BUCKETS];
+    std::atomic<uint32_t> resetSeen{0};  ///< resetGen this stage last cleared for
+};
+
+HAL_PER_THREAD StageStats stats[STAGE_COUNT];
+
+/** Bumped by reset(); each stage's own writer clears it on seeing a new value. */
+HAL_PER_THREAD std::atomic<uint32_t> resetGen{0};
+
+#ifdef SENTRY_SIM
+HAL_PER_THREAD Profiler::Observer observer    = nullptr;
+HAL_PER_THREAD void              *observerCtx = nullptr;
+#endif
+
+void bump(std::atomic<uint32_t> &a, uint32_t by) {
+    a.store(a.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+}
+
+/** True while @p s has a reset its writer has not acted on yet. */
+bool resetPending(const StageStats &s) {
+    return s.resetSeen.load(std::memory_order_relaxed) !=
+           resetGen.load(std::memory_order_acquire);
+}
+
+void clear(StageStats &s) {
+    s.count.store(0, std::memory_order_relaxed);
+    s.totalLo.store(0, std::memory_order_relaxed);
+    s.totalHi.store(0, std::memory_order_relaxed);
+    s.maxTicks.store(0, std::memory_order_relaxed);
+    for (uint8_t b = 0; b < PROF_BUCKETS; b++) {
+        s.buckets[b].store(0, std::memory_order_relaxed);
+    }
+}
+
+/** Upper edge of @p bucket in µs. */
+float bucketUpperUs(uint8_t bucket) {
+    return static_cast<float>(1ULL << (bucket + 1)) / Profiler::ticksPerUs();
+}
+
+}  // namespace
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+uint32_t Profiler::now() {
+    return Hal::cycleCount();
+}
+
+float Profiler::ticksPerUs() {
+    return Hal::cyclesPerUs();
+}
+
+void Profiler::record(ProfStage stage, uint32_t ticks) {
+    StageStats &s = stats[static_cast<uint8_t>(stage)];
+    uint32_t gen = resetGen.load(std::memory_order_acquire);
+    if (s.resetSeen.load(std::memory_order_relaxed) != gen) {
+        clear(s);
+        s.resetSeen.store(gen, std::memory_order_relaxed);
+    }
+    bump(s.count, 1);
+    uint32_t lo = s.totalLo.load(std::memory_order_relaxed) + ticks;
+    if (lo < ticks) bump(s.totalHi, 1);
+    s.totalLo.store(lo, std::memory_order_relaxed);
+    if (ticks > s.maxTicks.load(std::memory_order_relaxed)) {
+        s.maxTicks.store(ticks, std::memory_order_relaxed);
+    }
+    bump(s.buckets[bucketFor(ticks)], 1);
+#ifdef SENTRY_SIM
+    if (observer) observer(stage, now() - ticks, ticks, observerCtx);
+#endif
+}
+
+ProfSummary Profiler::summary(ProfStage stage) {
+    const StageStats &s = stats[static_cast<uint8_t>(stage)];
+    ProfSummary out;
+    if (resetPending(s)) return out;
+    out.count = s.count.load(std::memory_order_relaxed);
+    if (out.count == 0) return out;
+
+    // Re-read if the low word carried while we looked.
+    uint32_t hi, lo;
+    do {
+        hi = s.totalHi.load(std::memory_order_relaxed);
+        lo = s.totalLo.load(std::memory_order_relaxed);
+    } while (hi != s.totalHi.load(std::memory_order_relaxed));
+    double total = static_cast<double>(hi) * 4294967296.0 + lo;
+    out.meanUs = static_cast<float>(total / out.count / ticksPerUs());
+    out.maxUs  = s.maxTicks.load(std::memory_order_relaxed) / ticksPerUs();
+
+    uint32_t p50 = (out.count + 1) / 2;
+    uint32_t p99 = out.count - out.count / 100;
+    uint32_t seen = 0;
+    bool have50 = false;
+    for (uint8_t i = 0; i < PROF_BUCKETS; i++) {
+        seen += s.buckets[i].load(std::memory_order_relaxed);
+        if (!have50 && seen >= p50) {
+            out.p50Us = bucketUpperUs(i);
+            have50 = true;
+        }
+        if (seen >= p99) {
+            out.p99Us = bucketUpperUs(i);
+            break;
+        }
+    }
+    // A bucket edge can overshoot the largest sample.
+    if (out.p50Us > out.maxUs) out.p50Us = out.maxUs;
+    if (out.p99Us > out.maxUs) out.p99Us = out.maxUs;
+    return out;
+}
+
+uint32_t Profiler::bucketCount(ProfStage stage, uint8_t bucket) {
+    if (bucket >= PROF_BUCKETS) return 0;
+    const StageStats &s = stats[static_cast<uint8_t>(stage)];
+    if (resetPending(s)) return 0;
+    return s.buckets[bucket].load(std::memory_order_relaxed);
+}
+
+uint8_t Profiler::bucketFor(uint32_t ticks) {
+    if (ticks < 2) return 0;
+    uint8_t b = static_cast<uint8_t>(31 - __builtin_clz(ticks));
+    return (b < PROF_BUCKETS) ? b : PROF_BUCKETS - 1;
+}
+
+const char *Profiler::stageName(ProfStage stage) {
+    switch (stage) {
+        case ProfStage::SENSORS:      return "sensors";
+        case ProfStage::CONTROL_TICK: return "control";
+        case ProfStage::MONITOR:      return "monitor";
+        case ProfStage::FSM:          return "fsm";
+        case ProfStage::TRACKER:      return "tracker";
+        case ProfStage::POSITION:     return "position";
+        case ProfStage::SERVO_OUTPUT: return "servo-out";
+        case ProfStage::SCHEDULER:    return "sched";
+        case ProfStage::TELEMETRY:    return "telemetry";
+        default:                      return "?";
+    }
+}
+
+void Profiler::reset() {
+    // Only the recording task writes a stage's counters, so the clear
+    // itself happens there, on the stage's next sample.
+    resetGen.store(resetGen.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+#ifdef SENTRY_SIM
+void Profiler::setObserver(Observer fn, void *ctx) {
+    observer    = fn;
+    observerCtx = ctx;
+}
+#endif
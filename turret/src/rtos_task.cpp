@@ -0,0 +1,87 @@
+/**
+ * @file rtos_task.cpp
+ * @brief Task abstraction back ends.
+ */
+
+#include "rtos_task.h"
+
+#if defined(UNIT_TEST) || defined(SENTRY_SIM)
+#include <chrono>
+#else
+#include <Arduino.h>
+#include <esp_timer.h>
+#endif
+
+// ===================================================================
+// Host: std::thread
+// ===================================================================
+
+#if defined(UNIT_TEST) || defined(SENTRY_SIM)
+
+bool RtosTask::start(const Config &, Body body, void *arg) {
+    body_   = body;
+    arg_    = arg;
+    thread_ = std::thread([this] { body_(*this, arg_); });
+    return true;
+}
+
+void RtosTask::waitUs(uint32_t us) {
+    if (us > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+void RtosTask::join() {
+    if (thread_.joinable()) thread_.join();
+}
+
+// ===================================================================
+// Target: FreeRTOS task + esp_timer wake-up
+// ===================================================================
+
+#else
+
+bool RtosTask::start(const Config &cfg, Body body, void *arg) {
+    body_ = body;
+    arg_  = arg;
+
+    esp_timer_create_args_t args = {};
+    args.callback = onTimer;
+    args.arg      = this;
+    args.name     = cfg.name;
+    if (esp_timer_create(&args, reinterpret_cast<esp_timer_handle_t *>(&timer_)) != ESP_OK) {
+        return false;
+    }
+
+    BaseType_t core = (cfg.core < 0) ? tskNO_AFFINITY : cfg.core;
+    return xTaskCreatePinnedToCore(trampoline, cfg.name, cfg.stackBytes, this,
+                                   cfg.priority, nullptr, core) == pdPASS;
+}
+
+void RtosTask::waitUs(uint32_t us) {
+    if (us == 0) {
+        taskYIELD();
+        return;
+    }
+    esp_timer_start_once(static_cast<esp_timer_handle_t>(timer_), us);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+void RtosTask::join() {}
+
+void RtosTask::trampoline(void *self) {
+    RtosTask *t = static_cast<RtosTask *>(self);
+    // Set here, not in start(): a higher-priority task on the other
+    // core can be running before xTaskCreatePinnedToCore() returns.
+    t->handle_ = xTaskGetCurrentTaskHandle();
+    t->body_(*t, t->arg_);
+    vTaskDelete(nullptr);
+}
+
+void RtosTask::onTimer(void *self) {
+    xTaskNotifyGive(static_cast<TaskHandle_t>(static_cast<RtosTask *>(self)->handle_));
+}
+
+#endif
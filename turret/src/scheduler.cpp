@@ -0,0 +1,211 @@
+/**
+ * @file scheduler.cpp
+ * @brief Min-heap deadline scheduler.
+ */
+
+#include "scheduler.h"
+#include "hal.h"
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+void Scheduler::init() {
+    for (uint8_t i = 0; i < SCHED_MAX_JOBS; i++) {
+        jobs_[i].active  = false;
+        jobs_[i].lagging = false;
+    }
+    size_  = 0;
+    laggingCount_ = 0;
+    fired_ = 0;
+    wakes_ = 0;
+}
+
+Scheduler::JobId Scheduler::every(uint32_t periodMs, Callback cb, void *ctx,
+                                  uint32_t firstInMs) {
+    if (periodMs == 0) return INVALID_JOB;
+    return at(Hal::millis() + firstInMs, cb, ctx, periodMs);
+}
+
+Scheduler::JobId Scheduler::after(uint32_t delayMs, Callback cb, void *ctx) {
+    return at(Hal::millis() + delayMs, cb, ctx, 0);
+}
+
+Scheduler::JobId Scheduler::at(uint32_t deadlineMs, Callback cb, void *ctx,
+                               uint32_t periodMs) {
+    if (!cb) return INVALID_JOB;
+
+    uint8_t slot = 0;
+    while (slot < SCHED_MAX_JOBS && jobs_[slot].active) slot++;
+    if (slot >= SCHED_MAX_JOBS) return INVALID_JOB;
+
+    Job &j     = jobs_[slot];
+    j.deadline = deadlineMs;
+    j.period   = periodMs;
+    j.cb       = cb;
+    j.ctx      = ctx;
+    j.gen      = static_cast<uint8_t>((j.gen + 1) & 0x7F);
+    j.active   = true;
+    j.lagging  = false;
+    heapInsert(slot);
+
+    return static_cast<JobId>((j.gen << 8) | slot);
+}
+
+bool Scheduler::cancel(JobId id) {
+    uint8_t slot = slotOf(id);
+    if (slot >= SCHED_MAX_JOBS) return false;
+
+    Job &j = jobs_[slot];
+    if (j.lagging) {
+        j.lagging = false;   // Out of the heap until runDue() ends
+    } else {
+        heapRemove(heapPos_[slot]);
+    }
+    j.active = false;
+    return true;
+}
+
+bool Scheduler::isPending(JobId id) const {
+    return slotOf(id) < SCHED_MAX_JOBS;
+}
+
+uint8_t Scheduler::runDue() {
+    uint32_t now = Hal::millis();
+    uint8_t ran = 0;
+
+    // Bounded: each job runs at most once per call, so a periodic job
+    // that is far behind cannot starve the loop.  One still due after
+    // its run leaves the heap until the pass ends instead of being
+    // waited on, so the root is always the next job to run.
+    while (size_ > 0 && reached(jobs_[heap_[0]].deadline, now)) {
+        uint8_t slot = heap_[0];
+        Job &j = jobs_[slot];
+
+        // Re-arm (or retire) before the callback so it can cancel or
+        // reschedule itself.
+        Callback cb  = j.cb;
+        void    *ctx = j.ctx;
+        if (j.period > 0) {
+            j.deadline += j.period;
+            if (reached(j.deadline, now)) {
+                heapRemove(0);
+                j.lagging = true;
+                lagging_[laggingCount_++] = slot;
+            } else {
+                siftDown(0);
+            }
+        } else {
+            heapRemove(0);
+            j.active = false;
+        }
+
+        cb(ctx);
+        ran++;
+    }
+
+    // Lagging jobs back in (unless a callback cancelled them).
+    for (uint8_t i = 0; i < laggingCount_; i++) {
+        Job &j = jobs_[lagging_[i]];
+        if (!j.lagging) continue;
+        j.lagging = false;
+        heapInsert(lagging_[i]);
+    }
+    laggingCount_ = 0;
+
+    fired_ += ran;
+    if (ran > 0) wakes_++;
+    return ran;
+}
+
+uint32_t Scheduler::msUntilNext() const {
+    if (size_ == 0) return SCHED_IDLE_MAX_MS;
+    uint32_t now = Hal::millis();
+    uint32_t deadline = jobs_[heap_[0]].deadline;
+    if (reached(deadline, now)) return 0;
+    return deadline - now;
+}
+
+uint8_t Scheduler::pending() const {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < SCHED_MAX_JOBS; i++) {
+        if (jobs_[i].active) n++;
+    }
+    return n;
+}
+
+uint32_t Scheduler::firedCount() const {
+    return fired_;
+}
+
+uint32_t Scheduler::wakeCount() const {
+    return wakes_;
+}
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+bool Scheduler::earlier(uint8_t a, uint8_t b) const {
+    int32_t d = static_cast<int32_t>(jobs_[a].deadline - jobs_[b].deadline);
+    if (d != 0) return d < 0;
+    return a < b;
+}
+
+void Scheduler::heapSwap(uint8_t i, uint8_t j) {
+    uint8_t t = heap_[i];
+    heap_[i] = heap_[j];
+    heap_[j] = t;
+    heapPos_[heap_[i]] = i;
+    heapPos_[heap_[j]] = j;
+}
+
+void Scheduler::siftUp(uint8_t i) {
+    while (i > 0) {
+        uint8_t parent = (i - 1) / 2;
+        if (!earlier(heap_[i], heap_[parent])) break;
+        heapSwap(i, parent);
+        i = parent;
+    }
+}
+
+void Scheduler::siftDown(uint8_t i) {
+    for (;;) {
+        uint8_t l = 2 * i + 1;
+        uint8_t r = l + 1;
+        uint8_t m = i;
+        if (l < size_ && earlier(heap_[l], heap_[m])) m = l;
+        if (r < size_ && earlier(heap_[r], heap_[m])) m = r;
+        if (m == i) return;
+        heapSwap(i, m);
+        i = m;
+    }
+}
+
+void Scheduler::heapInsert(uint8_t slot) {
+    heap_[size_]  = slot;
+    heapPos_[slot] = size_;
+    size_++;
+    siftUp(size_ - 1);
+}
+
+void Scheduler::heapRemove(uint8_t i) {
+    size_--;
+    if (i == size_) return;
+    heapSwap(i, size_);
+    siftDown(i);
+    siftUp(i);
+}
+
+uint8_t Scheduler::slotOf(JobId id) const {
+    if (id < 0) return SCHED_MAX_JOBS;
+    uint8_t slot = static_cast<uint8_t>(id & 0xFF);
+    uint8_t gen  = static_cast<uint8_t>((id >> 8) & 0x7F);
+    if (slot >= SCHED_MAX_JOBS) return SCHED_MAX_JOBS;
+    const Job &j = jobs_[slot];
+    return (j.active && j.gen == gen) ? slot : SCHED_MAX_JOBS;
+}
+
+bool Scheduler::reached(uint32_t deadline, uint32_t now) {
+    return static_cast<int32_t>(now - deadline) >= 0;
+}
@@ -0,0 +1,279 @@
+/**
+ * @file search_planner.cpp
+ * @brief Prior-guided search: likely bearings first, then an exhaustive
+ *        detection-limited pattern.
+ */
+
+#include "search_planner.h"
+#include "config.h"
+#include "hal.h"
+#include <math.h>
+#include <stdlib.h>
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+void SearchPlanner::init(PanController *pan, TiltController *tilt,
+                         const BearingPrior *prior) {
+    pan_   = pan;
+    tilt_  = tilt;
+    prior_ = prior;
+    waypointCount_ = 0;
+    nextWaypoint_  = 0;
+    phase_ = Phase::PATTERN;
+}
+
+void SearchPlanner::setPattern(SearchPattern pattern) {
+    pattern_ = pattern;
+}
+
+SearchPattern SearchPlanner::getPattern() const {
+    return pattern_;
+}
+
+void SearchPlanner::begin(float lastBearingDeg, uint32_t holdMs) {
+    if (!pan_ || !tilt_ || !prior_) return;
+
+    holdStartMs_ = Hal::millis();
+    holdMs_      = holdMs;
+
+    // 1. Last-known bearing first — most losses are brief occlusions.
+    waypointCount_ = 0;
+    waypointDeg_[waypointCount_++] = clampBearing(lastBearingDeg);
+
+    // 2. Heaviest learned bins, skipping overlaps with listed waypoints.
+    uint8_t ranked[PRIOR_BINS];
+    uint8_t n = prior_->rankBins(ranked, PRIOR_BINS);
+    for (uint8_t i = 0; i < n && waypointCount_ < SEARCH_MAX_WAYPOINTS; i++) {
+        float center = BearingPrior::binCenterDeg(ranked[i]);
+
+        bool overlaps = false;
+        for (uint8_t w = 0; w < waypointCount_; w++) {
+            if (fabsf(waypointDeg_[w] - center) < PRIOR_BIN_DEG) {
+                overlaps = true;
+                break;
+            }
+        }
+        if (!overlaps) {
+            waypointDeg_[waypointCount_++] = clampBearing(center);
+        }
+    }
+
+    nextWaypoint_ = 0;
+    startNextWaypoint();
+}
+
+void SearchPlanner::update() {
+    if (!pan_ || !tilt_ || !prior_) return;
+
+    switch (phase_) {
+        case Phase::TRANSIT:
+            if (driveToward(legTargetDeg_, SEARCH_TRANSIT_SPEED)) {
+                phase_        = Phase::SCAN;
+                legTargetDeg_ = scanEndDeg_;
+            }
+            tilt_->stepToward(prior_->elevationAt(focusDeg_), TILT_STEP_DEG);
+            break;
+
+        case Phase::SCAN:
+        case Phase::HOLD:
+            if (driveToward(legTargetDeg_, SEARCH_SWEEP_SPEED)) {
+                if (nextWaypoint_ == 1 && (Hal::millis() - holdStartMs_) < holdMs_) {
+                    // Still holding: cross the exit bin again.
+                    float back    = scanStartDeg_;
+                    scanStartDeg_ = legTargetDeg_;
+                    legTargetDeg_ = back;
+                    phase_        = Phase::HOLD;
+                } else {
+                    startNextWaypoint();
+                }
+            }
+            tilt_->stepToward(prior_->elevationAt(focusDeg_), TILT_STEP_DEG);
+            break;
+
+        case Phase::PATTERN:
+            switch (pattern_) {
+                case SearchPattern::SWEEP:     updateSweep();     break;
+                case SearchPattern::RASTER:    updateRaster();    break;
+                case SearchPattern::LISSAJOUS: updateLissajous(); break;
+            }
+            break;
+    }
+}
+
+SearchPlanner::Phase SearchPlanner::getPhase() const {
+    return phase_;
+}
+
+uint8_t SearchPlanner::waypointCount() const {
+    return waypointCount_;
+}
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+void SearchPlanner::startNextWaypoint() {
+    float pos = pan_->getPositionDeg();
+
+    if (nextWaypoint_ >= waypointCount_) {
+        startPattern();
+        return;
+    }
+
+    float center = waypointDeg_[nextWaypoint_++];
+    float half   = PRIOR_BIN_DEG / 2.0f;
+
+    // Enter the bin from the side we are on and scan across it.
+    float nearEdge, farEdge;
+    if (pos <= center) {
+        nearEdge = center - half;
+        farEdge  = center + half;
+    } else {
+        nearEdge = center + half;
+        farEdge  = center - half;
+    }
+
+    phase_        = Phase::TRANSIT;
+    legTargetDeg_ = clampBearing(nearEdge);
+    scanStartDeg_ = legTargetDeg_;
+    scanEndDeg_   = clampBearing(farEdge);
+    focusDeg_     = center;
+}
+
+void SearchPlanner::startPattern() {
+    float pos = pan_->getPositionDeg();
+    phase_ = Phase::PATTERN;
+
+    // Carry on the way the last scan leg went: turning back would cross
+    // the bin just scanned again.  Without one, head toward center so
+    // SWEEP stays roughly symmetric and RASTER starts with the longer
+    // half of the pass.
+    if (legTargetDeg_ != scanStartDeg_) {
+        sweepCW_ = (legTargetDeg_ > scanStartDeg_);
+    } else {
+        sweepCW_ = (pos <= 0.0f);
+    }
+
+    // RASTER: start on the row nearest the current tilt, stepping toward
+    // the far end of the range.
+    int16_t tiltDeg = tilt_->getAngle();
+    rasterRow_ = 0;
+    for (uint8_t r = 1; r < SEARCH_RASTER_ROWS; r++) {
+        if (abs(rasterRowDeg(r) - tiltDeg) < abs(rasterRowDeg(rasterRow_) - tiltDeg)) {
+            rasterRow_ = r;
+        }
+    }
+    rasterRowDir_  = (rasterRow_ + 1 < SEARCH_RASTER_ROWS) ? 1 : -1;
+    rasterTurning_ = true;   // settle onto the row before the first pass
+
+    // LISSAJOUS: pick the pan phase that matches the current bearing.
+    constexpr float reach = PAN_LIMIT_DEG - SEARCH_WAYPOINT_TOL_DEG;
+    float ratio = clampBearing(pos) / reach;
+    lissajousPhase_ = asinf(ratio);
+    if (!sweepCW_) {
+        lissajousPhase_ = static_cast<float>(M_PI) - lissajousPhase_;   // moving CCW
+    }
+    patternTicks_ = 0;
+}
+
+void SearchPlanner::updateSweep() {
+    // Slow sweep: alternate CW and CCW.
+    float pos = pan_->getPositionDeg();
+    focusDeg_ = pos;
+    if (sweepCW_) {
+        pan_->setSpeed(SEARCH_SWEEP_SPEED);
+        if (pos >= SEARCH_SWEEP_DEG) {
+            sweepCW_ = false;
+        }
+    } else {
+        pan_->setSpeed(-SEARCH_SWEEP_SPEED);
+        if (pos <= -SEARCH_SWEEP_DEG) {
+            sweepCW_ = true;
+        }
+    }
+    tilt_->stepToward(prior_->elevationAt(focusDeg_), TILT_STEP_DEG);
+}
+
+void SearchPlanner::updateRaster() {
+    constexpr float reach = PAN_LIMIT_DEG - SEARCH_WAYPOINT_TOL_DEG;
+
+    // Row change: hold the pan until the tilt is on the new row, so the
+    // next pass is a full detection-limited sweep at that elevation.
+    if (rasterTurning_) {
+        pan_->stop();
+        if (tilt_->stepToward(rasterRowDeg(rasterRow_), TILT_STEP_DEG)) {
+            rasterTurning_ = false;
+        }
+        return;
+    }
+
+    if (driveToward(sweepCW_ ? reach : -reach, SEARCH_SWEEP_SPEED)) {
+        sweepCW_ = !sweepCW_;
+
+        // Ping-pong through the rows: 0, 1, … N−1, N−2, … 0, …
+        if (SEARCH_RASTER_ROWS > 1) {
+            if ((rasterRow_ == 0 && rasterRowDir_ < 0) ||
+                (rasterRow_ + 1 >= SEARCH_RASTER_ROWS && rasterRowDir_ > 0)) {
+                rasterRowDir_ = -rasterRowDir_;
+            }
+            rasterRow_ += rasterRowDir_;
+            rasterTurning_ = true;
+        }
+    }
+}
+
+void SearchPlanner::updateLissajous() {
+    constexpr float reach   = PAN_LIMIT_DEG - SEARCH_WAYPOINT_TOL_DEG;
+    constexpr float tiltMid = (TILT_MIN_DEG + TILT_MAX_DEG) / 2.0f;
+    constexpr float tiltAmp = (TILT_MAX_DEG - TILT_MIN_DEG) / 2.0f;
+
+    // Angular frequencies (rad/s) chosen so the peak rates equal the
+    // detection limits; tilt runs SEARCH_LISSAJOUS_RATIO times faster
+    // unless that would exceed its own limit.
+    constexpr float panW  = SEARCH_MAX_PAN_DEG_PER_SEC / reach;
+    constexpr float tiltW = (panW * SEARCH_LISSAJOUS_RATIO * tiltAmp > SEARCH_MAX_TILT_DEG_PER_SEC)
+                                ? SEARCH_MAX_TILT_DEG_PER_SEC / tiltAmp
+                                : panW * SEARCH_LISSAJOUS_RATIO;
+
+    patternTicks_++;
+    float t = patternTicks_ * (LOOP_PERIOD_MS / 1000.0f);
+
+    // Pan: velocity feed-forward plus a position correction for the
+    // dead-reckoning error and the backlash dead zone near turnarounds.
+    constexpr float KP = 2.0f;   // 1/s
+    float target = reach * sinf(panW * t + lissajousPhase_);
+    float rate   = reach * panW * cosf(panW * t + lissajousPhase_);
+    rate += KP * (target - pan_->getPositionDeg());
+    pan_->setSpeed(rate / PAN_DEG_PER_SEC);
+
+    // Tilt: start at mid-range moving up.
+    float tiltTarget = tiltMid + tiltAmp * sinf(tiltW * t);
+    tilt_->stepToward(static_cast<int16_t>(lroundf(tiltTarget)), TILT_STEP_DEG);
+}
+
+int16_t SearchPlanner::rasterRowDeg(uint8_t row) {
+    if (SEARCH_RASTER_ROWS < 2) {
+        return (TILT_MIN_DEG + TILT_MAX_DEG) / 2;
+    }
+    return static_cast<int16_t>(
+        TILT_MIN_DEG + (row * (TILT_MAX_DEG - TILT_MIN_DEG)) / (SEARCH_RASTER_ROWS - 1));
+}
+
+bool SearchPlanner::driveToward(float targetDeg, float speed) {
+    float error = targetDeg - pan_->getPositionDeg();
+    if (fabsf(error) <= SEARCH_WAYPOINT_TOL_DEG) {
+        return true;
+    }
+    pan_->setSpeed((error > 0.0f) ? speed : -speed);
+    return false;
+}
+
+float SearchPlanner::clampBearing(float deg) {
+    // Stay clear of the hard limit: setSpeed() refuses to push into it.
+    constexpr float reach = PAN_LIMIT_DEG - SEARCH_WAYPOINT_TOL_DEG;
+    if (deg >  reach) return  reach;
+    if (deg < -reach) return -reach;
+    return deg;
+}
@@ -5,7 +5,7 @@
 
 #include "sensor_array.h"
 #include "config.h"
-#include <Arduino.h>
+#include "hal.h"
 
 // Pin look-up table indexed by [0]=top, [1]=bottom, [2]=left, [3]=right.
 static const uint8_t SENSOR_PINS[4] = {
@@ -36,19 +36,31 @@ bool SensorReading::noneActive() const {
 
 void SensorArray::init() {
     for (uint8_t i = 0; i < 4; i++) {
-        pinMode(SENSOR_PINS[i], INPUT_PULLUP);
+        Hal::pinMode(SENSOR_PINS[i], INPUT_PULLUP);
+        Hal::armLowLatch(SENSOR_PINS[i]);
         filters_[i] = FilterState{};
     }
+    rawHits_   = 0;
+    rawBits_   = 0;
+    levelBits_ = 0;
+    threshold_.store(SENSOR_FILTER_THRESHOLD, std::memory_order_relaxed);
 }
 
 void SensorArray::update() {
+    rawHits_   = 0;
+    rawBits_   = 0;
+    levelBits_ = 0;
     for (uint8_t i = 0; i < 4; i++) {
-        // TSOP38238 is active-low: LOW = signal detected.
-        bool active = (digitalRead(SENSOR_PINS[i]) == LOW);
+        // TSOP38238 is active-low: LOW = signal detected, at any time
+        // since the last tick.
+        bool active = Hal::takeLowLatch(SENSOR_PINS[i]);
         pushSample(i, active);
+        if (active) rawBits_ |= static_cast<uint8_t>(1u << i);
 
-        // Saturation tracking.
-        if (active) {
+        // Saturation tracking: LOW right now as well, tick after tick.
+        // The latch alone cannot tell a stuck sensor from a busy beacon.
+        if (active && Hal::digitalRead(SENSOR_PINS[i]) == LOW) {
+            levelBits_ |= static_cast<uint8_t>(1u << i);
             filters_[i].lowRunMs += LOOP_PERIOD_MS;
             if (filters_[i].lowRunMs >= SENSOR_SATURATED_MS) {
                 filters_[i].saturated = true;
@@ -57,6 +69,10 @@ void SensorArray::update() {
             filters_[i].lowRunMs  = 0;
             filters_[i].saturated = false;
         }
+
+        if (active && !filters_[i].saturated) {
+            rawHits_ |= static_cast<uint8_t>(1u << i);
+        }
     }
 }
 
@@ -102,6 +118,28 @@ Direction SensorArray::getDirection() const {
     return Direction::CENTER;
 }
 
+uint8_t SensorArray::getRawHits() const {
+    return rawHits_;
+}
+
+uint8_t SensorArray::getRawBits() const {
+    return rawBits_;
+}
+
+uint8_t SensorArray::getLevelBits() const {
+    return levelBits_;
+}
+
+void SensorArray::setFilterThreshold(uint8_t threshold) {
+    if (threshold < 1) threshold = 1;
+    if (threshold > SENSOR_FILTER_WINDOW) threshold = SENSOR_FILTER_WINDOW;
+    threshold_.store(threshold, std::memory_order_relaxed);
+}
+
+uint8_t SensorArray::getFilterThreshold() const {
+    return threshold_.load(std::memory_order_relaxed);
+}
+
 // ===================================================================
 // Private helpers
 // ===================================================================
@@ -139,7 +177,7 @@ SensorState SensorArray::evaluateSensor(uint8_t idx) const {
     }
 
     uint8_t activeCount = popcount(f.buffer);
-    if (activeCount >= SENSOR_FILTER_THRESHOLD) {
+    if (activeCount >= threshold_.load(std::memory_order_relaxed)) {
         return SensorState::ACTIVE;
     }
     return SensorState::INACTIVE;
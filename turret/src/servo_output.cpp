@@ -0,0 +1,207 @@
+/**
+ * @file servo_output.cpp
+ * @brief Write-suppressing, frame-aligned servo output stage.
+ */
+
+#include "servo_output.h"
+#include "config.h"
+#include "hal.h"
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+void ServoOutput::attach(uint8_t pin, uint16_t initialUs) {
+    pin_ = pin;
+    servo_.attach(pin);
+    originUs_       = Hal::micros();
+    pending_        = false;
+    poweredDown_    = false;
+    awaitingCommand_ = false;
+    frameFree_      = false;
+    commits_        = 0;
+    suppressed_     = 0;
+    windowCommits_  = 0;
+    writesPerSec_   = 0;
+    windowStartMs_  = Hal::millis();
+    powerDowns_     = 0;
+    downTotalMs_    = 0;
+    lastWakeUs_     = 0;
+    maxWakeUs_      = 0;
+    commit(initialUs, 0);
+
+    // Nothing was driving the servo before: the first real command may
+    // share frame 0 with the initial write, as after a wake.
+    frameFree_ = true;
+}
+
+void ServoOutput::write(uint16_t us) {
+    // Same value the hardware already carries: nothing to do, and any
+    // pending change is superseded by "stay where you are".
+    if (us == lastUs_) {
+        pending_ = false;
+        suppressed_++;
+        if (!poweredDown_) noteCommandOut();
+        return;
+    }
+
+    if (poweredDown_) {
+        pendingUs_ = us;
+        pending_   = true;
+        return;
+    }
+
+    uint32_t frame = frameAt(Hal::micros());
+    if (frame != lastFrame_ || frameFree_) {
+        pending_ = false;
+        commit(us, frame);
+        return;
+    }
+
+    // Already wrote in this frame — latch for the next one.
+    pendingUs_ = us;
+    pending_   = true;
+}
+
+void ServoOutput::service() {
+    if (pending_ && !poweredDown_) {
+        uint32_t frame = frameAt(Hal::micros());
+        if (frame != lastFrame_ || frameFree_) {
+            pending_ = false;
+            commit(pendingUs_, frame);
+        }
+    }
+
+    uint32_t now = Hal::millis();
+    if ((now - windowStartMs_) >= 1000) {
+        writesPerSec_  = windowCommits_;
+        windowCommits_ = 0;
+        windowStartMs_ = now;
+    }
+}
+
+void ServoOutput::powerDown() {
+    if (poweredDown_) return;
+
+    servo_.detach();
+    poweredDown_     = true;
+    awaitingCommand_ = false;
+    downSinceMs_     = Hal::millis();
+    powerDowns_++;
+}
+
+void ServoOutput::powerUp() {
+    if (!poweredDown_) return;
+
+    wakeStartUs_ = Hal::micros();
+    downTotalMs_ += Hal::millis() - downSinceMs_;
+
+    // Re-attach and immediately re-assert the held position, so the first
+    // frame out of the channel carries the old pulse width, not the
+    // library's default.
+    servo_.attach(pin_);
+    servo_.writeMicroseconds(lastUs_);
+    poweredDown_ = false;
+    originUs_    = Hal::micros();
+    lastFrame_   = 0;
+
+    // The restore write is not a frame change, so let the first real
+    // command share frame 0 rather than wait a full frame.
+    frameFree_       = true;
+    awaitingCommand_ = true;
+
+    // A command latched while powered down goes out now.
+    if (pending_) {
+        pending_ = false;
+        commit(pendingUs_, 0);
+    }
+}
+
+bool ServoOutput::isPoweredDown() const {
+    return poweredDown_;
+}
+
+uint16_t ServoOutput::lastUs() const {
+    return lastUs_;
+}
+
+uint16_t ServoOutput::targetUs() const {
+    return pending_ ? pendingUs_ : lastUs_;
+}
+
+uint16_t ServoOutput::outputUs() const {
+    if (pending_ && !poweredDown_ &&
+        (frameAt(Hal::micros()) != lastFrame_ || frameFree_)) {
+        return pendingUs_;
+    }
+    return lastUs_;
+}
+
+bool ServoOutput::hasPending() const {
+    return pending_;
+}
+
+uint32_t ServoOutput::commitCount() const {
+    return commits_;
+}
+
+uint32_t ServoOutput::lastCommitUs() const {
+    return lastCommitUs_;
+}
+
+uint32_t ServoOutput::suppressedCount() const {
+    return suppressed_;
+}
+
+uint16_t ServoOutput::writesPerSecond() const {
+    return writesPerSec_;
+}
+
+uint32_t ServoOutput::powerDownCount() const {
+    return powerDowns_;
+}
+
+uint32_t ServoOutput::poweredDownMs() const {
+    if (poweredDown_) {
+        return downTotalMs_ + (Hal::millis() - downSinceMs_);
+    }
+    return downTotalMs_;
+}
+
+uint32_t ServoOutput::lastWakeLatencyUs() const {
+    return lastWakeUs_;
+}
+
+uint32_t ServoOutput::maxWakeLatencyUs() const {
+    return maxWakeUs_;
+}
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+uint32_t ServoOutput::frameAt(uint32_t nowUs) const {
+    // Unsigned subtraction keeps the index counting through a micros()
+    // rollover (~71 min); the grid shifts by a fraction of a frame there,
+    // which at worst defers one write by a frame.
+    return (nowUs - originUs_) / SERVO_FRAME_US;
+}
+
+void ServoOutput::commit(uint16_t us, uint32_t frame) {
+    servo_.writeMicroseconds(us);
+    lastUs_    = us;
+    lastFrame_ = frame;
+    lastCommitUs_ = Hal::micros();
+    frameFree_ = false;
+    commits_++;
+    windowCommits_++;
+    noteCommandOut();
+}
+
+void ServoOutput::noteCommandOut() {
+    if (!awaitingCommand_) return;
+
+    awaitingCommand_ = false;
+    lastWakeUs_ = Hal::micros() - wakeStartUs_;
+    if (lastWakeUs_ > maxWakeUs_) maxWakeUs_ = lastWakeUs_;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file session_capture.cpp
+ * @brief Session capture header / tick packing and the capture decoder.
+ */
+
+#include "session_capture.h"
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+static void putU16(uint8_t *p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+static void putU32(uint8_t *p, uint32_t v) {
+    putU16(p, static_cast<uint16_t>(v));
+    putU16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+static uint16_t getU16(const uint8_t *p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t getU32(const uint8_t *p) {
+    return getU16(p) | (static_cast<uint32_t>(getU16(p + 2)) << 16);
+}
+
+// ===================================================================
+// SessionCapture
+// ===================================================================
+
+size_t SessionCapture::packHeader(const CaptureHeader &h, uint8_t *out) {
+    uint8_t n = h.priorLen <= sizeof(h.prior) ? h.priorLen : 0;
+    out[0] = CaptureHeader::TAG;
+    out[1] = VERSION;
+    putU32(out + 2, h.bootUs);
+    out[6] = n;
+    for (uint8_t i = 0; i < n; i++) out[7 + i] = h.prior[i];
+    return 7 + n;
+}
+
+bool SessionCapture::unpackHeader(const uint8_t *in, size_t len, CaptureHeader &h) {
+    if (len < 7 || in[0] != CaptureHeader::TAG || in[1] != VERSION) return false;
+    if (in[6] > sizeof(h.prior) || len != 7u + in[6]) return false;
+
+    h.version  = in[1];
+    h.bootUs   = getU32(in + 2);
+    h.priorLen = in[6];
+    for (uint8_t i = 0; i < h.priorLen; i++) h.prior[i] = in[7 + i];
+    return true;
+}
+
+size_t SessionCapture::packTick(const CaptureTick &t, uint8_t *out) {
+    uint8_t n = t.samples <= CaptureTick::MAX_SAMPLES ? t.samples : CaptureTick::MAX_SAMPLES;
+    out[0] = CaptureTick::TAG;
+    TelemetryCodec::pack(t.rec, out + 1);
+    putU16(out + 19, t.dtMs);
+    out[21] = static_cast<uint8_t>(n | (t.samplesLost ? 0x80 : 0));
+
+    uint8_t *p = out + TICK_MIN;
+    for (uint8_t i = 0; i < n; i++, p += SAMPLE_BYTES) {
+        putU16(p, t.sample[i].seq);
+        putU32(p + 2, t.sample[i].tUs);
+        p[6] = t.sample[i].rawBits;
+    }
+    return TICK_MIN + n * SAMPLE_BYTES;
+}
+
+bool SessionCapture::unpackTick(const uint8_t *in, size_t len, CaptureTick &t) {
+    if (len < TICK_MIN || in[0] != CaptureTick::TAG) return false;
+    uint8_t n = in[21] & 0x7F;
+    if (n > CaptureTick::MAX_SAMPLES || len != TICK_MIN + n * SAMPLE_BYTES) return false;
+    if (!TelemetryCodec::unpack(in + 1, TelemetryRecord::BYTES, t.rec)) return false;
+
+    t.dtMs        = getU16(in + 19);
+    t.samples     = n;
+    t.samplesLost = (in[21] & 0x80) != 0;
+
+    const uint8_t *p = in + TICK_MIN;
+    for (uint8_t i = 0; i < n; i++, p += SAMPLE_BYTES) {
+        t.sample[i].seq     = getU16(p);
+        t.sample[i].tUs     = getU32(p + 2);
+        t.sample[i].rawBits = p[6];
+    }
+    return true;
+}
+
+size_t SessionCapture::encodeHeader(const CaptureHeader &h, uint8_t *out) {
+    uint8_t raw[HEADER_MAX];
+    size_t n = packHeader(h, raw);
+    return TelemetryCodec::encodePayload(raw, n, out);
+}
+
+size_t SessionCapture::encodeTick(const CaptureTick &t, uint8_t *out) {
+    uint8_t raw[TICK_MAX];
+    size_t n = packTick(t, raw);
+    return TelemetryCodec::encodePayload(raw, n, out);
+}
+
+// ===================================================================
+// CaptureDecoder
+// ===================================================================
+
+CaptureDecoder::Frame CaptureDecoder::feed(uint8_t b) {
+    if (b != 0x00) {
+        if (len_ < MAX_ENCODED) {
+            buf_[len_++] = b;
+        } else {
+            overflow_ = true;
+        }
+        return Frame::NONE;
+    }
+
+    // Delimiter: check what came before it.
+    size_t len = len_;
+    bool overflow = overflow_;
+    len_ = 0;
+    overflow_ = false;
+    if (len == 0 && !overflow) return Frame::NONE;   // Back-to-back delimiters
+
+    uint8_t raw[SessionCapture::PAYLOAD_MAX];
+    size_t n = overflow ? 0 : TelemetryCodec::decodePayload(buf_, len, raw, sizeof(raw));
+
+    Frame got = Frame::NONE;
+    if (n == 0) {
+        // Bad COBS or CRC
+    } else if (raw[0] == CaptureTick::TAG) {
+        if (SessionCapture::unpackTick(raw, n, tick_)) {
+            rec_ = tick_.rec;
+            got  = Frame::TICK;
+        }
+    } else if (raw[0] == CaptureHeader::TAG) {
+        if (SessionCapture::unpackHeader(raw, n, header_)) got = Frame::HEADER;
+    } else if (TelemetryCodec::unpack(raw, n, rec_)) {
+        got = Frame::RECORD;
+    }
+
+    if (got == Frame::NONE) {
+        bad_++;
+    } else {
+        frames_++;
+    }
+    return got;
+}
+
+const TelemetryRecord &CaptureDecoder::record() const {
+    return rec_;
+}
+
+const CaptureHeader &CaptureDecoder::header() const {
+    return header_;
+}
+
+const CaptureTick &CaptureDecoder::tick() const {
+    return tick_;
+}
+
+uint32_t CaptureDecoder::frames() const {
+    return frames_;
+}
+
+uint32_t CaptureDecoder::badFrames() const {
+    return bad_;
+}
@@ -7,12 +7,19 @@
  *     in TRACKING for at least this long after the last detection before
  *     beginning the transition toward SEARCHING.
  *   - Previous-state tracking enables the main loop to detect transitions
- *     and run one-time entry actions (sweep reset, position re-zero, etc.).
+ *     and run one-time entry actions (sweep reset, servo wake, etc.).
+ *   - updateEvidence() replaces the fixed holdoff / search timeouts with a
+ *     sequential probability ratio test on raw per-tick hits.
+ *   - The park timeout and exit-bearing hold adapt to the learned
+ *     distribution of absence durations.
+ *   - The SEARCHING blink can run as a scheduled job instead of a
+ *     per-tick millis() check.
  */
 
 #include "signal_monitor.h"
 #include "config.h"
-#include <Arduino.h>
+#include "hal.h"
+#include <math.h>
 
 // ===================================================================
 // Public API
@@ -21,16 +28,33 @@
 void SignalMonitor::init() {
     state_        = MonitorState::TRACKING;
     prevState_    = MonitorState::TRACKING;
-    lastSignalMs_ = millis();
-    lastBlinkMs_  = millis();
+    lastSignalMs_ = Hal::millis();
+    lastBlinkMs_  = Hal::millis();
     ledState_     = false;
+    if (sched_) sched_->cancel(blinkJob_);
+    blinkJob_     = Scheduler::INVALID_JOB;
 
-    pinMode(PIN_STATUS_LED, OUTPUT);
-    digitalWrite(PIN_STATUS_LED, HIGH);  // Solid ON = TRACKING
+    // SPRT increments and thresholds (Wald), from the config.h model.
+    llrHit_     = logf(SPRT_P_HIT_PRESENT / SPRT_P_HIT_ABSENT);
+    llrMiss_    = logf((1.0f - SPRT_P_HIT_PRESENT) / (1.0f - SPRT_P_HIT_ABSENT));
+    llrPresent_ = logf((1.0f - SPRT_BETA) / SPRT_ALPHA);
+    llrAbsent_  = logf(SPRT_BETA / (1.0f - SPRT_ALPHA));
+    for (uint8_t s = 0; s < 4; s++) {
+        llr_[s] = llrPresent_;   // Starts in TRACKING, as update(bool) does
+    }
+
+    // No absence history yet: fixed timeouts until enough is learned.
+    for (uint8_t i = 0; i < ABSENCE_BINS; i++) {
+        absence_[i] = 0;
+    }
+    adaptTimeouts();
+
+    Hal::pinMode(PIN_STATUS_LED, OUTPUT);
+    Hal::digitalWrite(PIN_STATUS_LED, HIGH);  // Solid ON = TRACKING
 }
 
 void SignalMonitor::update(bool anySignalDetected) {
-    unsigned long now = millis();
+    uint32_t now = Hal::millis();
 
     // Snapshot current state so the main loop can detect transitions.
     prevState_ = state_;
@@ -44,7 +68,7 @@ void SignalMonitor::update(bool anySignalDetected) {
     }
 
     // No signal — compute time since last detection.
-    unsigned long elapsed = now - lastSignalMs_;
+    uint32_t elapsed = now - lastSignalMs_;
 
     // Holdoff: stay in TRACKING if within the hysteresis window.
     // This prevents brief dropouts from starting the loss timer.
@@ -63,6 +87,107 @@ void SignalMonitor::update(bool anySignalDetected) {
     // (signal just recently lost, not long enough to start searching).
 }
 
+void SignalMonitor::updateEvidence(uint8_t rawHits) {
+    uint32_t now = Hal::millis();
+
+    // Snapshot current state so the main loop can detect transitions.
+    prevState_ = state_;
+
+    // Accumulate, clamped at both thresholds: the test restarts from the
+    // boundary after each decision instead of drifting without bound.
+    // The best sensor decides.
+    float best = llrAbsent_;
+    for (uint8_t s = 0; s < 4; s++) {
+        float l = llr_[s] + (((rawHits >> s) & 1) ? llrHit_ : llrMiss_);
+        if (l > llrPresent_) l = llrPresent_;
+        if (l < llrAbsent_)  l = llrAbsent_;
+        llr_[s] = l;
+        if (l > best) best = l;
+    }
+
+    if (best >= llrPresent_) {
+        // Decision: present.  An absence that reached SEARCHING ends here.
+        if (state_ != MonitorState::TRACKING) {
+            recordAbsence(now - lastSignalMs_);
+        }
+        // Also restarts the park timer.
+        lastSignalMs_ = now;
+        state_ = MonitorState::TRACKING;
+        return;
+    }
+
+    if (state_ == MonitorState::TRACKING) {
+        // Between the thresholds: undecided, hold TRACKING.
+        if (best <= llrAbsent_) {
+            state_ = MonitorState::SEARCHING;
+        }
+    } else if (state_ == MonitorState::SEARCHING) {
+        if ((now - lastSignalMs_) >= parkMs_) {
+            state_ = MonitorState::PARKED;
+        }
+    }
+}
+
+void SignalMonitor::recordAbsence(uint32_t durationMs) {
+    countAbsence(absence_, absenceBinFor(durationMs));
+    adaptTimeouts();
+}
+
+void SignalMonitor::setAdaptive(bool enable) {
+    adaptive_ = enable;
+    adaptTimeouts();
+}
+
+uint32_t SignalMonitor::getParkMs() const {
+    return parkMs_;
+}
+
+uint32_t SignalMonitor::getHoldMs() const {
+    return holdMs_;
+}
+
+uint8_t SignalMonitor::getAbsenceCount(uint8_t bin) const {
+    return (bin < ABSENCE_BINS) ? absence_[bin] : 0;
+}
+
+uint8_t SignalMonitor::absenceBinFor(uint32_t durationMs) {
+    // Bin 0: < 2 s; bin i: [2^i, 2^(i+1)) s; last bin open-ended.
+    uint32_t s = durationMs / 1000;
+    uint8_t bin = 0;
+    while (s >= 2 && bin < ABSENCE_BINS - 1) {
+        s >>= 1;
+        bin++;
+    }
+    return bin;
+}
+
+void SignalMonitor::countAbsence(uint8_t *absence, uint8_t bin) {
+    // Bounded counts: halve everything when a bin fills, so recent
+    // routine outweighs old habits.
+    if (absence[bin] >= ABSENCE_COUNT_MAX) {
+        for (uint8_t i = 0; i < ABSENCE_BINS; i++) {
+            absence[i] /= 2;
+        }
+    }
+    absence[bin]++;
+}
+
+float SignalMonitor::getLogLikelihood() const {
+    float best = llr_[0];
+    for (uint8_t s = 1; s < 4; s++) {
+        if (llr_[s] > best) best = llr_[s];
+    }
+    return best;
+}
+
+float SignalMonitor::getPresentThreshold() const {
+    return llrPresent_;
+}
+
+float SignalMonitor::getAbsentThreshold() const {
+    return llrAbsent_;
+}
+
 MonitorState SignalMonitor::getState() const {
     return state_;
 }
@@ -76,26 +201,140 @@ bool SignalMonitor::stateChanged() const {
 }
 
 void SignalMonitor::updateStatusLED() {
+    if (state_ != MonitorState::SEARCHING && sched_) {
+        sched_->cancel(blinkJob_);
+        blinkJob_ = Scheduler::INVALID_JOB;
+    }
+
     switch (state_) {
         case MonitorState::TRACKING:
             // Solid ON.
-            digitalWrite(PIN_STATUS_LED, HIGH);
+            Hal::digitalWrite(PIN_STATUS_LED, HIGH);
             break;
 
         case MonitorState::SEARCHING: {
-            // Slow blink (500 ms on, 500 ms off).
-            unsigned long now = millis();
-            if ((now - lastBlinkMs_) >= 500) {
-                ledState_ = !ledState_;
-                lastBlinkMs_ = now;
+            // Slow blink (STATUS_BLINK_MS on, STATUS_BLINK_MS off).
+            uint32_t now = Hal::millis();
+            if (!sched_) {
+                if ((now - lastBlinkMs_) >= STATUS_BLINK_MS) {
+                    blink(now);
+                } else {
+                    Hal::digitalWrite(PIN_STATUS_LED, ledState_ ? HIGH : LOW);
+                }
+                break;
+            }
+
+            // Scheduled: same toggle times as polling, no per-tick check.
+            if (sched_->isPending(blinkJob_)) break;
+            if ((now - lastBlinkMs_) >= STATUS_BLINK_MS) {
+                blink(now);
+            } else {
+                Hal::digitalWrite(PIN_STATUS_LED, ledState_ ? HIGH : LOW);
             }
-            digitalWrite(PIN_STATUS_LED, ledState_ ? HIGH : LOW);
+            blinkJob_ = sched_->at(lastBlinkMs_ + STATUS_BLINK_MS, onBlinkDue, this);
             break;
         }
 
         case MonitorState::PARKED:
             // OFF.
-            digitalWrite(PIN_STATUS_LED, LOW);
+            Hal::digitalWrite(PIN_STATUS_LED, LOW);
             break;
     }
 }
+
+void SignalMonitor::setScheduler(Scheduler *sched) {
+    if (sched_) sched_->cancel(blinkJob_);
+    blinkJob_ = Scheduler::INVALID_JOB;
+    sched_    = sched;
+}
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+void SignalMonitor::blink(uint32_t now) {
+    ledState_    = !ledState_;
+    lastBlinkMs_ = now;
+    Hal::digitalWrite(PIN_STATUS_LED, ledState_ ? HIGH : LOW);
+}
+
+void SignalMonitor::onBlinkDue(void *self) {
+    SignalMonitor *m = static_cast<SignalMonitor *>(self);
+    m->blink(Hal::millis());
+    m->blinkJob_ = m->sched_->at(m->lastBlinkMs_ + STATUS_BLINK_MS, onBlinkDue, m);
+}
+
+void SignalMonitor::adaptTimeouts() {
+    deriveTimeouts(absence_, adaptive_, parkMs_, holdMs_);
+}
+
+void SignalMonitor::deriveTimeouts(const uint8_t *absence, bool adaptive,
+                                   uint32_t &parkMs, uint32_t &holdMs) {
+    parkMs = SIGNAL_LOSS_PARK_MS;
+    holdMs = 0;
+    if (!adaptive) return;
+
+    uint16_t total = 0;
+    for (uint8_t i = 0; i < ABSENCE_BINS; i++) {
+        total += absence[i];
+    }
+    if (total < ABSENCE_MIN_SAMPLES) return;
+
+    // Park timeout: the candidate (clamp limits and bin edges) with the
+    // lowest expected cost.  An absence shorter than T costs its own
+    // duration in servo-on time; a longer one costs T plus a full
+    // park / unpark cycle.  Ties go to the shorter timeout.
+    float bestCost = 0.0f;
+    uint32_t bestT = 0;
+    for (uint8_t c = 0; c <= ABSENCE_BINS; c++) {
+        uint32_t T;
+        if (c == 0) {
+            T = ADAPT_PARK_MIN_MS;
+        } else if (c == ABSENCE_BINS) {
+            T = ADAPT_PARK_MAX_MS;
+        } else {
+            T = 1000UL << c;   // upper edge of bin c − 1
+            if (T <= ADAPT_PARK_MIN_MS || T >= ADAPT_PARK_MAX_MS) continue;
+        }
+
+        float cost = 0.0f;
+        for (uint8_t i = 0; i < ABSENCE_BINS; i++) {
+            if (absence[i] == 0) continue;
+            float d = absenceBinMs(i);
+            cost += absence[i] * ((d <= T) ? d
+                                           : static_cast<float>(T + ABSENCE_UNPARK_COST_MS));
+        }
+        if (bestT == 0 || cost < bestCost) {
+            bestCost = cost;
+            bestT    = T;
+        }
+    }
+    parkMs = bestT;
+
+    // Hold: ADAPT_HOLD_QUANTILE of the absences that end before the park
+    // timeout, rounded up to the end of its bin.
+    uint16_t shortTotal = 0;
+    for (uint8_t i = 0; i < ABSENCE_BINS; i++) {
+        if (absenceBinMs(i) <= parkMs) shortTotal += absence[i];
+    }
+    if (shortTotal == 0) return;
+
+    uint16_t seen = 0;
+    for (uint8_t i = 0; i < ABSENCE_BINS; i++) {
+        if (absenceBinMs(i) > parkMs) continue;
+        seen += absence[i];
+        if (seen >= ADAPT_HOLD_QUANTILE * shortTotal) {
+            uint32_t upper = 1000UL << (i + 1);
+            holdMs = upper;
+            if (holdMs > parkMs)            holdMs = parkMs;
+            if (holdMs > ADAPT_HOLD_MAX_MS) holdMs = ADAPT_HOLD_MAX_MS;
+            return;
+        }
+    }
+}
+
+float SignalMonitor::absenceBinMs(uint8_t bin) {
+    if (bin == 0) return 1000.0f;                      // middle of [0, 2) s
+    if (bin >= ABSENCE_BINS - 1) return INFINITY;      // open-ended
+    return 1414.2f * static_cast<float>(1UL << bin);   // geometric middle
+}
@@ -0,0 +1,263 @@
+/**
+ * @file telemetry_stream.cpp
+ * @brief Telemetry record packing, CRC-16, COBS, stream and decoder.
+ */
+
+#include "telemetry_stream.h"
+#include <stdio.h>
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+static void putU16(uint8_t *p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+static void putU32(uint8_t *p, uint32_t v) {
+    putU16(p, static_cast<uint16_t>(v));
+    putU16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+static uint16_t getU16(const uint8_t *p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t getU32(const uint8_t *p) {
+    return getU16(p) | (static_cast<uint32_t>(getU16(p + 2)) << 16);
+}
+
+// ===================================================================
+// TelemetryCodec
+// ===================================================================
+
+void TelemetryCodec::pack(const TelemetryRecord &rec, uint8_t *out) {
+    out[0] = TelemetryRecord::VERSION;
+    putU16(out + 1, rec.seq);
+    putU32(out + 3, rec.tUs);
+    out[7] = rec.rawBits;
+    out[8] = rec.filtered;
+    uint8_t samples = rec.samples > TelemetryRecord::MAX_SAMPLES ? TelemetryRecord::MAX_SAMPLES
+                                                                  : rec.samples;
+    out[9] = static_cast<uint8_t>((rec.state & 0x0F) | (samples << 4) |
+                                  (rec.transition ? 0x80 : 0));
+    putU16(out + 10, static_cast<uint16_t>(rec.panCdeg));
+    putU16(out + 12, static_cast<uint16_t>(rec.panCmd));
+    putU16(out + 14, static_cast<uint16_t>(rec.tiltDeg));
+    putU16(out + 16, rec.loopUs);
+}
+
+bool TelemetryCodec::unpack(const uint8_t *in, size_t len, TelemetryRecord &rec) {
+    if (len != TelemetryRecord::BYTES || in[0] != TelemetryRecord::VERSION) return false;
+
+    rec.seq        = getU16(in + 1);
+    rec.tUs        = getU32(in + 3);
+    rec.rawBits    = in[7];
+    rec.filtered   = in[8];
+    rec.state      = in[9] & 0x0F;
+    rec.samples    = (in[9] >> 4) & 0x07;
+    rec.transition = (in[9] & 0x80) != 0;
+    rec.panCdeg    = static_cast<int16_t>(getU16(in + 10));
+    rec.panCmd     = static_cast<int16_t>(getU16(in + 12));
+    rec.tiltDeg    = static_cast<int16_t>(getU16(in + 14));
+    rec.loopUs     = getU16(in + 16);
+    return true;
+}
+
+uint16_t TelemetryCodec::crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= static_cast<uint16_t>(data[i] << 8);
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                 : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+size_t TelemetryCodec::cobsEncode(const uint8_t *in, size_t len, uint8_t *out) {
+    size_t  codePos = 0;   // Where the current block's length byte goes
+    size_t  o       = 1;
+    uint8_t code    = 1;
+
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[codePos] = code;
+            codePos = o++;
+            code = 1;
+            continue;
+        }
+        out[o++] = in[i];
+        if (++code == 0xFF) {   // Full block: 254 data bytes, no implied zero
+            out[codePos] = code;
+            codePos = o++;
+            code = 1;
+        }
+    }
+    out[codePos] = code;
+    return o;
+}
+
+size_t TelemetryCodec::cobsDecode(const uint8_t *in, size_t len, uint8_t *out,
+                                  size_t outMax) {
+    size_t i = 0;
+    size_t o = 0;
+    while (i < len) {
+        uint8_t code = in[i++];
+        if (code == 0 || i + code - 1 > len) return 0;
+
+        for (uint8_t k = 1; k < code; k++) {
+            if (in[i] == 0 || o >= outMax) return 0;
+            out[o++] = in[i++];
+        }
+        // Implied zero between blocks (not after a full one, nor at the end).
+        if (code != 0xFF && i < len) {
+            if (o >= outMax) return 0;
+            out[o++] = 0;
+        }
+    }
+    return o;
+}
+
+size_t TelemetryCodec::encodeFrame(const TelemetryRecord &rec, uint8_t *out) {
+    uint8_t raw[TelemetryRecord::BYTES];
+    pack(rec, raw);
+    return encodePayload(raw, sizeof(raw), out);
+}
+
+size_t TelemetryCodec::encodePayload(const uint8_t *payload, size_t len, uint8_t *out) {
+    uint8_t raw[MAX_PAYLOAD + 2];
+    for (size_t i = 0; i < len; i++) raw[i] = payload[i];
+    putU16(raw + len, crc16(payload, len));
+
+    size_t n = cobsEncode(raw, len + 2, out);
+    out[n++] = 0x00;
+    return n;
+}
+
+size_t TelemetryCodec::decodePayload(const uint8_t *in, size_t len, uint8_t *out,
+                                     size_t outMax) {
+    uint8_t raw[MAX_PAYLOAD + 2];
+    size_t max = outMax + 2 < sizeof(raw) ? outMax + 2 : sizeof(raw);
+    size_t n = cobsDecode(in, len, raw, max);
+    if (n < 2) return 0;
+
+    n -= 2;
+    if (crc16(raw, n) != getU16(raw + n)) return 0;
+    for (size_t i = 0; i < n; i++) out[i] = raw[i];
+    return n;
+}
+
+const char *const TelemetryCodec::CSV_HEADER =
+    "seq,t_us,raw_t,raw_b,raw_l,raw_r,filt_t,filt_b,filt_l,filt_r,"
+    "state,transition,pan_deg,pan_cmd,tilt_deg,loop_us";
+
+int TelemetryCodec::csvRow(const TelemetryRecord &r, const char *stateName,
+                           char *out, size_t outLen) {
+    return snprintf(out, outLen, "%u,%lu,%u,%u,%u,%u,%u,%u,%u,%u,%s,%u,%.2f,%.4f,%d,%u",
+                    r.seq, static_cast<unsigned long>(r.tUs),
+                    r.rawBits & 1, (r.rawBits >> 1) & 1, (r.rawBits >> 2) & 1, (r.rawBits >> 3) & 1,
+                    r.filtered & 3, (r.filtered >> 2) & 3, (r.filtered >> 4) & 3, (r.filtered >> 6) & 3,
+                    stateName, r.transition ? 1 : 0,
+                    r.panCdeg / 100.0, r.panCmd / 10000.0, r.tiltDeg, r.loopUs);
+}
+
+// ===================================================================
+// TelemetryStream
+// ===================================================================
+
+bool TelemetryStream::push(const TelemetryRecord &rec) {
+    uint8_t frame[TelemetryCodec::FRAME_BYTES];
+    size_t n = TelemetryCodec::encodeFrame(rec, frame);
+    return pushFrame(frame, n);
+}
+
+bool TelemetryStream::pushFrame(const uint8_t *frame, size_t len) {
+    // Whole frame or nothing, so the receiver never sees a torn one.
+    size_t room = static_cast<size_t>(ring_.capacity() - ring_.size());
+    if (room < len) {
+        drops_++;
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        ring_.push(frame[i]);
+    }
+    frames_++;
+    return true;
+}
+
+size_t TelemetryStream::drain(WriteFn write, void *ctx, size_t maxBytes) {
+    uint8_t chunk[64];
+    size_t total = 0;
+
+    while (total < maxBytes) {
+        size_t want = maxBytes - total;
+        if (want > sizeof(chunk)) want = sizeof(chunk);
+
+        size_t n = 0;
+        while (n < want && ring_.pop(chunk[n])) n++;
+        if (n == 0) break;
+
+        size_t took = write(chunk, n, ctx);
+        total += took;
+        if (took < n) {
+            // Sink refused the rest: those bytes are lost, and the
+            // receiver rejects the torn frame on its CRC.
+            break;
+        }
+    }
+    return total;
+}
+
+uint16_t TelemetryStream::queued() const {
+    return ring_.size();
+}
+
+uint32_t TelemetryStream::frames() const {
+    return frames_;
+}
+
+uint32_t TelemetryStream::drops() const {
+    return drops_;
+}
+
+// ===================================================================
+// TelemetryDecoder
+// ===================================================================
+
+bool TelemetryDecoder::feed(uint8_t b, TelemetryRecord &out) {
+    if (b != 0x00) {
+        if (len_ < MAX_ENCODED) {
+            buf_[len_++] = b;
+        } else {
+            overflow_ = true;
+        }
+        return false;
+    }
+
+    // Delimiter: check what came before it.
+    size_t len = len_;
+    bool overflow = overflow_;
+    len_ = 0;
+    overflow_ = false;
+    if (len == 0 && !overflow) return false;   // Back-to-back delimiters
+
+    uint8_t raw[TelemetryRecord::BYTES];
+    size_t n = overflow ? 0 : TelemetryCodec::decodePayload(buf_, len, raw, sizeof(raw));
+    if (!TelemetryCodec::unpack(raw, n, out)) {
+        bad_++;
+        return false;
+    }
+    records_++;
+    return true;
+}
+
+uint32_t TelemetryDecoder::records() const {
+    return records_;
+}
+
+uint32_t TelemetryDecoder::badFrames() const {
+    return bad_;
+}
@@ -1,57 +1,101 @@
 /**
- * @file tilt_controller.h
- * @brief Standard 180° servo wrapper for the tilt (vertical) axis.
- *
- * Wraps an MG996R standard servo with:
- *   - Clamped angle range (TILT_MIN_DEG … TILT_MAX_DEG)
- *   - Incremental nudge with rate limiting (Issue #8)
- *   - Park-to-home convenience method
- *
- * Fix: currentAngle_ is now int16_t to avoid subtle signed/unsigned
- *      issues when nudging near the lower bound.
+ * @file tilt_controller.cpp
+ * @brief Standard-servo tilt control with clamping and rate limiting.
  */
 
-#ifndef TILT_CONTROLLER_H
-#define TILT_CONTROLLER_H
-
-#include <ESP32Servo.h>
-#include <stdint.h>
-
-class TiltController {
-public:
-    /** @brief Attach servo and move to TILT_HOME_DEG. */
-    void init();
-
-    /**
-     * @brief Set absolute tilt angle.
-     * @param degrees  Target angle, clamped to [TILT_MIN_DEG, TILT_MAX_DEG].
-     */
-    void setAngle(int16_t degrees);
-
-    /**
-     * @brief Incremental adjustment, respecting rate limit.
-     *
-     * Moves the tilt by @p delta degrees (positive = up, negative = down),
-     * but only if at least TILT_HOLDOFF_MS have elapsed since the last step.
-     *
-     * @param delta  Signed step in degrees.  Magnitude is clamped to TILT_STEP_DEG.
-     * @return true if the step was applied, false if rate-limited (too soon).
-     */
-    bool nudge(int8_t delta);
-
-    /** @brief Return current tilt angle (degrees). */
-    int16_t getAngle() const;
-
-    /** @brief Move to TILT_HOME_DEG. */
-    void parkHome();
-
-    /** @brief Move to TILT_SCAN_DEG (used during SEARCHING state). */
-    void goScanPosition();
-
-private:
-    Servo servo_;
-    int16_t currentAngle_ = 0;
-    unsigned long lastStepMs_ = 0;   ///< millis() of last nudge application
-};
-
-#endif // TILT_CONTROLLER_H
+#include "tilt_controller.h"
+#include "config.h"
+#include "hal.h"
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+void TiltController::init() {
+    currentAngle_ = TILT_HOME_DEG;
+    out_.attach(PIN_TILT_SERVO, angleToMicroseconds(currentAngle_));
+    lastStepMs_ = 0;
+}
+
+void TiltController::setAngle(int16_t degrees) {
+    if (degrees < TILT_MIN_DEG) degrees = TILT_MIN_DEG;
+    if (degrees > TILT_MAX_DEG) degrees = TILT_MAX_DEG;
+
+    currentAngle_ = degrees;
+    out_.write(angleToMicroseconds(currentAngle_));
+}
+
+bool TiltController::nudge(int8_t delta) {
+    uint32_t now = Hal::millis();
+
+    // Rate limit: let the head settle between steps (Issue #8).
+    if ((now - lastStepMs_) < TILT_HOLDOFF_MS) {
+        return false;
+    }
+
+    if (delta >  static_cast<int8_t>(TILT_STEP_DEG)) delta =  TILT_STEP_DEG;
+    if (delta < -static_cast<int8_t>(TILT_STEP_DEG)) delta = -TILT_STEP_DEG;
+
+    setAngle(currentAngle_ + delta);
+    lastStepMs_ = now;
+    return true;
+}
+
+bool TiltController::stepToward(int16_t target, uint8_t maxStep) {
+    if (target < TILT_MIN_DEG) target = TILT_MIN_DEG;
+    if (target > TILT_MAX_DEG) target = TILT_MAX_DEG;
+
+    int16_t error = target - currentAngle_;
+    if (error == 0) {
+        return true;
+    }
+
+    if (error >  maxStep) error =  maxStep;
+    if (error < -maxStep) error = -maxStep;
+
+    setAngle(currentAngle_ + error);
+    return currentAngle_ == target;
+}
+
+int16_t TiltController::getAngle() const {
+    return currentAngle_;
+}
+
+bool TiltController::parkHome() {
+    return stepToward(TILT_HOME_DEG, PARK_TILT_STEP_DEG);
+}
+
+void TiltController::goScanPosition() {
+    setAngle(TILT_SCAN_DEG);
+}
+
+void TiltController::serviceOutput() {
+    out_.service();
+}
+
+void TiltController::powerDown() {
+    out_.powerDown();
+}
+
+void TiltController::wake() {
+    out_.powerUp();
+}
+
+bool TiltController::isPoweredDown() const {
+    return out_.isPoweredDown();
+}
+
+const ServoOutput &TiltController::output() const {
+    return out_;
+}
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+uint16_t TiltController::angleToMicroseconds(int16_t degrees) {
+    // Same linear map Servo::write() applies for 0–180°.
+    return static_cast<uint16_t>(
+        SERVO_MIN_PULSE_US +
+        (static_cast<int32_t>(degrees) * (SERVO_MAX_PULSE_US - SERVO_MIN_PULSE_US)) / 180);
+}
@@ -6,7 +6,7 @@
  *
  * Fix: The pan speed heuristic now uses a time-based memory of when the
  * opposing horizontal sensor was last active.  If the other side fired
- * recently (within APPROACH_MEMORY_MS), the beacon must be near center,
+ * recently (within TRACK_APPROACH_MEMORY_MS), the beacon must be near center,
  * so we slow down for smooth convergence.  This replaces the previous
  * approach of checking vertical sensors, which was unreliable when the
  * beacon was at a different height than the sensor cross.
@@ -14,7 +14,7 @@
 
 #include "tracking_engine.h"
 #include "config.h"
-#include <Arduino.h>
+#include "hal.h"
 
 // ===================================================================
 // Public API
@@ -23,8 +23,11 @@
 void TrackingEngine::init(PanController *pan, TiltController *tilt) {
     pan_  = pan;
     tilt_ = tilt;
-    lastLeftActiveMs_  = 0;
-    lastRightActiveMs_ = 0;
+    // Neither side seen yet: "long ago", not at millis() == 0 (which is
+    // recent at boot and again each time the clock wraps).
+    lastLeftActiveMs_  = Hal::millis() - TRACK_APPROACH_MEMORY_MS;
+    lastRightActiveMs_ = lastLeftActiveMs_;
+    gains_ = {TRACK_PAN_SPEED_FAST, TRACK_PAN_SPEED_SLOW};
 }
 
 void TrackingEngine::update(const SensorReading &reading) {
@@ -46,12 +49,20 @@ void TrackingEngine::halt() {
     // Tilt holds its last angle automatically (standard servo).
 }
 
+void TrackingEngine::setGains(const TrackingGains &gains) {
+    gains_ = gains;
+}
+
+const TrackingGains &TrackingEngine::getGains() const {
+    return gains_;
+}
+
 // ===================================================================
 // Private helpers
 // ===================================================================
 
 float TrackingEngine::computePanSpeed(const SensorReading &reading) {
-    unsigned long now = millis();
+    uint32_t now = Hal::millis();
 
     bool left  = (reading.left  == SensorState::ACTIVE);
     bool right = (reading.right == SensorState::ACTIVE);
@@ -70,13 +81,13 @@ float TrackingEngine::computePanSpeed(const SensorReading &reading) {
     bool nearCenter = false;
     if (left) {
         // Beacon is to the left; was the RIGHT sensor active recently?
-        nearCenter = (now - lastRightActiveMs_) < APPROACH_MEMORY_MS;
+        nearCenter = (now - lastRightActiveMs_) < TRACK_APPROACH_MEMORY_MS;
     } else {
         // Beacon is to the right; was the LEFT sensor active recently?
-        nearCenter = (now - lastLeftActiveMs_) < APPROACH_MEMORY_MS;
+        nearCenter = (now - lastLeftActiveMs_) < TRACK_APPROACH_MEMORY_MS;
     }
 
-    float speed = nearCenter ? TRACK_PAN_SPEED_SLOW : TRACK_PAN_SPEED_FAST;
+    float speed = nearCenter ? gains_.panSlow : gains_.panFast;
 
     // Convention: negative = left (CCW), positive = right (CW).
     if (left) {
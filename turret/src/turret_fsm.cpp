@@ -0,0 +1,353 @@
+/**
+ * @file turret_fsm.cpp
+ * @brief Compile-time flattened transition table and per-state handlers.
+ */
+
+#include "turret_fsm.h"
+#include "config.h"
+#include "profiler.h"
+#include "hal.h"
+
+// ===================================================================
+// Compile-time dispatch table
+// ===================================================================
+
+static constexpr uint8_t STATE_COUNT = static_cast<uint8_t>(TurretState::COUNT);
+static constexpr uint8_t EVENT_COUNT = static_cast<uint8_t>(TurretEvent::COUNT);
+
+/** @brief [leaf][event] → next leaf (COUNT = unhandled). */
+struct DispatchTable {
+    TurretState next[STATE_COUNT][EVENT_COUNT];
+};
+
+/**
+ * @brief Flatten TRANSITIONS: a leaf's own rows first, then rows inherited
+ *        from its super-state.
+ */
+static constexpr DispatchTable buildDispatch() {
+    DispatchTable t{};
+    for (uint8_t s = 0; s < STATE_COUNT; s++) {
+        for (uint8_t e = 0; e < EVENT_COUNT; e++) {
+            t.next[s][e] = TurretState::COUNT;
+        }
+    }
+    for (uint8_t s = 0; s < STATE_COUNT; s++) {
+        TurretState leaf   = static_cast<TurretState>(s);
+        TurretState parent = TurretStateMachine::parentOf(leaf);
+        for (const auto &row : TurretStateMachine::TRANSITIONS) {
+            if (row.from == leaf) {
+                t.next[s][static_cast<uint8_t>(row.event)] = row.to;
+            }
+        }
+        if (parent == TurretState::COUNT) continue;
+        for (const auto &row : TurretStateMachine::TRANSITIONS) {
+            uint8_t e = static_cast<uint8_t>(row.event);
+            if (row.from == parent && t.next[s][e] == TurretState::COUNT) {
+                t.next[s][e] = row.to;
+            }
+        }
+    }
+    return t;
+}
+
+/** @brief Every row targets a leaf and no (from, event) pair repeats. */
+static constexpr bool tableIsWellFormed() {
+    const auto &rows = TurretStateMachine::TRANSITIONS;
+    for (uint8_t i = 0; i < TurretStateMachine::TRANSITION_COUNT; i++) {
+        if (rows[i].to == TurretState::TRACKING) return false;
+        for (uint8_t j = i + 1; j < TurretStateMachine::TRANSITION_COUNT; j++) {
+            if (rows[i].from == rows[j].from && rows[i].event == rows[j].event) return false;
+        }
+    }
+    return true;
+}
+
+static_assert(tableIsWellFormed(), "TRANSITIONS: duplicate row or super-state target");
+
+static constexpr DispatchTable DISPATCH = buildDispatch();
+
+// ===================================================================
+// Handler table
+// ===================================================================
+
+const TurretStateMachine::Handlers TurretStateMachine::HANDLERS[STATE_COUNT] = {
+    /* TRACKING  */ { enterTracking,  exitTracking, nullptr       },
+    /* ACQUIRING */ { enterAcquiring, nullptr,      tickTracker   },
+    /* LOCKED    */ { enterLocked,    nullptr,      tickTracker   },
+    /* COASTING  */ { enterCoasting,  nullptr,      tickCoasting  },
+    /* SEARCHING */ { enterSearching, nullptr,      tickSearching },
+    /* PARKED    */ { enterParked,    nullptr,      tickParked    },
+};
+
+// ===================================================================
+// Public API
+// ===================================================================
+
+TurretState TurretStateMachine::lookup(TurretState s, TurretEvent e) {
+    return DISPATCH.next[static_cast<uint8_t>(s)][static_cast<uint8_t>(e)];
+}
+
+const char *TurretStateMachine::stateName(TurretState s) {
+    switch (s) {
+        case TurretState::TRACKING:  return "TRACK";
+        case TurretState::ACQUIRING: return "ACQUIRE";
+        case TurretState::LOCKED:    return "LOCK";
+        case TurretState::COASTING:  return "COAST";
+        case TurretState::SEARCHING: return "SEARCH";
+        case TurretState::PARKED:    return "PARK";
+        default:                     return "?";
+    }
+}
+
+void TurretStateMachine::init(const TurretContext &ctx) {
+    ctx_      = ctx;
+    state_    = TurretState::ACQUIRING;
+    previous_ = TurretState::COUNT;
+    changed_  = false;
+    runEntry(TurretState::TRACKING);
+    runEntry(TurretState::ACQUIRING);
+}
+
+void TurretStateMachine::update(const SensorReading &reading) {
+    changed_ = false;
+
+    // 1. Monitor decisions.
+    if (ctx_.monitor && ctx_.monitor->stateChanged()) {
+        switch (ctx_.monitor->getState()) {
+            case MonitorState::TRACKING:  dispatch(TurretEvent::PRESENT); break;
+            case MonitorState::SEARCHING: dispatch(TurretEvent::LOST);    break;
+            case MonitorState::PARKED:    dispatch(TurretEvent::PARK);    break;
+        }
+    }
+
+    // 2. Sensor-derived events within TRACKING.
+    if (isIn(TurretState::TRACKING)) {
+        deriveSensorEvents(reading);
+    }
+
+    // 3. Tick the current state.
+    const Handlers &h = HANDLERS[static_cast<uint8_t>(state_)];
+    if (h.tick) h.tick(*this, reading);
+}
+
+bool TurretStateMachine::dispatch(TurretEvent e) {
+    TurretState next = lookup(state_, e);
+    if (next == TurretState::COUNT) return false;
+
+    TurretState from      = state_;
+    TurretState oldParent = parentOf(from);
+    TurretState newParent = parentOf(next);
+
+    runExit(from);
+    if (oldParent != newParent && oldParent != TurretState::COUNT) {
+        runExit(oldParent);
+    }
+
+    previous_ = from;
+    state_    = next;
+    changed_  = true;
+
+    if (oldParent != newParent && newParent != TurretState::COUNT) {
+        runEntry(newParent);
+    }
+    runEntry(next);
+    return true;
+}
+
+TurretState TurretStateMachine::state() const {
+    return state_;
+}
+
+TurretState TurretStateMachine::previous() const {
+    return previous_;
+}
+
+bool TurretStateMachine::isIn(TurretState s) const {
+    return state_ == s || parentOf(state_) == s;
+}
+
+bool TurretStateMachine::changed() const {
+    return changed_;
+}
+
+// ===================================================================
+// Private helpers
+// ===================================================================
+
+void TurretStateMachine::deriveSensorEvents(const SensorReading &r) {
+    uint32_t now = Hal::millis();
+
+    // Blank: coast only once it has lasted COAST_DEBOUNCE_MS.  Until then
+    // the sub-state and its dwell timers carry on as if nothing happened.
+    if (r.noneActive()) {
+        if (state_ == TurretState::COASTING) return;
+        if (!blank_) {
+            blank_        = true;
+            blankSinceMs_ = now;
+        }
+        if ((now - blankSinceMs_) >= COAST_DEBOUNCE_MS) {
+            dispatch(TurretEvent::DROPOUT);
+        }
+        return;
+    }
+    blank_ = false;
+
+    if (state_ == TurretState::COASTING) {
+        dispatch(coastFrom_ == TurretState::LOCKED ? TurretEvent::RELOCKED
+                                                   : TurretEvent::REGAINED);
+        return;
+    }
+
+    bool left  = (r.left  == SensorState::ACTIVE);
+    bool right = (r.right == SensorState::ACTIVE);
+
+    if (state_ == TurretState::ACQUIRING) {
+        if (left && right) {
+            if (!centered_) {
+                centered_        = true;
+                centeredSinceMs_ = now;
+            } else if ((now - centeredSinceMs_) >= LOCK_CENTERED_MS) {
+                dispatch(TurretEvent::CENTERED);
+            }
+        } else {
+            centered_ = false;
+        }
+    } else if (state_ == TurretState::LOCKED) {
+        if (left != right) {
+            if (!oneSided_) {
+                oneSided_        = true;
+                oneSidedSinceMs_ = now;
+            } else if ((now - oneSidedSinceMs_) >= LOCK_BREAK_MS) {
+                dispatch(TurretEvent::OFF_CENTER);
+            }
+        } else {
+            oneSided_ = false;
+        }
+    }
+}
+
+void TurretStateMachine::runEntry(TurretState s) {
+    const Handlers &h = HANDLERS[static_cast<uint8_t>(s)];
+    if (h.entry) h.entry(*this);
+}
+
+void TurretStateMachine::runExit(TurretState s) {
+    const Handlers &h = HANDLERS[static_cast<uint8_t>(s)];
+    if (h.exit) h.exit(*this);
+}
+
+// --- TRACKING (super-state) ---
+
+void TurretStateMachine::enterTracking(TurretStateMachine &m) {
+    TurretContext &c = m.ctx_;
+
+    // Coming from PARKED: re-attach before the tracker's first command.
+    // The estimate is kept, complete park or not: nothing moves the fan
+    // while it is powered down, and re-zeroing would throw away the
+    // residual the park stopped within (up to PARK_HOME_TOLERANCE_DEG,
+    // usually on the same side), one park after another.
+    if (m.previous_ == TurretState::PARKED) {
+        c.pan->wake();
+        c.tilt->wake();
+        c.parker->cancel();
+    }
+
+    // Reacquisition: remember where the beacon turned up.
+    if (m.previous_ == TurretState::SEARCHING || m.previous_ == TurretState::PARKED) {
+        c.prior->recordAcquired(c.pan->getPositionDeg(), c.tilt->getAngle());
+    }
+    m.blank_      = false;
+    m.trackSpeed_ = 0.0f;
+}
+
+void TurretStateMachine::exitTracking(TurretStateMachine &m) {
+    TurretContext &c = m.ctx_;
+
+    // Stop the tracker cleanly and restore the default filter / gains
+    // before the search or park takes over.
+    c.tracker->halt();
+    c.tracker->setGains({TRACK_PAN_SPEED_FAST, TRACK_PAN_SPEED_SLOW});
+    c.sensors->setFilterThreshold(SENSOR_FILTER_THRESHOLD);
+}
+
+// --- Tracking sub-states ---
+
+void TurretStateMachine::enterAcquiring(TurretStateMachine &m) {
+    m.ctx_.sensors->setFilterThreshold(ACQUIRE_FILTER_THRESHOLD);
+    m.ctx_.tracker->setGains({TRACK_PAN_SPEED_FAST, TRACK_PAN_SPEED_SLOW});
+    m.centered_ = false;
+    m.oneSided_ = false;
+}
+
+void TurretStateMachine::enterLocked(TurretStateMachine &m) {
+    m.ctx_.sensors->setFilterThreshold(LOCK_FILTER_THRESHOLD);
+    m.ctx_.tracker->setGains({LOCK_PAN_SPEED_FAST, LOCK_PAN_SPEED_SLOW});
+    m.centered_ = false;
+    m.oneSided_ = false;
+}
+
+void TurretStateMachine::enterCoasting(TurretStateMachine &m) {
+    // Decay from the first blank tick: the debounce is part of the coast.
+    m.coastSpeed_   = m.trackSpeed_;
+    m.coastStartMs_ = m.blank_ ? m.blankSinceMs_ : Hal::millis();
+    m.coastFrom_    = m.previous_;
+}
+
+void TurretStateMachine::tickTracker(TurretStateMachine &m, const SensorReading &r) {
+    ProfScope prof(ProfStage::TRACKER);
+    m.ctx_.tracker->update(r);
+
+    // Blank, the tracker stops the pan ("no info → hold"); COASTING picks
+    // up the speed from before the blank if it lasts.
+    if (!m.blank_) m.trackSpeed_ = m.ctx_.pan->getSpeed();
+}
+
+void TurretStateMachine::tickCoasting(TurretStateMachine &m, const SensorReading &) {
+    // Carry on in the last direction, decaying linearly to a stop; tilt
+    // holds.  Below PAN_MIN_SPEED the pan controller stops by itself.
+    uint32_t elapsed = Hal::millis() - m.coastStartMs_;
+    float remaining = (elapsed >= COAST_MAX_MS)
+                          ? 0.0f
+                          : 1.0f - static_cast<float>(elapsed) / COAST_MAX_MS;
+    m.ctx_.pan->setSpeed(m.coastSpeed_ * remaining);
+}
+
+// --- SEARCHING ---
+
+void TurretStateMachine::enterSearching(TurretStateMachine &m) {
+    TurretContext &c = m.ctx_;
+
+    // The tracker held the pan where the beacon was last seen.
+    if (parentOf(m.previous_) == TurretState::TRACKING) {
+        c.prior->recordLost(c.pan->getPositionDeg(), c.tilt->getAngle());
+    }
+
+    // Last-known bearing first (held for as long as absences usually
+    // last), then learned bearings, then the exhaustive pattern.
+    c.search->begin(c.pan->getPositionDeg(), c.monitor->getHoldMs());
+}
+
+void TurretStateMachine::tickSearching(TurretStateMachine &m, const SensorReading &) {
+    m.ctx_.search->update();
+}
+
+// --- PARKED ---
+
+void TurretStateMachine::enterParked(TurretStateMachine &m) {
+    TurretContext &c = m.ctx_;
+
+    // The park planner drives both axes home from the next tick; stop
+    // whatever the search was commanding so no stale speed lingers.
+    c.tracker->halt();
+    c.parker->begin();
+
+    if (c.onParked) c.onParked();
+}
+
+void TurretStateMachine::tickParked(TurretStateMachine &m, const SensorReading &) {
+    TurretContext &c = m.ctx_;
+    if (c.parker->update() && c.parker->isSettled()) {
+        c.pan->powerDown();
+        c.tilt->powerDown();
+    }
+}
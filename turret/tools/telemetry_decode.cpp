@@ -0,0 +1,109 @@
+/**
+ * @file telemetry_decode.cpp
+ * @brief Host tool: binary turret telemetry capture → CSV, or → a
+ *        fixed-record log for telemetry_stats.
+ *
+ * Build (from turret/):
+ *
+ *     g++ -std=c++17 -O2 -Iinclude -Itools tools/telemetry_decode.cpp \
+ *         tools/telemetry_log.cpp src/telemetry_stream.cpp \
+ *         src/session_capture.cpp -o telemetry_decode
+ *
+ * Capture the raw serial stream and decode it:
+ *
+ *     stty -F /dev/ttyUSB0 115200 raw && cat /dev/ttyUSB0 > capture.bin
+ *     ./telemetry_decode capture.bin > capture.csv
+ *     ./telemetry_decode --log capture.tlog capture.bin
+ *
+ * With no file argument it reads stdin, so it can also sit on the end of
+ * the pipe live.  Text between frames (boot banner, 'j' / 'p' / 'l' replies)
+ * is skipped; the counts of records, rejected chunks and sequence gaps
+ * go to stderr at the end.  A session capture (session_capture.h)
+ * decodes the same way, one row per captured tick.
+ *
+ * Columns: TelemetryCodec::CSV_HEADER — the same as the flight
+ * recorder dump printed at boot after a reset.
+ *
+ * --log FILE writes the records to FILE in the fixed-record layout
+ * (telemetry_log.h) instead of CSV: the clock unwrapped, reboots and
+ * sequence gaps flagged, ready for telemetry_stats.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "telemetry_stream.h"
+#include "session_capture.h"
+#include "telemetry_log.h"
+
+int main(int argc, char **argv) {
+    const char *inPath  = nullptr;
+    const char *logPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--log") == 0 && i + 1 < argc) {
+            logPath = argv[++i];
+        } else if (!inPath && argv[i][0] != '-') {
+            inPath = argv[i];
+        } else {
+            fprintf(stderr, "usage: %s [--log OUT.tlog] [CAPTURE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    FILE *in = stdin;
+    if (inPath) {
+        in = fopen(inPath, "rb");
+        if (!in) {
+            perror(inPath);
+            return 1;
+        }
+    }
+
+    TelemetryLogWriter log;
+    if (logPath) {
+        if (!log.open(logPath)) {
+            perror(logPath);
+            return 1;
+        }
+    } else {
+        printf("%s\n", TelemetryCodec::CSV_HEADER);
+    }
+
+    CaptureDecoder decoder;
+    unsigned long records = 0;
+    unsigned long gaps = 0;
+    bool haveLast = false;
+    uint16_t lastSeq = 0;
+
+    static uint8_t buf[1 << 16];
+    size_t got;
+    while ((got = fread(buf, 1, sizeof(buf), in)) > 0) {
+        for (size_t i = 0; i < got; i++) {
+            CaptureDecoder::Frame kind = decoder.feed(buf[i]);
+            if (kind != CaptureDecoder::Frame::RECORD && kind != CaptureDecoder::Frame::TICK) continue;
+            const TelemetryRecord &rec = decoder.record();
+            records++;
+
+            // seq moves on by the snapshots each tick consumed (none, one,
+            // or a parked stride's several); further means losses.
+            if (haveLast && TelemetryCodec::seqGap(lastSeq, rec)) gaps++;
+            lastSeq  = rec.seq;
+            haveLast = true;
+            if (logPath) {
+                log.append(rec);
+                continue;
+            }
+            char line[128];
+            TelemetryCodec::csvRow(rec, telemetryStateName(rec.state), line, sizeof(line));
+            puts(line);
+        }
+    }
+
+    if (in != stdin) fclose(in);
+    if (logPath && !log.close()) {
+        perror(logPath);
+        return 1;
+    }
+    fprintf(stderr, "%lu records, %lu rejected chunks, %lu sequence gaps\n",
+            records, static_cast<unsigned long>(decoder.badFrames()), gaps);
+    return 0;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file telemetry_log.cpp
+ * @brief Fixed-record telemetry log writer and memory-mapped reader.
+ */
+
+#include "telemetry_log.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char *const STATE_NAMES[TELEMETRY_STATES] = {
+    "TRACK", "ACQUIRE", "LOCK", "COAST", "SEARCH", "PARK"
+};
+
+const char *telemetryStateName(uint8_t state) {
+    return state < TELEMETRY_STATES ? STATE_NAMES[state] : "?";
+}
+
+// ===================================================================
+// TelemetryLogWriter
+// ===================================================================
+
+TelemetryLogWriter::~TelemetryLogWriter() {
+    close();
+}
+
+bool TelemetryLogWriter::open(const char *path) {
+    f_ = fopen(path, "wb");
+    if (!f_) return false;
+
+    TelemetryLogHeader h;
+    h.recordBytes = sizeof(TelemetryLogRecord);
+    ok_      = fwrite(&h, sizeof(h), 1, f_) == 1;
+    records_ = 0;
+    return ok_;
+}
+
+void TelemetryLogWriter::append(const TelemetryRecord &rec) {
+    if (!f_) return;
+
+    TelemetryLogRecord r = {};
+    uint32_t delta = rec.tUs - lastUs_;
+    if (records_ == 0 || delta >= 0x80000000u) {
+        // First record, or the clock went backwards: the turret rebooted.
+        r.flags = TelemetryLogRecord::SESSION_START;
+        tUs_    = rec.tUs;
+    } else {
+        tUs_ += delta;   // Across a micros() rollover too
+        if (TelemetryCodec::seqGap(lastSeq_, rec)) r.flags = TelemetryLogRecord::SEQ_GAP;
+    }
+    lastUs_  = rec.tUs;
+    lastSeq_ = rec.seq;
+
+    r.tUs      = tUs_;
+    r.seq      = rec.seq;
+    r.rawBits  = rec.rawBits;
+    r.filtered = rec.filtered;
+    r.state    = rec.state;
+    r.flags   |= rec.transition ? TelemetryLogRecord::TRANSITION : 0;
+    r.panCdeg  = rec.panCdeg;
+    r.panCmd   = rec.panCmd;
+    r.tiltDeg  = rec.tiltDeg;
+    r.loopUs   = rec.loopUs;
+    r.samples  = rec.samples;
+    ok_ &= fwrite(&r, sizeof(r), 1, f_) == 1;
+    records_++;
+}
+
+bool TelemetryLogWriter::close() {
+    if (!f_) return ok_;
+    ok_ &= fclose(f_) == 0;
+    f_ = nullptr;
+    return ok_;
+}
+
+// ===================================================================
+// TelemetryLogFile
+// ===================================================================
+
+TelemetryLogFile::~TelemetryLogFile() {
+    close();
+}
+
+bool TelemetryLogFile::open(const char *path) {
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        error_ = "cannot open";
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(TelemetryLogHeader))) {
+        ::close(fd);
+        error_ = "not a telemetry log (too short)";
+        return false;
+    }
+
+    bytes_ = static_cast<uint64_t>(st.st_size);
+    map_ = mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);   // The mapping keeps the file
+    if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        error_ = "mmap failed";
+        return false;
+    }
+
+    const TelemetryLogHeader *h = static_cast<const TelemetryLogHeader *>(map_);
+    if (h->magic != TelemetryLogHeader::MAGIC || h->version != TelemetryLogHeader::VERSION) {
+        close();
+        error_ = "not a telemetry log (convert with telemetry_decode --log)";
+        return false;
+    }
+    if (h->recordBytes != sizeof(TelemetryLogRecord)) {
+        close();
+        error_ = "unsupported record size";
+        return false;
+    }
+
+    // One pass front to back: let the kernel read ahead and drop behind.
+    madvise(map_, bytes_, MADV_SEQUENTIAL);
+    records_ = reinterpret_cast<const TelemetryLogRecord *>(
+        static_cast<const uint8_t *>(map_) + sizeof(TelemetryLogHeader));
+    count_ = static_cast<size_t>((bytes_ - sizeof(TelemetryLogHeader)) / sizeof(TelemetryLogRecord));
+    return true;
+}
+
+void TelemetryLogFile::close() {
+    if (map_) munmap(map_, bytes_);
+    map_     = nullptr;
+    bytes_   = 0;
+    records_ = nullptr;
+    count_   = 0;
+}
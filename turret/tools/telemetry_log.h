@@ -0,0 +1,123 @@
+/**
+ * @file telemetry_log.h
+ * @brief Host tools: fixed-record telemetry log, written from a decoded
+ *        serial capture and read back memory-mapped.
+ *
+ * The serial stream (telemetry_stream.h) is framed for a noisy wire:
+ * COBS, CRCs, text between frames, a 32-bit clock that wraps every
+ * 71.6 minutes.  Decode it once into a log (telemetry_decode --log) and
+ * every later pass is a scan over an array:
+ *
+ *   off size
+ *     0  32   TelemetryLogHeader
+ *    32  24   TelemetryLogRecord × N, back to back, to the end of file
+ *
+ * Little-endian, natural alignment, no per-record framing.  The record
+ * count is the file size; a log cut short by a crash loses at most the
+ * last partial record.  TelemetryLogFile maps it read-only, so files far
+ * larger than RAM scan from the page cache with no copies.
+ */
+
+#ifndef TELEMETRY_LOG_H
+#define TELEMETRY_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "telemetry_stream.h"
+
+/** @brief File header (32 bytes). */
+struct TelemetryLogHeader {
+    static constexpr uint32_t MAGIC   = 0x474C5453;   ///< "STLG"
+    static constexpr uint16_t VERSION = 2;
+
+    uint32_t magic       = MAGIC;
+    uint16_t version     = VERSION;
+    uint16_t recordBytes = 0;
+    uint8_t  reserved[24] = {};
+};
+
+/** @brief One control tick (24 bytes). */
+struct TelemetryLogRecord {
+    enum Flags : uint8_t {
+        TRANSITION    = 0x01,   ///< State changed this tick
+        SESSION_START = 0x02,   ///< First record, or the turret rebooted before it
+        SEQ_GAP       = 0x04    ///< Frames or snapshots lost before it (TelemetryCodec::seqGap)
+    };
+
+    uint64_t tUs;        ///< micros(), unwrapped: monotonic within a session
+    uint16_t seq;
+    uint8_t  rawBits;    ///< As TelemetryRecord
+    uint8_t  filtered;
+    uint8_t  state;      ///< TurretState
+    uint8_t  flags;
+    int16_t  panCdeg;
+    int16_t  panCmd;
+    int16_t  tiltDeg;
+    uint16_t loopUs;
+    uint8_t  samples;    ///< Snapshots consumed: several on a parked stride
+    uint8_t  pad;
+};
+
+static_assert(sizeof(TelemetryLogHeader) == 32, "log header layout");
+static_assert(sizeof(TelemetryLogRecord) == 24, "log record layout");
+
+/** @brief Names in TurretState order (turret_fsm.h pulls in ESP32 headers). */
+const char *telemetryStateName(uint8_t state);
+
+/** @brief Number of TurretState values named by telemetryStateName(). */
+constexpr uint8_t TELEMETRY_STATES = 6;
+
+/** @brief Appends decoded records: unwraps the clock, marks sessions and gaps. */
+class TelemetryLogWriter {
+public:
+    ~TelemetryLogWriter();
+
+    /** @brief Create @p path with a header.  @return false on I/O error. */
+    bool open(const char *path);
+
+    void append(const TelemetryRecord &rec);
+
+    /** @brief Flush and close.  @return false if any write failed. */
+    bool close();
+
+    uint64_t records() const { return records_; }
+
+private:
+    FILE    *f_       = nullptr;
+    bool     ok_      = true;
+    uint64_t records_ = 0;
+    uint64_t tUs_     = 0;       ///< Unwrapped time of the last record
+    uint32_t lastUs_  = 0;       ///< ... as received
+    uint16_t lastSeq_ = 0;
+};
+
+/** @brief A log mapped read-only. */
+class TelemetryLogFile {
+public:
+    ~TelemetryLogFile();
+
+    /**
+     * @brief Map @p path.
+     *
+     * @return false (with a message in error()) if it cannot be opened,
+     *         is not a log or has another record size.
+     */
+    bool open(const char *path);
+
+    void close();
+
+    const TelemetryLogRecord *records() const { return records_; }
+    size_t count() const { return count_; }
+    uint64_t bytes() const { return bytes_; }
+    const char *error() const { return error_; }
+
+private:
+    void                     *map_     = nullptr;
+    uint64_t                  bytes_   = 0;
+    const TelemetryLogRecord *records_ = nullptr;
+    size_t                    count_   = 0;
+    const char               *error_   = "";
+};
+
+#endif // TELEMETRY_LOG_H
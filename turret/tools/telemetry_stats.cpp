@@ -0,0 +1,343 @@
+/**
+ * @file telemetry_stats.cpp
+ * @brief Host tool: one pass over fixed-record telemetry logs — state
+ *        dwell, reacquisition, loop time, sensor duty, servo travel.
+ *
+ * Build (from turret/):
+ *
+ *     g++ -std=c++17 -O2 -Iinclude -Itools tools/telemetry_stats.cpp \
+ *         tools/telemetry_log.cpp -o telemetry_stats -lpthread
+ *
+ * Convert each capture once, then scan the logs as often as needed:
+ *
+ *     ./telemetry_decode --log lounge.tlog lounge.bin
+ *     ./telemetry_stats lounge.tlog hall.tlog
+ *
+ * Each log is mapped read-only (telemetry_log.h) and split into one
+ * contiguous chunk per thread (--threads, default one per core).  A
+ * worker reads its records in place; the only state that crosses a
+ * chunk boundary is the record before it (read in place too) and an
+ * open signal loss, both resolved when the chunks are merged in order.
+ * Memory use is the per-thread tables, whatever the file size: logs
+ * bigger than RAM stream from the page cache.
+ *
+ * Figures, per log and over all of them:
+ *
+ *   dwell      time per state and entries into it
+ *   reacquire  signal loss (a tracking state → SEARCH / PARK) to
+ *              the next ACQUIRE, histogram in doubling bins
+ *   loop time  loopUs percentiles (exact, 1 µs bins) and ticks over
+ *              LOOP_PERIOD_US
+ *   sensors    per sensor: raw LOW, filtered ACTIVE and SATURATED, % of
+ *              ticks
+ *   servos     dead-reckoned pan travel, tilt travel, pan reversals
+ *              and full-speed-equivalent pan time
+ *
+ * Time between records longer than MAX_TICK_GAP_US (lost frames, a
+ * paused capture) and across reboots counts as a gap, not as dwell or
+ * travel.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "config.h"
+#include "telemetry_log.h"
+
+namespace {
+
+/** Longer than this between two records is a gap in the capture. */
+constexpr uint64_t MAX_TICK_GAP_US = 1000000;
+
+/** Reacquisition bins: < 0.25 s, then doubling, the last open-ended. */
+constexpr uint8_t  REACQ_BINS     = 12;
+constexpr uint64_t REACQ_FIRST_US = 250000;
+
+constexpr uint32_t LOOP_BINS = 0x10000;
+
+bool tracking(uint8_t state) {
+    return state >= 1 && state <= 3;   // ACQUIRE, LOCK, COAST
+}
+
+struct Stats {
+    uint64_t records   = 0;
+    uint64_t sessions  = 0;
+    uint64_t seqGaps   = 0;
+    uint64_t timeGaps  = 0;
+    uint64_t coveredUs = 0;
+    uint64_t gapUs     = 0;
+
+    uint64_t dwellUs[TELEMETRY_STATES] = {};
+    uint64_t entries[TELEMETRY_STATES] = {};
+
+    uint64_t reacqBins[REACQ_BINS] = {};
+    uint64_t reacqCount = 0;
+    uint64_t reacqSumUs = 0;
+    uint64_t reacqMaxUs = 0;
+
+    // Chunk boundary: the first loss / acquire / reboot event, and a loss
+    // still open at the end.
+    enum class First : uint8_t { NONE, ACQUIRE, OTHER };
+    First    first    = First::NONE;
+    uint64_t firstUs  = 0;
+    bool     lossOpen = false;
+    uint64_t lossUs   = 0;
+
+    std::vector<uint64_t> loopHist;
+    uint64_t overruns = 0;
+
+    uint64_t rawLow[4]    = {};
+    uint64_t active[4]    = {};
+    uint64_t saturated[4] = {};
+
+    uint64_t panTravelCdeg = 0;
+    uint64_t tiltTravelDeg = 0;
+    uint64_t panReversals  = 0;
+    double   panFullS      = 0.0;   ///< ∑ |command| × dt
+
+    Stats() : loopHist(LOOP_BINS, 0) {}
+
+    void reacquired(uint64_t us) {
+        uint8_t bin = 0;
+        for (uint64_t edge = REACQ_FIRST_US; us >= edge && bin < REACQ_BINS - 1; edge *= 2) bin++;
+        reacqBins[bin]++;
+        reacqCount++;
+        reacqSumUs += us;
+        if (us > reacqMaxUs) reacqMaxUs = us;
+    }
+
+    /**
+     * Fold in @p b, which follows this.  @p contiguous: b's first record
+     * directly follows this one's last (chunks of one log), so an open
+     * loss pairs with b's first acquire.
+     */
+    void merge(const Stats &b, bool contiguous) {
+        if (contiguous && lossOpen && b.first == First::ACQUIRE) reacquired(b.firstUs - lossUs);
+        if (contiguous) {
+            if (first == First::NONE) {
+                first   = b.first;
+                firstUs = b.firstUs;
+            }
+            if (b.first != First::NONE) {
+                lossOpen = b.lossOpen;
+                lossUs   = b.lossUs;
+            }
+        } else {
+            lossOpen = false;
+        }
+
+        records   += b.records;
+        sessions  += b.sessions;
+        seqGaps   += b.seqGaps;
+        timeGaps  += b.timeGaps;
+        coveredUs += b.coveredUs;
+        gapUs     += b.gapUs;
+        for (uint8_t s = 0; s < TELEMETRY_STATES; s++) {
+            dwellUs[s] += b.dwellUs[s];
+            entries[s] += b.entries[s];
+        }
+        for (uint8_t i = 0; i < REACQ_BINS; i++) reacqBins[i] += b.reacqBins[i];
+        reacqCount += b.reacqCount;
+        reacqSumUs += b.reacqSumUs;
+        if (b.reacqMaxUs > reacqMaxUs) reacqMaxUs = b.reacqMaxUs;
+        for (uint32_t i = 0; i < LOOP_BINS; i++) loopHist[i] += b.loopHist[i];
+        overruns += b.overruns;
+        for (uint8_t k = 0; k < 4; k++) {
+            rawLow[k]    += b.rawLow[k];
+            active[k]    += b.active[k];
+            saturated[k] += b.saturated[k];
+        }
+        panTravelCdeg += b.panTravelCdeg;
+        tiltTravelDeg += b.tiltTravelDeg;
+        panReversals  += b.panReversals;
+        panFullS      += b.panFullS;
+    }
+};
+
+/** Records [begin, end) of @p r; r[begin − 1] is read for the first one. */
+void scan(const TelemetryLogRecord *r, size_t begin, size_t end, Stats &st) {
+    for (size_t i = begin; i < end; i++) {
+        const TelemetryLogRecord &cur = r[i];
+        st.records++;
+        st.loopHist[cur.loopUs]++;
+        if (cur.loopUs > LOOP_PERIOD_US) st.overruns++;
+        for (uint8_t k = 0; k < 4; k++) {
+            st.rawLow[k] += (cur.rawBits >> k) & 1;
+            uint8_t f = (cur.filtered >> (2 * k)) & 3;
+            st.active[k]    += f == 1;
+            st.saturated[k] += f == 2;
+        }
+        if (cur.flags & TelemetryLogRecord::SEQ_GAP) st.seqGaps++;
+        uint8_t state = cur.state < TELEMETRY_STATES ? cur.state : 0;
+
+        if (i == 0 || (cur.flags & TelemetryLogRecord::SESSION_START)) {
+            st.sessions++;
+            st.entries[state]++;
+            st.lossOpen = false;
+            if (st.first == Stats::First::NONE) st.first = Stats::First::OTHER;
+            continue;
+        }
+
+        const TelemetryLogRecord &prev = r[i - 1];
+        uint64_t dt = cur.tUs - prev.tUs;
+        if (dt > MAX_TICK_GAP_US) {
+            st.timeGaps++;
+            st.gapUs += dt;
+        } else {
+            uint8_t held = prev.state < TELEMETRY_STATES ? prev.state : 0;
+            st.coveredUs     += dt;
+            st.dwellUs[held] += dt;
+            st.panTravelCdeg += static_cast<uint64_t>(abs(cur.panCdeg - prev.panCdeg));
+            st.tiltTravelDeg += static_cast<uint64_t>(abs(cur.tiltDeg - prev.tiltDeg));
+            st.panFullS      += abs(prev.panCmd) / 10000.0 * dt / 1e6;
+        }
+        if ((cur.panCmd > 0 && prev.panCmd < 0) || (cur.panCmd < 0 && prev.panCmd > 0)) st.panReversals++;
+
+        if (cur.state == prev.state) continue;
+        st.entries[state]++;
+        bool was = tracking(prev.state);
+        bool is  = tracking(cur.state);
+        if (was && !is) {
+            st.lossOpen = true;
+            st.lossUs   = cur.tUs;
+            if (st.first == Stats::First::NONE) st.first = Stats::First::OTHER;
+        } else if (!was && is) {
+            if (st.lossOpen) {
+                st.reacquired(cur.tUs - st.lossUs);
+            } else if (st.first == Stats::First::NONE) {
+                st.first   = Stats::First::ACQUIRE;
+                st.firstUs = cur.tUs;
+            }
+            st.lossOpen = false;
+        }
+    }
+}
+
+/** Scan @p log on @p threads workers, merged in order into @p out. */
+void scanParallel(const TelemetryLogFile &log, unsigned threads, Stats &out) {
+    size_t n = log.count();
+    if (threads > n / 4096 + 1) threads = static_cast<unsigned>(n / 4096 + 1);   // Not worth a thread
+
+    std::vector<Stats> part(threads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        size_t b = n * t / threads;
+        size_t e = n * (t + 1) / threads;
+        workers.emplace_back(scan, log.records(), b, e, std::ref(part[t]));
+    }
+    for (std::thread &w : workers) w.join();
+    for (const Stats &p : part) out.merge(p, true);
+}
+
+uint32_t loopPercentile(const Stats &st, double p) {
+    uint64_t want = static_cast<uint64_t>(p * st.records);
+    if (want >= st.records) want = st.records - 1;
+    uint64_t cum = 0;
+    for (uint32_t v = 0; v < LOOP_BINS; v++) {
+        cum += st.loopHist[v];
+        if (cum > want) return v;
+    }
+    return LOOP_BINS - 1;
+}
+
+double pct(uint64_t part, uint64_t whole) {
+    return whole ? 100.0 * part / whole : 0.0;
+}
+
+void report(const char *name, const Stats &st) {
+    printf("== %s: %llu records, %llu session(s), %.2f h covered, %llu gaps (%.1f s), %llu seq gaps\n",
+           name, (unsigned long long)st.records, (unsigned long long)st.sessions,
+           st.coveredUs / 3.6e9, (unsigned long long)st.timeGaps, st.gapUs / 1e6,
+           (unsigned long long)st.seqGaps);
+    if (st.records == 0) return;
+
+    printf("  state       dwell        %%   entries\n");
+    for (uint8_t s = 0; s < TELEMETRY_STATES; s++) {
+        if (st.dwellUs[s] == 0 && st.entries[s] == 0) continue;
+        printf("  %-8s %9.1f s %6.1f %9llu\n", telemetryStateName(s), st.dwellUs[s] / 1e6,
+               pct(st.dwellUs[s], st.coveredUs), (unsigned long long)st.entries[s]);
+    }
+
+    printf("  reacquire  %llu, mean %.2f s, max %.2f s\n", (unsigned long long)st.reacqCount,
+           st.reacqCount ? st.reacqSumUs / 1e6 / st.reacqCount : 0.0, st.reacqMaxUs / 1e6);
+    uint64_t edge = REACQ_FIRST_US;
+    for (uint8_t i = 0; i < REACQ_BINS; i++, edge *= 2) {
+        if (st.reacqBins[i] == 0) continue;
+        if (i == 0) {
+            printf("    < %7.2f s %9llu\n", edge / 1e6, (unsigned long long)st.reacqBins[i]);
+        } else if (i == REACQ_BINS - 1) {
+            printf("   >= %7.2f s %9llu\n", edge / 2e6, (unsigned long long)st.reacqBins[i]);
+        } else {
+            printf("    < %7.2f s %9llu\n", edge / 1e6, (unsigned long long)st.reacqBins[i]);
+        }
+    }
+
+    printf("  loop us    p50 %u  p90 %u  p99 %u  p99.9 %u  max %u  over %lu us: %llu\n",
+           loopPercentile(st, 0.50), loopPercentile(st, 0.90), loopPercentile(st, 0.99),
+           loopPercentile(st, 0.999), loopPercentile(st, 1.0), (unsigned long)LOOP_PERIOD_US,
+           (unsigned long long)st.overruns);
+
+    static const char SENSOR[4] = {'T', 'B', 'L', 'R'};
+    printf("  sensor     raw LOW %%   active %%   saturated %%\n");
+    for (uint8_t k = 0; k < 4; k++) {
+        printf("  %c        %9.2f %10.2f %13.3f\n", SENSOR[k], pct(st.rawLow[k], st.records),
+               pct(st.active[k], st.records), pct(st.saturated[k], st.records));
+    }
+
+    double hours = st.coveredUs / 3.6e9;
+    printf("  servos     pan %.0f° (%.0f°/h), tilt %llu° (%.0f°/h), %llu pan reversals, "
+           "%.0f s at full pan speed\n",
+           st.panTravelCdeg / 100.0, hours > 0 ? st.panTravelCdeg / 100.0 / hours : 0.0,
+           (unsigned long long)st.tiltTravelDeg, hours > 0 ? st.tiltTravelDeg / hours : 0.0,
+           (unsigned long long)st.panReversals, st.panFullS);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    unsigned threads = std::thread::hardware_concurrency();
+    std::vector<const char *> paths;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned>(strtoul(argv[++i], nullptr, 0));
+        } else if (argv[i][0] != '-') {
+            paths.push_back(argv[i]);
+        } else {
+            paths.clear();
+            break;
+        }
+    }
+    if (paths.empty()) {
+        fprintf(stderr, "usage: %s [--threads N] LOG.tlog...\n", argv[0]);
+        return 2;
+    }
+    if (threads == 0) threads = 1;
+
+    Stats all;
+    uint64_t bytes = 0;
+    double wallS = 0.0;
+    for (const char *path : paths) {
+        TelemetryLogFile log;
+        if (!log.open(path)) {
+            fprintf(stderr, "%s: %s\n", path, log.error());
+            return 1;
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        Stats st;
+        scanParallel(log, threads, st);
+        wallS += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        bytes += log.bytes();
+
+        report(path, st);
+        all.merge(st, false);
+    }
+    if (paths.size() > 1) report("all", all);
+
+    fprintf(stderr, "scanned %llu records (%.1f MB) in %.3f s on %u threads: %.3g records/s\n",
+            (unsigned long long)all.records, bytes / 1e6, wallS, threads,
+            wallS > 0 ? all.records / wallS : 0.0);
+    return 0;
+}